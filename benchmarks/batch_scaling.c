@@ -0,0 +1,149 @@
+#include "json_grammar.h"
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Usage: batch_scaling [record_count] [max_threads]
+//
+// Parses the same records with 1, 2, 4, ... threads up to max_threads (by default, the number of online
+// processors), and prints the time taken and the speedup over one thread.
+
+static atomic_size_t failures;
+
+static double
+now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// A JSON object with a number of members that varies from record to record, so that the threads get uneven work.
+static char *
+make_record(size_t index)
+{
+    size_t const members = 4 + (index * 7919) % 60;
+    char * record = malloc(members * 80 + 16);
+    char * end = record;
+
+    end += sprintf(end, "{\"id\": %zu", index);
+    for (size_t i = 0; i < members; i++)
+    {
+        end += sprintf(
+            end,
+            ", \"field_%zu\": {\"name\": \"value %zu\", \"score\": %zu.5, \"tags\": [true, null, %zu]}",
+            i,
+            index + i,
+            i * 3,
+            i
+        );
+    }
+    strcpy(end, "}");
+
+    return record;
+}
+
+static void
+check_result(size_t index, epc_parse_session_t * session, void * user_data)
+{
+    (void)index;
+    (void)user_data;
+    if (session->result.is_error)
+    {
+        atomic_fetch_add(&failures, 1);
+    }
+}
+
+static double
+time_batch(epc_parser_t * grammar, epc_parse_input_t const * inputs, size_t count, size_t threads)
+{
+    epc_parse_batch_options_t options = {.thread_count = threads, .on_result = check_result};
+    double const start = now_seconds();
+
+    epc_parse_batch(grammar, inputs, count, NULL, &options);
+
+    return now_seconds() - start;
+}
+
+int
+main(int argc, char ** argv)
+{
+    size_t const count = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+    long const online = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t const max_threads = argc > 2 ? strtoul(argv[2], NULL, 10) : (online > 0 ? (size_t)online : 1);
+
+    epc_parser_list * list = epc_parser_list_create();
+    epc_parser_t * grammar = create_json_grammar(list);
+    char ** records = malloc(count * sizeof(*records));
+    epc_parse_input_t * inputs = malloc(count * sizeof(*inputs));
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        records[i] = make_record(i);
+        bytes += strlen(records[i]);
+        inputs[i] = (epc_parse_input_t){.type = EPC_PARSE_TYPE_STRING, .input_string = records[i]};
+    }
+
+    printf("%zu records, %.1f MB, %zu processors\n", count, (double)bytes / 1e6, (size_t)online);
+    if (online > 0 && max_threads > (size_t)online)
+    {
+        fprintf(
+            stderr,
+            "warning: only %ld processors are online, so runs with more threads than that don't measure scaling\n",
+            online
+        );
+    }
+    printf("%8s %10s %12s %8s %10s\n", "threads", "seconds", "MB/s", "speedup", "efficiency");
+
+    // The first run warms up the caches and the allocator.
+    time_batch(grammar, inputs, count, 1);
+
+    double single = 0;
+    size_t threads = 1;
+    for (;;)
+    {
+        double const seconds = time_batch(grammar, inputs, count, threads);
+
+        if (threads == 1)
+        {
+            single = seconds;
+        }
+        printf(
+            "%8zu %10.3f %12.1f %7.2fx %9.0f%%\n",
+            threads,
+            seconds,
+            (double)bytes / 1e6 / seconds,
+            single / seconds,
+            100.0 * single / seconds / (double)threads
+        );
+
+        if (threads >= max_threads)
+        {
+            break;
+        }
+        threads = threads * 2 < max_threads ? threads * 2 : max_threads;
+    }
+
+    if (atomic_load(&failures) > 0)
+    {
+        fprintf(stderr, "%zu records failed to parse\n", atomic_load(&failures));
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        free(records[i]);
+    }
+    free(records);
+    free(inputs);
+    epc_parser_list_free(list);
+
+    return atomic_load(&failures) > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,248 @@
+#include "corpus.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A string that grows as it is appended to. Once an append fails, the rest are ignored and the result is NULL.
+typedef struct
+{
+    char * text;
+    size_t len;
+    size_t capacity;
+    bool is_out_of_memory;
+} corpus_buffer_t;
+
+static void
+corpus_reserve(corpus_buffer_t * buffer, size_t extra)
+{
+    if (buffer->is_out_of_memory || buffer->len + extra + 1 <= buffer->capacity)
+    {
+        return;
+    }
+
+    size_t capacity = buffer->capacity == 0 ? 4096 : buffer->capacity;
+    while (capacity < buffer->len + extra + 1)
+    {
+        capacity *= 2;
+    }
+
+    char * text = realloc(buffer->text, capacity);
+    if (text == NULL)
+    {
+        buffer->is_out_of_memory = true;
+        return;
+    }
+    buffer->text = text;
+    buffer->capacity = capacity;
+}
+
+static void
+corpus_append(corpus_buffer_t * buffer, char const * s)
+{
+    size_t const len = strlen(s);
+
+    corpus_reserve(buffer, len);
+    if (!buffer->is_out_of_memory)
+    {
+        memcpy(buffer->text + buffer->len, s, len + 1);
+        buffer->len += len;
+    }
+}
+
+static void
+corpus_appendf(corpus_buffer_t * buffer, char const * format, ...)
+{
+    char text[256];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    corpus_append(buffer, text);
+}
+
+static void
+corpus_append_repeated(corpus_buffer_t * buffer, char c, size_t count)
+{
+    corpus_reserve(buffer, count);
+    if (!buffer->is_out_of_memory)
+    {
+        memset(buffer->text + buffer->len, c, count);
+        buffer->len += count;
+        buffer->text[buffer->len] = '\0';
+    }
+}
+
+static char *
+corpus_finish(corpus_buffer_t * buffer)
+{
+    if (buffer->is_out_of_memory)
+    {
+        free(buffer->text);
+        return NULL;
+    }
+    if (buffer->text == NULL)
+    {
+        return calloc(1, 1);
+    }
+
+    return buffer->text;
+}
+
+// A small linear congruential generator, so that the corpora are the same on every platform.
+static unsigned
+corpus_random(unsigned * state)
+{
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7fff;
+}
+
+char *
+corpus_nested_json(size_t depth, size_t count)
+{
+    corpus_buffer_t buffer = {0};
+
+    corpus_append(&buffer, "[");
+    for (size_t i = 0; i < count; i++)
+    {
+        corpus_append(&buffer, i == 0 ? "\n" : ",\n");
+        for (size_t level = 0; level < depth; level++)
+        {
+            corpus_appendf(&buffer, level % 2 == 0 ? "{\"level_%zu\": " : "[%zu, ", level);
+        }
+        corpus_append(&buffer, "\"leaf\"");
+        for (size_t level = depth; level > 0; level--)
+        {
+            corpus_append(&buffer, (level - 1) % 2 == 0 ? "}" : "]");
+        }
+    }
+    corpus_append(&buffer, "\n]");
+
+    return corpus_finish(&buffer);
+}
+
+char *
+corpus_json_records(size_t bytes)
+{
+    corpus_buffer_t buffer = {0};
+    unsigned state = 1;
+
+    corpus_append(&buffer, "[");
+    for (size_t i = 0; buffer.len < bytes && !buffer.is_out_of_memory; i++)
+    {
+        size_t const members = 2 + corpus_random(&state) % 12;
+
+        corpus_appendf(&buffer, "%s\n  {\"id\": %zu", i == 0 ? "" : ",", i);
+        for (size_t m = 0; m < members; m++)
+        {
+            corpus_appendf(
+                &buffer,
+                ", \"field_%zu\": {\"name\": \"value \\\"%zu\\\"\", \"score\": %u.25e-3, "
+                "\"tags\": [true, false, null]}",
+                m,
+                i + m,
+                corpus_random(&state)
+            );
+        }
+        corpus_append(&buffer, "}");
+    }
+    corpus_append(&buffer, "\n]");
+
+    return corpus_finish(&buffer);
+}
+
+char *
+corpus_arithmetic_chain(size_t terms)
+{
+    static char const * const operators[] = {" + ", " - ", " * ", " / "};
+    static char const * const names[] = {"x", "pi", "e"};
+    corpus_buffer_t buffer = {0};
+    unsigned state = 2;
+    size_t open = 0;
+
+    for (size_t i = 0; i < terms; i++)
+    {
+        unsigned const r = corpus_random(&state);
+
+        if (i > 0)
+        {
+            corpus_append(&buffer, operators[r % 4]);
+        }
+        if (r % 7 == 0 && i + 1 < terms)
+        {
+            corpus_append(&buffer, "(");
+            open++;
+        }
+        if (r % 5 == 0)
+        {
+            corpus_append(&buffer, names[r % 3]);
+        }
+        else
+        {
+            corpus_appendf(&buffer, "%u.%u", r % 1000 + 1, r % 10);
+        }
+        if (open > 0 && r % 3 == 0)
+        {
+            corpus_append(&buffer, ")");
+            open--;
+        }
+    }
+    corpus_append_repeated(&buffer, ')', open);
+
+    return corpus_finish(&buffer);
+}
+
+char *
+corpus_comment_runs(size_t bytes)
+{
+    corpus_buffer_t buffer = {0};
+    unsigned state = 3;
+
+    for (size_t i = 0; buffer.len < bytes && !buffer.is_out_of_memory; i++)
+    {
+        unsigned const r = corpus_random(&state);
+
+        switch (r % 3)
+        {
+        case 0:
+            corpus_append_repeated(&buffer, ' ', 100 + r % 400);
+            corpus_append(&buffer, "\n\t\n");
+            break;
+        case 1:
+            corpus_append(&buffer, "/*");
+            corpus_append_repeated(&buffer, '*', 10);
+            corpus_append_repeated(&buffer, '-', 200 + r % 300);
+            corpus_append(&buffer, "\n * a comment that spans lines\n */ ");
+            break;
+        default:
+            corpus_append(&buffer, "//");
+            corpus_append_repeated(&buffer, '=', 100 + r % 200);
+            corpus_append(&buffer, "\n");
+            break;
+        }
+        corpus_appendf(&buffer, "word%zu", i);
+    }
+    corpus_append(&buffer, "\n");
+
+    return corpus_finish(&buffer);
+}
+
+char *
+corpus_json_pointer(size_t segments)
+{
+    static char const * const tokens[] = {"foo", "a~1b", "0", "m~0n", "", "with spaces", "c%d", "i\\j", "k\"l"};
+    corpus_buffer_t buffer = {0};
+    unsigned state = 4;
+
+    for (size_t i = 0; i < segments; i++)
+    {
+        corpus_append(&buffer, "/");
+        corpus_append(&buffer, tokens[corpus_random(&state) % (sizeof(tokens) / sizeof(tokens[0]))]);
+    }
+
+    return corpus_finish(&buffer);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+
+// Generators for the inputs the benchmarks parse. Each returns a NUL terminated string to be freed with free(), or NULL
+// if there isn't the memory for it. The same arguments always give the same input.
+
+// A JSON array of `count` documents, each nested `depth` objects and arrays deep.
+char *
+corpus_nested_json(size_t depth, size_t count);
+
+// A JSON array of records of varying size, about `bytes` long.
+char *
+corpus_json_records(size_t bytes);
+
+// A simple_calc expression of `terms` numbers, variables and constants joined by arithmetic operators, with some
+// parenthesised.
+char *
+corpus_arithmetic_chain(size_t terms);
+
+// Words separated by long runs of whitespace, C comments and C++ comments, about `bytes` long.
+char *
+corpus_comment_runs(size_t bytes);
+
+// A JSON pointer of `segments` reference tokens, some with escapes.
+char *
+corpus_json_pointer(size_t segments);
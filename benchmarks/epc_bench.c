@@ -0,0 +1,844 @@
+#include "ast_evaluator.h"
+#include "corpus.h"
+#include "grammar.h"
+#include "json_ast.h"
+#include "json_ast_actions.h"
+#include "json_grammar.h"
+#include "json_pointer.h"
+#include "semantic_actions.h"
+#include "simple_calc_ast_actions.h"
+
+#include <easy_pc/easy_pc.h>
+#include <easy_pc/easy_pc_ast.h>
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+// Usage: epc_bench [--filter=TEXT] [--iterations=N] [--scale=F] [--json=FILE] [--compare=BASELINE] [--threshold=PCT]
+//
+// Runs each benchmark whose name contains TEXT (all of them by default) N times (10 by default) on inputs F times
+// their default size (1 by default), and prints the results. --json writes them to FILE as JSON as well, which makes a
+// baseline. --compare checks the results against those in the JSON file BASELINE, and exits with a failure if a
+// benchmark's throughput fell, or its allocations per byte rose, by more than PCT percent (10 by default), or if a
+// benchmark that was run isn't in the baseline.
+//
+// Compare with a baseline made with the same --filter and --scale, as the benchmarks run before one warm up the
+// allocator for it.
+//
+// Peak RSS is that of the whole process so far, so it only describes a benchmark on its own when it is the only one
+// run, or the one with the largest input.
+
+#define BENCH_MAX_NAME 64
+
+// --- Allocation counting ---
+
+static atomic_size_t allocations;
+
+#ifdef __GLIBC__
+// Every allocation, by the library too, comes through these, as the executable's definitions take precedence.
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t count, size_t size);
+extern void * __libc_realloc(void * ptr, size_t size);
+
+void *
+malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *
+calloc(size_t count, size_t size)
+{
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *
+realloc(void * ptr, size_t size)
+{
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+static bool const counts_allocations = true;
+#else
+static bool const counts_allocations = false;
+#endif
+
+// --- Benchmarks ---
+
+typedef struct
+{
+    epc_parser_t * parser;
+    char * text;
+    size_t len;
+
+    epc_ast_hook_registry_t * registry; // For AST benchmarks.
+    epc_ast_node_free_cb free_node;
+    epc_parse_session_t session; // The parse AST benchmarks build from.
+
+    FILE * file; // For file descriptor benchmarks, holding `text`.
+} bench_input_t;
+
+typedef struct
+{
+    uint64_t ns;
+    size_t allocations;
+    size_t nodes; // Counted when asked for, outside of the time measured.
+    bool is_ok;
+    uint64_t start_ns;
+    size_t start_allocations;
+} bench_sample_t;
+
+typedef struct
+{
+    char const * name;
+    char * (*corpus)(double scale);
+    epc_parser_t * (*grammar)(epc_parser_list * list);
+    bool (*setup)(bench_input_t * input);
+    void (*run)(bench_input_t * input, bench_sample_t * sample, bool count_nodes);
+
+    // For AST benchmarks.
+    int action_count;
+    epc_ast_registry_init_cb registry_init;
+    epc_ast_node_free_cb free_node;
+} bench_t;
+
+typedef struct
+{
+    char name[BENCH_MAX_NAME];
+    size_t bytes;
+    size_t nodes;
+    size_t iterations;
+    uint64_t min_ns;
+    uint64_t median_ns;
+    uint64_t p99_ns;
+    double mb_per_s;
+    double ns_per_node;
+    double allocs_per_byte;
+    long peak_rss_kb;
+} bench_result_t;
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void
+sample_start(bench_sample_t * sample)
+{
+    sample->start_allocations = atomic_load(&allocations);
+    sample->start_ns = now_ns();
+}
+
+static void
+sample_stop(bench_sample_t * sample)
+{
+    sample->ns = now_ns() - sample->start_ns;
+    sample->allocations = atomic_load(&allocations) - sample->start_allocations;
+}
+
+static void
+count_node(epc_cpt_node_t * node, void * user_data)
+{
+    (void)node;
+    (*(size_t *)user_data)++;
+}
+
+static size_t
+count_nodes(epc_cpt_node_t * root)
+{
+    size_t nodes = 0;
+    epc_cpt_visitor_t visitor = {.enter_node = count_node, .user_data = &nodes};
+
+    epc_cpt_visit_nodes(root, &visitor);
+
+    return nodes;
+}
+
+// Records the outcome of a parse, and destroys it.
+static void
+sample_session(bench_sample_t * sample, epc_parse_session_t * session, bool count)
+{
+    sample->is_ok = !session->result.is_error;
+    if (sample->is_ok && count)
+    {
+        sample->nodes = count_nodes(session->result.data.success);
+    }
+    epc_parse_session_destroy(session);
+}
+
+static void
+run_parse_str(bench_input_t * input, bench_sample_t * sample, bool count)
+{
+    sample_start(sample);
+    epc_parse_session_t session = epc_parse_str(input->parser, input->text, NULL);
+    sample_stop(sample);
+
+    sample_session(sample, &session, count);
+}
+
+#ifdef WITH_INPUT_STREAM_SUPPORT
+static bool
+setup_parse_fd(bench_input_t * input)
+{
+    input->file = tmpfile();
+
+    return input->file != NULL && fwrite(input->text, 1, input->len, input->file) == input->len
+           && fflush(input->file) == 0;
+}
+
+static void
+run_parse_fd(bench_input_t * input, bench_sample_t * sample, bool count)
+{
+    int const fd = fileno(input->file);
+
+    lseek(fd, 0, SEEK_SET);
+
+    sample_start(sample);
+    epc_parse_session_t session = epc_parse_fd(input->parser, fd, NULL);
+    sample_stop(sample);
+
+    sample_session(sample, &session, count);
+}
+#endif
+
+static bool
+setup_ast_build(bench_input_t * input)
+{
+    input->session = epc_parse_str(input->parser, input->text, NULL);
+
+    return !input->session.result.is_error;
+}
+
+// Builds the AST of a parse made beforehand, so only the build is measured.
+static void
+run_ast_build(bench_input_t * input, bench_sample_t * sample, bool count)
+{
+    epc_cpt_node_t * root = input->session.result.data.success;
+
+    sample_start(sample);
+    epc_ast_result_t result = epc_ast_build(root, input->registry, NULL);
+    sample_stop(sample);
+
+    sample->is_ok = !result.has_error;
+    if (count)
+    {
+        sample->nodes = count_nodes(root);
+    }
+    if (result.ast_root != NULL)
+    {
+        input->free_node(result.ast_root, NULL);
+    }
+}
+
+static char *
+json_records_corpus(double scale)
+{
+    return corpus_json_records((size_t)(4e6 * scale));
+}
+
+static char *
+json_nested_corpus(double scale)
+{
+    return corpus_nested_json(200, (size_t)(200 * scale) + 1);
+}
+
+static char *
+arithmetic_chain_corpus(double scale)
+{
+    return corpus_arithmetic_chain((size_t)(50000 * scale) + 1);
+}
+
+static char *
+comment_runs_corpus(double scale)
+{
+    return corpus_comment_runs((size_t)(4e6 * scale));
+}
+
+static char *
+json_pointer_corpus(double scale)
+{
+    return corpus_json_pointer((size_t)(100000 * scale) + 1);
+}
+
+static variable_t const calc_variables[] = {{.name = "x", .value = 2.3}};
+static variable_t const calc_constants[] = {{.name = "pi", .value = M_PI}, {.name = "e", .value = M_E}};
+
+static epc_parser_t *
+calc_grammar(epc_parser_list * list)
+{
+    return create_formula_grammar(list, 1, calc_variables, 2, calc_constants);
+}
+
+// Words separated by whitespace, C comments and C++ comments.
+static epc_parser_t *
+comment_grammar(epc_parser_list * list)
+{
+    epc_parser_t * gap = epc_many_l(
+        list,
+        "gap",
+        epc_or_l(
+            list,
+            "gap_item",
+            3,
+            epc_plus_l(list, "spaces", epc_space_l(list, "space")),
+            epc_c_comment_l(list, "c_comment"),
+            epc_cpp_comment_l(list, "cpp_comment")
+        )
+    );
+    epc_parser_t * word = epc_plus_l(list, "word", epc_alphanum_l(list, "word_char"));
+    epc_parser_t * words = epc_many_l(list, "words", epc_and_l(list, "spaced_word", 2, word, gap));
+
+    return epc_and_l(list, "document", 3, gap, words, epc_eoi_l(list, "eoi"));
+}
+
+static bench_t const benchmarks[] = {
+    {.name = "parse_str/json_records",
+     .corpus = json_records_corpus,
+     .grammar = create_json_grammar,
+     .run = run_parse_str},
+    {.name = "parse_str/json_nested",
+     .corpus = json_nested_corpus,
+     .grammar = create_json_grammar,
+     .run = run_parse_str},
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    {.name = "parse_fd/json_records",
+     .corpus = json_records_corpus,
+     .grammar = create_json_grammar,
+     .setup = setup_parse_fd,
+     .run = run_parse_fd},
+#endif
+    {.name = "ast_build/json_records",
+     .corpus = json_records_corpus,
+     .grammar = create_json_grammar,
+     .setup = setup_ast_build,
+     .run = run_ast_build,
+     .action_count = JSON_ACTION_MAX,
+     .registry_init = json_ast_hook_registry_init,
+     .free_node = json_node_free},
+    {.name = "parse_str/simple_calc_chain",
+     .corpus = arithmetic_chain_corpus,
+     .grammar = calc_grammar,
+     .run = run_parse_str},
+    {.name = "ast_build/simple_calc_chain",
+     .corpus = arithmetic_chain_corpus,
+     .grammar = calc_grammar,
+     .setup = setup_ast_build,
+     .run = run_ast_build,
+     .action_count = AST_ACTION_MAX,
+     .registry_init = simple_calc_ast_hook_registry_init,
+     .free_node = ast_node_free},
+    {.name = "parse_str/json_pointer",
+     .corpus = json_pointer_corpus,
+     .grammar = create_json_pointer_parser,
+     .run = run_parse_str},
+    {.name = "parse_str/comment_runs",
+     .corpus = comment_runs_corpus,
+     .grammar = comment_grammar,
+     .run = run_parse_str},
+};
+
+static int
+compare_ns(void const * a, void const * b)
+{
+    uint64_t const x = *(uint64_t const *)a;
+    uint64_t const y = *(uint64_t const *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void
+bench_input_release(bench_input_t * input)
+{
+    epc_parse_session_destroy(&input->session);
+    epc_ast_hook_registry_free(input->registry);
+    if (input->file != NULL)
+    {
+        fclose(input->file);
+    }
+    free(input->text);
+}
+
+// Runs `bench` `iterations` times, after a run to warm up the caches and count the nodes. Returns false if the input
+// couldn't be made or didn't parse.
+static bool
+bench_run(bench_t const * bench, size_t iterations, double scale, bench_result_t * result)
+{
+    epc_parser_list * list = epc_parser_list_create();
+    bench_input_t input = {.parser = bench->grammar(list), .text = bench->corpus(scale)};
+    uint64_t * ns = calloc(iterations, sizeof(*ns));
+    bool is_ok = input.parser != NULL && input.text != NULL && ns != NULL;
+
+    if (is_ok)
+    {
+        input.len = strlen(input.text);
+        if (bench->registry_init != NULL)
+        {
+            input.registry = epc_ast_hook_registry_create(bench->action_count);
+            bench->registry_init(input.registry);
+            input.free_node = bench->free_node;
+        }
+        is_ok = bench->setup == NULL || bench->setup(&input);
+    }
+
+    bench_sample_t sample = {0};
+    size_t sample_allocations = 0;
+
+    if (is_ok)
+    {
+        bench->run(&input, &sample, true);
+        is_ok = sample.is_ok;
+        result->nodes = sample.nodes;
+    }
+    for (size_t i = 0; is_ok && i < iterations; i++)
+    {
+        bench->run(&input, &sample, false);
+        is_ok = sample.is_ok;
+        ns[i] = sample.ns;
+        sample_allocations += sample.allocations;
+    }
+
+    if (is_ok)
+    {
+        struct rusage usage;
+
+        qsort(ns, iterations, sizeof(*ns), compare_ns);
+        snprintf(result->name, sizeof(result->name), "%s", bench->name);
+        result->bytes = input.len;
+        result->iterations = iterations;
+        result->min_ns = ns[0];
+        result->median_ns = ns[iterations / 2];
+        result->p99_ns = ns[(iterations * 99 + 99) / 100 - 1];
+        result->mb_per_s = result->median_ns > 0 ? (double)input.len / 1e6 / ((double)result->median_ns / 1e9) : 0;
+        result->ns_per_node = result->nodes > 0 ? (double)result->median_ns / (double)result->nodes : 0;
+        result->allocs_per_byte = counts_allocations && input.len > 0
+                                      ? (double)sample_allocations / (double)iterations / (double)input.len
+                                      : 0;
+        getrusage(RUSAGE_SELF, &usage);
+        result->peak_rss_kb = usage.ru_maxrss;
+    }
+
+    free(ns);
+    bench_input_release(&input);
+    epc_parser_list_free(list);
+
+    return is_ok;
+}
+
+// --- Output ---
+
+static void
+print_results(bench_result_t const * results, size_t count)
+{
+    printf(
+        "%-30s %10s %8s %12s %12s %12s %10s %10s %12s %10s\n",
+        "benchmark",
+        "bytes",
+        "runs",
+        "min ns",
+        "median ns",
+        "p99 ns",
+        "MB/s",
+        "ns/node",
+        "allocs/byte",
+        "RSS KiB"
+    );
+    for (size_t i = 0; i < count; i++)
+    {
+        bench_result_t const * r = &results[i];
+
+        printf(
+            "%-30s %10zu %8zu %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %10.2f %10.2f %12.6f %10ld\n",
+            r->name,
+            r->bytes,
+            r->iterations,
+            r->min_ns,
+            r->median_ns,
+            r->p99_ns,
+            r->mb_per_s,
+            r->ns_per_node,
+            r->allocs_per_byte,
+            r->peak_rss_kb
+        );
+    }
+}
+
+// Writes the results as JSON, which read_baseline() reads back.
+static bool
+write_json(char const * filename, bench_result_t const * results, size_t count, double scale)
+{
+    FILE * fp = fopen(filename, "w");
+    if (fp == NULL)
+    {
+        perror(filename);
+        return false;
+    }
+
+    fprintf(fp, "{\n  \"scale\": %g,\n  \"benchmarks\": [\n", scale);
+    for (size_t i = 0; i < count; i++)
+    {
+        bench_result_t const * r = &results[i];
+
+        fprintf(
+            fp,
+            "    {\"name\": \"%s\", \"bytes\": %zu, \"nodes\": %zu, \"iterations\": %zu, \"min_ns\": %" PRIu64
+            ", \"median_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64
+            ", \"mb_per_s\": %.3f, \"ns_per_node\": %.3f, \"allocs_per_byte\": %.6f, \"peak_rss_kb\": %ld}%s\n",
+            r->name,
+            r->bytes,
+            r->nodes,
+            r->iterations,
+            r->min_ns,
+            r->median_ns,
+            r->p99_ns,
+            r->mb_per_s,
+            r->ns_per_node,
+            r->allocs_per_byte,
+            r->peak_rss_kb,
+            i + 1 < count ? "," : ""
+        );
+    }
+    fprintf(fp, "  ]\n}\n");
+
+    return fclose(fp) == 0;
+}
+
+// --- Comparison ---
+
+// Returns the value of member `key` of a JSON object, or NULL if it has none.
+static json_node_t const *
+json_member_value(json_node_t const * object, char const * key)
+{
+    for (size_t i = 0; i < object->data.list.count; i++)
+    {
+        json_member_t const * member = &object->data.list.items[i]->data.member;
+
+        if (strcmp(member->key, key) == 0)
+        {
+            return member->value;
+        }
+    }
+
+    return NULL;
+}
+
+static bool
+json_number_member(json_node_t const * object, char const * key, double * value)
+{
+    json_node_t const * node = json_member_value(object, key);
+
+    if (node == NULL || node->type != JSON_NODE_NUMBER)
+    {
+        return false;
+    }
+    *value = node->data.number;
+
+    return true;
+}
+
+// Checks that a baseline has the members write_json() writes and compare_results() reads, whatever the layout of the
+// file. Returns a description of the first that is missing, or NULL.
+static char const *
+check_baseline(json_node_t const * root)
+{
+    double value;
+
+    if (root->type != JSON_NODE_OBJECT)
+    {
+        return "it isn't a JSON object";
+    }
+    if (!json_number_member(root, "scale", &value))
+    {
+        return "it has no numeric \"scale\"";
+    }
+
+    json_node_t const * benchmarks = json_member_value(root, "benchmarks");
+
+    if (benchmarks == NULL || benchmarks->type != JSON_NODE_ARRAY)
+    {
+        return "it has no \"benchmarks\" array";
+    }
+    for (size_t i = 0; i < benchmarks->data.list.count; i++)
+    {
+        json_node_t const * benchmark = benchmarks->data.list.items[i];
+        json_node_t const * name = benchmark->type == JSON_NODE_OBJECT ? json_member_value(benchmark, "name") : NULL;
+
+        if (name == NULL || name->type != JSON_NODE_STRING || !json_number_member(benchmark, "mb_per_s", &value)
+            || !json_number_member(benchmark, "allocs_per_byte", &value))
+        {
+            return "a benchmark lacks a string \"name\" or numeric \"mb_per_s\" and \"allocs_per_byte\"";
+        }
+    }
+
+    return NULL;
+}
+
+// Parses a baseline with the json_parser example's grammar, so that any JSON holding the results is read, however it
+// was written or re-serialised. Returns NULL, having said why, if it can't be read or isn't a set of results.
+static json_node_t *
+read_baseline(char const * filename)
+{
+    epc_parser_list * list = epc_parser_list_create();
+    epc_parse_input_t input = {.type = EPC_PARSE_TYPE_FILENAME, .filename = filename};
+    epc_compile_result_t result = epc_parse_and_build_ast(
+        create_json_grammar(list), input, JSON_ACTION_MAX, json_ast_hook_registry_init, NULL, NULL
+    );
+    json_node_t * root = NULL;
+
+    if (!result.success)
+    {
+        fprintf(
+            stderr,
+            "%s: %s\n",
+            filename,
+            result.parse_error_message != NULL ? result.parse_error_message : result.ast_error_message
+        );
+    }
+    else
+    {
+        char const * problem = check_baseline(result.ast);
+
+        if (problem != NULL)
+        {
+            fprintf(stderr, "%s: not a baseline written by --json, as %s\n", filename, problem);
+        }
+        else
+        {
+            root = result.ast;
+            result.ast = NULL;
+        }
+    }
+    epc_compile_result_cleanup(&result, json_node_free, NULL);
+    epc_parser_list_free(list);
+
+    return root;
+}
+
+// Finds benchmark `name` in a baseline that passed check_baseline(), and reads its throughput and allocations.
+static bool
+find_baseline(json_node_t const * root, char const * name, double * mb_per_s, double * allocs_per_byte)
+{
+    json_node_t const * benchmarks = json_member_value(root, "benchmarks");
+
+    for (size_t i = 0; i < benchmarks->data.list.count; i++)
+    {
+        json_node_t const * benchmark = benchmarks->data.list.items[i];
+
+        if (strcmp(json_member_value(benchmark, "name")->data.string, name) == 0)
+        {
+            return json_number_member(benchmark, "mb_per_s", mb_per_s)
+                   && json_number_member(benchmark, "allocs_per_byte", allocs_per_byte);
+        }
+    }
+
+    return false;
+}
+
+// Returns the number of benchmarks that regressed by more than `threshold` percent, or -1 if the baseline can't be
+// read. `missing` is set to the number of benchmarks that aren't in the baseline, and so couldn't be checked.
+static int
+compare_results(
+    char const * filename, bench_result_t const * results, size_t count, double scale, double threshold, int * missing
+)
+{
+    json_node_t * baseline = read_baseline(filename);
+    if (baseline == NULL)
+    {
+        return -1;
+    }
+
+    int regressions = 0;
+    double base_scale = scale;
+
+    *missing = 0;
+    json_number_member(baseline, "scale", &base_scale);
+    printf("\nCompared with %s (threshold %.1f%%):\n", filename, threshold);
+    if (base_scale != scale)
+    {
+        printf("(the baseline was run with --scale=%g, so the inputs differ)\n", base_scale);
+    }
+    printf(
+        "%-30s %12s %12s %9s %14s %14s %9s\n",
+        "benchmark",
+        "base MB/s",
+        "MB/s",
+        "change",
+        "base allocs/B",
+        "allocs/B",
+        "change"
+    );
+    for (size_t i = 0; i < count; i++)
+    {
+        bench_result_t const * r = &results[i];
+        double base_mb_per_s;
+        double base_allocs;
+
+        if (!find_baseline(baseline, r->name, &base_mb_per_s, &base_allocs))
+        {
+            printf(
+                "%-30s %12s %12.2f %9s %14s %14.6f %9s  MISSING\n",
+                r->name,
+                "-",
+                r->mb_per_s,
+                "",
+                "-",
+                r->allocs_per_byte,
+                ""
+            );
+            (*missing)++;
+            continue;
+        }
+
+        double const speed_change = base_mb_per_s > 0 ? 100.0 * (r->mb_per_s - base_mb_per_s) / base_mb_per_s : 0;
+        double const allocs_change = base_allocs > 0 ? 100.0 * (r->allocs_per_byte - base_allocs) / base_allocs : 0;
+        bool const is_regression = speed_change < -threshold || allocs_change > threshold;
+
+        regressions += is_regression;
+        printf(
+            "%-30s %12.2f %12.2f %+8.1f%% %14.6f %14.6f %+8.1f%%  %s\n",
+            r->name,
+            base_mb_per_s,
+            r->mb_per_s,
+            speed_change,
+            base_allocs,
+            r->allocs_per_byte,
+            allocs_change,
+            is_regression ? "REGRESSED" : ""
+        );
+    }
+    json_node_free(baseline, NULL);
+
+    return regressions;
+}
+
+// --- Main ---
+
+static char const *
+option_value(char const * arg, char const * option)
+{
+    size_t const len = strlen(option);
+
+    return strncmp(arg, option, len) == 0 && arg[len] == '=' ? arg + len + 1 : NULL;
+}
+
+int
+main(int argc, char ** argv)
+{
+    char const * filter = "";
+    char const * json_filename = NULL;
+    char const * baseline_filename = NULL;
+    size_t iterations = 10;
+    double scale = 1.0;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        char const * value;
+
+        if ((value = option_value(argv[i], "--filter")) != NULL)
+        {
+            filter = value;
+        }
+        else if ((value = option_value(argv[i], "--iterations")) != NULL)
+        {
+            iterations = strtoul(value, NULL, 10);
+        }
+        else if ((value = option_value(argv[i], "--scale")) != NULL)
+        {
+            scale = strtod(value, NULL);
+        }
+        else if ((value = option_value(argv[i], "--json")) != NULL)
+        {
+            json_filename = value;
+        }
+        else if ((value = option_value(argv[i], "--compare")) != NULL)
+        {
+            baseline_filename = value;
+        }
+        else if ((value = option_value(argv[i], "--threshold")) != NULL)
+        {
+            threshold = strtod(value, NULL);
+        }
+        else
+        {
+            fprintf(
+                stderr,
+                "Usage: %s [--filter=TEXT] [--iterations=N] [--scale=F] [--json=FILE] [--compare=BASELINE] "
+                "[--threshold=PCT]\n",
+                argv[0]
+            );
+            return EXIT_FAILURE;
+        }
+    }
+    if (iterations == 0 || scale <= 0)
+    {
+        fprintf(stderr, "The iterations and scale must be greater than 0\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t const bench_count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    bench_result_t results[sizeof(benchmarks) / sizeof(benchmarks[0])];
+    size_t result_count = 0;
+    int exit_code = EXIT_SUCCESS;
+
+    for (size_t i = 0; i < bench_count; i++)
+    {
+        if (strstr(benchmarks[i].name, filter) == NULL)
+        {
+            continue;
+        }
+        if (!bench_run(&benchmarks[i], iterations, scale, &results[result_count]))
+        {
+            fprintf(stderr, "%s: failed to parse its input\n", benchmarks[i].name);
+            exit_code = EXIT_FAILURE;
+            continue;
+        }
+        result_count++;
+    }
+
+    print_results(results, result_count);
+    if (!counts_allocations)
+    {
+        printf("(allocations aren't counted on this platform)\n");
+    }
+
+    if (json_filename != NULL && !write_json(json_filename, results, result_count, scale))
+    {
+        exit_code = EXIT_FAILURE;
+    }
+    if (baseline_filename != NULL)
+    {
+        int missing = 0;
+        int const regressions = compare_results(baseline_filename, results, result_count, scale, threshold, &missing);
+
+        if (regressions != 0 || missing != 0)
+        {
+            if (regressions > 0)
+            {
+                fprintf(stderr, "%d benchmark(s) regressed by more than %.1f%%\n", regressions, threshold);
+            }
+            if (missing > 0)
+            {
+                fprintf(stderr, "%d benchmark(s) aren't in the baseline, so weren't checked\n", missing);
+            }
+            exit_code = EXIT_FAILURE;
+        }
+    }
+
+    return exit_code;
+}
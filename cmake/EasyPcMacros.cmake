@@ -2,7 +2,7 @@
 
 function(epc_generate_grammar)
     set(options)
-    set(oneValueArgs TARGET GDL_FILE OUTPUT_DIR)
+    set(oneValueArgs TARGET GDL_FILE OUTPUT_DIR EMIT)
     set(multiValueArgs)
     cmake_parse_arguments(EPC_GEN "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
 
@@ -18,6 +18,11 @@ function(epc_generate_grammar)
         set(EPC_GEN_OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/generated")
     endif()
 
+    # The kind of parser to generate: "graph" (the default) or "direct"
+    if(NOT EPC_GEN_EMIT)
+        set(EPC_GEN_EMIT "graph")
+    endif()
+
     file(MAKE_DIRECTORY "${EPC_GEN_OUTPUT_DIR}")
 
     # Get the base name of the GDL file (without extension)
@@ -30,7 +35,7 @@ function(epc_generate_grammar)
     # Add custom command to run gdl_compiler
     add_custom_command(
         OUTPUT "${GENERATED_C}" "${GENERATED_H}" "${GENERATED_ACTIONS_H}"
-        COMMAND gdl_compiler "${EPC_GEN_GDL_FILE}" "--output-dir=${EPC_GEN_OUTPUT_DIR}"
+        COMMAND gdl_compiler "${EPC_GEN_GDL_FILE}" "--output-dir=${EPC_GEN_OUTPUT_DIR}" "--emit=${EPC_GEN_EMIT}"
         DEPENDS "${EPC_GEN_GDL_FILE}" gdl_compiler
         VERBATIM
         COMMENT "Generating parser code for ${GDL_BASE_NAME}.gdl"
@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 // For symbol visibility control
@@ -46,6 +47,7 @@ typedef struct epc_parser_t epc_parser_t;
 typedef struct epc_cpt_node_t epc_cpt_node_t;
 typedef struct epc_parser_ctx_t epc_parser_ctx_t;
 typedef struct epc_parser_list epc_parser_list;
+typedef struct epc_compiled_grammar_t epc_compiled_grammar_t;
 
 // line and column information.
 typedef struct epc_line_col_t
@@ -64,6 +66,7 @@ typedef enum epc_parse_type_t
     EPC_PARSE_TYPE_FILENAME,
 #ifdef WITH_INPUT_STREAM_SUPPORT
     EPC_PARSE_TYPE_FD,
+    EPC_PARSE_TYPE_PUSH, /**< Input is supplied later with `epc_parse_feed()`. */
 #endif
 } epc_parse_type_t;
 
@@ -89,6 +92,32 @@ typedef struct epc_parse_input_t
     };
 } epc_parse_input_t;
 
+/**
+ * @brief Options controlling a single parse session.
+ *
+ * A zero-initialised structure gives the same behaviour as `epc_parse_str()` and friends.
+ */
+typedef struct epc_parse_options_t
+{
+    bool memoize;       /**< @brief Enable packrat mode: cache the result of every parser at every input offset it is
+                         *          tried at, so that backtracking never re-parses the same input with the same parser.
+                         */
+    size_t memo_budget; /**< @brief Upper bound, in bytes, on the memory used by the memo table. When it is full the
+                         *          entries for the lowest input offsets are evicted first. 0 selects a 16 MiB default.
+                         *          It separately bounds the nodes of failed parses that are kept alive because
+                         *          results cached within them refer to them; past it, those results are dropped.
+                         */
+    size_t thread_count; /**< @brief Threads that a parser with a split predicate (see `epc_parser_set_split()`) may
+                          *          parse its input with, counting the caller's. 0 selects one per online processor,
+                          *          and 1 never parses in parallel.
+                          */
+    bool profile; /**< @brief Count what each parser does and the time it takes, for
+                   *          `epc_parse_session_profile_report()`. Profiled parses don't run compiled grammars or split
+                   *          their input, so that every parser is counted. Ignored unless the library is built with
+                   *          `WITH_PARSE_PROFILING`.
+                   */
+} epc_parse_options_t;
+
 // Error Handling struct
 /**
  * @brief Represents a detailed parsing error.
@@ -884,6 +913,59 @@ EASY_PC_API epc_parser_t * epc_or(char const * name, int count, ...);
  */
 EASY_PC_API epc_parser_t * epc_or_l(epc_parser_list * list, char const * name, int count, ...);
 
+/**
+ * @brief Creates a parser that matches the longest of several strings.
+ *
+ * The strings are put in a trie, so the input is only read once however many there are, where an `epc_or()` of
+ * `epc_string()` parsers compares each string in turn. Unlike `epc_or()`, the longest string that matches is chosen
+ * rather than the first: "int" or "integer" matches all of "integer". Use `epc_cpt_node_get_keyword_index()` to find
+ * which of the strings a match is.
+ *
+ * @param name The name of the parser for debugging/CPT.
+ * @param count The number of strings, at most 65535.
+ * @param ... A variable argument list of `char const *` strings. They are copied.
+ * @return A new `parser_t` instance, or NULL on error.
+ */
+EASY_PC_API epc_parser_t * epc_keywords(char const * name, int count, ...);
+
+/**
+ * @brief Creates a parser that matches the longest of several strings and adds it to the list.
+ *        This is a convenience wrapper for `epc_keywords()` that automatically adds the created
+ *        parser to the provided `epc_parser_list`.
+ *
+ * @param list The parser list to add to.
+ * @param name The name of the parser for debugging/CPT.
+ * @param count The number of strings, at most 65535.
+ * @param ... A variable argument list of `char const *` strings. They are copied.
+ * @return A new `parser_t` instance, or NULL on error.
+ */
+EASY_PC_API epc_parser_t * epc_keywords_l(epc_parser_list * list, char const * name, int count, ...);
+
+/**
+ * @brief Creates a parser that matches the longest of an array of strings.
+ *        The same as `epc_keywords()`, for when the number of strings is only known at run time.
+ *
+ * @param name The name of the parser for debugging/CPT.
+ * @param count The number of strings, at most 65535.
+ * @param keywords An array of `count` strings. They are copied.
+ * @return A new `parser_t` instance, or NULL on error.
+ */
+EASY_PC_API epc_parser_t * epc_keywords_array(char const * name, int count, char const * const * keywords);
+
+/**
+ * @brief Creates a parser that matches the longest of an array of strings and adds it to the list.
+ *        This is a convenience wrapper for `epc_keywords_array()` that automatically adds the created
+ *        parser to the provided `epc_parser_list`.
+ *
+ * @param list The parser list to add to.
+ * @param name The name of the parser for debugging/CPT.
+ * @param count The number of strings, at most 65535.
+ * @param keywords An array of `count` strings. They are copied.
+ * @return A new `parser_t` instance, or NULL on error.
+ */
+EASY_PC_API epc_parser_t *
+epc_keywords_array_l(epc_parser_list * list, char const * name, int count, char const * const * keywords);
+
 /**
  * @brief Creates a parser that matches a sequence of parsers in order.
  *
@@ -1243,6 +1325,10 @@ epc_parser_fwd_decl_l(epc_parser_list * list, char const * name)
  * useful for forward declarations where a placeholder parser needs to be
  * filled in later with the definition of another parser.
  *
+ * The grammars that reach `dst` are prepared for parsing again when they are next parsed. Other grammars are left
+ * alone, so a grammar may be built while unrelated ones are parsed on other threads; `dst` itself must not be
+ * redefined while a grammar that reaches it is being parsed.
+ *
  * @param dst A pointer to the destination `parser_t` to be filled.
  * @param src A pointer to the source `parser_t` whose contents will be copied.
  */
@@ -1261,6 +1347,82 @@ EASY_PC_API void epc_parser_duplicate(epc_parser_t * dst, epc_parser_t const * s
  */
 EASY_PC_API void epc_parser_set_ast_action(epc_parser_t * p, int action_type);
 
+/**
+ * @brief Enables or disables memoization of a single parser.
+ *
+ * A memoized parser caches its result for each input offset it is tried at, and returns the cached result
+ * (sharing the CPT subtree) if it is tried at that offset again. This is useful for rules that several `epc_or`
+ * alternatives start with. Use `epc_parse_options_t.memoize` to memoize every parser in a grammar instead.
+ * Memoization assumes the parser's result depends only on its input, so it should not be used with `epc_wrap()` or
+ * `epc_satisfy()` callbacks that depend on other state.
+ *
+ * @param p A pointer to the `parser_t` to configure.
+ * @param memoize true to cache the parser's results.
+ */
+EASY_PC_API void epc_parser_set_memoize(epc_parser_t * p, bool memoize);
+
+/**
+ * @brief Decides whether a record may start at `offset` in the input of a parser set up with `epc_parser_set_split()`.
+ *
+ * It is only asked about offsets where the input has a byte that a record could start with, so a predicate for
+ * line-oriented records need only check that `offset` is just after a newline. It is called on the parsing thread
+ * while the parse is running.
+ *
+ * @param input The whole input.
+ * @param input_len The length of the input.
+ * @param offset The offset in question, greater than 0 and less than `input_len`.
+ * @param user_data The pointer given to `epc_parser_set_split()`.
+ * @return true if a record may start at `offset`.
+ */
+typedef bool (*epc_split_fn)(char const * input, size_t input_len, size_t offset, void * user_data);
+
+/**
+ * @brief Lets an `epc_many()` or `epc_delimited()` parser of records parse long input in chunks on several threads.
+ *
+ * When the parser is tried on a long enough input (at least 64 KiB per chunk), the input after it is divided into a
+ * chunk per thread (see `epc_parse_options_t.thread_count`). Each chunk but the first starts at the first offset after
+ * an equal share of the input where `split` says a record may start, and the chunks are parsed at the same time, each
+ * in a context of its own. Their CPTs are then joined, in order, under the parser's node, which is the same as a
+ * sequential parse would give.
+ *
+ * A split is only kept if it proves to be at a record boundary: the records of the chunk before it must end exactly
+ * there (after a delimiter, for `epc_delimited()`). Otherwise, or if any chunk fails to parse, the work is thrown
+ * away and the input is parsed sequentially, so a predicate that is sometimes wrong only costs time. This relies on
+ * records parsing the same way wherever parsing starts, so it isn't suited to records that depend on `epc_wrap()` or
+ * `epc_satisfy()` callbacks with state of their own. Those callbacks are called from several threads at once.
+ *
+ * Input that is streamed, parses that build an AST as they go (`epc_parse_to_ast()`) and parsers that repeat a single
+ * character are always parsed sequentially.
+ *
+ * In GDL, `split(Records, split_fn, split_data)` sets the predicate of a repetition or `delimited()` call.
+ *
+ * @param p An `epc_many()` or `epc_delimited()` parser. Other parsers ignore the setting.
+ * @param split The predicate, or NULL to always parse sequentially.
+ * @param user_data Passed to `split`.
+ * @return `p`, so that the call can be used where the parser is.
+ */
+EASY_PC_API epc_parser_t * epc_parser_set_split(epc_parser_t * p, epc_split_fn split, void * user_data);
+
+/**
+ * @brief A split predicate for records that start at the beginning of a line.
+ *
+ * Use it with `epc_parser_set_split()`. It ignores `user_data`.
+ */
+EASY_PC_API bool epc_split_at_line_start(char const * input, size_t input_len, size_t offset, void * user_data);
+
+/**
+ * @brief Makes a parser produce a single CPT node without children, however it matches.
+ *
+ * A token parser's node has the `content`, `len`, tag, name and semantic offsets its subtree would have had at the
+ * root, so `epc_cpt_node_get_semantic_content()` and the AST action work as before, but the nodes beneath it are
+ * reclaimed as soon as it matches. This is meant for lexical rules such as identifiers, numbers and strings, whose
+ * per-character nodes are rarely looked at and make up most of a CPT.
+ *
+ * @param p A pointer to the `parser_t` to configure.
+ * @param is_token true to collapse the parser's subtree into one node.
+ */
+EASY_PC_API void epc_parser_set_token(epc_parser_t * p, bool is_token);
+
 /**
  * @brief Retrieves the user-defined context pointer from the parser context.
  *        This is the pointer passed in when initiating a parse session (e.g., via `epc_parse_str()`, `epc_parse_fp()`, etc.) and is accessible within parser callbacks (e.g. epc_wrap callbacks). 
@@ -1292,6 +1454,9 @@ EASY_PC_API epc_parse_session_t epc_parse_str(epc_parser_t * top_parser, char co
  * stream instead of a string. It attempts to match the `top_parser` against
  * the content of the file.
  *
+ * A regular file is mapped into memory rather than read, so it isn't copied. It must not be truncated while the
+ * session exists.
+ *
  * @param top_parser The starting parser for the grammar (e.g., the root rule).
  * @param fp A pointer to an open `FILE` stream to be parsed.
  * @param user_ctx A user-defined context pointer that will be passed to the internal parser context. The lifetime of this pointer must exceed that of the parse session.
@@ -1331,8 +1496,183 @@ EASY_PC_API epc_parse_session_t epc_parse_file(epc_parser_t * top_parser, char c
  * @return An `easy_pc_parse_session_t` structure.
  */
 EASY_PC_API epc_parse_session_t epc_parse_fd(epc_parser_t * top_parser, int fd, void * user_ctx);
+
+/**
+ * @brief The state of a parse whose input is pushed to it with `epc_parse_feed()`.
+ */
+typedef enum epc_parse_status_t
+{
+    EPC_PARSE_STATUS_NEED_INPUT, /**< The parser has used all the input given so far, and needs more to continue. */
+    EPC_PARSE_STATUS_DONE,       /**< The parse has finished, and the session's `result` is set. */
+} epc_parse_status_t;
+
+/**
+ * @brief Starts a parse whose input is pushed to it a piece at a time, e.g. as it arrives on a non-blocking socket.
+ *
+ * No thread is used. Each call to `epc_parse_feed()` runs the parser on the calling thread until it has used all the
+ * input given so far, and `epc_parse_finish()` marks the end of the input. Parsing with `epc_parse_with_options()` or
+ * `epc_parse_compiled()` with input of type `EPC_PARSE_TYPE_PUSH` is equivalent.
+ *
+ * Input is copied into the session, as parse tree nodes point into it.
+ *
+ * @param top_parser The starting parser for the grammar.
+ * @param user_ctx A user-defined context pointer that will be passed to the internal parser context. The lifetime of this pointer must exceed that of the parse session.
+ * @return An `epc_parse_session_t` structure whose `result` is set once the parse is done. If the session could not
+ *         be created, `result` holds the error and `internal_parse_ctx` is NULL.
+ *         This session MUST be destroyed with `epc_parse_session_destroy`, which may be done before the parse is
+ *         done.
+ */
+EASY_PC_API epc_parse_session_t epc_parse_start(epc_parser_t * top_parser, void * user_ctx);
+
+/**
+ * @brief Gives more input to a parse started with `epc_parse_start()`, and continues the parse with it.
+ *
+ * @param session The parse session.
+ * @param data The input. It is copied, so it needn't outlive the call.
+ * @param len The number of bytes in `data`.
+ * @return `EPC_PARSE_STATUS_DONE` if the parse has finished (which may be before all the input is used, in which case
+ *         the rest is ignored), or `EPC_PARSE_STATUS_NEED_INPUT` if it needs more input to finish.
+ */
+EASY_PC_API epc_parse_status_t epc_parse_feed(epc_parse_session_t * session, char const * data, size_t len);
+
+/**
+ * @brief Tells a parse started with `epc_parse_start()` that there is no more input, and finishes the parse.
+ *
+ * @param session The parse session.
+ * @return `EPC_PARSE_STATUS_DONE`, after which the session's `result` is set.
+ */
+EASY_PC_API epc_parse_status_t epc_parse_finish(epc_parse_session_t * session);
 #endif
 
+/**
+ * @brief Initiates a parsing operation with explicit session options.
+ *
+ * @param top_parser The starting parser for the grammar.
+ * @param input The input to parse.
+ * @param user_ctx A user-defined context pointer that will be passed to the internal parser context. The lifetime of this pointer must exceed that of the parse session.
+ * @param options Options for this session (e.g. packrat memoization), or NULL for the defaults.
+ * @return An `easy_pc_parse_session_t` structure.
+ *         This session MUST be destroyed with `easy_pc_parse_session_destroy`.
+ */
+EASY_PC_API epc_parse_session_t epc_parse_with_options(
+    epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx, epc_parse_options_t const * options
+);
+
+/**
+ * @brief Options for `epc_parse_batch()`.
+ */
+typedef struct epc_parse_batch_options_t
+{
+    size_t thread_count; /**< @brief Number of threads to parse with, counting the caller's, or 0 for one per online
+                            processor. No more threads are used than there are inputs. */
+    epc_parse_options_t const * parse_options; /**< @brief Options for every parse, or NULL for the defaults. */
+    void * user_ctx; /**< @brief User context for every parse. It is used from several threads at once. */
+
+    /**
+     * @brief If set, called with each result instead of storing it, and the `sessions` array may be NULL.
+     *
+     * Each thread then parses into a session of its own, which is reused (see `epc_parse_session_reset()`) for the
+     * next input, so the session passed is only valid during the call. It is called on the worker threads,
+     * concurrently, and in no particular order.
+     *
+     * @param index The index of the input in `inputs`.
+     * @param session The session holding the result of parsing the input.
+     * @param user_data `on_result_data`.
+     */
+    void (*on_result)(size_t index, epc_parse_session_t * session, void * user_data);
+    void * on_result_data; /**< @brief Passed to `on_result`. */
+} epc_parse_batch_options_t;
+
+/**
+ * @brief Parses many independent inputs with the same grammar, spread across a pool of threads.
+ *
+ * Each thread starts with an equal share of the inputs, and a thread that runs out takes half of what is left of
+ * another's share, so inputs of very different sizes still keep every thread busy. The calling thread is one of the
+ * threads, and if the others can't be started it parses everything itself.
+ *
+ * The parsers are shared by the threads, and every parse has a context of its own. The grammar is finalized before
+ * the threads start. Finalizing publishes what it works out about each parser whole, and never changes it in place,
+ * so the workers only read the grammar. Other grammars may be built, redefined and parsed with on any thread while
+ * the batch runs, even ones that share parsers with this grammar. The parsers reachable from `top_parser` must not
+ * be changed (e.g. with `epc_parser_duplicate()` or `epc_parser_set_token()`) until this returns. Predicates and
+ * other callbacks in the grammar are called from several threads at once.
+ *
+ * @param top_parser The starting parser for the grammar.
+ * @param inputs The inputs to parse, of any type other than `EPC_PARSE_TYPE_PUSH`.
+ * @param count The number of inputs.
+ * @param sessions An array of `count` sessions that receives the result of each input, in the same order. Each must be
+ *                 destroyed with `epc_parse_session_destroy()`. May be NULL if `options->on_result` is set.
+ * @param options Options for the batch, or NULL for the defaults.
+ */
+EASY_PC_API void epc_parse_batch(
+    epc_parser_t * top_parser,
+    epc_parse_input_t const inputs[],
+    size_t count,
+    epc_parse_session_t sessions[],
+    epc_parse_batch_options_t const * options
+);
+
+/**
+ * @brief Compiles a grammar to a program for the parsing virtual machine.
+ *
+ * The combinators (`epc_and`, `epc_or`, `epc_many`, `epc_plus`, `epc_optional`, `epc_count`, `epc_lookahead` and
+ * `epc_not`) and the single character and string parsers are lowered to a flat instruction stream, which is run by a
+ * loop rather than by recursive calls through each parser. Other parsers, and parsers with memoization enabled, are
+ * run by their usual parse functions from within the program.
+ *
+ * Parsing with the compiled grammar gives the same CPT, or the same error, as parsing with `top_parser`. The parsers
+ * of the grammar must outlive the compiled grammar. If a parser reachable from `top_parser` is redefined with
+ * `epc_parser_duplicate()` after the grammar was compiled, `epc_parse_compiled()` falls back to parsing with
+ * `top_parser`.
+ *
+ * @param top_parser The starting parser for the grammar. Forward declarations must already be defined.
+ * @return The compiled grammar, to be freed with `epc_compiled_grammar_free()`, or NULL if the grammar contains an
+ *         undefined forward declaration or memory ran out.
+ */
+EASY_PC_API epc_compiled_grammar_t * epc_grammar_compile(epc_parser_t * top_parser);
+
+/**
+ * @brief Frees a grammar returned by `epc_grammar_compile()`. The parsers it was compiled from are not affected.
+ */
+EASY_PC_API void epc_compiled_grammar_free(epc_compiled_grammar_t * grammar);
+
+/**
+ * @brief Initiates a parsing operation with a compiled grammar.
+ *
+ * Behaves as `epc_parse_with_options()` with the grammar's top parser. With `options->memoize` set the grammar is
+ * run by the parse functions, as the packrat cache is kept by them.
+ *
+ * @param grammar A grammar returned by `epc_grammar_compile()`.
+ * @param input The input to parse.
+ * @param user_ctx A user-defined context pointer that will be passed to the internal parser context.
+ * @param options Options for this session, or NULL for the defaults.
+ * @return An `easy_pc_parse_session_t` structure.
+ *         This session MUST be destroyed with `easy_pc_parse_session_destroy`.
+ */
+EASY_PC_API epc_parse_session_t epc_parse_compiled(
+    epc_compiled_grammar_t const * grammar, epc_parse_input_t input, void * user_ctx, epc_parse_options_t const * options
+);
+
+/**
+ * @brief Parses another input string with the grammar, user context and options of an existing session.
+ *
+ * The session keeps the memory it used for its previous input (the input buffer, the CPT arena, the error records and
+ * their strings, and the line index) and parses the new input with it, so once the session has seen an input at
+ * least as long and a tree at least as big, and has reported errors with strings at least as long, parsing makes no
+ * system calls and no allocations, whether it succeeds or fails. This suits parsing many small inputs, such as
+ * messages or commands, one after another. A session that memoizes allocates its memo table again for each input.
+ *
+ * The previous result, and everything in it, is freed first. Only a session that parsed a string (with
+ * `epc_parse_str()`, or `EPC_PARSE_TYPE_STRING` input) can be reset.
+ *
+ * @param session The session to reuse.
+ * @param input_string The new input. It is copied, so it needn't outlive the call.
+ * @return true if the new input was parsed, in which case the session's `result` is that of the parse, which may be an
+ *         error. false if the session can't be reset, in which case `result` holds the reason. Either way, the
+ *         session must still be destroyed with `epc_parse_session_destroy`.
+ */
+EASY_PC_API bool epc_parse_session_reset(epc_parse_session_t * session, char const * input_string);
+
 /**
  * @brief Destroys an `easy_pc_parse_session_t` and frees all associated resources.
  *
@@ -1347,6 +1687,139 @@ EASY_PC_API void epc_parse_session_destroy(epc_parse_session_t * session);
 EASY_PC_API
 void epc_parse_session_print_cpt(FILE * fp, epc_parse_session_t const * session);
 
+/**
+ * @brief What a parser did in a profiled parse (see `epc_parse_options_t.profile`).
+ */
+typedef struct epc_parser_profile_t
+{
+    char const * name;          /**< @brief The parser's name, or its type if it has none. Owned by the parser. */
+    uint64_t invocations;       /**< @brief The times it was tried, including those answered from the memo table. */
+    uint64_t successes;         /**< @brief The times it matched. */
+    uint64_t failures;          /**< @brief The times it didn't. */
+    uint64_t bytes_consumed;    /**< @brief The total length of its matches. */
+    uint64_t backtracked_bytes; /**< @brief The input its children had matched when it failed, which has to be parsed
+                                 *          again by whatever is tried next. Large counts are where backtracking costs.
+                                 */
+    uint64_t inclusive_ns;      /**< @brief Time spent in it and the parsers it ran. A parser that runs itself,
+                                 *          directly or not, only counts the outermost run.
+                                 */
+    uint64_t exclusive_ns;      /**< @brief Time spent in it but not in the parsers it ran. */
+} epc_parser_profile_t;
+
+/**
+ * @brief Orders for `epc_parse_session_profile_report()`, each largest first.
+ */
+typedef enum epc_profile_order_t
+{
+    EPC_PROFILE_BY_EXCLUSIVE_TIME,
+    EPC_PROFILE_BY_INCLUSIVE_TIME,
+    EPC_PROFILE_BY_INVOCATIONS,
+    EPC_PROFILE_BY_BACKTRACKED_BYTES,
+} epc_profile_order_t;
+
+/**
+ * @brief Reports the parsers of a profiled parse that did the most, by a given measure.
+ *
+ * Times are measured with `CLOCK_MONOTONIC` around every parser, so they include the cost of measuring them, which
+ * is largest in parsers that do little each time.
+ *
+ * @param session A session parsed with `epc_parse_options_t.profile` set.
+ * @param order What the parsers are ranked by.
+ * @param n The most parsers to report.
+ * @param top Filled with the top `n` parsers, in order. May be NULL.
+ * @param fp The top `n` parsers are printed to it as a table if it isn't NULL.
+ * @return The number of parsers reported, which is 0 if the session wasn't profiled.
+ */
+EASY_PC_API size_t epc_parse_session_profile_report(
+    epc_parse_session_t const * session, epc_profile_order_t order, size_t n, epc_parser_profile_t top[], FILE * fp
+);
+
+/**
+ * @brief The problems `epc_grammar_analyze()` looks for.
+ */
+typedef enum epc_grammar_issue_kind_t
+{
+    EPC_GRAMMAR_LEFT_RECURSION,       /**< @brief A left-recursive cycle is entered at the parser. This isn't an error:
+                                       *          its matches are grown from a seed.
+                                       */
+    EPC_GRAMMAR_UNBOUNDED_RECURSION,  /**< @brief A left-recursive cycle passes through an `epc_wrap()`, so isn't
+                                       *          seen when parsing, and recurses until the stack runs out.
+                                       */
+    EPC_GRAMMAR_NULLABLE_REPETITION,  /**< @brief A repetition (`epc_many()`, `epc_plus()`, `epc_skip()`,
+                                       *          `epc_delimited()`, ...) of a parser that can match without consuming
+                                       *          anything, which fails wherever it does.
+                                       */
+    EPC_GRAMMAR_SHADOWED_ALTERNATIVE, /**< @brief An `epc_or()` alternative that is never tried where it could match,
+                                       *          as an earlier one always matches there, e.g. "int" before "integer".
+                                       */
+    EPC_GRAMMAR_UNDEFINED_PARSER,     /**< @brief A forward declaration that was never defined. */
+} epc_grammar_issue_kind_t;
+
+/**
+ * @brief A problem found by `epc_grammar_analyze()`.
+ */
+typedef struct epc_grammar_issue_t
+{
+    epc_grammar_issue_kind_t kind;
+    epc_parser_t const * parser; /**< @brief The parser with the problem; the `epc_or()` for a shadowed alternative. */
+    char const * name;           /**< @brief The parser's name, or its type if it has none. Owned by the parser. */
+    int alternative;             /**< @brief For a shadowed alternative, its index, from 0. Otherwise -1. */
+    int shadowed_by;             /**< @brief For a shadowed alternative, the index of the one that matches first. */
+} epc_grammar_issue_t;
+
+/**
+ * @brief What `epc_grammar_analyze()` found a parser may match. Byte `c` is in a set if bit `c % 64` of word `c / 64`
+ * is set. The sets may be larger than strictly needed, e.g. for `epc_double()`, whose first byte may be anything.
+ */
+typedef struct epc_grammar_sets_t
+{
+    bool nullable;       /**< @brief It may match without consuming anything. */
+    uint64_t first[4];   /**< @brief The bytes a match that consumes something may begin with. */
+    uint64_t follow[4];  /**< @brief The bytes that may come after a match. */
+    bool may_end_input;  /**< @brief A match may be followed by the end of the input. */
+} epc_grammar_sets_t;
+
+typedef struct epc_grammar_analysis_t epc_grammar_analysis_t;
+
+/**
+ * @brief Analyses a grammar without parsing anything.
+ *
+ * Computes which parsers may match without consuming anything and the FIRST and FOLLOW sets of every parser reachable
+ * from `top_parser`, and reports left recursion, repetitions of parsers that can match nothing, `epc_or()`
+ * alternatives that an earlier one always matches before, and forward declarations that were never defined.
+ *
+ * @param top_parser The parser the grammar is parsed with.
+ * @return The analysis, to be freed with `epc_grammar_analysis_free()`, or NULL if memory ran out.
+ */
+EASY_PC_API epc_grammar_analysis_t * epc_grammar_analyze(epc_parser_t * top_parser);
+
+/**
+ * @brief Returns the problems found by `epc_grammar_analyze()`.
+ * @param issues Set to the problems, in the order they were found. Owned by the analysis.
+ * @return The number of problems.
+ */
+EASY_PC_API size_t
+epc_grammar_analysis_get_issues(epc_grammar_analysis_t const * analysis, epc_grammar_issue_t const ** issues);
+
+/**
+ * @brief Gets the sets `epc_grammar_analyze()` found for a parser.
+ * @return false if the parser isn't part of the analysed grammar.
+ */
+EASY_PC_API bool epc_grammar_analysis_get_sets(
+    epc_grammar_analysis_t const * analysis, epc_parser_t const * parser, epc_grammar_sets_t * sets
+);
+
+/**
+ * @brief Prints the sets of each named parser, followed by the problems found.
+ * @return The number of problems.
+ */
+EASY_PC_API size_t epc_grammar_analysis_print(epc_grammar_analysis_t const * analysis, FILE * fp);
+
+/**
+ * @brief Frees an analysis returned by `epc_grammar_analyze()`. The parsers analysed are not affected.
+ */
+EASY_PC_API void epc_grammar_analysis_free(epc_grammar_analysis_t * analysis);
+
 /**
  * @brief Retrieves the semantically relevant content from a CPT node.
  *
@@ -1395,6 +1868,58 @@ EASY_PC_API const char * epc_cpt_node_get_content(epc_cpt_node_t * node);
  */
 EASY_PC_API size_t epc_cpt_node_get_len(epc_cpt_node_t * node);
 
+/**
+ * @brief Retrieves which of the strings of an `epc_keywords()` parser a CPT node matched.
+ *
+ * @param node A pointer to the `epc_cpt_node_t`.
+ * @return The index of the string in the list the parser was created with, or -1 if the node wasn't made by an
+ *         `epc_keywords()` parser.
+ */
+EASY_PC_API int epc_cpt_node_get_keyword_index(epc_cpt_node_t const * node);
+
+/**
+ * @brief Converts an input offset to a line and column.
+ *
+ * The positions are the same as those reported in `epc_parser_error_t::position`. The first lookup indexes the
+ * newlines in the input, after which each lookup is a binary search, so this is cheap enough to call for every
+ * node when producing diagnostics. Streamed input is indexed as far as the data received so far.
+ *
+ * @param ctx The parser context of the parse session (e.g. `session.internal_parse_ctx`).
+ * @param offset The offset from the start of the input.
+ * @return The 0-indexed line and column, or {0, 0} if `offset` is past the end of the input. The end itself has a
+ *         position, that of where more input would go.
+ */
+EASY_PC_API epc_line_col_t epc_parse_ctx_get_line_col(epc_parser_ctx_t * ctx, size_t offset);
+
+/**
+ * @brief Releases the memory holding the input before an offset.
+ *
+ * Streamed input (see `epc_parse_fd()`) is kept in memory for the whole parse, as parse tree nodes point into it.
+ * When a long stream is parsed a piece at a time (e.g. a record handled by an `epc_wrap()` callback), calling this
+ * once a piece is done stops the input buffer growing with the size of the input.
+ *
+ * It releases only the input. The CPT nodes of finished pieces stay in the session's arena until the session is
+ * destroyed, and with a node per character they take far more memory than the input did. Making the piece's parser
+ * a token (see `epc_parser_set_token()`) leaves one node per piece, so memory use still grows with the number of
+ * pieces, but by that node rather than by the piece's size.
+ *
+ * Afterwards the parse must not backtrack before `offset`, and the content of nodes before `offset` must not be
+ * accessed. Line and column numbers of the released input remain available. Only whole pages are released.
+ *
+ * @param ctx The parser context, as passed to parser callbacks.
+ * @param offset The offset from the start of the input before which the input is no longer needed.
+ */
+EASY_PC_API void epc_parse_ctx_discard_input(epc_parser_ctx_t * ctx, size_t offset);
+
+/**
+ * @brief Returns the line and column of the start of a CPT node's content.
+ *
+ * @param ctx The parser context of the parse session that produced the node.
+ * @param node A pointer to the `epc_cpt_node_t`.
+ * @return The 0-indexed line and column, as for `epc_parse_ctx_get_line_col()`.
+ */
+EASY_PC_API epc_line_col_t epc_cpt_node_get_line_col(epc_parser_ctx_t * ctx, epc_cpt_node_t const * node);
+
 /**
  * @brief Prints a Concrete Parse Tree (CPT) to a dynamically allocated string.
  *
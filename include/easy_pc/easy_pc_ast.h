@@ -195,6 +195,40 @@ EASY_PC_API epc_compile_result_t epc_parse_and_build_ast(
     void * ast_user_data
 );
 
+/**
+ * @brief Parses an input and builds an AST as epc_parse_and_build_ast() does, but runs the AST actions during the
+ *        parse rather than on a complete parse tree.
+ *
+ * The actions for a node run as soon as the parser that produced it matches, after those of its children. Once they
+ * have run, the CPT below the node is discarded, so the memory used peaks at the size of the AST rather than that of
+ * the CPT and the AST together. This changes what the callbacks see:
+ * - Actions also run for matches within alternatives that are later abandoned. The AST nodes pushed for those are
+ *   freed with the `free_node` callback when the parser backtracks, and an error set with epc_ast_builder_set_error()
+ *   within them is forgotten.
+ * - The `enter_node` callback for a node is called just before its action, once its children are built.
+ * - CPT nodes have no children by the time they are passed to callbacks, including the predicates of epc_satisfy()
+ *   and the callbacks of epc_wrap().
+ * - Results aren't memoized, whatever epc_parser_set_memoize() says.
+ *
+ * Pushed input (`EPC_PARSE_TYPE_PUSH`) isn't supported, as its parse continues after this function would return.
+ *
+ * @param parser The top-level parser to use.
+ * @param input The input (string or file) to parse.
+ * @param ast_action_count The number of AST actions (max index + 1).
+ * @param registry_init_cb A callback function to initialize the hook registry.
+ * @param parse_user_data Optional user data to be assigned to the parse context.
+ * @param ast_user_data Optional user data to be passed to all AST callbacks.
+ * @return An 'epc_compile_result_t' struct containing the result, to be freed with epc_compile_result_cleanup().
+ */
+EASY_PC_API epc_compile_result_t epc_parse_to_ast(
+    epc_parser_t * parser,
+    epc_parse_input_t input,
+    int ast_action_count,
+    epc_ast_registry_init_cb registry_init_cb,
+    void * parse_user_data,
+    void * ast_user_data
+);
+
 /**
  * @brief Frees the resources held by an epc_compile_result_t.
  *
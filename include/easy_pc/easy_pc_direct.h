@@ -0,0 +1,229 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file easy_pc_direct.h
+ * @brief Runtime support for parsers generated by `gdl_compiler --emit=direct`.
+ *
+ * A direct parser is a set of C functions, one per grammar rule, that match the input without going through the
+ * parser graph. The nodes they create belong to the parsers of the graph that the generated code also builds (the
+ * "sites" of the parser), so the CPT is the same as the one the graph would produce. Constructs that have no direct
+ * form are run by calling out to the graph parser at their site.
+ *
+ * Matching functions share one convention: on success a function has pushed exactly one node and advanced `*pos`
+ * past the input it matched; on failure it leaves both the node stack and `*pos` as they were, and has reported its
+ * error with one of the functions below, so that errors are those the graph would report.
+ */
+
+/**
+ * @brief The state of a running direct parser. Only the input fields may be used by generated code.
+ */
+typedef struct epc_direct_t
+{
+    char const * input; /**< @brief The start of the input. */
+    size_t input_len;   /**< @brief The amount of input known to be available. */
+    bool is_streaming;  /**< @brief More input may become available than `input_len`. */
+} epc_direct_t;
+
+/**
+ * @brief A generated matching function. See the file documentation for its contract.
+ */
+typedef bool (*epc_direct_fn)(epc_direct_t * d, size_t * pos);
+
+/**
+ * @brief Waits until `count` bytes are available at `pos` of a streamed input.
+ * @return false if the input ends first.
+ */
+EASY_PC_API bool epc_direct_wait_for_input(epc_direct_t * d, size_t pos, size_t count);
+
+/**
+ * @brief Returns true if `count` bytes of input are available at `pos`.
+ */
+static inline bool
+epc_direct_has_input(epc_direct_t * d, size_t pos, size_t count)
+{
+    return pos + count <= d->input_len || (d->is_streaming && epc_direct_wait_for_input(d, pos, count));
+}
+
+/**
+ * @brief Reports that the parser at `site` failed at `pos` without running any of its children, as terminals and the
+ * end of input check of combinators do.
+ * @return false, so that a failing match can return it.
+ */
+EASY_PC_API bool epc_direct_fail(epc_direct_t * d, size_t site, size_t pos);
+
+/**
+ * @brief Pushes a node without children for the parser at `site`, covering `len` bytes at `*pos`, and advances
+ * `*pos` past them.
+ * @return false if memory ran out.
+ */
+EASY_PC_API bool epc_direct_token(epc_direct_t * d, size_t site, size_t * pos, size_t len);
+
+/**
+ * @brief Returned by `epc_direct_mark()` if memory ran out.
+ */
+#define EPC_DIRECT_NO_MARK SIZE_MAX
+
+/**
+ * @brief Records the state of the node stack, for a later `epc_direct_close()` or `epc_direct_reset()`.
+ *
+ * Every mark must be passed to exactly one of those functions, in the reverse order to which marks were taken.
+ * @return The mark, or `EPC_DIRECT_NO_MARK` if memory ran out.
+ */
+EASY_PC_API size_t epc_direct_mark(epc_direct_t * d);
+
+/**
+ * @brief Replaces the nodes pushed since `mark` with a node for the parser at `site` that has them as its children
+ * and covers the input from `start` to `*pos`.
+ * @return false if memory ran out, in which case the nodes are discarded and `*pos` is set back to `start`.
+ */
+EASY_PC_API bool epc_direct_close(epc_direct_t * d, size_t mark, size_t site, size_t start, size_t * pos);
+
+/**
+ * @brief Discards the nodes pushed since `mark`.
+ */
+EASY_PC_API void epc_direct_reset(epc_direct_t * d, size_t mark);
+
+/**
+ * @brief Replaces the top node with a node for the parser at `site` that has it as its only child.
+ * @return false if memory ran out, in which case the top node is discarded and `*pos` is moved back over its input.
+ */
+EASY_PC_API bool epc_direct_wrap(epc_direct_t * d, size_t site, size_t * pos);
+
+/**
+ * @brief Runs the graph parser at `site` with its parse function, and pushes the node it returns.
+ */
+EASY_PC_API bool epc_direct_callout(epc_direct_t * d, size_t site, size_t * pos);
+
+/**
+ * @brief Saves the furthest error, for a combinator that puts it back once its child has matched.
+ *
+ * Every saved error must be passed to exactly one of the functions below that take it, in the reverse order to which
+ * errors were saved.
+ * @return The saved error, or `EPC_DIRECT_NO_MARK` if memory ran out.
+ */
+EASY_PC_API size_t epc_direct_save_error(epc_direct_t * d);
+
+/**
+ * @brief Makes `saved` the furthest error again, once the child of an or, optional or lookahead has matched.
+ */
+EASY_PC_API void epc_direct_restore_error(epc_direct_t * d, size_t saved);
+
+/**
+ * @brief Discards `saved`, leaving the furthest error as the failed child of an optional left it.
+ */
+EASY_PC_API void epc_direct_keep_error(epc_direct_t * d, size_t saved);
+
+/**
+ * @brief Discards `saved` and reports that none of the alternatives of the or at `site` matched at `pos`.
+ * @return false.
+ */
+EASY_PC_API bool epc_direct_no_alternative(epc_direct_t * d, size_t saved, size_t site, size_t pos);
+
+/**
+ * @brief Reports the failure of the child of a lookahead as its own, and makes `saved` the furthest error again.
+ * @return false.
+ */
+EASY_PC_API bool epc_direct_lookahead_failed(epc_direct_t * d, size_t saved);
+
+/**
+ * @brief Makes `saved` the furthest error again, and reports that the child of the not at `site`, whose node is on top
+ * of the stack, matched at `pos`.
+ */
+EASY_PC_API void epc_direct_unexpected_match(epc_direct_t * d, size_t saved, size_t site, size_t pos);
+
+/**
+ * @brief Reports that the child of a count failed at `pos` after `matched` matches.
+ */
+EASY_PC_API void epc_direct_count_failed(epc_direct_t * d, size_t pos, size_t matched);
+
+/**
+ * @brief Reports that the child of a repetition matched nothing at `pos`, so it would repeat forever.
+ */
+EASY_PC_API void epc_direct_no_progress(epc_direct_t * d, size_t pos);
+
+/**
+ * @brief Matches the character `c`.
+ */
+static inline bool
+epc_direct_char(epc_direct_t * d, size_t site, size_t * pos, char c)
+{
+    return epc_direct_has_input(d, *pos, 1) && d->input[*pos] == c ? epc_direct_token(d, site, pos, 1)
+                                                                    : epc_direct_fail(d, site, *pos);
+}
+
+/**
+ * @brief Matches the `len` bytes of `s`.
+ */
+static inline bool
+epc_direct_string(epc_direct_t * d, size_t site, size_t * pos, char const * s, size_t len)
+{
+    return epc_direct_has_input(d, *pos, len) && memcmp(d->input + *pos, s, len) == 0
+               ? epc_direct_token(d, site, pos, len)
+               : epc_direct_fail(d, site, *pos);
+}
+
+/**
+ * @brief Returns the `index`th child of a combinator, in the order its parse function runs them.
+ *
+ * Generated code uses this to find the parsers at its sites.
+ * @return The child, or NULL if the parser doesn't have that many children.
+ */
+EASY_PC_API epc_parser_t * epc_direct_child(epc_parser_t * parser, int index);
+
+/**
+ * @brief Creates a parser that runs a generated direct parser.
+ *
+ * On success the CPT is the one `fallback` would have produced. If the input doesn't match, the error is built from
+ * the failures the generated code reports, and is the one `fallback` would have reported. `fallback` is only run if
+ * there is no input at all.
+ *
+ * @param name The name of the parser.
+ * @param fn The generated function for the top rule.
+ * @param fallback The graph parser for the top rule.
+ * @param sites The graph parsers that the generated code creates nodes for, indexed by site number. The array is
+ *        copied.
+ * @param site_count The number of entries in `sites`.
+ * @return A new `parser_t` instance, or NULL on error.
+ */
+EASY_PC_API epc_parser_t * epc_direct(
+    char const * name, epc_direct_fn fn, epc_parser_t * fallback, epc_parser_t * const * sites, size_t site_count
+);
+
+/**
+ * @brief Creates a parser that runs a generated direct parser.
+ *        This is a convenience wrapper for `epc_direct()` that automatically adds the created parser to the provided
+ *        `epc_parser_list`.
+ * @param list The parser list to add to.
+ * @param name The name of the parser.
+ * @param fn The generated function for the top rule.
+ * @param fallback The graph parser for the top rule.
+ * @param sites The graph parsers that the generated code creates nodes for, indexed by site number.
+ * @param site_count The number of entries in `sites`.
+ * @return A new `parser_t` instance, or NULL on error.
+ */
+static inline epc_parser_t *
+epc_direct_l(
+    epc_parser_list * list,
+    char const * name,
+    epc_direct_fn fn,
+    epc_parser_t * fallback,
+    epc_parser_t * const * sites,
+    size_t site_count
+)
+{
+    return epc_parser_list_add(list, epc_direct(name, fn, fallback, sites, site_count));
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,973 @@
+#include "easy_pc_private.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ANALYSIS_INITIAL_CAPACITY 64
+
+// The longest literal prefix compared when looking for shadowed alternatives.
+#define ANALYSIS_MAX_LITERAL 64
+
+static first_set_t const analysis_anything = {
+    .bytes = {UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX},
+    .nullable = true,
+};
+
+typedef enum visit_state_t
+{
+    VISIT_NONE,
+    VISIT_ACTIVE, // On the path of the left-recursion search.
+    VISIT_DONE,
+} visit_state_t;
+
+typedef struct analysed_parser_t
+{
+    epc_parser_t * parser;
+    first_set_t first;
+    first_set_t follow; // `nullable` is set if the end of the input may follow.
+    visit_state_t visit;
+    bool is_left_recursive; // Already reported.
+} analysed_parser_t;
+
+struct epc_grammar_analysis_t
+{
+    analysed_parser_t * parsers; // In the order they were reached from the top parser.
+    size_t count;
+    size_t capacity;
+
+    size_t * slots;    // Open addressed hash of parser to index + 1, where 0 is empty.
+    size_t slot_count; // A power of two, twice `capacity`.
+
+    epc_grammar_issue_t * issues;
+    size_t issue_count;
+    size_t issue_capacity;
+
+    bool is_out_of_memory;
+};
+
+static size_t
+analysis_slot(epc_grammar_analysis_t const * analysis, epc_parser_t const * parser)
+{
+    uintptr_t const key = (uintptr_t)parser;
+
+    return (size_t)((key >> 4) * UINT64_C(0x9E3779B97F4A7C15) >> 17) & (analysis->slot_count - 1);
+}
+
+static bool
+analysis_grow(epc_grammar_analysis_t * analysis)
+{
+    size_t const capacity = analysis->capacity == 0 ? ANALYSIS_INITIAL_CAPACITY : analysis->capacity * 2;
+    analysed_parser_t * parsers = realloc(analysis->parsers, capacity * sizeof(*parsers));
+    if (parsers == NULL)
+    {
+        return false;
+    }
+    analysis->parsers = parsers;
+    analysis->capacity = capacity;
+
+    size_t * slots = calloc(capacity * 2, sizeof(*slots));
+    if (slots == NULL)
+    {
+        return false;
+    }
+    free(analysis->slots);
+    analysis->slots = slots;
+    analysis->slot_count = capacity * 2;
+
+    for (size_t i = 0; i < analysis->count; i++)
+    {
+        size_t slot = analysis_slot(analysis, analysis->parsers[i].parser);
+
+        while (analysis->slots[slot] != 0)
+        {
+            slot = (slot + 1) & (analysis->slot_count - 1);
+        }
+        analysis->slots[slot] = i + 1;
+    }
+
+    return true;
+}
+
+static analysed_parser_t *
+analysis_find(epc_grammar_analysis_t const * analysis, epc_parser_t const * parser)
+{
+    if (parser == NULL || analysis->slot_count == 0)
+    {
+        return NULL;
+    }
+    for (size_t slot = analysis_slot(analysis, parser); analysis->slots[slot] != 0;
+         slot = (slot + 1) & (analysis->slot_count - 1))
+    {
+        if (analysis->parsers[analysis->slots[slot] - 1].parser == parser)
+        {
+            return &analysis->parsers[analysis->slots[slot] - 1];
+        }
+    }
+
+    return NULL;
+}
+
+// Adds a parser reached from the top parser, unless it already has been.
+static void
+analysis_add(epc_parser_t * parser, void * data)
+{
+    epc_grammar_analysis_t * analysis = data;
+
+    if (parser == NULL || analysis_find(analysis, parser) != NULL)
+    {
+        return;
+    }
+    if (analysis->count == analysis->capacity && !analysis_grow(analysis))
+    {
+        analysis->is_out_of_memory = true;
+        return;
+    }
+
+    size_t slot = analysis_slot(analysis, parser);
+
+    while (analysis->slots[slot] != 0)
+    {
+        slot = (slot + 1) & (analysis->slot_count - 1);
+    }
+    analysis->slots[slot] = analysis->count + 1;
+    analysis->parsers[analysis->count++] = (analysed_parser_t){.parser = parser};
+}
+
+static void
+analysis_report(
+    epc_grammar_analysis_t * analysis,
+    epc_grammar_issue_kind_t kind,
+    epc_parser_t const * parser,
+    int alternative,
+    int shadowed_by
+)
+{
+    if (analysis->issue_count == analysis->issue_capacity)
+    {
+        size_t const capacity = analysis->issue_capacity == 0 ? 8 : analysis->issue_capacity * 2;
+        epc_grammar_issue_t * issues = realloc(analysis->issues, capacity * sizeof(*issues));
+
+        if (issues == NULL)
+        {
+            analysis->is_out_of_memory = true;
+            return;
+        }
+        analysis->issues = issues;
+        analysis->issue_capacity = capacity;
+    }
+    analysis->issues[analysis->issue_count++] = (epc_grammar_issue_t){
+        .kind = kind,
+        .parser = parser,
+        .name = epc_parser_get_name(parser),
+        .alternative = alternative,
+        .shadowed_by = shadowed_by,
+    };
+}
+
+// --- FIRST sets ---
+
+static first_set_t const *
+analysis_first_lookup(epc_parser_t * child, void * data)
+{
+    analysed_parser_t const * entry = analysis_find(data, child);
+
+    return entry != NULL ? &entry->first : &analysis_anything;
+}
+
+static bool
+first_set_equal(first_set_t const * a, first_set_t const * b)
+{
+    return memcmp(a->bytes, b->bytes, sizeof(a->bytes)) == 0 && a->nullable == b->nullable;
+}
+
+// Grows every FIRST set from nothing until none changes, each time computing a parser's set from the current sets of
+// its children. Unlike the sets found for parsing, a left-recursive cycle doesn't make its sets match anything.
+static void
+analysis_first_sets(epc_grammar_analysis_t * analysis)
+{
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        // The children of a parser were mostly reached after it, so their sets are best computed first.
+        for (size_t i = analysis->count; i-- > 0;)
+        {
+            analysed_parser_t * entry = &analysis->parsers[i];
+            epc_parser_t * parser = entry->parser;
+            first_set_t first;
+
+            if (parser->data.type == PARSER_DATA_TYPE_WRAP)
+            {
+                // A wrap has no FIRST set so that its callbacks see every attempt, but it matches what it wraps.
+                first = *analysis_first_lookup(parser->data.wrap.parser, analysis);
+            }
+            else if (!epc_parser_first_set_from(parser, analysis_first_lookup, analysis, &first))
+            {
+                first = analysis_anything;
+            }
+            first_set_union(&first, &entry->first);
+            first.nullable = first.nullable || entry->first.nullable;
+            if (!first_set_equal(&first, &entry->first))
+            {
+                entry->first = first;
+                changed = true;
+            }
+        }
+    }
+}
+
+static first_set_t const *
+analysis_first(epc_grammar_analysis_t const * analysis, epc_parser_t const * parser)
+{
+    analysed_parser_t const * entry = analysis_find(analysis, parser);
+
+    return entry != NULL ? &entry->first : &analysis_anything;
+}
+
+// --- FOLLOW sets ---
+
+// Adds `follow` to the FOLLOW set of `parser`. Returns true if it grew.
+static bool
+analysis_follow_add(epc_grammar_analysis_t * analysis, epc_parser_t const * parser, first_set_t const * follow)
+{
+    analysed_parser_t * entry = analysis_find(analysis, parser);
+
+    if (entry == NULL)
+    {
+        return false;
+    }
+
+    first_set_t grown = entry->follow;
+
+    first_set_union(&grown, follow);
+    grown.nullable = grown.nullable || follow->nullable;
+    if (first_set_equal(&grown, &entry->follow))
+    {
+        return false;
+    }
+    entry->follow = grown;
+
+    return true;
+}
+
+// What may come after a parser that is followed by `next`, which is itself followed by `after`.
+static first_set_t
+follow_of_next(first_set_t const * next, first_set_t const * after)
+{
+    first_set_t follow = *next;
+
+    follow.nullable = false;
+    if (next->nullable)
+    {
+        first_set_union(&follow, after);
+        follow.nullable = after->nullable;
+    }
+
+    return follow;
+}
+
+// Passes FOLLOW sets down to parsers matched one after the other, the last of which is followed by `after`.
+static bool
+analysis_follow_sequence(
+    epc_grammar_analysis_t * analysis, epc_parser_t * const * parsers, int count, first_set_t const * after
+)
+{
+    first_set_t follow = *after;
+    bool changed = false;
+
+    for (int i = count - 1; i >= 0; i--)
+    {
+        changed |= analysis_follow_add(analysis, parsers[i], &follow);
+        follow = follow_of_next(analysis_first(analysis, parsers[i]), &follow);
+    }
+
+    return changed;
+}
+
+// Passes the FOLLOW set of `entry` down to its children. Returns true if any of theirs grew.
+static bool
+analysis_follow_children(epc_grammar_analysis_t * analysis, analysed_parser_t const * entry)
+{
+    epc_parser_t * parser = entry->parser;
+    first_set_t const * follow = &entry->follow;
+
+    switch (parser->data.type)
+    {
+    case PARSER_DATA_TYPE_PARSER:
+    {
+        epc_parser_t * child = parser->data.parser;
+
+        switch (epc_parser_get_kind(parser))
+        {
+        case PARSER_KIND_MANY:
+        case PARSER_KIND_PLUS:
+        case PARSER_KIND_SKIP:
+        {
+            first_set_t again = *analysis_first(analysis, child);
+
+            // Another repetition or whatever follows the repetition.
+            first_set_union(&again, follow);
+            again.nullable = follow->nullable;
+            return analysis_follow_add(analysis, child, &again);
+        }
+
+        case PARSER_KIND_LOOKAHEAD:
+        case PARSER_KIND_NOT:
+            // What comes after the input it looks at isn't known.
+            return analysis_follow_add(analysis, child, &analysis_anything);
+
+        default:
+            return analysis_follow_add(analysis, child, follow);
+        }
+    }
+
+    case PARSER_DATA_TYPE_PARSER_LIST:
+    {
+        parser_list_t const * list = parser->data.parser_list;
+        bool changed = false;
+
+        if (list == NULL)
+        {
+            return false;
+        }
+        if (epc_parser_get_kind(parser) == PARSER_KIND_AND)
+        {
+            return analysis_follow_sequence(analysis, list->parsers, list->count, follow);
+        }
+        for (int i = 0; i < list->count; i++)
+        {
+            changed |= analysis_follow_add(analysis, list->parsers[i], follow);
+        }
+        return changed;
+    }
+
+    case PARSER_DATA_TYPE_COUNT:
+    {
+        first_set_t again = *analysis_first(analysis, parser->data.count.parser);
+
+        first_set_union(&again, follow);
+        again.nullable = follow->nullable;
+        return analysis_follow_add(analysis, parser->data.count.parser, &again);
+    }
+
+    case PARSER_DATA_TYPE_BETWEEN:
+    {
+        epc_parser_t * const sequence[] = {
+            parser->data.between.open, parser->data.between.parser, parser->data.between.close
+        };
+
+        return analysis_follow_sequence(analysis, sequence, 3, follow);
+    }
+
+    case PARSER_DATA_TYPE_DELIMITED:
+    {
+        // Also chainl1 and chainr1: an item, then any number of delimiters (operators) each followed by an item.
+        epc_parser_t * item = parser->data.delimited.item;
+        epc_parser_t * delimiter = parser->data.delimited.delimiter;
+        first_set_t after_item = *analysis_first(analysis, delimiter != NULL ? delimiter : item);
+        first_set_t const after_delimiter = *analysis_first(analysis, item);
+        bool changed = false;
+
+        if (delimiter != NULL)
+        {
+            after_item = follow_of_next(&after_item, &after_delimiter);
+        }
+        first_set_union(&after_item, follow);
+        after_item.nullable = after_item.nullable || follow->nullable;
+        changed |= analysis_follow_add(analysis, item, &after_item);
+        if (delimiter != NULL)
+        {
+            changed |= analysis_follow_add(analysis, delimiter, &after_delimiter);
+        }
+        return changed;
+    }
+
+    case PARSER_DATA_TYPE_LEXEME:
+    {
+        // The child may be followed by the whitespace and comments the lexeme skips.
+        first_set_t after = entry->first;
+
+        first_set_union(&after, follow);
+        after.nullable = follow->nullable;
+        return analysis_follow_add(analysis, parser->data.lexeme.parser, &after);
+    }
+
+    case PARSER_DATA_TYPE_PREDICATE:
+        return analysis_follow_add(analysis, parser->data.predicate.parser, follow);
+
+    case PARSER_DATA_TYPE_WRAP:
+        return analysis_follow_add(analysis, parser->data.wrap.parser, follow);
+
+    case PARSER_DATA_TYPE_DIRECT:
+        // The sites are parsers of the fallback's grammar, which get their sets from there.
+        return analysis_follow_add(analysis, parser->data.direct.fallback, follow);
+
+    case PARSER_DATA_TYPE_NONE:
+    case PARSER_DATA_TYPE_STRING:
+    case PARSER_DATA_TYPE_CHAR_RANGE:
+    case PARSER_DATA_TYPE_KEYWORDS:
+        break;
+    }
+
+    return false;
+}
+
+static void
+analysis_follow_sets(epc_grammar_analysis_t * analysis)
+{
+    if (analysis->count == 0)
+    {
+        return;
+    }
+    analysis->parsers[0].follow.nullable = true; // The top parser is followed by the end of the input.
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        for (size_t i = 0; i < analysis->count; i++)
+        {
+            changed |= analysis_follow_children(analysis, &analysis->parsers[i]);
+        }
+    }
+}
+
+// --- Left recursion ---
+
+typedef struct left_call_search_t
+{
+    epc_grammar_analysis_t * analysis;
+    analysed_parser_t ** path; // The parsers being searched, outermost first.
+    size_t depth;
+} left_call_search_t;
+
+static void left_call_search(epc_parser_t * parser, void * data);
+
+// Searches the children of `parser` that may be run at the offset it was run at.
+static void
+left_call_search_children(left_call_search_t * search, epc_parser_t * parser)
+{
+    switch (parser->data.type)
+    {
+    case PARSER_DATA_TYPE_PARSER_LIST:
+        if (parser->data.parser_list != NULL && epc_parser_get_kind(parser) == PARSER_KIND_AND)
+        {
+            parser_list_t const * sequence = parser->data.parser_list;
+
+            for (int i = 0; i < sequence->count; i++)
+            {
+                left_call_search(sequence->parsers[i], search);
+                if (!analysis_first(search->analysis, sequence->parsers[i])->nullable)
+                {
+                    break;
+                }
+            }
+            return;
+        }
+        break;
+
+    case PARSER_DATA_TYPE_BETWEEN:
+        left_call_search(parser->data.between.open, search);
+        if (analysis_first(search->analysis, parser->data.between.open)->nullable)
+        {
+            left_call_search(parser->data.between.parser, search);
+            if (analysis_first(search->analysis, parser->data.between.parser)->nullable)
+            {
+                left_call_search(parser->data.between.close, search);
+            }
+        }
+        return;
+
+    case PARSER_DATA_TYPE_DELIMITED:
+        left_call_search(parser->data.delimited.item, search);
+        if (analysis_first(search->analysis, parser->data.delimited.item)->nullable)
+        {
+            left_call_search(parser->data.delimited.delimiter, search);
+        }
+        return;
+
+    case PARSER_DATA_TYPE_DIRECT:
+        left_call_search(parser->data.direct.fallback, search);
+        return;
+
+    default:
+        break;
+    }
+    epc_parser_visit_children(parser, left_call_search, search);
+}
+
+// Reports a left-recursive cycle that comes back to the parser at `path[start]`.
+static void
+left_recursion_report(left_call_search_t * search, size_t start)
+{
+    analysed_parser_t * entry = search->path[start];
+    bool is_wrapped = false;
+
+    if (entry->is_left_recursive)
+    {
+        return;
+    }
+    entry->is_left_recursive = true;
+    // A wrap has no FIRST set, so parsing doesn't see a cycle through one, and it isn't grown from a seed.
+    for (size_t i = start; i < search->depth; i++)
+    {
+        is_wrapped = is_wrapped || search->path[i]->parser->data.type == PARSER_DATA_TYPE_WRAP;
+    }
+    analysis_report(
+        search->analysis,
+        is_wrapped ? EPC_GRAMMAR_UNBOUNDED_RECURSION : EPC_GRAMMAR_LEFT_RECURSION,
+        entry->parser,
+        -1,
+        -1
+    );
+}
+
+static void
+left_call_search(epc_parser_t * parser, void * data)
+{
+    left_call_search_t * search = data;
+    analysed_parser_t * entry = analysis_find(search->analysis, parser);
+
+    if (entry == NULL || entry->visit == VISIT_DONE)
+    {
+        return;
+    }
+    if (entry->visit == VISIT_ACTIVE)
+    {
+        size_t start = search->depth;
+
+        while (search->path[start - 1] != entry)
+        {
+            start--;
+        }
+        left_recursion_report(search, start - 1);
+        return;
+    }
+
+    entry->visit = VISIT_ACTIVE;
+    search->path[search->depth++] = entry;
+    left_call_search_children(search, parser);
+    search->depth--;
+    entry->visit = VISIT_DONE;
+}
+
+// --- Other checks ---
+
+static bool
+parser_is_single_char(epc_parser_t const * parser)
+{
+    switch (epc_parser_get_kind(parser))
+    {
+    case PARSER_KIND_CHAR:
+    case PARSER_KIND_ANY:
+    case PARSER_KIND_DIGIT:
+    case PARSER_KIND_ALPHA:
+    case PARSER_KIND_ALPHANUM:
+    case PARSER_KIND_SPACE:
+    case PARSER_KIND_HEX_DIGIT:
+    case PARSER_KIND_CHAR_RANGE:
+    case PARSER_KIND_ONE_OF:
+    case PARSER_KIND_NONE_OF:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Returns true if `parser` matches wherever it is run, as long as there is input.
+static bool
+parser_never_fails(epc_parser_t const * parser)
+{
+    switch (epc_parser_get_kind(parser))
+    {
+    case PARSER_KIND_MANY:
+    case PARSER_KIND_OPTIONAL:
+    case PARSER_KIND_SUCCEED:
+    case PARSER_KIND_SKIP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Appends the literal text that any match of `parser` starts with to `text`, which holds `*len` bytes. Returns true if
+// that text is all the parser ever matches.
+static bool
+literal_prefix(epc_parser_t const * parser, char * text, size_t * len)
+{
+    char const * literal = NULL;
+    size_t literal_len = 0;
+
+    switch (parser != NULL ? epc_parser_get_kind(parser) : PARSER_KIND_OTHER)
+    {
+    case PARSER_KIND_CHAR:
+        literal = parser->data.string;
+        literal_len = 1;
+        break;
+
+    case PARSER_KIND_STRING:
+        literal = parser->data.string;
+        literal_len = strlen(literal);
+        break;
+
+    case PARSER_KIND_AND:
+        if (parser->data.parser_list == NULL)
+        {
+            return false;
+        }
+        for (int i = 0; i < parser->data.parser_list->count; i++)
+        {
+            if (!literal_prefix(parser->data.parser_list->parsers[i], text, len))
+            {
+                return false;
+            }
+        }
+        return true;
+
+    default:
+        return false;
+    }
+
+    if (*len + literal_len > ANALYSIS_MAX_LITERAL)
+    {
+        literal_len = ANALYSIS_MAX_LITERAL - *len;
+        memcpy(text + *len, literal, literal_len);
+        *len += literal_len;
+        return false;
+    }
+    memcpy(text + *len, literal, literal_len);
+    *len += literal_len;
+
+    return true;
+}
+
+// Returns true if alternative `earlier` of an epc_or always matches where `later` could, so `later` is never tried
+// there.
+static bool
+alternative_shadows(epc_grammar_analysis_t const * analysis, epc_parser_t const * earlier, epc_parser_t const * later)
+{
+    if (earlier == NULL || later == NULL)
+    {
+        return false;
+    }
+    if (parser_never_fails(earlier))
+    {
+        return true;
+    }
+
+    first_set_t const * later_first = analysis_first(analysis, later);
+
+    if (parser_is_single_char(earlier) && !later_first->nullable)
+    {
+        // Whatever `later` matches starts with a byte that `earlier` accepts.
+        for (int c = 0; c <= UCHAR_MAX; c++)
+        {
+            if (first_set_contains(later_first, (unsigned char)c) && !epc_parser_accepts_char(earlier, (char)c))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    char earlier_text[ANALYSIS_MAX_LITERAL];
+    char later_text[ANALYSIS_MAX_LITERAL];
+    size_t earlier_len = 0;
+    size_t later_len = 0;
+
+    if (!literal_prefix(earlier, earlier_text, &earlier_len) || earlier_len == 0)
+    {
+        return false;
+    }
+    (void)literal_prefix(later, later_text, &later_len);
+
+    return later_len >= earlier_len && memcmp(earlier_text, later_text, earlier_len) == 0;
+}
+
+static void
+analysis_check_alternatives(epc_grammar_analysis_t * analysis, epc_parser_t const * parser)
+{
+    parser_list_t const * alternatives = parser->data.parser_list;
+
+    if (alternatives == NULL)
+    {
+        return;
+    }
+    for (int later = 1; later < alternatives->count; later++)
+    {
+        for (int earlier = 0; earlier < later; earlier++)
+        {
+            if (alternative_shadows(analysis, alternatives->parsers[earlier], alternatives->parsers[later]))
+            {
+                analysis_report(analysis, EPC_GRAMMAR_SHADOWED_ALTERNATIVE, parser, later, earlier);
+                break;
+            }
+        }
+    }
+}
+
+static void
+analysis_check(epc_grammar_analysis_t * analysis, epc_parser_t const * parser)
+{
+    epc_parser_t const * repeated = NULL;
+
+    if (parser->parse_fn == NULL)
+    {
+        analysis_report(analysis, EPC_GRAMMAR_UNDEFINED_PARSER, parser, -1, -1);
+        return;
+    }
+    switch (epc_parser_get_kind(parser))
+    {
+    case PARSER_KIND_MANY:
+    case PARSER_KIND_PLUS:
+    case PARSER_KIND_SKIP:
+        repeated = parser->data.parser;
+        break;
+
+    case PARSER_KIND_OR:
+        analysis_check_alternatives(analysis, parser);
+        break;
+
+    default:
+        if (parser->data.type == PARSER_DATA_TYPE_DELIMITED
+            && (parser->data.delimited.delimiter == NULL
+                || analysis_first(analysis, parser->data.delimited.delimiter)->nullable))
+        {
+            repeated = parser->data.delimited.item;
+        }
+        break;
+    }
+    if (repeated != NULL && analysis_first(analysis, repeated)->nullable)
+    {
+        analysis_report(analysis, EPC_GRAMMAR_NULLABLE_REPETITION, parser, -1, -1);
+    }
+}
+
+// --- API ---
+
+EASY_PC_API epc_grammar_analysis_t *
+epc_grammar_analyze(epc_parser_t * top_parser)
+{
+    epc_grammar_analysis_t * analysis = calloc(1, sizeof(*analysis));
+
+    if (analysis == NULL)
+    {
+        return NULL;
+    }
+    analysis_add(top_parser, analysis);
+    // Each parser's children are added after it, so this reaches every parser in the grammar.
+    for (size_t i = 0; i < analysis->count; i++)
+    {
+        epc_parser_visit_children(analysis->parsers[i].parser, analysis_add, analysis);
+    }
+
+    analysis_first_sets(analysis);
+    analysis_follow_sets(analysis);
+
+    left_call_search_t search = {
+        .analysis = analysis,
+        .path = malloc((analysis->count + 1) * sizeof(*search.path)),
+    };
+
+    if (search.path == NULL)
+    {
+        analysis->is_out_of_memory = true;
+    }
+    else
+    {
+        for (size_t i = 0; i < analysis->count; i++)
+        {
+            left_call_search(analysis->parsers[i].parser, &search);
+        }
+        free(search.path);
+    }
+    for (size_t i = 0; i < analysis->count; i++)
+    {
+        analysis_check(analysis, analysis->parsers[i].parser);
+    }
+
+    if (analysis->is_out_of_memory)
+    {
+        epc_grammar_analysis_free(analysis);
+        return NULL;
+    }
+
+    return analysis;
+}
+
+EASY_PC_API size_t
+epc_grammar_analysis_get_issues(epc_grammar_analysis_t const * analysis, epc_grammar_issue_t const ** issues)
+{
+    if (analysis == NULL)
+    {
+        *issues = NULL;
+        return 0;
+    }
+    *issues = analysis->issues;
+
+    return analysis->issue_count;
+}
+
+EASY_PC_API bool
+epc_grammar_analysis_get_sets(
+    epc_grammar_analysis_t const * analysis, epc_parser_t const * parser, epc_grammar_sets_t * sets
+)
+{
+    analysed_parser_t const * entry = analysis != NULL ? analysis_find(analysis, parser) : NULL;
+
+    if (entry == NULL)
+    {
+        return false;
+    }
+    *sets = (epc_grammar_sets_t){
+        .nullable = entry->first.nullable,
+        .may_end_input = entry->follow.nullable,
+    };
+    memcpy(sets->first, entry->first.bytes, sizeof(sets->first));
+    memcpy(sets->follow, entry->follow.bytes, sizeof(sets->follow));
+
+    return true;
+}
+
+static void
+print_byte(FILE * fp, unsigned char c)
+{
+    if (c == '\\' || c == ']' || c == '-' || c == '^')
+    {
+        fprintf(fp, "\\%c", c);
+    }
+    else if (isprint(c))
+    {
+        fputc(c, fp);
+    }
+    else
+    {
+        fprintf(fp, "\\x%02x", c);
+    }
+}
+
+// Prints a set of bytes as a character class, e.g. [+\-0-9], with ranges of three or more bytes shortened. The end of
+// the input is shown as $.
+static void
+print_byte_set(FILE * fp, uint64_t const bytes[4], bool with_end)
+{
+    first_set_t set = {.bytes = {bytes[0], bytes[1], bytes[2], bytes[3]}};
+    first_set_t const nothing = {0};
+
+    if (memcmp(set.bytes, analysis_anything.bytes, sizeof(set.bytes)) == 0)
+    {
+        fputs("any", fp);
+    }
+    else if (memcmp(set.bytes, nothing.bytes, sizeof(set.bytes)) == 0)
+    {
+        fputs(with_end ? "$" : "[]", fp);
+        return;
+    }
+    else
+    {
+        fputc('[', fp);
+        for (int c = 0; c <= UCHAR_MAX; c++)
+        {
+            if (!first_set_contains(&set, (unsigned char)c))
+            {
+                continue;
+            }
+
+            int last = c;
+
+            while (last < UCHAR_MAX && first_set_contains(&set, (unsigned char)(last + 1)))
+            {
+                last++;
+            }
+            print_byte(fp, (unsigned char)c);
+            if (last >= c + 2)
+            {
+                fputc('-', fp);
+                print_byte(fp, (unsigned char)last);
+                c = last;
+            }
+        }
+        fputc(']', fp);
+    }
+    if (with_end)
+    {
+        fputs(" $", fp);
+    }
+}
+
+static void
+print_issue(FILE * fp, epc_grammar_issue_t const * issue)
+{
+    switch (issue->kind)
+    {
+    case EPC_GRAMMAR_LEFT_RECURSION:
+        fprintf(fp, "note: '%s' is left-recursive; its matches are grown from a seed\n", issue->name);
+        break;
+
+    case EPC_GRAMMAR_UNBOUNDED_RECURSION:
+        fprintf(
+            fp, "error: '%s' is left-recursive through epc_wrap() and recurses until the stack runs out\n", issue->name
+        );
+        break;
+
+    case EPC_GRAMMAR_NULLABLE_REPETITION:
+        fprintf(fp, "error: '%s' repeats a parser that can match without consuming anything\n", issue->name);
+        break;
+
+    case EPC_GRAMMAR_SHADOWED_ALTERNATIVE:
+        fprintf(
+            fp,
+            "warning: alternative %d of '%s' is never tried where it could match; alternative %d matches first\n",
+            issue->alternative + 1,
+            issue->name,
+            issue->shadowed_by + 1
+        );
+        break;
+
+    case EPC_GRAMMAR_UNDEFINED_PARSER:
+        fprintf(fp, "error: '%s' is declared but never defined\n", issue->name);
+        break;
+    }
+}
+
+EASY_PC_API size_t
+epc_grammar_analysis_print(epc_grammar_analysis_t const * analysis, FILE * fp)
+{
+    if (analysis == NULL)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < analysis->count; i++)
+    {
+        analysed_parser_t const * entry = &analysis->parsers[i];
+
+        if (entry->parser->name == NULL)
+        {
+            continue;
+        }
+        fprintf(fp, "%s%s\n    FIRST:  ", entry->parser->name, entry->first.nullable ? " (nullable)" : "");
+        print_byte_set(fp, entry->first.bytes, false);
+        fputs("\n    FOLLOW: ", fp);
+        print_byte_set(fp, entry->follow.bytes, entry->follow.nullable);
+        fputc('\n', fp);
+    }
+    for (size_t i = 0; i < analysis->issue_count; i++)
+    {
+        print_issue(fp, &analysis->issues[i]);
+    }
+
+    return analysis->issue_count;
+}
+
+EASY_PC_API void
+epc_grammar_analysis_free(epc_grammar_analysis_t * analysis)
+{
+    if (analysis == NULL)
+    {
+        return;
+    }
+    free(analysis->parsers);
+    free(analysis->slots);
+    free(analysis->issues);
+    free(analysis);
+}
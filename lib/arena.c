@@ -0,0 +1,210 @@
+#include "arena.h"
+
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct arena_slab_t
+{
+    arena_slab_t * next; // The previously filled slab (or next spare slab).
+    size_t capacity;
+    size_t used;
+    alignas(max_align_t) unsigned char data[];
+};
+
+static size_t
+arena_align(size_t size)
+{
+    size_t const alignment = alignof(max_align_t);
+
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+EASY_PC_HIDDEN
+void
+arena_init(arena_t * arena, size_t slab_size)
+{
+    arena->current = NULL;
+    arena->spare = NULL;
+    arena->slab_size = slab_size > 0 ? slab_size : ARENA_DEFAULT_SLAB_SIZE;
+    arena->allocated = 0;
+}
+
+static arena_slab_t *
+arena_slab_get(arena_t * arena, size_t size)
+{
+    // Reuse a spare slab if the one at the head of the spare list is big enough.
+    if (arena->spare != NULL && arena->spare->capacity >= size)
+    {
+        arena_slab_t * slab = arena->spare;
+        arena->spare = slab->next;
+        slab->used = 0;
+        return slab;
+    }
+
+    size_t const capacity = size > arena->slab_size ? size : arena->slab_size;
+    arena_slab_t * slab = malloc(sizeof(*slab) + capacity);
+    if (slab == NULL)
+    {
+        return NULL;
+    }
+    slab->capacity = capacity;
+    slab->used = 0;
+
+    return slab;
+}
+
+EASY_PC_HIDDEN
+void *
+arena_alloc(arena_t * arena, size_t size)
+{
+    size = arena_align(size > 0 ? size : 1);
+
+    arena_slab_t * slab = arena->current;
+    if (slab == NULL || slab->capacity - slab->used < size)
+    {
+        slab = arena_slab_get(arena, size);
+        if (slab == NULL)
+        {
+            return NULL;
+        }
+        slab->next = arena->current;
+        arena->current = slab;
+    }
+
+    void * ptr = &slab->data[slab->used];
+    slab->used += size;
+    arena->allocated += size;
+    memset(ptr, 0, size);
+
+    return ptr;
+}
+
+EASY_PC_HIDDEN
+void *
+arena_realloc(arena_t * arena, void * ptr, size_t old_size, size_t new_size)
+{
+    if (ptr == NULL)
+    {
+        return arena_alloc(arena, new_size);
+    }
+    if (new_size <= old_size)
+    {
+        return ptr;
+    }
+
+    arena_slab_t * slab = arena->current;
+    size_t const old_aligned = arena_align(old_size);
+    size_t const new_aligned = arena_align(new_size);
+
+    // Extend in place if this block is the last thing allocated from the current slab.
+    if (slab != NULL && (unsigned char *)ptr + old_aligned == &slab->data[slab->used]
+        && slab->capacity - slab->used >= new_aligned - old_aligned)
+    {
+        slab->used += new_aligned - old_aligned;
+        arena->allocated += new_aligned - old_aligned;
+        memset((unsigned char *)ptr + old_size, 0, new_size - old_size);
+        return ptr;
+    }
+
+    void * new_ptr = arena_alloc(arena, new_size);
+    if (new_ptr == NULL)
+    {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, old_size);
+
+    return new_ptr;
+}
+
+EASY_PC_HIDDEN
+arena_mark_t
+arena_mark(arena_t const * arena)
+{
+    return (arena_mark_t){
+        .slab = arena->current,
+        .used = arena->current != NULL ? arena->current->used : 0,
+        .allocated = arena->allocated,
+    };
+}
+
+EASY_PC_HIDDEN
+void
+arena_rollback(arena_t * arena, arena_mark_t mark)
+{
+    // Slabs started after the mark was taken go back on the spare list.
+    while (arena->current != NULL && arena->current != mark.slab)
+    {
+        arena_slab_t * slab = arena->current;
+        arena->current = slab->next;
+        slab->next = arena->spare;
+        arena->spare = slab;
+    }
+
+    if (arena->current != NULL)
+    {
+        arena->current->used = mark.used;
+    }
+    arena->allocated = mark.allocated;
+}
+
+EASY_PC_HIDDEN
+void
+arena_adopt(arena_t * dst, arena_t * src)
+{
+    if (src->current != NULL)
+    {
+        arena_slab_t * oldest = src->current;
+
+        while (oldest->next != NULL)
+        {
+            oldest = oldest->next;
+        }
+        oldest->next = dst->current;
+        dst->current = src->current;
+        dst->allocated += src->allocated;
+    }
+    if (src->spare != NULL)
+    {
+        arena_slab_t * last_spare = src->spare;
+
+        while (last_spare->next != NULL)
+        {
+            last_spare = last_spare->next;
+        }
+        last_spare->next = dst->spare;
+        dst->spare = src->spare;
+    }
+    src->current = NULL;
+    src->spare = NULL;
+    src->allocated = 0;
+}
+
+EASY_PC_HIDDEN
+void
+arena_reset(arena_t * arena)
+{
+    arena_rollback(arena, (arena_mark_t){0});
+}
+
+static void
+arena_slab_chain_free(arena_slab_t * slab)
+{
+    while (slab != NULL)
+    {
+        arena_slab_t * next = slab->next;
+        free(slab);
+        slab = next;
+    }
+}
+
+EASY_PC_HIDDEN
+void
+arena_release(arena_t * arena)
+{
+    arena_slab_chain_free(arena->current);
+    arena_slab_chain_free(arena->spare);
+    arena->current = NULL;
+    arena->spare = NULL;
+    arena->allocated = 0;
+}
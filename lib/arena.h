@@ -0,0 +1,71 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct arena_slab_t arena_slab_t;
+
+// A bump allocator handing out memory from a chain of large slabs.
+// Individual allocations are never freed; the arena is either rolled back to
+// an earlier mark or released as a whole.
+typedef struct arena_t
+{
+    arena_slab_t * current; // Slab currently being allocated from (head of the in-use chain).
+    arena_slab_t * spare;   // Slabs released by a rollback, kept for reuse.
+    size_t slab_size;       // Default capacity of newly created slabs.
+    size_t allocated;       // Bytes handed out and not rolled back, which orders marks.
+} arena_t;
+
+// A position within an arena that it can later be rolled back to.
+typedef struct arena_mark_t
+{
+    arena_slab_t * slab;
+    size_t used;
+    size_t allocated;
+} arena_mark_t;
+
+#define ARENA_DEFAULT_SLAB_SIZE (64 * 1024)
+
+// Initializes an empty arena. No memory is allocated until the first request.
+EASY_PC_HIDDEN
+void
+arena_init(arena_t * arena, size_t slab_size);
+
+// Returns a zeroed block of at least `size` bytes, or NULL on allocation failure.
+EASY_PC_HIDDEN
+void *
+arena_alloc(arena_t * arena, size_t size);
+
+// Grows a block previously returned by arena_alloc(). The block is extended in place when it was the most recent
+// allocation, otherwise a new block is allocated and the old contents copied. Any new space is zeroed.
+EASY_PC_HIDDEN
+void *
+arena_realloc(arena_t * arena, void * ptr, size_t old_size, size_t new_size);
+
+// Records the current allocation position.
+EASY_PC_HIDDEN
+arena_mark_t
+arena_mark(arena_t const * arena);
+
+// Discards every allocation made since `mark` was taken.
+EASY_PC_HIDDEN
+void
+arena_rollback(arena_t * arena, arena_mark_t mark);
+
+// Moves every allocation of `src` to `dst`, which frees them along with its own. They count as allocated after
+// everything `dst` had allocated, so rolling `dst` back to an earlier mark discards them. `src` is left empty.
+EASY_PC_HIDDEN
+void
+arena_adopt(arena_t * dst, arena_t * src);
+
+// Discards every allocation, keeping the slabs for reuse.
+EASY_PC_HIDDEN
+void
+arena_reset(arena_t * arena);
+
+// Frees all slabs owned by the arena.
+EASY_PC_HIDDEN
+void
+arena_release(arena_t * arena);
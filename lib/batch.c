@@ -0,0 +1,225 @@
+#include "easy_pc_private.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// The inputs a worker has still to parse, [next, end). The owner takes them from the front one at a time, and an idle
+// worker steals the back half.
+typedef struct batch_range_t
+{
+    pthread_mutex_t mutex;
+    size_t next;
+    size_t end;
+} batch_range_t;
+
+typedef struct batch_t
+{
+    epc_parser_t * top_parser;
+    epc_parse_input_t const * inputs;
+    epc_parse_session_t * sessions;
+    epc_parse_batch_options_t options;
+    batch_range_t * ranges; // One per worker.
+    size_t worker_count;
+} batch_t;
+
+typedef struct batch_worker_t
+{
+    batch_t * batch;
+    size_t index;
+    pthread_t thread;
+    bool is_started;
+    epc_parse_session_t session; // Reused for every input when the results are handed to a callback.
+} batch_worker_t;
+
+static bool
+batch_range_take(batch_range_t * range, size_t * input_index)
+{
+    pthread_mutex_lock(&range->mutex);
+    bool const taken = range->next < range->end;
+    if (taken)
+    {
+        *input_index = range->next++;
+    }
+    pthread_mutex_unlock(&range->mutex);
+
+    return taken;
+}
+
+// Moves the back half of another worker's inputs to this worker. Returns false if every other worker has run out.
+static bool
+batch_steal(batch_t * batch, size_t thief)
+{
+    for (size_t i = 1; i < batch->worker_count; i++)
+    {
+        batch_range_t * victim = &batch->ranges[(thief + i) % batch->worker_count];
+
+        pthread_mutex_lock(&victim->mutex);
+        size_t const remaining = victim->end - victim->next;
+        size_t const stolen = (remaining + 1) / 2;
+        size_t const end = victim->end;
+        victim->end -= stolen;
+        pthread_mutex_unlock(&victim->mutex);
+
+        if (stolen > 0)
+        {
+            batch_range_t * own = &batch->ranges[thief];
+
+            pthread_mutex_lock(&own->mutex);
+            own->next = end - stolen;
+            own->end = end;
+            pthread_mutex_unlock(&own->mutex);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void
+batch_parse_into_session(batch_t * batch, size_t input_index)
+{
+    batch->sessions[input_index] = epc_parse_with_options(
+        batch->top_parser, batch->inputs[input_index], batch->options.user_ctx, batch->options.parse_options
+    );
+}
+
+static void
+batch_parse_for_callback(batch_worker_t * worker, size_t input_index)
+{
+    batch_t * batch = worker->batch;
+    epc_parse_input_t const input = batch->inputs[input_index];
+
+    // A session that parsed a string can parse the next one in the same memory.
+    bool const is_reset = input.type == EPC_PARSE_TYPE_STRING && input.input_string != NULL
+                          && worker->session.internal_parse_ctx != NULL
+                          && epc_parse_session_reset(&worker->session, input.input_string);
+    if (!is_reset)
+    {
+        epc_parse_session_destroy(&worker->session);
+        worker->session
+            = epc_parse_with_options(batch->top_parser, input, batch->options.user_ctx, batch->options.parse_options);
+    }
+
+    batch->options.on_result(input_index, &worker->session, batch->options.on_result_data);
+}
+
+static void *
+batch_worker_run(void * arg)
+{
+    batch_worker_t * worker = arg;
+    batch_t * batch = worker->batch;
+    size_t input_index;
+
+    do
+    {
+        while (batch_range_take(&batch->ranges[worker->index], &input_index))
+        {
+            if (batch->options.on_result != NULL)
+            {
+                batch_parse_for_callback(worker, input_index);
+            }
+            else
+            {
+                batch_parse_into_session(batch, input_index);
+            }
+        }
+    } while (batch_steal(batch, worker->index));
+
+    epc_parse_session_destroy(&worker->session);
+
+    return NULL;
+}
+
+static size_t
+batch_worker_count(epc_parse_batch_options_t const * options, size_t count)
+{
+    size_t workers = options->thread_count;
+
+    if (workers == 0)
+    {
+        long const online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (size_t)online : 1;
+    }
+
+    return workers < count ? workers : count;
+}
+
+EASY_PC_API void
+epc_parse_batch(
+    epc_parser_t * top_parser,
+    epc_parse_input_t const inputs[],
+    size_t count,
+    epc_parse_session_t sessions[],
+    epc_parse_batch_options_t const * options
+)
+{
+    epc_parse_batch_options_t const defaults = {0};
+    batch_t batch = {
+        .top_parser = top_parser,
+        .inputs = inputs,
+        .sessions = sessions,
+        .options = options != NULL ? *options : defaults,
+    };
+
+    if (count == 0 || inputs == NULL || (sessions == NULL && batch.options.on_result == NULL))
+    {
+        return;
+    }
+
+    // Finalizing is done before the workers share the grammar, so that none of them has to wait for it. Finalizing
+    // other grammars while they run doesn't change what they read.
+    if (top_parser != NULL)
+    {
+        epc_grammar_finalize(top_parser);
+    }
+
+    batch.worker_count = batch_worker_count(&batch.options, count);
+    batch.ranges = calloc(batch.worker_count, sizeof(*batch.ranges));
+    batch_worker_t * workers = calloc(batch.worker_count, sizeof(*workers));
+    if (batch.ranges == NULL || workers == NULL)
+    {
+        // Parse everything on the calling thread instead.
+        free(batch.ranges);
+        free(workers);
+        batch_range_t range = {.next = 0, .end = count};
+        batch_worker_t worker = {.batch = &batch};
+
+        pthread_mutex_init(&range.mutex, NULL);
+        batch.ranges = &range;
+        batch.worker_count = 1;
+        batch_worker_run(&worker);
+        pthread_mutex_destroy(&range.mutex);
+        return;
+    }
+
+    // Each worker starts with an equal share of the inputs, in order.
+    for (size_t i = 0; i < batch.worker_count; i++)
+    {
+        pthread_mutex_init(&batch.ranges[i].mutex, NULL);
+        batch.ranges[i].next = count * i / batch.worker_count;
+        batch.ranges[i].end = count * (i + 1) / batch.worker_count;
+        workers[i] = (batch_worker_t){.batch = &batch, .index = i};
+    }
+
+    // The calling thread is worker 0. If a thread can't be started, its share is stolen by the others.
+    for (size_t i = 1; i < batch.worker_count; i++)
+    {
+        workers[i].is_started = pthread_create(&workers[i].thread, NULL, batch_worker_run, &workers[i]) == 0;
+    }
+    batch_worker_run(&workers[0]);
+    for (size_t i = 1; i < batch.worker_count; i++)
+    {
+        if (workers[i].is_started)
+        {
+            pthread_join(workers[i].thread, NULL);
+        }
+    }
+
+    for (size_t i = 0; i < batch.worker_count; i++)
+    {
+        pthread_mutex_destroy(&batch.ranges[i].mutex);
+    }
+    free(batch.ranges);
+    free(workers);
+}
@@ -0,0 +1,151 @@
+#include "char_class.h"
+
+#include <limits.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define CHAR_CLASS_X86 1
+#include <immintrin.h>
+#endif
+
+EASY_PC_HIDDEN
+void
+char_class_init(char_class_t * cls, first_set_t const * set)
+{
+    *cls = (char_class_t){0};
+    memcpy(cls->set.bytes, set->bytes, sizeof(cls->set.bytes));
+
+    size_t range_count = 0;
+
+    for (int c = 0; c <= UCHAR_MAX; c++)
+    {
+        if (!first_set_contains(set, (unsigned char)c))
+        {
+            continue;
+        }
+        if (c > 0 && first_set_contains(set, (unsigned char)(c - 1)))
+        {
+            cls->range_span[range_count - 1]++;
+            continue;
+        }
+        if (range_count == CHAR_CLASS_MAX_RANGES)
+        {
+            range_count = 0;
+            break;
+        }
+        cls->range_start[range_count] = (unsigned char)c;
+        cls->range_span[range_count] = 0;
+        range_count++;
+    }
+    cls->range_count = range_count;
+
+#ifdef CHAR_CLASS_X86
+    __builtin_cpu_init();
+    cls->use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+static size_t
+char_class_span_scalar(char_class_t const * cls, char const * s, size_t len)
+{
+    size_t i = 0;
+
+    while (i < len && first_set_contains(&cls->set, (unsigned char)s[i]))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+#ifdef CHAR_CLASS_X86
+
+// A byte is in a range when subtracting the start of the range leaves it no greater than the span. The subtraction
+// wraps, so bytes below the start end up above the span. Unsigned saturating subtraction of the span then leaves
+// zero exactly for the bytes in the range.
+static size_t
+char_class_span_sse2(char_class_t const * cls, char const * s, size_t len)
+{
+    __m128i start[CHAR_CLASS_MAX_RANGES];
+    __m128i span[CHAR_CLASS_MAX_RANGES];
+    __m128i const zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (size_t r = 0; r < cls->range_count; r++)
+    {
+        start[r] = _mm_set1_epi8((char)cls->range_start[r]);
+        span[r] = _mm_set1_epi8((char)cls->range_span[r]);
+    }
+    for (; i + sizeof(__m128i) <= len; i += sizeof(__m128i))
+    {
+        __m128i const bytes = _mm_loadu_si128((__m128i const *)(s + i));
+        __m128i in_class = zero;
+
+        for (size_t r = 0; r < cls->range_count; r++)
+        {
+            __m128i const offset = _mm_subs_epu8(_mm_sub_epi8(bytes, start[r]), span[r]);
+
+            in_class = _mm_or_si128(in_class, _mm_cmpeq_epi8(offset, zero));
+        }
+
+        unsigned const mask = (unsigned)_mm_movemask_epi8(in_class);
+
+        if (mask != 0xFFFFu)
+        {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+    }
+
+    return i + char_class_span_scalar(cls, s + i, len - i);
+}
+
+__attribute__((target("avx2"))) static size_t
+char_class_span_avx2(char_class_t const * cls, char const * s, size_t len)
+{
+    __m256i start[CHAR_CLASS_MAX_RANGES];
+    __m256i span[CHAR_CLASS_MAX_RANGES];
+    __m256i const zero = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (size_t r = 0; r < cls->range_count; r++)
+    {
+        start[r] = _mm256_set1_epi8((char)cls->range_start[r]);
+        span[r] = _mm256_set1_epi8((char)cls->range_span[r]);
+    }
+    for (; i + sizeof(__m256i) <= len; i += sizeof(__m256i))
+    {
+        __m256i const bytes = _mm256_loadu_si256((__m256i const *)(s + i));
+        __m256i in_class = zero;
+
+        for (size_t r = 0; r < cls->range_count; r++)
+        {
+            __m256i const offset = _mm256_subs_epu8(_mm256_sub_epi8(bytes, start[r]), span[r]);
+
+            in_class = _mm256_or_si256(in_class, _mm256_cmpeq_epi8(offset, zero));
+        }
+
+        unsigned const mask = (unsigned)_mm256_movemask_epi8(in_class);
+
+        if (mask != 0xFFFFFFFFu)
+        {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+    }
+
+    return i + char_class_span_sse2(cls, s + i, len - i);
+}
+
+#endif
+
+EASY_PC_HIDDEN
+size_t
+char_class_span(char_class_t const * cls, char const * s, size_t len)
+{
+#ifdef CHAR_CLASS_X86
+    if (cls->range_count > 0)
+    {
+        return cls->use_avx2 ? char_class_span_avx2(cls, s, len) : char_class_span_sse2(cls, s, len);
+    }
+#endif
+
+    return char_class_span_scalar(cls, s, len);
+}
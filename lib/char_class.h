@@ -0,0 +1,33 @@
+#pragma once
+
+#include "first_set.h"
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Classes made of at most this many ranges of consecutive bytes are scanned with vector instructions.
+#define CHAR_CLASS_MAX_RANGES 4
+
+// A set of bytes laid out for finding where a run of bytes from the set ends. Classes such as digits, letters,
+// whitespace and short one_of/none_of lists are a few ranges of byte values, and each range can be tested against
+// a whole vector of input at once. Other classes are tested a byte at a time against the bitmap.
+typedef struct char_class_t
+{
+    first_set_t set; // Only `bytes` is used.
+    size_t range_count; // 0 if the class has too many ranges to be scanned with vector instructions.
+    unsigned char range_start[CHAR_CLASS_MAX_RANGES];
+    unsigned char range_span[CHAR_CLASS_MAX_RANGES]; // The last byte in the range, less its start.
+    bool use_avx2;
+} char_class_t;
+
+// Initializes a class holding the bytes in `set`.
+EASY_PC_HIDDEN
+void
+char_class_init(char_class_t * cls, first_set_t const * set);
+
+// Returns the number of bytes at the start of `s` that are in the class, looking at no more than `len` of them.
+EASY_PC_HIDDEN
+size_t
+char_class_span(char_class_t const * cls, char const * s, size_t len);
@@ -1,18 +1,17 @@
 #include "child_list.h"
 
-#include <stdlib.h>
-
 EASY_PC_HIDDEN
 bool
-child_list_init(child_list_t * list, size_t initial_capacity)
+child_list_init(child_list_t * list, epc_parser_ctx_t * ctx, size_t initial_capacity)
 {
-    if (list == NULL)
+    if (list == NULL || ctx == NULL)
     {
         return false;
     }
+    list->ctx = ctx;
     list->count = 0;
     list->capacity = initial_capacity > 0 ? initial_capacity : 4; // Default initial capacity
-    list->children = calloc(list->capacity, sizeof(epc_cpt_node_t *));
+    list->children = parse_ctx_children_alloc(ctx, list->capacity);
     return list->children != NULL;
 }
 
@@ -27,24 +26,45 @@ child_list_append(child_list_t * list, epc_cpt_node_t * child)
         return false;
     }
 
-    if (list->count == list->capacity)
+    if (list->count == list->capacity && !child_list_reserve(list, list->capacity == 0 ? 4 : list->capacity * 2))
     {
-        size_t new_capacity = list->capacity == 0 ? 4 : list->capacity * 2;
-        epc_cpt_node_t ** new_children = realloc(list->children, new_capacity * sizeof(*new_children));
-        if (new_children == NULL)
-        {
-            // Allocation failed, do not add child. The list remains in its current state.
-            return false;
-        }
-        list->children = new_children;
-        list->capacity = new_capacity;
+        // Allocation failed, do not add child. The list remains in its current state.
+        return false;
     }
 
     list->children[list->count++] = child;
     return true;
 }
 
-// Releases the memory allocated for the children array, and ALSO frees the child nodes themselves.
+EASY_PC_HIDDEN
+bool
+child_list_reserve(child_list_t * list, size_t capacity)
+{
+    if (capacity <= list->capacity)
+    {
+        return true;
+    }
+
+    // Grow at least geometrically, so that reserving a little more each time stays linear overall.
+    size_t new_capacity = list->capacity * 2;
+    if (new_capacity < capacity)
+    {
+        new_capacity = capacity;
+    }
+
+    epc_cpt_node_t ** new_children
+        = parse_ctx_children_realloc(list->ctx, list->children, list->capacity, new_capacity);
+    if (new_children == NULL)
+    {
+        return false;
+    }
+    list->children = new_children;
+    list->capacity = new_capacity;
+
+    return true;
+}
+
+// Frees the child nodes. The children array belongs to the arena, so it is simply dropped.
 // Sets list->children to NULL and count/capacity to 0.
 EASY_PC_HIDDEN
 void
@@ -58,7 +78,6 @@ child_list_release(child_list_t * list)
     {
         epc_node_free(list->children[i]);
     }
-    free(list->children);
     list->children = NULL;
     list->count = 0;
     list->capacity = 0;
@@ -82,12 +101,11 @@ child_list_transfer(child_list_t * list, epc_cpt_node_t * parent)
         return;
     }
 
-    // Assign the dynamically allocated array and its metadata to the parent node.
+    // Assign the arena allocated array and its metadata to the parent node.
     parent->children = list->children;
     parent->children_count = list->count;
 
-    // Prevent double free by nulling out the list's pointer.
-    // The parent node now owns the memory.
+    // The parent node now refers to the array.
     list->children = NULL;
     list->count = 0;
     list->capacity = 0;
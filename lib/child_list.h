@@ -7,16 +7,17 @@
 
 typedef struct child_list_t
 {
+    epc_parser_ctx_t * ctx; // The parse context whose arena holds the children array.
     size_t count;
     size_t capacity;
     epc_cpt_node_t ** children;
 } child_list_t;
 
-// Initializes a child list. Allocates initial capacity.
+// Initializes a child list. Allocates initial capacity from the context's arena.
 // Returns true on success, false on failure.
 EASY_PC_HIDDEN
 bool
-child_list_init(child_list_t * list, size_t initial_capacity);
+child_list_init(child_list_t * list, epc_parser_ctx_t * ctx, size_t initial_capacity);
 
 // Appends a child node to the list. Resizes if necessary.
 // Returns true on success, false on failure (e.g., allocation failure).
@@ -24,7 +25,13 @@ EASY_PC_HIDDEN
 bool
 child_list_append(child_list_t * list, epc_cpt_node_t * child);
 
-// Releases the memory allocated for the children array, but DOES NOT free the child nodes themselves.
+// Makes room for at least `capacity` children, so that appending up to that many can't fail.
+// Returns true on success, false on failure.
+EASY_PC_HIDDEN
+bool
+child_list_reserve(child_list_t * list, size_t capacity);
+
+// Releases the child nodes. The children array itself stays in the arena until it is rolled back or released.
 // Sets list->children to NULL and count/capacity to 0.
 EASY_PC_HIDDEN
 void
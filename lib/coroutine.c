@@ -0,0 +1,168 @@
+#include "coroutine.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+// AddressSanitizer has to be told when the stack is switched, or it reports errors on the other stack.
+#if defined(__SANITIZE_ADDRESS__)
+#define COROUTINE_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define COROUTINE_ASAN 1
+#endif
+#endif
+
+#ifdef COROUTINE_ASAN
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+struct coroutine_t
+{
+    ucontext_t caller;
+    ucontext_t callee;
+    void * mapping; // The stack with the guard page below it.
+    size_t mapping_size;
+    void * stack;
+    coroutine_fn fn;
+    void * arg;
+    bool is_finished;
+#ifdef COROUTINE_ASAN
+    void * caller_fake_stack;
+    void * callee_fake_stack;
+    void const * caller_stack;
+    size_t caller_stack_size;
+#endif
+};
+
+static void
+coroutine_entered(coroutine_t * co)
+{
+#ifdef COROUTINE_ASAN
+    __sanitizer_finish_switch_fiber(co->callee_fake_stack, &co->caller_stack, &co->caller_stack_size);
+#else
+    (void)co;
+#endif
+}
+
+static void
+coroutine_leaving(coroutine_t * co)
+{
+#ifdef COROUTINE_ASAN
+    // A coroutine that has returned won't be switched back to, so its fake stack can go.
+    __sanitizer_start_switch_fiber(
+        co->is_finished ? NULL : &co->callee_fake_stack, co->caller_stack, co->caller_stack_size
+    );
+#else
+    (void)co;
+#endif
+}
+
+// makecontext() only passes int arguments, so the coroutine pointer is passed in two halves.
+static void
+coroutine_main(unsigned int high, unsigned int low)
+{
+    coroutine_t * co = (coroutine_t *)(((uintptr_t)high << 16 << 16) | (uintptr_t)low);
+
+    coroutine_entered(co);
+    co->fn(co->arg);
+    co->is_finished = true;
+    coroutine_leaving(co);
+    // Returning resumes co->caller through uc_link.
+}
+
+EASY_PC_HIDDEN
+coroutine_t *
+coroutine_create(coroutine_fn fn, void * arg)
+{
+    coroutine_t * co = calloc(1, sizeof(*co));
+
+    if (co == NULL)
+    {
+        return NULL;
+    }
+    // The lowest page is left inaccessible, so that a parse that runs off the end of the stack faults rather than
+    // writing over whatever is mapped below it.
+    size_t const page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+    co->mapping_size = COROUTINE_STACK_SIZE + page_size;
+    co->mapping = mmap(
+        NULL, co->mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0
+    );
+    if (co->mapping == MAP_FAILED)
+    {
+        free(co);
+        return NULL;
+    }
+    if (mprotect(co->mapping, page_size, PROT_NONE) != 0 || getcontext(&co->callee) != 0)
+    {
+        munmap(co->mapping, co->mapping_size);
+        free(co);
+        return NULL;
+    }
+    co->stack = (char *)co->mapping + page_size;
+    co->fn = fn;
+    co->arg = arg;
+    co->callee.uc_stack.ss_sp = co->stack;
+    co->callee.uc_stack.ss_size = COROUTINE_STACK_SIZE;
+    co->callee.uc_link = &co->caller;
+
+    uintptr_t const address = (uintptr_t)co;
+
+    makecontext(
+        &co->callee,
+        (void (*)(void))coroutine_main,
+        2,
+        (unsigned int)(address >> 16 >> 16),
+        (unsigned int)(address & 0xFFFFFFFFu)
+    );
+
+    return co;
+}
+
+EASY_PC_HIDDEN
+bool
+coroutine_resume(coroutine_t * co)
+{
+    if (co->is_finished)
+    {
+        return true;
+    }
+
+#ifdef COROUTINE_ASAN
+    __sanitizer_start_switch_fiber(&co->caller_fake_stack, co->stack, COROUTINE_STACK_SIZE);
+#endif
+    swapcontext(&co->caller, &co->callee);
+#ifdef COROUTINE_ASAN
+    __sanitizer_finish_switch_fiber(co->caller_fake_stack, NULL, NULL);
+#endif
+
+    return co->is_finished;
+}
+
+EASY_PC_HIDDEN
+void
+coroutine_yield(coroutine_t * co)
+{
+    coroutine_leaving(co);
+    swapcontext(&co->callee, &co->caller);
+    coroutine_entered(co);
+}
+
+EASY_PC_HIDDEN
+void
+coroutine_free(coroutine_t * co)
+{
+    if (co == NULL)
+    {
+        return;
+    }
+    munmap(co->mapping, co->mapping_size);
+    free(co);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A function running on its own stack, on the thread that resumes it. It runs until it yields or returns, and picks
+// up from where it yielded when resumed again. This lets a recursive descent parse stop for more input and be
+// continued later without a thread to hold its state.
+typedef struct coroutine_t coroutine_t;
+
+typedef void (*coroutine_fn)(void * arg);
+
+// Stack reserved for each coroutine, not counting the guard page below it. Only the pages a parse actually touches
+// use memory.
+#define COROUTINE_STACK_SIZE ((size_t)8 * 1024 * 1024)
+
+// Creates a coroutine that will call fn(arg) when first resumed.
+// Returns NULL if its stack could not be allocated.
+EASY_PC_HIDDEN
+coroutine_t *
+coroutine_create(coroutine_fn fn, void * arg);
+
+// Runs the coroutine until it yields or returns.
+// Returns true if it has returned, after which it must not be resumed again.
+EASY_PC_HIDDEN
+bool
+coroutine_resume(coroutine_t * co);
+
+// Called from within the coroutine to return control to coroutine_resume().
+EASY_PC_HIDDEN
+void
+coroutine_yield(coroutine_t * co);
+
+// Frees the coroutine. Anything a coroutine that hasn't returned allocated on the heap is leaked.
+EASY_PC_HIDDEN
+void
+coroutine_free(coroutine_t * co);
@@ -67,13 +67,11 @@ cpt_printer_enter_node(epc_cpt_node_t * node, void * user_data)
 {
     cpt_printer_data_t * data = (cpt_printer_data_t *)user_data;
     // include content and length
-    epc_line_col_t position = epc_calculate_line_and_column(
-        data->parse_ctx, parse_ctx_get_offset_from_input(data->parse_ctx, node->content)
-    );
+    epc_line_col_t position = epc_cpt_node_get_line_col(data->parse_ctx, node);
     char const * scontent = epc_cpt_node_get_semantic_content(node);
     size_t scontent_len = epc_cpt_node_get_semantic_len(node);
     epc_line_col_t sposition
-        = epc_calculate_line_and_column(data->parse_ctx, parse_ctx_get_offset_from_input(data->parse_ctx, scontent));
+        = epc_parse_ctx_get_line_col(data->parse_ctx, parse_ctx_get_offset_from_input(data->parse_ctx, scontent));
     int required_len;
     char const * node_id = epc_node_id(node);
     size_t estimated_line_len
@@ -0,0 +1,447 @@
+#include "direct.h"
+#include "failure.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct direct_mark_t
+{
+    size_t node_top;
+    parse_ctx_mark_t arena;
+} direct_mark_t;
+
+typedef struct direct_state_t
+{
+    epc_direct_t direct; // Must be first; generated code only sees this.
+
+    epc_parser_ctx_t * ctx;
+    epc_parser_t * const * sites;
+
+    epc_cpt_node_t ** nodes;
+    size_t node_top;
+    size_t node_capacity;
+
+    direct_mark_t * marks;
+    size_t mark_top;
+    size_t mark_capacity;
+
+    // The furthest errors saved by combinators that put it back once their child has matched.
+    epc_parser_error_t ** saved_errors;
+    size_t saved_top;
+    size_t saved_capacity;
+
+    failure_t failure;
+    bool out_of_memory; // The generated code can't tell running out of memory from a mismatch.
+} direct_state_t;
+
+static inline direct_state_t *
+direct_state(epc_direct_t * d)
+{
+    return (direct_state_t *)d;
+}
+
+static bool
+direct_grow(void ** items, size_t * capacity, size_t count, size_t item_size)
+{
+    if (count < *capacity)
+    {
+        return true;
+    }
+
+    size_t const new_capacity = *capacity == 0 ? 64 : *capacity * 2;
+    void * grown = realloc(*items, new_capacity * item_size);
+
+    if (grown == NULL)
+    {
+        return false;
+    }
+    *items = grown;
+    *capacity = new_capacity;
+
+    return true;
+}
+
+static bool
+direct_push_node(direct_state_t * state, epc_cpt_node_t * node)
+{
+    if (node == NULL
+        || !direct_grow((void **)&state->nodes, &state->node_capacity, state->node_top, sizeof(*state->nodes)))
+    {
+        state->out_of_memory = true;
+        return false;
+    }
+    state->nodes[state->node_top++] = node;
+
+    return true;
+}
+
+static epc_cpt_node_t *
+direct_new_node(direct_state_t * state, size_t site, size_t start, size_t len)
+{
+    epc_parser_t * p = state->sites[site];
+    epc_cpt_node_t * node = parse_ctx_node_alloc(state->ctx, p, p->tag);
+
+    if (node != NULL)
+    {
+        node->content = state->direct.input + start;
+        node->len = len;
+    }
+
+    return node;
+}
+
+EASY_PC_API bool
+epc_direct_wait_for_input(epc_direct_t * d, size_t pos, size_t count)
+{
+    parse_get_input_result_t const input_result = parse_ctx_get_input_at_offset(direct_state(d)->ctx, pos, count);
+
+    if (input_result.next_input != NULL)
+    {
+        d->input_len = pos + input_result.available;
+    }
+
+    return !input_result.is_eof;
+}
+
+EASY_PC_API bool
+epc_direct_token(epc_direct_t * d, size_t site, size_t * pos, size_t len)
+{
+    direct_state_t * state = direct_state(d);
+
+    if (!direct_push_node(state, direct_new_node(state, site, *pos, len)))
+    {
+        return false;
+    }
+    *pos += len;
+
+    return true;
+}
+
+EASY_PC_API size_t
+epc_direct_mark(epc_direct_t * d)
+{
+    direct_state_t * state = direct_state(d);
+
+    if (!direct_grow((void **)&state->marks, &state->mark_capacity, state->mark_top, sizeof(*state->marks)))
+    {
+        state->out_of_memory = true;
+        return EPC_DIRECT_NO_MARK;
+    }
+    state->marks[state->mark_top] = (direct_mark_t){
+        .node_top = state->node_top,
+        .arena = parse_ctx_mark(state->ctx),
+    };
+
+    return state->mark_top++;
+}
+
+EASY_PC_API bool
+epc_direct_close(epc_direct_t * d, size_t mark, size_t site, size_t start, size_t * pos)
+{
+    direct_state_t * state = direct_state(d);
+    size_t const node_base = state->marks[mark].node_top;
+    size_t const child_count = state->node_top - node_base;
+    epc_cpt_node_t * node = direct_new_node(state, site, start, *pos - start);
+
+    if (node != NULL && child_count > 0)
+    {
+        node->children = parse_ctx_children_alloc(state->ctx, child_count);
+        if (node->children != NULL)
+        {
+            memcpy(node->children, &state->nodes[node_base], child_count * sizeof(*node->children));
+            node->children_count = (int)child_count;
+        }
+    }
+    if (node == NULL || (child_count > 0 && node->children == NULL)
+        || !direct_grow((void **)&state->nodes, &state->node_capacity, node_base, sizeof(*state->nodes)))
+    {
+        state->out_of_memory = true;
+        epc_direct_reset(d, mark);
+        *pos = start;
+        return false;
+    }
+    if (state->sites[site]->is_token)
+    {
+        node = parse_ctx_token_node(state->ctx, node, &state->marks[mark].arena);
+        if (node == NULL)
+        {
+            state->out_of_memory = true;
+            epc_direct_reset(d, mark);
+            *pos = start;
+            return false;
+        }
+    }
+    state->mark_top = mark;
+    state->node_top = node_base;
+    state->nodes[state->node_top++] = node;
+
+    return true;
+}
+
+EASY_PC_API void
+epc_direct_reset(epc_direct_t * d, size_t mark)
+{
+    direct_state_t * state = direct_state(d);
+    direct_mark_t const * entry = &state->marks[mark];
+
+    state->node_top = entry->node_top;
+    parse_ctx_reclaim(state->ctx, &entry->arena);
+    state->mark_top = mark;
+}
+
+EASY_PC_API bool
+epc_direct_wrap(epc_direct_t * d, size_t site, size_t * pos)
+{
+    direct_state_t * state = direct_state(d);
+    epc_cpt_node_t * child = state->nodes[state->node_top - 1];
+    epc_parser_t * p = state->sites[site];
+    epc_cpt_node_t * node = parse_ctx_node_alloc(state->ctx, p, p->tag);
+
+    // A token is left without the child. Its subtree can't be reclaimed without a mark, but is out of the tree.
+    if (node != NULL && !p->is_token)
+    {
+        node->children = parse_ctx_children_alloc(state->ctx, 1);
+    }
+    if (node == NULL || (!p->is_token && node->children == NULL))
+    {
+        state->out_of_memory = true;
+        state->node_top--;
+        *pos -= child->len;
+        return false;
+    }
+    node->content = child->content;
+    node->len = child->len;
+    if (!p->is_token)
+    {
+        node->children[0] = child;
+        node->children_count = 1;
+    }
+    state->nodes[state->node_top - 1] = node;
+
+    return true;
+}
+
+EASY_PC_API bool
+epc_direct_callout(epc_direct_t * d, size_t site, size_t * pos)
+{
+    direct_state_t * state = direct_state(d);
+
+    failure_flush(&state->failure);
+
+    epc_parse_result_t result = epc_parser_parse(state->sites[site], state->ctx, *pos);
+
+    if (result.is_error)
+    {
+        failure_set(&state->failure, result);
+        return false;
+    }
+    if (!direct_push_node(state, result.data.success))
+    {
+        return false;
+    }
+    *pos += result.data.success->len;
+
+    return true;
+}
+
+EASY_PC_API bool
+epc_direct_fail(epc_direct_t * d, size_t site, size_t pos)
+{
+    direct_state_t * state = direct_state(d);
+
+    failure_set_parser(&state->failure, state->sites[site], pos);
+
+    return false;
+}
+
+EASY_PC_API size_t
+epc_direct_save_error(epc_direct_t * d)
+{
+    direct_state_t * state = direct_state(d);
+
+    if (!direct_grow(
+            (void **)&state->saved_errors, &state->saved_capacity, state->saved_top, sizeof(*state->saved_errors)
+        ))
+    {
+        state->out_of_memory = true;
+        return EPC_DIRECT_NO_MARK;
+    }
+    state->saved_errors[state->saved_top] = failure_save_furthest(&state->failure);
+
+    return state->saved_top++;
+}
+
+EASY_PC_API void
+epc_direct_restore_error(epc_direct_t * d, size_t saved)
+{
+    direct_state_t * state = direct_state(d);
+
+    if (saved != EPC_DIRECT_NO_MARK)
+    {
+        failure_restore_furthest(&state->failure, &state->saved_errors[saved]);
+        state->saved_top = saved;
+    }
+}
+
+EASY_PC_API void
+epc_direct_keep_error(epc_direct_t * d, size_t saved)
+{
+    direct_state_t * state = direct_state(d);
+
+    if (saved != EPC_DIRECT_NO_MARK)
+    {
+        epc_parser_error_free(state->saved_errors[saved]);
+        state->saved_top = saved;
+    }
+}
+
+EASY_PC_API bool
+epc_direct_no_alternative(epc_direct_t * d, size_t saved, size_t site, size_t pos)
+{
+    direct_state_t * state = direct_state(d);
+
+    epc_direct_keep_error(d, saved);
+    failure_flush(&state->failure);
+    failure_set(
+        &state->failure, parser_no_alternative_error_result(state->ctx, state->sites[site], pos, d->input + pos)
+    );
+
+    return false;
+}
+
+EASY_PC_API bool
+epc_direct_lookahead_failed(epc_direct_t * d, size_t saved)
+{
+    direct_state_t * state = direct_state(d);
+
+    // The child's error is passed on, so it is built before the furthest error is put back.
+    failure_build(&state->failure);
+    epc_direct_restore_error(d, saved);
+
+    return false;
+}
+
+EASY_PC_API void
+epc_direct_unexpected_match(epc_direct_t * d, size_t saved, size_t site, size_t pos)
+{
+    direct_state_t * state = direct_state(d);
+    epc_cpt_node_t const * match = state->nodes[state->node_top - 1];
+
+    epc_direct_restore_error(d, saved);
+    failure_set(&state->failure, parser_unexpected_match_error_result(state->ctx, state->sites[site], pos, match));
+}
+
+EASY_PC_API void
+epc_direct_count_failed(epc_direct_t * d, size_t pos, size_t matched)
+{
+    direct_state_t * state = direct_state(d);
+    epc_parser_error_t * child_error = failure_build(&state->failure);
+
+    failure_set(&state->failure, parser_count_error_result(state->ctx, pos, matched, child_error));
+}
+
+EASY_PC_API void
+epc_direct_no_progress(epc_direct_t * d, size_t pos)
+{
+    direct_state_t * state = direct_state(d);
+
+    failure_flush(&state->failure);
+    failure_set(&state->failure, parser_no_progress_error_result(state->ctx, pos));
+}
+
+typedef struct child_search_t
+{
+    int index;
+    epc_parser_t * child;
+} child_search_t;
+
+static void
+find_child(epc_parser_t * child, void * data)
+{
+    child_search_t * search = data;
+
+    if (search->index-- == 0)
+    {
+        search->child = child;
+    }
+}
+
+EASY_PC_API epc_parser_t *
+epc_direct_child(epc_parser_t * parser, int index)
+{
+    child_search_t search = {.index = index};
+
+    if (parser != NULL && index >= 0)
+    {
+        epc_parser_visit_children(parser, find_child, &search);
+    }
+
+    return search.child;
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+direct_parse(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+{
+    direct_data_t const * data = &self->data.direct;
+    direct_state_t state = {
+        .direct = {
+            .input = parse_ctx_get_input_start(ctx),
+            .is_streaming = parse_ctx_is_streaming(ctx),
+        },
+        .ctx = ctx,
+        .sites = data->sites,
+    };
+
+    if (!state.direct.is_streaming)
+    {
+        state.direct.input_len = parse_ctx_get_input_len(ctx);
+    }
+
+    if (state.direct.input == NULL)
+    {
+        // Nothing can be matched, and the fallback fails straight away.
+        return data->fallback->parse_fn(data->fallback, ctx, input_offset);
+    }
+#ifdef WITH_PARSE_PROFILING
+    if (parse_ctx_get_profile(ctx) != NULL)
+    {
+        // The generated code doesn't run the parsers it was made from, so the fallback does, to count each of them.
+        return data->fallback->parse_fn(data->fallback, ctx, input_offset);
+    }
+#endif
+
+    failure_init(&state.failure, ctx);
+
+    parse_ctx_mark_t const mark = parse_ctx_mark(ctx);
+    size_t pos = input_offset;
+    epc_cpt_node_t * root = NULL;
+
+    if (data->fn(&state.direct, &pos))
+    {
+        root = state.nodes[state.node_top - 1];
+    }
+
+    // Saved errors are only left if memory ran out.
+    for (size_t i = 0; i < state.saved_top; i++)
+    {
+        epc_parser_error_free(state.saved_errors[i]);
+    }
+    free(state.nodes);
+    free(state.marks);
+    free(state.saved_errors);
+
+    if (state.out_of_memory)
+    {
+        failure_flush(&state.failure);
+        failure_set(&state.failure, parser_out_of_memory_error_result(ctx, self, input_offset));
+        root = NULL;
+    }
+    if (root == NULL)
+    {
+        parse_ctx_reclaim(ctx, &mark);
+    }
+
+    return failure_result(&state.failure, root, self, input_offset);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "easy_pc_private.h"
+
+// The parse function of epc_direct() parsers. Runs the generated function, which reports its own errors.
+EASY_PC_HIDDEN
+epc_parse_result_t
+direct_parse(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset);
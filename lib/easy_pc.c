@@ -1,25 +1,40 @@
+#include "arena.h"
+#include "coroutine.h"
 #include "easy_pc_private.h"
+#include "input_buffer.h"
+#include "line_index.h"
 #include "parsers.h"
+#include "profile.h"
+#include "vm.h"
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
 #include <ctype.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #endif
 #include <errno.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
-#define MAX_MMAP_INPUT_SIZE (100 * 1024 * 1024) /* 100 MB */
+#ifdef WITH_INPUT_STREAM_SUPPORT
+// How much is read from a streamed input at a time.
+#define STREAM_READ_SIZE (64 * 1024)
+#endif
 
-typedef struct mmap_input_buffer_t
+#ifdef WITH_INPUT_STREAM_SUPPORT
+// What a parse that runs apart from the caller (on a thread, or a coroutine for pushed input) works on.
+typedef struct
 {
-    char * buffer;     /**< Pointer to the start of the memory-mapped input buffer. */
-    size_t total_size; /**< Total size of the memory-mapped region (including guard page). */
-    size_t input_size; /**< Actual size of the input string stored in the buffer. */
-} mmap_input_buffer_t;
+    epc_parser_t * top_parser;
+    epc_compiled_grammar_t const * compiled; // Run in place of top_parser when not NULL.
+    epc_parser_ctx_t * ctx;
+    epc_parse_result_t result;
+} ParsingThreadArgs;
+#endif
 
 // The Parsing Context (for a single parse operation and its results)
 // This will be internally managed by epc_parse_input
@@ -28,40 +43,152 @@ struct epc_parser_ctx_t
     char const * input_start;
     size_t input_len;
 
-    mmap_input_buffer_t mmap_buffer; /* Internal buffer management for input string, using mmap for large inputs. */
+    input_buffer_t input; /* Holds the input. It never moves, as CPT nodes point into it. */
     epc_parser_error_t * furthest_error;
+    parse_error_pool_t error_pool; /* Recycled error records, so failed matches don't hit the heap. */
+
+    arena_t arena; /* Owns every CPT node and children array created during the parse. */
+
+    line_index_t line_index; /* Newline offsets, built on the first line/column lookup. */
+
+    memo_table_t memo; /* Packrat cache of (parser, offset) -> result. */
+    bool memoize_all;  /* Memoize every parser rather than just those flagged with epc_parser_set_memoize(). */
+
+    epc_ast_builder_ctx_t * ast_builder; /* Runs the AST actions as the parse goes, if not NULL. */
+
+    left_recursion_t * left_recursion; /* The left-recursive parsers being grown, innermost first. */
 
     void * user_ctx; /* User-defined context that can be used in predicates (e.g. epc_wrap()). */
 
+    size_t thread_count; /* For parsers with a split predicate. 0 means one per online processor. */
+
+#ifdef WITH_PARSE_PROFILING
+    profile_t * profile; /* What each parser did, if the parse is profiled. */
+#endif
+
+    /* What the session parses with, so that epc_parse_session_reset() can parse another input with it. */
+    epc_parser_t * top_parser;
+    epc_compiled_grammar_t const * compiled;
+    bool is_resettable; /* The input is a copy of a string, so the buffer can take another one. */
+
 #ifdef WITH_INPUT_STREAM_SUPPORT
+    /* epc_parse_fd() hands input from the reading thread to the parsing thread by publishing its length, after which
+     * the parsing thread reads it without locking. input_len is the parsing thread's copy of published_len, which
+     * it only loads again when asked for input beyond it. The mutex and condition are only used when the parsing
+     * thread has used everything published and has to sleep, which it announces in `sleepers`.
+     */
     pthread_mutex_t mutex;
     pthread_cond_t cond;
+    _Atomic size_t published_len;
+    atomic_int sleepers;
     bool is_streaming;
-    bool is_eof;
-    int input_error;
+    atomic_bool is_eof;
+    atomic_int input_error;
+
+    /* Set when input is pushed with epc_parse_feed(). The parse runs on push_parse, on the thread feeding it, and
+     * yields when it runs out of input, so none of the locking is needed.
+     */
+    bool is_push;
+    coroutine_t * push_parse; /* NULL once the parse is done. */
+    bool is_abandoned;        /* Set when the session is destroyed before the parse is done. */
+    ParsingThreadArgs push_args;
 #endif
 };
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
-typedef struct
-{
-    epc_parser_t * top_parser;
-    epc_parser_ctx_t * ctx;
-    epc_parse_result_t result;
-} ParsingThreadArgs;
-
 static void *
 epc_parsing_thread_worker(void * arg)
 {
     ParsingThreadArgs * args = (ParsingThreadArgs *) arg;
 
-    args->result = args->top_parser->parse_fn(args->top_parser, args->ctx, 0);
+    if (args->compiled != NULL)
+    {
+        args->result = vm_parse(args->compiled, args->ctx);
+    }
+    else
+    {
+        args->result = epc_parser_parse(args->top_parser, args->ctx, 0);
+    }
 
     return NULL;
 }
+
+static void
+push_parse_main(void * arg)
+{
+    epc_parsing_thread_worker(arg);
+}
 #endif
 
+// --- CPT Walking ---
+
+// Number of levels a walk covers before its stack moves to the heap.
+#define CPT_WALK_INLINE_FRAMES 64
+
+typedef struct cpt_walk_frame_t
+{
+    epc_cpt_node_t * node;
+    int next_child; // Index of the next child to walk.
+} cpt_walk_frame_t;
+
+// An explicit stack for walking a CPT, so that deep trees don't use up the native stack. It starts in the walk itself
+// and is only moved to the heap for trees deeper than CPT_WALK_INLINE_FRAMES, after which it is reused for the rest of
+// the walk.
+typedef struct cpt_walk_t
+{
+    cpt_walk_frame_t * frames;
+    size_t count;
+    size_t capacity;
+    cpt_walk_frame_t inline_frames[CPT_WALK_INLINE_FRAMES];
+} cpt_walk_t;
+
+static void
+cpt_walk_init(cpt_walk_t * walk)
+{
+    walk->frames = walk->inline_frames;
+    walk->count = 0;
+    walk->capacity = CPT_WALK_INLINE_FRAMES;
+}
+
+// Returns false if the stack can't grow.
+static bool
+cpt_walk_push(cpt_walk_t * walk, epc_cpt_node_t * node)
+{
+    if (walk->count == walk->capacity)
+    {
+        size_t const new_capacity = walk->capacity * 2;
+        cpt_walk_frame_t * frames = walk->frames == walk->inline_frames ? NULL : walk->frames;
+
+        frames = realloc(frames, new_capacity * sizeof(*frames));
+        if (frames == NULL)
+        {
+            return false;
+        }
+        if (walk->frames == walk->inline_frames)
+        {
+            memcpy(frames, walk->inline_frames, sizeof(walk->inline_frames));
+        }
+        walk->frames = frames;
+        walk->capacity = new_capacity;
+    }
+    walk->frames[walk->count++] = (cpt_walk_frame_t){.node = node, .next_child = 0};
+
+    return true;
+}
+
+static void
+cpt_walk_release(cpt_walk_t * walk)
+{
+    if (walk->frames != walk->inline_frames)
+    {
+        free(walk->frames);
+    }
+    cpt_walk_init(walk);
+}
+
 // --- CPT Visitor ---
+
+// Only used for the subtrees that an explicit stack couldn't be grown for.
 static void
 pt_visit_recursive(epc_cpt_node_t * node, epc_cpt_visitor_t * visitor)
 {
@@ -92,57 +219,60 @@ epc_cpt_visit_nodes(epc_cpt_node_t * root, epc_cpt_visitor_t * visitor)
     {
         return;
     }
-    pt_visit_recursive(root, visitor);
-}
 
-// --- Top-Level API ---
-
-mmap_input_buffer_t
-create_mmap_input_buffer(size_t input_size)
-{
-    mmap_input_buffer_t buffer = {0};
+    cpt_walk_t walk;
 
-    if (input_size > MAX_MMAP_INPUT_SIZE)
+    cpt_walk_init(&walk);
+    if (visitor->enter_node)
     {
-        return buffer; // Return empty buffer if input size exceeds our limit
+        visitor->enter_node(root, visitor->user_data);
     }
+    cpt_walk_push(&walk, root); // Can't fail while the stack is inline.
 
-    long const page_size = sysconf(_SC_PAGESIZE);
-    buffer.total_size = MAX_MMAP_INPUT_SIZE + page_size;
-
-    /*
-     * Allocate 100MB + 1 guard page.
-     * MAP_ANONYMOUS ensures no physical memory is used until written to.
-     */
-    void * mem = mmap(NULL, buffer.total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-
-    if (mem == MAP_FAILED)
+    while (walk.count > 0)
     {
-        return (mmap_input_buffer_t){0}; // Return empty buffer on failure
-    }
+        cpt_walk_frame_t * frame = &walk.frames[walk.count - 1];
 
-    /* Set the guard page at the very end of the 100MB range. */
-    if (mprotect((char *)mem + MAX_MMAP_INPUT_SIZE, page_size, PROT_NONE) != 0)
-    {
-        munmap(mem, buffer.total_size);
-        return (mmap_input_buffer_t){0}; // Return empty buffer on failure
-    }
+        if (frame->next_child == frame->node->children_count)
+        {
+            if (visitor->exit_node)
+            {
+                visitor->exit_node(frame->node, visitor->user_data);
+            }
+            walk.count--;
+            continue;
+        }
 
-    buffer.buffer = mem;
-    buffer.input_size = input_size;
+        epc_cpt_node_t * child = frame->node->children[frame->next_child++];
 
-    return buffer;
+        if (child == NULL)
+        {
+            continue;
+        }
+        if (!cpt_walk_push(&walk, child))
+        {
+            pt_visit_recursive(child, visitor);
+            continue;
+        }
+        if (visitor->enter_node)
+        {
+            visitor->enter_node(child, visitor->user_data);
+        }
+    }
+    cpt_walk_release(&walk);
 }
 
+// --- Top-Level API ---
+
 // Internal parser_ctx_t creation (for parse results)
 static epc_parser_ctx_t *
 internal_create_parse_ctx_from_string(char const * input_start)
 {
     size_t input_len = input_start == NULL ? 0 : strlen(input_start);
 
-    mmap_input_buffer_t buffer = create_mmap_input_buffer(input_len + 1);
+    input_buffer_t buffer;
 
-    if (buffer.buffer == NULL)
+    if (!input_buffer_init_fixed(&buffer, input_len + 1))
     {
         return NULL;
     }
@@ -150,10 +280,15 @@ internal_create_parse_ctx_from_string(char const * input_start)
     epc_parser_ctx_t * ctx = calloc(1, sizeof(*ctx));
     if (ctx == NULL)
     {
-        munmap(buffer.buffer, buffer.total_size);
+        input_buffer_free(&buffer);
         return NULL;
     }
 
+    arena_init(&ctx->arena, ARENA_DEFAULT_SLAB_SIZE);
+    memo_table_init(&ctx->memo, MEMO_DEFAULT_BUDGET);
+    parse_error_pool_init(&ctx->error_pool);
+    line_index_init(&ctx->line_index);
+
 #ifdef WITH_INPUT_STREAM_SUPPORT
     pthread_mutex_init(&ctx->mutex, NULL);
     pthread_cond_init(&ctx->cond, NULL);
@@ -161,16 +296,17 @@ internal_create_parse_ctx_from_string(char const * input_start)
 
     if (input_start != NULL)
     {
-        memcpy(buffer.buffer, input_start, input_len + 1); /* +1 to include null terminator */
+        memcpy(buffer.base, input_start, input_len + 1); /* +1 to include null terminator */
     }
     else
     {
-        buffer.buffer[0] = '\0'; /* Ensure null termination for NULL input */
+        buffer.base[0] = '\0'; /* Ensure null termination for NULL input */
     }
 
-    ctx->mmap_buffer = buffer;
-    ctx->input_start = ctx->mmap_buffer.buffer;
+    ctx->input = buffer;
+    ctx->input_start = ctx->input.base;
     ctx->input_len = input_len;
+    ctx->is_resettable = true;
 
     return ctx;
 }
@@ -195,34 +331,50 @@ internal_create_parse_ctx_from_fp(FILE * fp)
     }
     rewind(fp);
 
-    mmap_input_buffer_t buffer = create_mmap_input_buffer((size_t)file_size + 1);
-    if (buffer.buffer == NULL)
-    {
-        return NULL;
-    }
+    // Regular files are mapped rather than read, so the input isn't copied and parsing needn't wait for all of it to
+    // be read first. Anything else (or a file that can't be mapped) is read into a buffer.
+    input_buffer_t buffer;
+    size_t total_read = (size_t)file_size;
+    struct stat file_stat;
+    int const fd = fileno(fp);
+    bool const is_mapped = fd >= 0 && fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)
+                           && input_buffer_init_file(&buffer, fd, (size_t)file_size);
 
-    size_t total_read = fread(buffer.buffer, 1, (size_t)file_size, fp);
-    if (total_read != (size_t)file_size)
+    if (!is_mapped)
     {
-        munmap(buffer.buffer, buffer.total_size);
-        return NULL;
+        if (!input_buffer_init_fixed(&buffer, (size_t)file_size + 1))
+        {
+            return NULL;
+        }
+
+        total_read = fread(buffer.base, 1, (size_t)file_size, fp);
+        if (total_read != (size_t)file_size)
+        {
+            input_buffer_free(&buffer);
+            return NULL;
+        }
+        buffer.base[total_read] = '\0'; // Null-terminate the buffer
     }
-    buffer.buffer[total_read] = '\0'; // Null-terminate the buffer
 
     epc_parser_ctx_t * ctx = calloc(1, sizeof(*ctx));
     if (!ctx)
     {
-        munmap(buffer.buffer, buffer.total_size);
+        input_buffer_free(&buffer);
         return NULL;
     }
 
+    arena_init(&ctx->arena, ARENA_DEFAULT_SLAB_SIZE);
+    memo_table_init(&ctx->memo, MEMO_DEFAULT_BUDGET);
+    parse_error_pool_init(&ctx->error_pool);
+    line_index_init(&ctx->line_index);
+
 #ifdef WITH_INPUT_STREAM_SUPPORT
     pthread_mutex_init(&ctx->mutex, NULL);
     pthread_cond_init(&ctx->cond, NULL);
 #endif
 
-    ctx->mmap_buffer = buffer;
-    ctx->input_start = buffer.buffer;
+    ctx->input = buffer;
+    ctx->input_start = buffer.base;
     ctx->input_len = total_read;
 
     return ctx;
@@ -230,10 +382,10 @@ internal_create_parse_ctx_from_fp(FILE * fp)
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
 static epc_parser_ctx_t *
-internal_create_parse_ctx_streaming(void)
+internal_create_parse_ctx_streaming(bool is_push)
 {
-    mmap_input_buffer_t buffer = create_mmap_input_buffer(0);
-    if (buffer.buffer == NULL)
+    input_buffer_t buffer;
+    if (!input_buffer_init_stream(&buffer))
     {
         return NULL;
     }
@@ -241,17 +393,22 @@ internal_create_parse_ctx_streaming(void)
     epc_parser_ctx_t * ctx = calloc(1, sizeof(*ctx));
     if (ctx == NULL)
     {
-        munmap(buffer.buffer, buffer.total_size);
+        input_buffer_free(&buffer);
         return NULL;
     }
 
+    arena_init(&ctx->arena, ARENA_DEFAULT_SLAB_SIZE);
+    memo_table_init(&ctx->memo, MEMO_DEFAULT_BUDGET);
+    parse_error_pool_init(&ctx->error_pool);
+    line_index_init(&ctx->line_index);
     pthread_mutex_init(&ctx->mutex, NULL);
     pthread_cond_init(&ctx->cond, NULL);
 
-    ctx->mmap_buffer = buffer;
-    ctx->input_start = buffer.buffer;
+    ctx->input = buffer;
+    ctx->input_start = buffer.base;
     ctx->input_len = 0;
     ctx->is_streaming = true;
+    ctx->is_push = is_push;
 
     return ctx;
 }
@@ -273,21 +430,76 @@ internal_destroy_parse_ctx(epc_parser_ctx_t * ctx)
         return;
     }
 
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    if (ctx->push_parse != NULL)
+    {
+        // An unfinished parse is unwound rather than left on its stack, so that the scratch buffers its frames hold
+        // are freed. Every parser fails as soon as it is entered, and no callbacks run. What it built is released
+        // with the arena and error pool below.
+        ctx->is_abandoned = true;
+        ctx->is_eof = true;
+        coroutine_resume(ctx->push_parse);
+        coroutine_free(ctx->push_parse);
+    }
+#endif
+
     epc_parser_error_free(ctx->furthest_error);
+    memo_table_release(&ctx->memo);
+#ifdef WITH_PARSE_PROFILING
+    if (ctx->profile != NULL)
+    {
+        profile_release(ctx->profile);
+        free(ctx->profile);
+    }
+#endif
+    parse_error_pool_release(&ctx->error_pool);
+    line_index_release(&ctx->line_index);
+    arena_release(&ctx->arena);
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
     pthread_mutex_destroy(&ctx->mutex);
     pthread_cond_destroy(&ctx->cond);
 #endif
 
-    if (ctx->mmap_buffer.buffer != NULL)
+    input_buffer_free(&ctx->input);
+
+    free(ctx);
+}
+
+#ifdef WITH_INPUT_STREAM_SUPPORT
+// Called on the parsing thread of epc_parse_fd() to sleep until `len` bytes of input have arrived, the input has
+// ended, or reading it failed.
+static void
+stream_wait_for_input(epc_parser_ctx_t * ctx, size_t len)
+{
+    pthread_mutex_lock(&ctx->mutex);
+    // The reader checks for sleepers after publishing, and this checks what's published after announcing itself, so
+    // one of the two always sees the other.
+    atomic_fetch_add(&ctx->sleepers, 1);
+    while (atomic_load(&ctx->published_len) < len && !atomic_load(&ctx->is_eof) && atomic_load(&ctx->input_error) == 0)
     {
-        munmap((void *)ctx->mmap_buffer.buffer, ctx->mmap_buffer.total_size);
+        pthread_cond_wait(&ctx->cond, &ctx->mutex);
     }
+    atomic_fetch_sub(&ctx->sleepers, 1);
+    pthread_mutex_unlock(&ctx->mutex);
 
-    free(ctx);
+    // The length is published before the end of the input is, so this is final if the input has ended.
+    ctx->input_len = atomic_load(&ctx->published_len);
 }
 
+// Called on the reading thread of epc_parse_fd() after publishing more input or the end of the input.
+static void
+stream_wake_parser(epc_parser_ctx_t * ctx)
+{
+    if (atomic_load(&ctx->sleepers) > 0)
+    {
+        pthread_mutex_lock(&ctx->mutex);
+        pthread_cond_broadcast(&ctx->cond);
+        pthread_mutex_unlock(&ctx->mutex);
+    }
+}
+#endif
+
 EASY_PC_HIDDEN
 parse_get_input_result_t
 parse_ctx_get_input_at_offset(epc_parser_ctx_t * const ctx, size_t const input_offset, size_t const count)
@@ -300,33 +512,23 @@ parse_ctx_get_input_at_offset(epc_parser_ctx_t * const ctx, size_t const input_o
     }
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
-    if (ctx->is_streaming)
+    if (ctx->is_push)
     {
-        pthread_mutex_lock(&ctx->mutex);
+        // The feeding thread is waiting for the parse to give control back, so waiting for input means yielding.
         while (input_offset + count > ctx->input_len && !ctx->is_eof && ctx->input_error == 0)
         {
-            pthread_cond_wait(&ctx->cond, &ctx->mutex);
+            coroutine_yield(ctx->push_parse);
         }
-
+    }
+    else if (ctx->is_streaming && input_offset + count > ctx->input_len)
+    {
+        // Input that has already arrived is read without any synchronisation. Only input beyond it needs a look at
+        // what has been published since, and only input beyond that needs to wait.
+        ctx->input_len = atomic_load_explicit(&ctx->published_len, memory_order_acquire);
         if (input_offset + count > ctx->input_len)
         {
-            // We've reached EOF or an error occurred before enough data was available
-            pthread_mutex_unlock(&ctx->mutex);
-            return (parse_get_input_result_t){
-                .next_input = &ctx->input_start[input_offset],
-                .available = ctx->input_len - input_offset,
-                .is_eof = true,
-                /* We might want to pass back the error code somehow in the future */
-            };
+            stream_wait_for_input(ctx, input_offset + count);
         }
-
-        parse_get_input_result_t result = {
-            .next_input = &ctx->input_start[input_offset],
-            .available = ctx->input_len - input_offset,
-            .is_eof = false,
-        };
-        pthread_mutex_unlock(&ctx->mutex);
-        return result;
     }
 #endif
 
@@ -357,6 +559,18 @@ parse_ctx_is_streaming(epc_parser_ctx_t const * ctx)
 #endif
 }
 
+EASY_PC_HIDDEN
+bool
+parse_ctx_is_abandoned(epc_parser_ctx_t const * ctx)
+{
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    return ctx->is_abandoned;
+#else
+    (void)ctx;
+    return false;
+#endif
+}
+
 EASY_PC_HIDDEN
 bool
 parse_ctx_is_eof(epc_parser_ctx_t * ctx)
@@ -368,10 +582,7 @@ parse_ctx_is_eof(epc_parser_ctx_t * ctx)
 #ifdef WITH_INPUT_STREAM_SUPPORT
     if (ctx->is_streaming)
     {
-        pthread_mutex_lock(&ctx->mutex);
-        bool const is_eof = ctx->is_eof;
-        pthread_mutex_unlock(&ctx->mutex);
-        return is_eof;
+        return atomic_load(&ctx->is_eof);
     }
 #endif
     return true; // For non-streaming, data is always loaded up to "EOF"
@@ -401,6 +612,85 @@ parse_ctx_get_offset_from_input(epc_parser_ctx_t * const ctx, char const * const
     return (size_t)(input_position - ctx->input_start);
 }
 
+static size_t
+parse_ctx_get_available_len(epc_parser_ctx_t * ctx)
+{
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    if (ctx->is_streaming && !ctx->is_push)
+    {
+        return atomic_load(&ctx->published_len);
+    }
+#endif
+    return ctx->input_len;
+}
+
+EASY_PC_API
+epc_line_col_t
+epc_parse_ctx_get_line_col(epc_parser_ctx_t * ctx, size_t offset)
+{
+    if (ctx == NULL || ctx->input_start == NULL)
+    {
+        return (epc_line_col_t){0};
+    }
+
+    // Only scan the input when an offset beyond the part already indexed is asked for. Streamed input is then
+    // indexed in pieces as it arrives, and each byte is scanned once however many positions are looked up.
+    if (offset >= ctx->line_index.scanned_len)
+    {
+        size_t const input_len = parse_ctx_get_available_len(ctx);
+
+        // The end of the input is a position too: where a parse fails for want of more of it.
+        if (offset > input_len || !line_index_extend(&ctx->line_index, ctx->input_start, input_len))
+        {
+            return (epc_line_col_t){0};
+        }
+    }
+
+    return line_index_lookup(&ctx->line_index, offset);
+}
+
+EASY_PC_API
+epc_line_col_t
+epc_cpt_node_get_line_col(epc_parser_ctx_t * ctx, epc_cpt_node_t const * node)
+{
+    if (ctx == NULL || node == NULL)
+    {
+        return (epc_line_col_t){0};
+    }
+
+    return epc_parse_ctx_get_line_col(ctx, parse_ctx_get_offset_from_input(ctx, node->content));
+}
+
+EASY_PC_API
+void
+epc_parse_ctx_discard_input(epc_parser_ctx_t * ctx, size_t offset)
+{
+    if (ctx == NULL || ctx->input_start == NULL)
+    {
+        return;
+    }
+
+    size_t const input_len = parse_ctx_get_available_len(ctx);
+
+    if (offset > input_len)
+    {
+        offset = input_len;
+    }
+    // Line and column lookups only ever scan input beyond the indexed part, so index what is about to go.
+    if (!line_index_extend(&ctx->line_index, ctx->input_start, offset))
+    {
+        return;
+    }
+
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    pthread_mutex_lock(&ctx->mutex);
+#endif
+    input_buffer_release_before(&ctx->input, offset);
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    pthread_mutex_unlock(&ctx->mutex);
+#endif
+}
+
 EASY_PC_HIDDEN
 ATTR_NONNULL(1)
 epc_parser_error_t *
@@ -409,6 +699,17 @@ parse_ctx_get_furthest_error(epc_parser_ctx_t const * ctx)
     return ctx->furthest_error;
 }
 
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+epc_parser_error_t *
+parse_ctx_take_furthest_error(epc_parser_ctx_t * ctx)
+{
+    epc_parser_error_t * furthest_error = ctx->furthest_error;
+
+    ctx->furthest_error = NULL;
+    return furthest_error;
+}
+
 EASY_PC_HIDDEN
 ATTR_NONNULL(1)
 void
@@ -419,65 +720,288 @@ parser_ctx_set_furthest_error(epc_parser_ctx_t * ctx, epc_parser_error_t ** repl
     *replacement = NULL;
 }
 
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+memo_table_t *
+parse_ctx_get_memo_table(epc_parser_ctx_t * ctx)
+{
+    return &ctx->memo;
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+parse_error_pool_t *
+parse_ctx_get_error_pool(epc_parser_ctx_t * ctx)
+{
+    return &ctx->error_pool;
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2)
+bool
+parse_ctx_should_memoize(epc_parser_ctx_t const * ctx, epc_parser_t const * parser, size_t input_offset)
+{
+    // A cached node has had its actions run already, for a match whose AST nodes may since have been used or freed.
+    // While a left-recursive parser grows, a match at or before its offset may be built on a seed that is about to be
+    // outgrown; those after it can't reach back to it. Matches of left-recursive parsers are always kept, so that
+    // each is only grown once at an offset.
+    return (ctx->memoize_all || parser->memoize || epc_parser_is_left_recursive(parser)) && ctx->ast_builder == NULL
+           && (ctx->left_recursion == NULL || input_offset > ctx->left_recursion->input_offset);
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+epc_ast_builder_ctx_t *
+parse_ctx_get_ast_builder(epc_parser_ctx_t const * ctx)
+{
+    return ctx->left_recursion == NULL ? ctx->ast_builder : NULL;
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+left_recursion_t *
+parse_ctx_get_left_recursion(epc_parser_ctx_t const * ctx)
+{
+    return ctx->left_recursion;
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+void
+parse_ctx_set_left_recursion(epc_parser_ctx_t * ctx, left_recursion_t * left_recursion)
+{
+    ctx->left_recursion = left_recursion;
+}
+
+#ifdef WITH_PARSE_PROFILING
+EASY_PC_HIDDEN
+profile_t *
+parse_ctx_get_profile(epc_parser_ctx_t const * ctx)
+{
+    return ctx->profile;
+}
+#endif
+
+// True if every parser has to be run by parse() for the parse to be profiled.
+static bool
+parse_ctx_is_profiled(epc_parser_ctx_t const * ctx)
+{
+#ifdef WITH_PARSE_PROFILING
+    return ctx->profile != NULL;
+#else
+    (void)ctx;
+    return false;
+#endif
+}
+
+EASY_PC_HIDDEN
+size_t
+parse_ctx_split_thread_count(epc_parser_ctx_t const * ctx)
+{
+    // Streamed input may not have arrived where a chunk starts, and AST actions have to run in input order. The
+    // chunks of a profiled parse would count into the same table from several threads. The chunks of a parse that is
+    // growing a left-recursive parser wouldn't know its seed.
+    if (ctx->ast_builder != NULL || parse_ctx_is_streaming(ctx) || parse_ctx_is_profiled(ctx)
+        || ctx->left_recursion != NULL)
+    {
+        return 1;
+    }
+    if (ctx->thread_count == 0)
+    {
+        long const online = sysconf(_SC_NPROCESSORS_ONLN);
+
+        return online > 0 ? (size_t)online : 1;
+    }
+
+    return ctx->thread_count;
+}
+
+EASY_PC_HIDDEN
+epc_parser_ctx_t *
+parse_ctx_create_chunk(epc_parser_ctx_t const * parent)
+{
+    epc_parser_ctx_t * chunk = calloc(1, sizeof(*chunk));
+    if (chunk == NULL)
+    {
+        return NULL;
+    }
+
+    arena_init(&chunk->arena, ARENA_DEFAULT_SLAB_SIZE);
+    memo_table_init(&chunk->memo, parent->memo.budget);
+    parse_error_pool_init(&chunk->error_pool);
+    line_index_init(&chunk->line_index);
+
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    pthread_mutex_init(&chunk->mutex, NULL);
+    pthread_cond_init(&chunk->cond, NULL);
+#endif
+
+    // The input buffer is left empty, as it is the parent's to free.
+    chunk->input_start = parent->input_start;
+    chunk->input_len = parent->input_len;
+    chunk->memoize_all = parent->memoize_all;
+    chunk->user_ctx = parent->user_ctx;
+    chunk->thread_count = 1;
+
+    return chunk;
+}
+
+EASY_PC_HIDDEN
+void
+parse_ctx_adopt_chunk(epc_parser_ctx_t * ctx, epc_parser_ctx_t * chunk)
+{
+    arena_adopt(&ctx->arena, &chunk->arena);
+    parser_furthest_error_merge(ctx, chunk->furthest_error);
+}
+
+EASY_PC_HIDDEN
+void
+parse_ctx_destroy_chunk(epc_parser_ctx_t * chunk)
+{
+    internal_destroy_parse_ctx(chunk);
+}
+
 #ifdef WITH_INPUT_STREAM_SUPPORT
 static epc_parse_result_t
-parse_in_thread(epc_parser_t * top_parser, epc_parser_ctx_t * ctx, epc_parse_input_t input)
+parse_in_thread(
+    epc_parser_t * top_parser, epc_compiled_grammar_t const * compiled, epc_parser_ctx_t * ctx, epc_parse_input_t input
+)
 {
-        ParsingThreadArgs args = {
-            .top_parser = top_parser,
-            .ctx = ctx,
-            .result = {0},
-        };
+    ParsingThreadArgs args = {
+        .top_parser = top_parser,
+        .compiled = compiled,
+        .ctx = ctx,
+        .result = {0},
+    };
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, epc_parsing_thread_worker, &args) != 0)
+    {
+        return epc_unparsed_error_result(
+            0, "Failed to create parsing thread", "parsing thread created", "pthread_create failed"
+        );
+    }
 
-        pthread_t thread;
-        if (pthread_create(&thread, NULL, epc_parsing_thread_worker, &args) != 0)
+    // Producer Loop (Main Thread)
+    // Data is read straight into the input buffer, just past the end of the input that the parser can see.
+    size_t input_len = 0;
+    ssize_t bytes_read;
+    int read_error = 0;
+    for (;;)
+    {
+        // The buffer is only locked against epc_parse_ctx_discard_input().
+        pthread_mutex_lock(&ctx->mutex);
+        bool const committed = input_buffer_commit(&ctx->input, input_len + STREAM_READ_SIZE);
+        read_error = errno;
+        pthread_mutex_unlock(&ctx->mutex);
+
+        if (!committed)
         {
-            return epc_unparsed_error_result(0, "Failed to create parsing thread", "parsing thread created", "pthread_create failed");
+            bytes_read = -1;
+            break;
         }
 
-        // Producer Loop (Main Thread)
-        char read_buf[4096];
-        ssize_t bytes_read;
-        while ((bytes_read = read(input.fd, read_buf, sizeof(read_buf))) > 0)
+        bytes_read = read(input.fd, ctx->input.base + input_len, STREAM_READ_SIZE);
+        if (bytes_read <= 0)
         {
-            pthread_mutex_lock(&ctx->mutex);
-            
-            // Check if we have space in mmap buffer (100MB limit currently)
-            if (ctx->input_len + (size_t)bytes_read > MAX_MMAP_INPUT_SIZE)
-            {
-                ctx->input_error = EFBIG;
-                pthread_cond_broadcast(&ctx->cond);
-                pthread_mutex_unlock(&ctx->mutex);
-                break;
-            }
+            read_error = errno;
+            break;
+        }
+
+        input_len += (size_t)bytes_read;
+        atomic_store_explicit(&ctx->published_len, input_len, memory_order_seq_cst);
+        stream_wake_parser(ctx);
+    }
 
-            memcpy((void *)(ctx->input_start + ctx->input_len), read_buf, (size_t)bytes_read);
-            ctx->input_len += (size_t)bytes_read;
-            
-            pthread_cond_broadcast(&ctx->cond);
-            pthread_mutex_unlock(&ctx->mutex);
+    if (bytes_read == 0)
+    {
+        atomic_store(&ctx->is_eof, true);
+    }
+    else
+    {
+        atomic_store(&ctx->input_error, read_error != 0 ? read_error : EIO);
+    }
+    stream_wake_parser(ctx);
+
+    pthread_join(thread, NULL);
+    ctx->input_len = input_len;
+
+    return args.result;
+}
+#endif
+
+// Makes the result of the top parser the result of the session.
+static epc_parse_result_t
+parse_session_complete(epc_parser_ctx_t * ctx, epc_parse_result_t result)
+{
+    // After parsing, if an error occurred, check if the tracked "furthest_error"
+    // is more informative than the one that caused the final failure.
+    if (result.is_error)
+    {
+        epc_parser_error_t * furthest_error = parser_furthest_error_copy(ctx);
+
+        // A `furthest_error` is more informative if it parsed further into the input string.
+        if (furthest_error != NULL
+            && (result.data.error == NULL
+                || epc_parser_error_get_offset(furthest_error) > epc_parser_error_get_offset(result.data.error)))
+        {
+            // If it is, replace the result's error with the furthest one.
+            epc_parser_result_cleanup(&result);
+            result.is_error = true;
+            result.data.error = furthest_error;
+        }
+        else
+        {
+            // Otherwise, the original error is fine, so just free the copy of furthest_error.
+            epc_parser_error_free(furthest_error);
         }
 
-        pthread_mutex_lock(&ctx->mutex);
-        if (bytes_read == 0)
-        {
-            ctx->is_eof = true;
-        }
-        else if (bytes_read < 0)
-        {
-            ctx->input_error = errno;
-        }
-        pthread_cond_broadcast(&ctx->cond);
-        pthread_mutex_unlock(&ctx->mutex);
+        // This is the error the caller gets to see, so now build its strings and position.
+        epc_parser_error_materialize(ctx, result.data.error);
+    }
+
+    return result;
+}
+
+// Returns the compiled grammar the session should run, or NULL if it should run the top parser.
+static epc_compiled_grammar_t const *
+parse_ctx_program(epc_parser_ctx_t * ctx)
+{
+    epc_grammar_finalize(ctx->top_parser);
+
+    // The program is stale if the grammar has changed since it was compiled, and it doesn't use the memo table. It
+    // doesn't run most parsers through parse(), so they can't be profiled either.
+    if (ctx->compiled != NULL
+        && (ctx->memoize_all || parse_ctx_is_profiled(ctx)
+            || vm_grammar_generation(ctx->compiled) != epc_grammar_generation(ctx->top_parser)))
+    {
+        return NULL;
+    }
+
+    return ctx->compiled;
+}
 
-        pthread_join(thread, NULL);
+// Parses input that is all in the buffer already.
+static epc_parse_result_t
+parse_ctx_run(epc_parser_ctx_t * ctx, epc_compiled_grammar_t const * compiled)
+{
+    if (compiled != NULL)
+    {
+        return vm_parse(compiled, ctx);
+    }
 
-        return args.result;
+    return epc_parser_parse(ctx->top_parser, ctx, 0);
 }
-#endif
 
-EASY_PC_HIDDEN epc_parse_session_t
-epc_parse_input(epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx)
+static epc_parse_session_t
+parse_session_run(
+    epc_parser_t * top_parser,
+    epc_compiled_grammar_t const * compiled,
+    epc_parse_input_t input,
+    void * user_ctx,
+    epc_parse_options_t const * options,
+    epc_ast_builder_ctx_t * ast_builder
+)
 {
     epc_parse_session_t session = {0};
 
@@ -532,7 +1056,11 @@ epc_parse_input(epc_parser_t * top_parser, epc_parse_input_t input, void * user_
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
     case EPC_PARSE_TYPE_FD:
-        ctx = internal_create_parse_ctx_streaming();
+        ctx = internal_create_parse_ctx_streaming(false);
+        break;
+
+    case EPC_PARSE_TYPE_PUSH:
+        ctx = internal_create_parse_ctx_streaming(true);
         break;
 #endif
 
@@ -549,43 +1077,96 @@ epc_parse_input(epc_parser_t * top_parser, epc_parse_input_t input, void * user_
     }
     session.internal_parse_ctx = ctx;
     ctx->user_ctx = user_ctx;
-
+    if (options != NULL)
+    {
+        ctx->memoize_all = options->memoize;
+        memo_table_init(&ctx->memo, options->memo_budget);
+        ctx->thread_count = options->thread_count;
+#ifdef WITH_PARSE_PROFILING
+        if (options->profile)
+        {
+            ctx->profile = malloc(sizeof(*ctx->profile));
+            if (ctx->profile == NULL)
+            {
+                internal_destroy_parse_ctx(ctx);
+                session.internal_parse_ctx = NULL;
+                session.result
+                    = epc_unparsed_error_result(0, "Failed to create parse context.", "valid parse context", "NULL");
+                return session;
+            }
+            profile_init(ctx->profile);
+        }
+#endif
+    }
+    ctx->ast_builder = ast_builder;
+    ctx->top_parser = top_parser;
+    ctx->compiled = compiled;
+    compiled = parse_ctx_program(ctx);
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
+    if (ctx->is_push)
+    {
+        // The parse starts with the first epc_parse_feed() or epc_parse_finish().
+        ctx->push_args = (ParsingThreadArgs){
+            .top_parser = top_parser,
+            .compiled = compiled,
+            .ctx = ctx,
+        };
+        ctx->push_parse = coroutine_create(push_parse_main, &ctx->push_args);
+        if (ctx->push_parse == NULL)
+        {
+            internal_destroy_parse_ctx(ctx);
+            session.internal_parse_ctx = NULL;
+            session.result = epc_unparsed_error_result(
+                0, "Failed to create parsing coroutine", "parsing coroutine created", "coroutine_create failed"
+            );
+        }
+        return session;
+    }
     if (ctx->is_streaming)
     {
-        session.result = parse_in_thread(top_parser, ctx, input);
+        session.result = parse_in_thread(top_parser, compiled, ctx, input);
     }
     else
 #endif
     {
-        session.result = top_parser->parse_fn(top_parser, ctx, 0);
+        session.result = parse_ctx_run(ctx, compiled);
     }
 
-    // After parsing, if an error occurred, check if the tracked "furthest_error"
-    // is more informative than the one that caused the final failure.
-    if (session.result.is_error)
-    {
-        epc_parser_error_t * furthest_error = parser_furthest_error_copy(ctx);
+    session.result = parse_session_complete(ctx, session.result);
 
-        // A `furthest_error` is more informative if it parsed further into the input string.
-        if (furthest_error != NULL
-            && (session.result.data.error == NULL
-                || furthest_error->input_position > session.result.data.error->input_position))
-        {
-            // If it is, replace the result's error with the furthest one.
-            epc_parser_result_cleanup(&session.result);
-            session.result.is_error = true;
-            session.result.data.error = furthest_error;
-        }
-        else
-        {
-            // Otherwise, the original error is fine, so just free the copy of furthest_error.
-            epc_parser_error_free(furthest_error);
-        }
+    return session;
+}
+
+EASY_PC_HIDDEN epc_parse_session_t
+epc_parse_input(
+    epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx, epc_parse_options_t const * options
+)
+{
+    return parse_session_run(top_parser, NULL, input, user_ctx, options, NULL);
+}
+
+EASY_PC_HIDDEN epc_parse_session_t
+epc_parse_input_building_ast(
+    epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx, epc_ast_builder_ctx_t * ast_builder
+)
+{
+    return parse_session_run(top_parser, NULL, input, user_ctx, NULL, ast_builder);
+}
+
+EASY_PC_API epc_parse_session_t
+epc_parse_compiled(
+    epc_compiled_grammar_t const * grammar, epc_parse_input_t input, void * user_ctx, epc_parse_options_t const * options
+)
+{
+    if (grammar == NULL)
+    {
+        return (epc_parse_session_t){
+            .result = epc_unparsed_error_result(0, "Compiled grammar is NULL", "compiled grammar", "NULL"),
+        };
     }
 
-    return session;
+    return parse_session_run(vm_grammar_top_parser(grammar), grammar, input, user_ctx, options, NULL);
 }
 
 EASY_PC_API epc_parse_session_t
@@ -593,7 +1174,7 @@ epc_parse_str(epc_parser_t * top_parser, char const * input_string, void * user_
 {
     epc_parse_input_t input = {.type = EPC_PARSE_TYPE_STRING, .input_string = input_string};
     
-    return epc_parse_input(top_parser, input, user_ctx);
+    return epc_parse_input(top_parser, input, user_ctx, NULL);
 }
 
 EASY_PC_API epc_parse_session_t
@@ -601,14 +1182,14 @@ epc_parse_fp(epc_parser_t * top_parser, FILE * fp, void * user_ctx)
 {
     epc_parse_input_t input = {.type = EPC_PARSE_TYPE_FILE, .fp = fp};
     
-    return epc_parse_input(top_parser, input, user_ctx);
+    return epc_parse_input(top_parser, input, user_ctx, NULL);
 }
 
 EASY_PC_API epc_parse_session_t epc_parse_file(epc_parser_t * top_parser, char const * filename, void * user_ctx)
 {
     epc_parse_input_t input = {.type = EPC_PARSE_TYPE_FILENAME, .filename = filename};
     
-    return epc_parse_input(top_parser, input, user_ctx);
+    return epc_parse_input(top_parser, input, user_ctx, NULL);
 }
 
 #ifdef WITH_INPUT_STREAM_SUPPORT
@@ -617,9 +1198,144 @@ epc_parse_fd(epc_parser_t * top_parser, int fd, void * user_ctx)
 {
     epc_parse_input_t input = {.type = EPC_PARSE_TYPE_FD, .fd = fd};
 
-    return epc_parse_input(top_parser, input, user_ctx);
+    return epc_parse_input(top_parser, input, user_ctx, NULL);
+}
+
+EASY_PC_API epc_parse_session_t
+epc_parse_start(epc_parser_t * top_parser, void * user_ctx)
+{
+    epc_parse_input_t input = {.type = EPC_PARSE_TYPE_PUSH};
+
+    return epc_parse_input(top_parser, input, user_ctx, NULL);
+}
+
+// Continues a pushed parse until it needs more input or is done.
+static epc_parse_status_t
+push_parse_resume(epc_parse_session_t * session)
+{
+    epc_parser_ctx_t * ctx = session->internal_parse_ctx;
+
+    if (!coroutine_resume(ctx->push_parse))
+    {
+        return EPC_PARSE_STATUS_NEED_INPUT;
+    }
+    coroutine_free(ctx->push_parse);
+    ctx->push_parse = NULL;
+    session->result = parse_session_complete(ctx, ctx->push_args.result);
+
+    return EPC_PARSE_STATUS_DONE;
+}
+
+EASY_PC_API epc_parse_status_t
+epc_parse_feed(epc_parse_session_t * session, char const * data, size_t len)
+{
+    epc_parser_ctx_t * ctx = session != NULL ? session->internal_parse_ctx : NULL;
+
+    // Not a pushed parse, or one that is already done.
+    if (ctx == NULL || ctx->push_parse == NULL)
+    {
+        return EPC_PARSE_STATUS_DONE;
+    }
+
+    if (data != NULL && len > 0 && !ctx->is_eof)
+    {
+        if (input_buffer_commit(&ctx->input, ctx->input_len + len))
+        {
+            memcpy(ctx->input.base + ctx->input_len, data, len);
+            ctx->input_len += len;
+        }
+        else
+        {
+            ctx->input_error = errno;
+        }
+    }
+
+    return push_parse_resume(session);
+}
+
+EASY_PC_API epc_parse_status_t
+epc_parse_finish(epc_parse_session_t * session)
+{
+    epc_parser_ctx_t * ctx = session != NULL ? session->internal_parse_ctx : NULL;
+
+    if (ctx == NULL || ctx->push_parse == NULL)
+    {
+        return EPC_PARSE_STATUS_DONE;
+    }
+    ctx->is_eof = true;
+
+    return push_parse_resume(session);
+}
+#endif
+
+EASY_PC_API epc_parse_session_t
+epc_parse_with_options(
+    epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx, epc_parse_options_t const * options
+)
+{
+    return epc_parse_input(top_parser, input, user_ctx, options);
 }
+
+// Forgets everything about the previous input, keeping the memory that held it.
+static void
+parse_ctx_reset(epc_parser_ctx_t * ctx)
+{
+    epc_parser_error_free(ctx->furthest_error);
+    ctx->furthest_error = NULL;
+    memo_table_reset(&ctx->memo);
+    line_index_reset(&ctx->line_index);
+    arena_reset(&ctx->arena);
+#ifdef WITH_PARSE_PROFILING
+    if (ctx->profile != NULL)
+    {
+        profile_reset(ctx->profile);
+    }
 #endif
+}
+
+EASY_PC_API bool
+epc_parse_session_reset(epc_parse_session_t * session, char const * input_string)
+{
+    if (session == NULL)
+    {
+        return false;
+    }
+
+    epc_parser_ctx_t * ctx = session->internal_parse_ctx;
+
+    // The previous tree is in the arena, so it has to go first.
+    epc_parser_result_cleanup(&session->result);
+
+    if (ctx == NULL || !ctx->is_resettable)
+    {
+        session->result = epc_unparsed_error_result(
+            0, "Session can't be reset", "session parsing a string", "session parsing another kind of input"
+        );
+        return false;
+    }
+    if (input_string == NULL)
+    {
+        session->result = epc_unparsed_error_result(0, "Input string is NULL", "non-NULL input string", "NULL");
+        return false;
+    }
+
+    size_t const input_len = strlen(input_string);
+
+    if (!input_buffer_reuse_fixed(&ctx->input, input_len + 1))
+    {
+        session->result
+            = epc_unparsed_error_result(0, "Failed to create parse context.", "valid parse context", "NULL");
+        return false;
+    }
+    parse_ctx_reset(ctx);
+    memcpy(ctx->input.base, input_string, input_len + 1);
+    ctx->input_start = ctx->input.base;
+    ctx->input_len = input_len;
+
+    session->result = parse_session_complete(ctx, parse_ctx_run(ctx, parse_ctx_program(ctx)));
+
+    return true;
+}
 
 EASY_PC_API void
 epc_parse_session_destroy(epc_parse_session_t * session)
@@ -638,6 +1354,89 @@ epc_parse_session_destroy(epc_parse_session_t * session)
     }
 }
 
+EASY_PC_API size_t
+epc_parse_session_profile_report(
+    epc_parse_session_t const * session, epc_profile_order_t order, size_t n, epc_parser_profile_t top[], FILE * fp
+)
+{
+#ifdef WITH_PARSE_PROFILING
+    if (session == NULL || session->internal_parse_ctx == NULL || session->internal_parse_ctx->profile == NULL)
+    {
+        return 0;
+    }
+
+    profile_t const * profile = session->internal_parse_ctx->profile;
+
+    if (n > profile->count)
+    {
+        n = profile->count;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    epc_parser_profile_t * ranked = top != NULL ? top : malloc(n * sizeof(*ranked));
+    if (ranked == NULL)
+    {
+        return 0;
+    }
+    n = profile_top(profile, order, n, ranked);
+
+    if (fp != NULL)
+    {
+        fprintf(
+            fp,
+            "%-24s %12s %12s %12s %14s %14s %14s %14s\n",
+            "parser",
+            "calls",
+            "matched",
+            "failed",
+            "consumed",
+            "backtracked",
+            "inclusive ns",
+            "exclusive ns"
+        );
+        for (size_t i = 0; i < n; i++)
+        {
+            epc_parser_profile_t const * counts = &ranked[i];
+
+            fprintf(
+                fp,
+                "%-24s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %14" PRIu64 " %14" PRIu64 " %14" PRIu64 " %14" PRIu64
+                "\n",
+                counts->name != NULL ? counts->name : "?",
+                counts->invocations,
+                counts->successes,
+                counts->failures,
+                counts->bytes_consumed,
+                counts->backtracked_bytes,
+                counts->inclusive_ns,
+                counts->exclusive_ns
+            );
+        }
+        if (profile->is_out_of_memory)
+        {
+            fprintf(fp, "(some parsers weren't counted, as there wasn't the memory to)\n");
+        }
+    }
+    if (ranked != top)
+    {
+        free(ranked);
+    }
+
+    return n;
+#else
+    (void)session;
+    (void)order;
+    (void)n;
+    (void)top;
+    (void)fp;
+
+    return 0;
+#endif
+}
+
 EASY_PC_API
 void
 epc_parse_session_print_cpt(FILE * fp, epc_parse_session_t const * session)
@@ -685,6 +1484,126 @@ epc_node_alloc(epc_parser_t * parser, char const * tag)
     return node;
 }
 
+EASY_PC_HIDDEN
+epc_cpt_node_t *
+parse_ctx_node_alloc(epc_parser_ctx_t * ctx, epc_parser_t * parser, char const * tag)
+{
+    epc_cpt_node_t * node = arena_alloc(&ctx->arena, sizeof(*node));
+    if (node == NULL)
+    {
+        return NULL;
+    }
+    node->content = ""; /* Make non-NULL. */
+    node->tag = tag;
+    node->name = parser->name;
+    node->ast_config = parser->ast_config;
+    node->is_arena_node = true;
+
+    return node;
+}
+
+EASY_PC_HIDDEN
+epc_cpt_node_t *
+parse_ctx_nodes_alloc(epc_parser_ctx_t * ctx, epc_parser_t * parser, char const * tag, size_t count)
+{
+    epc_cpt_node_t * nodes = arena_alloc(&ctx->arena, count * sizeof(*nodes));
+    if (nodes == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        nodes[i].content = "";
+        nodes[i].tag = tag;
+        nodes[i].name = parser->name;
+        nodes[i].ast_config = parser->ast_config;
+        nodes[i].is_arena_node = true;
+    }
+
+    return nodes;
+}
+
+EASY_PC_HIDDEN
+epc_cpt_node_t **
+parse_ctx_children_alloc(epc_parser_ctx_t * ctx, size_t count)
+{
+    return arena_alloc(&ctx->arena, count * sizeof(epc_cpt_node_t *));
+}
+
+EASY_PC_HIDDEN
+epc_cpt_node_t **
+parse_ctx_children_realloc(epc_parser_ctx_t * ctx, epc_cpt_node_t ** children, size_t old_count, size_t new_count)
+{
+    return arena_realloc(
+        &ctx->arena, children, old_count * sizeof(epc_cpt_node_t *), new_count * sizeof(epc_cpt_node_t *)
+    );
+}
+
+EASY_PC_HIDDEN
+parse_ctx_mark_t
+parse_ctx_mark(epc_parser_ctx_t const * ctx)
+{
+    return (parse_ctx_mark_t){.arena = arena_mark(&ctx->arena), .success_stores = ctx->memo.success_stores};
+}
+
+EASY_PC_HIDDEN
+bool
+parse_ctx_reclaim(epc_parser_ctx_t * ctx, parse_ctx_mark_t const * mark)
+{
+    if (ctx->memo.success_stores != mark->success_stores
+        && memo_table_keep(&ctx->memo, mark->success_stores, mark->arena.allocated, ctx->arena.allocated))
+    {
+        return false;
+    }
+    arena_rollback(&ctx->arena, mark->arena);
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+epc_cpt_node_t *
+parse_ctx_token_node(epc_parser_ctx_t * ctx, epc_cpt_node_t * node, parse_ctx_mark_t const * mark)
+{
+    if (node->children_count == 0)
+    {
+        return node;
+    }
+
+    // Copied first, as reclaiming the subtree may release `node` itself.
+    epc_cpt_node_t leaf = *node;
+
+    leaf.children = NULL;
+    leaf.children_count = 0;
+    if (mark != NULL)
+    {
+        parse_ctx_reclaim(ctx, mark);
+    }
+
+    epc_cpt_node_t * token = arena_alloc(&ctx->arena, sizeof(*token));
+    if (token != NULL)
+    {
+        *token = leaf;
+    }
+
+    return token;
+}
+
+// Only used for the subtrees that an explicit stack couldn't be grown for.
+static void
+epc_node_free_recursive(epc_cpt_node_t * node)
+{
+    if (node == NULL || node->is_arena_node)
+    {
+        return;
+    }
+    for (int i = 0; node->children != NULL && i < node->children_count; i++)
+    {
+        epc_node_free_recursive(node->children[i]);
+    }
+    free(node->children);
+    free(node);
+}
+
 EASY_PC_HIDDEN
 void
 epc_node_free(epc_cpt_node_t * node)
@@ -693,15 +1612,38 @@ epc_node_free(epc_cpt_node_t * node)
     {
         return;
     }
-    if (node->children != NULL)
+    if (node->is_arena_node)
+    {
+        /* Nodes created during a parse live in the session arena and are released along with it. */
+        return;
+    }
+
+    // Each node is freed once its children are.
+    cpt_walk_t walk;
+
+    cpt_walk_init(&walk);
+    cpt_walk_push(&walk, node); // Can't fail while the stack is inline.
+    while (walk.count > 0)
     {
-        for (int i = 0; i < node->children_count; i++)
+        cpt_walk_frame_t * frame = &walk.frames[walk.count - 1];
+        epc_cpt_node_t * current = frame->node;
+
+        if (current->children == NULL || frame->next_child == current->children_count)
+        {
+            free(current->children);
+            free(current);
+            walk.count--;
+            continue;
+        }
+
+        epc_cpt_node_t * child = current->children[frame->next_child++];
+
+        if (child != NULL && !child->is_arena_node && !cpt_walk_push(&walk, child))
         {
-            epc_node_free(node->children[i]);
+            epc_node_free_recursive(child);
         }
-        free(node->children);
     }
-    free(node);
+    cpt_walk_release(&walk);
 }
 
 EASY_PC_HIDDEN
@@ -846,3 +1788,14 @@ epc_cpt_node_get_len(epc_cpt_node_t * node)
 
     return node->len;
 }
+
+int
+epc_cpt_node_get_keyword_index(epc_cpt_node_t const * node)
+{
+    if (node == NULL)
+    {
+        return -1;
+    }
+
+    return (int)node->keyword - 1;
+}
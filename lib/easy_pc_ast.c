@@ -116,6 +116,14 @@ epc_ast_builder_ctx_cleanup(epc_ast_builder_ctx_t * ctx)
     ctx->stack = NULL;
     ctx->top = 0;
     ctx->capacity = 0;
+    free(ctx->built);
+    ctx->built = NULL;
+    ctx->built_count = 0;
+    ctx->built_capacity = 0;
+    free(ctx->frames);
+    ctx->frames = NULL;
+    ctx->frame_count = 0;
+    ctx->frame_capacity = 0;
 }
 
 EASY_PC_API
@@ -290,6 +298,9 @@ epc_ast_builder_enter_node_cb(epc_cpt_node_t * node, void * user_data)
     }
 }
 
+static void
+epc_ast_builder_apply(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int children_count);
+
 static void
 epc_ast_builder_exit_node_cb(epc_cpt_node_t * node, void * user_data)
 {
@@ -309,6 +320,14 @@ epc_ast_builder_exit_node_cb(epc_cpt_node_t * node, void * user_data)
         return;
     }
 
+    epc_ast_builder_apply(ctx, node, children, children_count);
+}
+
+// Runs the action for `node` on the AST nodes of its children, which have been taken off the stack, and frees the
+// `children` array.
+static void
+epc_ast_builder_apply(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int children_count)
+{
     bool has_action_assigned = node->ast_config.assigned && node->ast_config.action >= 0
                                && node->ast_config.action < ctx->registry->action_count;
 
@@ -336,8 +355,269 @@ epc_ast_builder_exit_node_cb(epc_cpt_node_t * node, void * user_data)
     free(children);
 }
 
+// --- AST Building During the Parse ---
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+ast_builder_mark_t
+ast_builder_mark(epc_ast_builder_ctx_t const * ctx)
+{
+    return (ast_builder_mark_t){.top = ctx->top, .built_count = ctx->built_count, .has_error = ctx->has_error};
+}
+
+static void
+epc_ast_builder_free_items(epc_ast_builder_ctx_t * ctx, int from, int to)
+{
+    if (ctx->registry->free_node == NULL)
+    {
+        return;
+    }
+    for (int i = from; i < to; i++)
+    {
+        if (ctx->stack[i].type == EPC_AST_ITEM_USER_NODE && ctx->stack[i].ptr != NULL)
+        {
+            ctx->registry->free_node(ctx->stack[i].ptr, ctx->user_data);
+        }
+    }
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2)
+void
+ast_builder_rollback(epc_ast_builder_ctx_t * ctx, ast_builder_mark_t const * mark)
+{
+    epc_ast_builder_free_items(ctx, mark->top, ctx->top);
+    ctx->top = mark->top;
+    ctx->built_count = mark->built_count;
+    if (!mark->has_error)
+    {
+        ctx->has_error = false;
+        ctx->error_message[0] = '\0';
+    }
+}
+
+static bool
+epc_ast_builder_push_frame(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node)
+{
+    if (ctx->frame_count == ctx->frame_capacity)
+    {
+        size_t const new_capacity = ctx->frame_capacity == 0 ? EPC_AST_BUILDER_INITIAL_STACK_CAPACITY
+                                                              : ctx->frame_capacity * 2;
+        epc_ast_build_frame_t * grown = realloc(ctx->frames, new_capacity * sizeof(*grown));
+
+        if (grown == NULL)
+        {
+            epc_ast_builder_set_error(ctx, "Failed to grow the node stack (realloc failed).");
+            return false;
+        }
+        ctx->frames = grown;
+        ctx->frame_capacity = new_capacity;
+    }
+    ctx->frames[ctx->frame_count++] = (epc_ast_build_frame_t){.node = node, .next_child = 0, .first = ctx->top};
+
+    return true;
+}
+
+// Finds `node` among the nodes built from `*next` on, and moves `*next` past it. Most of the nodes looked for were
+// never built, such as those of a chain that a parser built itself, and are ruled out without a search.
+static epc_ast_built_node_t const *
+epc_ast_builder_find_built(epc_ast_builder_ctx_t const * ctx, epc_cpt_node_t const * node, size_t * next)
+{
+    if (!node->is_ast_built)
+    {
+        return NULL;
+    }
+    for (size_t i = *next; i < ctx->built_count; i++)
+    {
+        if (ctx->built[i].node == node)
+        {
+            *next = i + 1;
+            return &ctx->built[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Runs the actions for `node` on the items from `first` to the top of the stack, which its children resulted in.
+static void
+epc_ast_builder_reduce_items(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, int first)
+{
+    if (ctx->has_error)
+    {
+        return;
+    }
+    if (ctx->registry->enter_node != NULL)
+    {
+        ctx->registry->enter_node(ctx, node, ctx->user_data);
+    }
+
+    int const children_count = ctx->top - first;
+    void ** children = NULL;
+
+    if (children_count > 0)
+    {
+        children = calloc(children_count, sizeof(*children));
+        if (children == NULL)
+        {
+            epc_ast_builder_set_error(ctx, "Failed to allocate children array.");
+            return;
+        }
+        for (int i = 0; i < children_count; i++)
+        {
+            children[i] = ctx->stack[first + i].ptr;
+        }
+    }
+    ctx->top = first;
+    epc_ast_builder_apply(ctx, node, children, children_count);
+}
+
+// Runs the actions for `node`, leaving the items it results in on top of the stack. The items of children that were
+// built already are moved from where they are on the stack, leaving placeholders behind; the others are built now.
+// Nested nodes are walked with an explicit stack, as a chain of nodes that a parser built itself can be long.
+static void
+epc_ast_builder_build(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, size_t * next_built)
+{
+    size_t const base = ctx->frame_count;
+
+    if (!epc_ast_builder_push_frame(ctx, node))
+    {
+        return;
+    }
+    while (ctx->frame_count > base && !ctx->has_error)
+    {
+        epc_ast_build_frame_t * frame = &ctx->frames[ctx->frame_count - 1];
+
+        if (frame->next_child == frame->node->children_count)
+        {
+            epc_ast_builder_reduce_items(ctx, frame->node, frame->first);
+            ctx->frame_count--;
+            continue;
+        }
+
+        epc_cpt_node_t * child = frame->node->children[frame->next_child++];
+        epc_ast_built_node_t const * built = epc_ast_builder_find_built(ctx, child, next_built);
+
+        if (built == NULL)
+        {
+            epc_ast_builder_push_frame(ctx, child);
+            continue;
+        }
+
+        int const first = built->first;
+        int const last = built->first + built->count;
+
+        for (int i = first; i < last; i++)
+        {
+            void * item = ctx->stack[i].ptr;
+
+            ctx->stack[i] = (epc_ast_stack_entry_t){.type = EPC_AST_ITEM_PLACEHOLDER, .ptr = NULL};
+            epc_ast_push(ctx, item);
+        }
+    }
+    ctx->frame_count = base;
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2, 3)
+void
+ast_builder_reduce(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, ast_builder_mark_t const * mark)
+{
+    if (ctx->has_error)
+    {
+        return;
+    }
+
+    // A parser may return the node of a child as its own, whose actions have run already.
+    size_t next_built = mark->built_count;
+    epc_ast_built_node_t const * built = epc_ast_builder_find_built(ctx, node, &next_built);
+    int first = ctx->top;
+    int count;
+
+    if (built != NULL)
+    {
+        first = built->first;
+        count = built->count;
+    }
+    else
+    {
+        epc_ast_builder_build(ctx, node, &next_built);
+        count = ctx->top - first;
+    }
+    if (ctx->has_error)
+    {
+        return;
+    }
+
+    // Whatever else was pushed since the mark came from matches that aren't part of the node.
+    epc_ast_builder_free_items(ctx, mark->top, first);
+    epc_ast_builder_free_items(ctx, first + count, ctx->top);
+    memmove(&ctx->stack[mark->top], &ctx->stack[first], (size_t)count * sizeof(*ctx->stack));
+    ctx->top = mark->top + count;
+    ctx->built_count = mark->built_count;
+}
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2, 3)
+void
+ast_builder_record(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, ast_builder_mark_t const * mark)
+{
+    if (ctx->has_error)
+    {
+        return;
+    }
+    if (ctx->built_count == ctx->built_capacity)
+    {
+        size_t const new_capacity = ctx->built_capacity == 0 ? EPC_AST_BUILDER_INITIAL_STACK_CAPACITY
+                                                              : ctx->built_capacity * 2;
+        epc_ast_built_node_t * grown = realloc(ctx->built, new_capacity * sizeof(*grown));
+
+        if (grown == NULL)
+        {
+            epc_ast_builder_set_error(ctx, "Failed to grow the list of built nodes (realloc failed).");
+            return;
+        }
+        ctx->built = grown;
+        ctx->built_capacity = new_capacity;
+    }
+    node->is_ast_built = true;
+    ctx->built[ctx->built_count++] = (epc_ast_built_node_t){
+        .node = node,
+        .first = mark->top,
+        .count = ctx->top - mark->top,
+    };
+}
+
 // --- Public AST Building API ---
 
+// Takes the root of the AST off the stack once every node has been built.
+static epc_ast_result_t
+epc_ast_builder_take_result(epc_ast_builder_ctx_t * ctx)
+{
+    epc_ast_result_t result = {0};
+
+    if (!ctx->has_error && ctx->top == 1)
+    {
+        // The single remaining item on the stack is the root of the AST
+        result.ast_root = ctx->stack[0].ptr;
+        ctx->stack[0].ptr = NULL; // Ownership transferred
+    }
+    else if (!ctx->has_error && ctx->top > 1)
+    {
+        epc_ast_builder_set_error(ctx, "AST stack not empty after build. Multiple roots or unhandled nodes remain.");
+    }
+    // If ctx->top == 0, it means the AST was completely pruned or empty, ast_root remains NULL.
+
+    if (ctx->has_error)
+    {
+        result.has_error = true;
+        memcpy(result.error_message, ctx->error_message, sizeof(result.error_message));
+        result.error_message[sizeof(result.error_message) - 1] = '\0';
+    }
+
+    return result;
+}
+
 EASY_PC_API epc_ast_result_t
 epc_ast_build(epc_cpt_node_t * root, epc_ast_hook_registry_t * registry, void * user_data)
 {
@@ -365,36 +645,44 @@ epc_ast_build(epc_cpt_node_t * root, epc_ast_hook_registry_t * registry, void *
 
     epc_cpt_visit_nodes(root, &ast_builder_visitor);
 
-    if (ctx.has_error)
-    {
-        result.has_error = true;
-        memcpy(result.error_message, ctx.error_message, sizeof(result.error_message));
-        result.error_message[sizeof(result.error_message) - 1] = '\0';
-        epc_ast_builder_ctx_cleanup(&ctx); // Cleanup allocated nodes on stack
-        return result;
-    }
-
-    if (ctx.top == 1)
-    {
-        // The single remaining item on the stack is the root of the AST
-        result.ast_root = ctx.stack[0].ptr;
-        ctx.stack[0].ptr = NULL; // Ownership transferred
-    }
-    else if (ctx.top > 1)
-    {
-        epc_ast_builder_set_error(&ctx, "AST stack not empty after build. Multiple roots or unhandled nodes remain.");
-        result.has_error = true;
-        memcpy(result.error_message, ctx.error_message, sizeof(result.error_message));
-        result.error_message[sizeof(result.error_message) - 1] = '\0';
-        epc_ast_builder_ctx_cleanup(&ctx);
-        return result;
-    }
-    // If ctx.top == 0, it means the AST was completely pruned or empty, ast_root remains NULL.
-
+    result = epc_ast_builder_take_result(&ctx);
     epc_ast_builder_ctx_cleanup(&ctx); // Frees stack memory, but not the root node if transferred
     return result;
 }
 
+// Describes the error that a parse failed with.
+static char *
+epc_parse_error_message(epc_parse_session_t const * parse_session)
+{
+    char const * input = parse_ctx_get_input_start(parse_session->internal_parse_ctx);
+    if (input == NULL)
+    {
+        input = ""; // Fallback to empty string if we can't get input position
+    }
+    size_t input_len = strlen(input);
+    char * msg = NULL;
+    // The error structure from the parser has all the necessary details.
+    epc_parser_error_t * err = parse_session->result.data.error;
+    int len = asprintf(
+        &msg,
+        "Parse error: %s at '%.*s' (expected '%s', found '%.*s')Error err: line: %zu, col: %zu",
+        err->message,
+        (int)(input + input_len - err->input_position),
+        err->input_position,
+        err->expected ? err->expected : "N/A",
+        (int)strlen(err->found),
+        err->found ? err->found : "N/A",
+        err->position.line,
+        err->position.col
+    );
+    if (len < 0)
+    {
+        return strdup("Failed to allocate memory for parse error message.");
+    }
+
+    return msg;
+}
+
 EASY_PC_API epc_compile_result_t
 epc_parse_and_build_ast(
     epc_parser_t * parser,
@@ -406,40 +694,12 @@ epc_parse_and_build_ast(
 )
 {
     epc_compile_result_t result = {0};
-    epc_parse_session_t parse_session = epc_parse_input(parser, input, parse_user_data);
+    epc_parse_session_t parse_session = epc_parse_input(parser, input, parse_user_data, NULL);
 
     if (parse_session.result.is_error)
     {
-        char const * input = parse_ctx_get_input_start(parse_session.internal_parse_ctx);
-        if (input == NULL)
-        {
-            input = ""; // Fallback to empty string if we can't get input position
-        }
-        size_t input_len = strlen(input);
         result.success = false;
-        char * msg = NULL;
-        // The error structure from the parser has all the necessary details.
-        epc_parser_error_t * err = parse_session.result.data.error;
-        int len = asprintf(
-            &msg,
-            "Parse error: %s at '%.*s' (expected '%s', found '%.*s')Error err: line: %zu, col: %zu",
-            err->message,
-            (int)(input + input_len - err->input_position),
-            err->input_position,
-            err->expected ? err->expected : "N/A",
-            (int)strlen(err->found),
-            err->found ? err->found : "N/A",
-            err->position.line,
-            err->position.col
-        );
-        if (len < 0)
-        {
-            result.parse_error_message = strdup("Failed to allocate memory for parse error message.");
-        }
-        else
-        {
-            result.parse_error_message = msg;
-        }
+        result.parse_error_message = epc_parse_error_message(&parse_session);
     }
     else
     {
@@ -477,6 +737,73 @@ epc_parse_and_build_ast(
     return result;
 }
 
+EASY_PC_API epc_compile_result_t
+epc_parse_to_ast(
+    epc_parser_t * parser,
+    epc_parse_input_t input,
+    int ast_action_count,
+    epc_ast_registry_init_cb registry_init_cb,
+    void * parse_user_data,
+    void * ast_user_data
+)
+{
+    epc_compile_result_t result = {0};
+
+#ifdef WITH_INPUT_STREAM_SUPPORT
+    if (input.type == EPC_PARSE_TYPE_PUSH)
+    {
+        result.parse_error_message = strdup("Pushed input can't be parsed to an AST in a single call.");
+        return result;
+    }
+#endif
+
+    epc_ast_hook_registry_t * ast_registry = epc_ast_hook_registry_create(ast_action_count);
+    if (ast_registry == NULL)
+    {
+        result.ast_error_message = strdup("Failed to create AST hook registry.");
+        return result;
+    }
+    if (registry_init_cb != NULL)
+    {
+        registry_init_cb(ast_registry);
+    }
+
+    epc_ast_builder_ctx_t ctx;
+    epc_ast_builder_ctx_init(&ctx, ast_registry, ast_user_data);
+    if (ctx.has_error)
+    {
+        result.ast_error_message = strdup(ctx.error_message);
+    }
+    else
+    {
+        epc_parse_session_t parse_session = epc_parse_input_building_ast(parser, input, parse_user_data, &ctx);
+
+        if (parse_session.result.is_error)
+        {
+            result.parse_error_message = epc_parse_error_message(&parse_session);
+        }
+        else
+        {
+            epc_ast_result_t ast_build_result = epc_ast_builder_take_result(&ctx);
+
+            if (ast_build_result.has_error)
+            {
+                result.ast_error_message = strdup(ast_build_result.error_message);
+            }
+            else
+            {
+                result.success = true;
+                result.ast = ast_build_result.ast_root;
+            }
+        }
+        epc_parse_session_destroy(&parse_session);
+    }
+
+    epc_ast_builder_ctx_cleanup(&ctx);
+    epc_ast_hook_registry_free(ast_registry);
+    return result;
+}
+
 EASY_PC_API void
 epc_compile_result_cleanup(epc_compile_result_t * result, epc_ast_node_free_cb ast_free_cb, void * user_data)
 {
@@ -1,7 +1,15 @@
 #pragma once
 
+#include "arena.h"
+#include "char_class.h"
+#include "first_set.h"
+#include "keyword_trie.h"
+#include "memo.h"
+#include "parse_error.h"
+
 #include <easy_pc/easy_pc.h>
 #include <easy_pc/easy_pc_ast.h> // Include the new AST header
+#include <easy_pc/easy_pc_direct.h>
 #include <stdarg.h>
 #include <stdbool.h>
 
@@ -30,6 +38,13 @@ struct epc_cpt_node_t
     epc_ast_semantic_action_t ast_config; /**< @brief A copy of the ast action assigned to the associated parser that
                                            *    created the node.
                                            */
+    bool is_arena_node; /**< @brief Set when the node (and its `children` array) belongs to a parse context arena. */
+    bool is_ast_built;  /**< @brief Set once the node has been recorded as built while the AST is built during the
+                         *    parse, so that the nodes a parser built itself needn't be looked for.
+                         */
+    uint16_t keyword;   /**< @brief For a node made by `epc_keywords()`, 1 + the index of the keyword it matched. Fits
+                         *    in what would otherwise be padding.
+                         */
 };
 
 // Internal types for AST builder stack management
@@ -45,6 +60,22 @@ typedef struct
     void * ptr; // Points to user's AST node or is NULL for a placeholder
 } epc_ast_stack_entry_t;
 
+// The AST stack items left by a CPT node whose actions have run while parsing.
+typedef struct epc_ast_built_node_t
+{
+    epc_cpt_node_t const * node;
+    int first; // Index on the stack of the first item.
+    int count;
+} epc_ast_built_node_t;
+
+// A CPT node whose actions are run during the parse, with the children it has had built so far.
+typedef struct epc_ast_build_frame_t
+{
+    epc_cpt_node_t * node;
+    int next_child;
+    int first; // Index on the stack of the first item of its children.
+} epc_ast_build_frame_t;
+
 struct epc_ast_builder_ctx_t
 {
     epc_ast_stack_entry_t * stack;
@@ -54,8 +85,57 @@ struct epc_ast_builder_ctx_t
     void * user_data;
     bool has_error;
     char error_message[512];
+
+    // When the AST is built during the parse, the nodes whose actions have run and whose parent hasn't been matched
+    // yet, in the order they were matched.
+    epc_ast_built_node_t * built;
+    size_t built_count;
+    size_t built_capacity;
+
+    // Nodes being built, whose actions can only run once their children's have. Kept for reuse between matches.
+    epc_ast_build_frame_t * frames;
+    size_t frame_count;
+    size_t frame_capacity;
 };
 
+// A point in a parse that builds the AST as it goes, which the AST stack can be rolled back to.
+typedef struct ast_builder_mark_t
+{
+    int top;
+    size_t built_count;
+    bool has_error;
+} ast_builder_mark_t;
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+ast_builder_mark_t ast_builder_mark(epc_ast_builder_ctx_t const * ctx);
+
+/**
+ * @brief Frees the AST nodes pushed since `mark`, for a parser that failed. An error set since is forgotten too.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2)
+void ast_builder_rollback(epc_ast_builder_ctx_t * ctx, ast_builder_mark_t const * mark);
+
+/**
+ * @brief Runs the actions for `node`, just matched by a parser that started at `mark`.
+ *
+ * The actions of the children that were matched through parse() have run already, and their items are taken from the
+ * stack. Those of children that a parser built itself run now. Items left by parsers that matched since `mark` but
+ * whose nodes aren't part of `node` are freed. The items `node` results in are left on the stack from `mark`.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2, 3)
+void ast_builder_reduce(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, ast_builder_mark_t const * mark);
+
+/**
+ * @brief Records that the items left on the stack from `mark` by ast_builder_reduce() belong to `node`, which may be
+ * a copy of the node that was reduced.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2, 3)
+void ast_builder_record(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, ast_builder_mark_t const * mark);
+
 typedef struct parse_get_input_result_t
 {
     char const * next_input;
@@ -69,9 +149,35 @@ parse_get_input_result_t parse_ctx_get_input_at_offset(epc_parser_ctx_t * ctx, s
 EASY_PC_HIDDEN
 bool parse_ctx_is_streaming(epc_parser_ctx_t const * ctx);
 
+// True once a pushed parse is being unwound because its session was destroyed.
+EASY_PC_HIDDEN
+bool parse_ctx_is_abandoned(epc_parser_ctx_t const * ctx);
+
 EASY_PC_HIDDEN
 bool parse_ctx_is_eof(epc_parser_ctx_t * ctx);
 
+#ifdef WITH_PARSE_PROFILING
+// The counts of a profiled parse, or NULL if the parse isn't profiled.
+EASY_PC_HIDDEN
+struct profile_t * parse_ctx_get_profile(epc_parser_ctx_t const * ctx);
+#endif
+
+// The number of threads a parser with a split predicate may use in this context, which is 1 if it can't be split.
+EASY_PC_HIDDEN
+size_t parse_ctx_split_thread_count(epc_parser_ctx_t const * ctx);
+
+// Creates a context for parsing a chunk of the input of `parent` on another thread. It reads the parent's input in
+// place, and doesn't split its own input any further.
+EASY_PC_HIDDEN
+epc_parser_ctx_t * parse_ctx_create_chunk(epc_parser_ctx_t const * parent);
+
+// Gives `ctx` the nodes built in a chunk's context, and the furthest error reached in it.
+EASY_PC_HIDDEN
+void parse_ctx_adopt_chunk(epc_parser_ctx_t * ctx, epc_parser_ctx_t * chunk);
+
+EASY_PC_HIDDEN
+void parse_ctx_destroy_chunk(epc_parser_ctx_t * chunk);
+
 static inline char const *
 parse_ctx_get_input_start(epc_parser_ctx_t * ctx)
 {
@@ -79,6 +185,15 @@ parse_ctx_get_input_start(epc_parser_ctx_t * ctx)
     return input_result.next_input;
 }
 
+// Returns all of the input that has arrived from `input_offset` onwards, waiting for at least one byte of it.
+// Terminators that run over many bytes scan the window in one go and only come back for another at its end.
+// is_eof is set if the input ends at `input_offset`.
+static inline parse_get_input_result_t
+parse_ctx_get_input_window(epc_parser_ctx_t * ctx, size_t input_offset)
+{
+    return parse_ctx_get_input_at_offset(ctx, input_offset, 1);
+}
+
 EASY_PC_HIDDEN
 size_t parse_ctx_get_input_len(epc_parser_ctx_t * const ctx);
 
@@ -90,10 +205,62 @@ EASY_PC_HIDDEN
 ATTR_NONNULL(1)
 epc_parser_error_t * parse_ctx_get_furthest_error(epc_parser_ctx_t const * ctx);
 
+// Returns the furthest error, leaving the context without one. The caller owns it.
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+epc_parser_error_t * parse_ctx_take_furthest_error(epc_parser_ctx_t * ctx);
+
 EASY_PC_HIDDEN
 ATTR_NONNULL(1)
 void parser_ctx_set_furthest_error(epc_parser_ctx_t * ctx, epc_parser_error_t ** replacement);
 
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+memo_table_t * parse_ctx_get_memo_table(epc_parser_ctx_t * ctx);
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+parse_error_pool_t * parse_ctx_get_error_pool(epc_parser_ctx_t * ctx);
+
+/**
+ * @brief Returns true if results of `parser` at `input_offset` should be memoized, either because the session runs in
+ * packrat mode or because memoization was enabled on the parser itself.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2)
+bool parse_ctx_should_memoize(epc_parser_ctx_t const * ctx, epc_parser_t const * parser, size_t input_offset);
+
+/**
+ * @brief Returns the AST builder whose actions are run as the parse goes, or NULL if the parse only builds a CPT. It is
+ * NULL while a left-recursive parser grows, as the actions only run on its final match.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+epc_ast_builder_ctx_t * parse_ctx_get_ast_builder(epc_parser_ctx_t const * ctx);
+
+/**
+ * @brief A left-recursive parser whose match at an offset is being grown. Calls to the parser at that offset while it
+ * grows get the longest match so far, its seed, rather than recursing.
+ */
+typedef struct left_recursion_t
+{
+    epc_parser_t const * parser;
+    size_t input_offset;
+    epc_cpt_node_t * seed; /**< @brief NULL until the parser has matched once. */
+    struct left_recursion_t * outer; /**< @brief The parser that was growing when this one started, if any. */
+} left_recursion_t;
+
+/**
+ * @brief Returns the innermost parser being grown, or NULL if none is.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+left_recursion_t * parse_ctx_get_left_recursion(epc_parser_ctx_t const * ctx);
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+void parse_ctx_set_left_recursion(epc_parser_ctx_t * ctx, left_recursion_t * left_recursion);
+
 // Structure for user-managed parser list
 struct epc_parser_list
 {
@@ -154,6 +321,22 @@ typedef struct
     void * parser_data;
 } wrap_data_t;
 
+typedef struct
+{
+    epc_direct_fn fn;        // The generated function for the top rule.
+    epc_parser_t * fallback; // The graph parser for the top rule.
+    epc_parser_t ** sites;   // The graph parsers that nodes are created for.
+    size_t site_count;
+} direct_data_t;
+
+typedef struct
+{
+    char ** keywords;
+    int count;
+    char * expected; // The keywords joined with " or ", for errors.
+    keyword_trie_t trie;
+} keywords_data_t;
+
 typedef enum parser_data_type_t
 {
     PARSER_DATA_TYPE_NONE,
@@ -167,6 +350,8 @@ typedef enum parser_data_type_t
     PARSER_DATA_TYPE_LEXEME,
     PARSER_DATA_TYPE_PREDICATE,
     PARSER_DATA_TYPE_WRAP,
+    PARSER_DATA_TYPE_DIRECT,
+    PARSER_DATA_TYPE_KEYWORDS,
 } parser_data_type_t;
 
 typedef struct parser_data_type_st
@@ -184,11 +369,38 @@ typedef struct parser_data_type_st
         lexeme_data_t lexeme;
         predicate_data_t predicate;
         wrap_data_t wrap;
+        direct_data_t direct;
+        keywords_data_t * keywords;
     };
 } parser_data_type_st;
 
 typedef epc_parse_result_t (*parse_fn_t)(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset);
 
+/**
+ * @brief Computes the FIRST set of a parser from its data and the FIRST sets of its children.
+ */
+typedef void (*first_set_fn_t)(struct epc_parser_t * self, first_set_t * first);
+
+/**
+ * @brief What finalizing a grammar works out about one of its parsers from the rest of the grammar.
+ * A plan isn't written to once it is published, as parses on other threads may be reading it. When the parser, or one
+ * it reaches, is redefined, finalizing builds a new plan and publishes it in place of the old one, which is kept
+ * until the parser is freed.
+ */
+typedef struct parser_plan_t parser_plan_t;
+
+struct parser_plan_t
+{
+    parser_plan_t * retired;  /**< @brief The next older plan of the same parser, once this one has been replaced. */
+    unsigned long generation; /**< @brief The grammar generation the plan was worked out at. */
+    first_set_t first_set;
+    bool is_left_recursive;   /**< @brief Where a left-recursive cycle is entered. Its matches are grown from a seed. */
+    char_class_t * run_class; /**< @brief epc_many/epc_plus of a single character parser only. The bytes it accepts. */
+    uint64_t * dispatch; /**< @brief epc_or only. For each byte, a bitmap of the alternatives that may match it. */
+    char_class_t run_class_storage;
+    uint64_t dispatch_storage[];
+};
+
 struct epc_parser_t
 {
     parse_fn_t parse_fn;
@@ -203,6 +415,26 @@ struct epc_parser_t
                                   */
 
     epc_ast_semantic_action_t ast_config;
+
+    bool memoize; /**< @brief Cache results of this parser even when the session is not in packrat mode. */
+    epc_split_fn split; /**< @brief epc_many/epc_delimited only. Where its input may be divided among threads. */
+    void * split_data;
+    bool is_token; /**< @brief Replace the subtree the parser builds with a single node without children. */
+
+    first_set_fn_t first_set_fn; /**< @brief NULL if the parser may match anything (e.g. a forward declaration). */
+    unsigned long defined_generation; /**< @brief The grammar generation at which the parser was last redefined. */
+    parser_plan_t * plan; /**< @brief NULL until the grammar is finalized. Only loaded and stored atomically. */
+    parser_plan_t * retired_plans; /**< @brief Plans that have been replaced, newest first. */
+    unsigned long checked_generation; /**< @brief The grammar generation at which finalizing last found every parser
+                                       * reachable from this one planned. Only loaded and stored atomically.
+                                       */
+
+    // Only used while the grammar is being finalized, which is done for one grammar at a time.
+    unsigned long walk_pass;
+    unsigned long reach_generation; /**< @brief The latest `defined_generation` of the parsers reachable from this one. */
+    parser_plan_t * pending_plan;   /**< @brief The plan being worked out, if the current one is out of date. */
+    bool first_set_computing; /**< @brief Set while the FIRST set is being computed, to detect left recursion. */
+    bool first_set_known;
 };
 
 struct epc_ast_hook_registry_t
@@ -215,8 +447,126 @@ struct epc_ast_hook_registry_t
 
 /**
  * @brief Initiates a parsing operation with a given grammar and input.
+ * @param options Session options, or NULL for the defaults.
  */
-EASY_PC_HIDDEN epc_parse_session_t epc_parse_input(epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx);
+EASY_PC_HIDDEN epc_parse_session_t epc_parse_input(
+    epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx, epc_parse_options_t const * options
+);
+
+/**
+ * @brief Parses as epc_parse_input() does, running the actions of `ast_builder` as each parser matches. The nodes
+ * below each match are reclaimed once its actions have run, so the CPT that results is a single leaf.
+ */
+EASY_PC_HIDDEN epc_parse_session_t epc_parse_input_building_ast(
+    epc_parser_t * top_parser, epc_parse_input_t input, void * user_ctx, epc_ast_builder_ctx_t * ast_builder
+);
+
+/**
+ * @brief The kinds of parser that the bytecode compiler lowers to instructions.
+ * Every other parser is run through its `parse_fn` from compiled code.
+ */
+typedef enum parser_kind_t
+{
+    PARSER_KIND_OTHER,
+    PARSER_KIND_CHAR,
+    PARSER_KIND_STRING,
+    PARSER_KIND_ANY,
+    PARSER_KIND_DIGIT,
+    PARSER_KIND_ALPHA,
+    PARSER_KIND_ALPHANUM,
+    PARSER_KIND_SPACE,
+    PARSER_KIND_HEX_DIGIT,
+    PARSER_KIND_CHAR_RANGE,
+    PARSER_KIND_ONE_OF,
+    PARSER_KIND_NONE_OF,
+    PARSER_KIND_EOI,
+    PARSER_KIND_SUCCEED,
+    PARSER_KIND_AND,
+    PARSER_KIND_OR,
+    PARSER_KIND_MANY,
+    PARSER_KIND_PLUS,
+    PARSER_KIND_OPTIONAL,
+    PARSER_KIND_COUNT,
+    PARSER_KIND_LOOKAHEAD,
+    PARSER_KIND_NOT,
+    PARSER_KIND_SKIP, // Not lowered; the grammar analysis tells it apart from other repetitions.
+    PARSER_KIND_KEYWORDS,
+} parser_kind_t;
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+parser_kind_t epc_parser_get_kind(epc_parser_t const * p);
+
+/**
+ * @brief Returns true if a parser that matches a single character (char, any, digit, alpha, alphanum, space,
+ * hex_digit, char_range, one_of and none_of) accepts `c`.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+bool epc_parser_accepts_char(epc_parser_t const * p, char c);
+
+/**
+ * @brief Runs a parser at `input_offset`, the way combinators run their children.
+ */
+EASY_PC_HIDDEN
+epc_parse_result_t epc_parser_parse(epc_parser_t * p, epc_parser_ctx_t * ctx, size_t input_offset);
+
+typedef void (*parser_visit_fn_t)(epc_parser_t * child, void * data);
+
+/**
+ * @brief Calls `visit` for each child of `p`, in order. NULL children are included.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2)
+void epc_parser_visit_children(epc_parser_t * p, parser_visit_fn_t visit, void * data);
+
+/**
+ * @brief Returns the plan finalizing published for a parser, or NULL if its grammar hasn't been finalized.
+ */
+EASY_PC_HIDDEN
+parser_plan_t const * epc_parser_get_plan(epc_parser_t const * p);
+
+/**
+ * @brief Returns true if a parser's matches are grown from a seed, as it is where a left-recursive cycle is entered.
+ */
+EASY_PC_HIDDEN
+bool epc_parser_is_left_recursive(epc_parser_t const * p);
+
+/**
+ * @brief Returns the FIRST set finalizing worked out for a parser. NULL parsers, and parsers whose grammar hasn't been
+ * finalized, may match anything.
+ */
+EASY_PC_HIDDEN
+first_set_t const * epc_parser_get_first_set(epc_parser_t * p);
+
+typedef first_set_t const * (*first_set_lookup_fn)(epc_parser_t * child, void * data);
+
+/**
+ * @brief Computes the FIRST set of `p` from the sets `lookup` gives for its children, rather than from their own.
+ * The grammar analysis finds FIRST sets as a fixed point this way, so that they aren't lost to left recursion.
+ * @return false if `p` has no FIRST set function, i.e. it may match anything.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2, 4)
+bool epc_parser_first_set_from(epc_parser_t * p, first_set_lookup_fn lookup, void * data, first_set_t * first);
+
+/**
+ * @brief Returns the grammar generation at which `top_parser`'s grammar was last finalized with a change to any of its
+ * parsers. It changes only when a parser reachable from `top_parser` is redefined with `epc_parser_duplicate()`.
+ */
+EASY_PC_HIDDEN
+unsigned long epc_grammar_generation(epc_parser_t const * top_parser);
+
+/**
+ * @brief Prepares a grammar for parsing.
+ * Plans every parser reachable from `top_parser`: its FIRST set, whether it is where a left-recursive cycle is
+ * entered, and the tables `epc_or` and `epc_many` use to skip alternatives and scan runs of characters. The work is
+ * only done the first time a grammar is parsed, and then only for the parsers that reach one redefined with
+ * `epc_parser_duplicate()` since. Plans are published whole, so grammars may be finalized while others, even ones
+ * sharing parsers with them, are parsed on other threads.
+ */
+EASY_PC_HIDDEN
+void epc_grammar_finalize(epc_parser_t * top_parser);
 
 EASY_PC_HIDDEN
 epc_parse_result_t
@@ -231,19 +581,122 @@ epc_cpt_node_t * epc_node_alloc(epc_parser_t * parser, char const * const tag);
 EASY_PC_HIDDEN
 void epc_node_free(epc_cpt_node_t * node);
 
+// A point in a parse that the nodes allocated since can be reclaimed back to.
+typedef struct parse_ctx_mark_t
+{
+    arena_mark_t arena;
+    size_t success_stores; // Of the memo table.
+} parse_ctx_mark_t;
+
+/**
+ * @brief Allocates a CPT node from the parse context's arena.
+ * Arena nodes are not freed individually; they are released when the session is destroyed, or earlier if the
+ * arena is rolled back past them.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2, 3)
+epc_cpt_node_t * parse_ctx_node_alloc(epc_parser_ctx_t * ctx, epc_parser_t * parser, char const * tag);
+
+/**
+ * @brief Allocates an array of `count` nodes from the parse context's arena, each set up as parse_ctx_node_alloc()
+ * would.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2, 3)
+epc_cpt_node_t * parse_ctx_nodes_alloc(epc_parser_ctx_t * ctx, epc_parser_t * parser, char const * tag, size_t count);
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+epc_cpt_node_t ** parse_ctx_children_alloc(epc_parser_ctx_t * ctx, size_t count);
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+epc_cpt_node_t **
+parse_ctx_children_realloc(epc_parser_ctx_t * ctx, epc_cpt_node_t ** children, size_t old_count, size_t new_count);
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+parse_ctx_mark_t parse_ctx_mark(epc_parser_ctx_t const * ctx);
+
+/**
+ * @brief Discards every arena allocation made since `mark`, which must no longer be in use. Used to reclaim the nodes
+ * of failed alternatives.
+ *
+ * Successful results memoized since `mark` may refer to the nodes, which are then kept unless the memory kept that way
+ * would exceed the memo budget, in which case those results are dropped instead.
+ * @return true if the nodes were reclaimed.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2)
+bool parse_ctx_reclaim(epc_parser_ctx_t * ctx, parse_ctx_mark_t const * mark);
+
+/**
+ * @brief Returns a node without children that covers the same input as `node`, for a parser set with
+ * epc_parser_set_token(). If `mark` isn't NULL, `node` and everything else allocated since `mark` are reclaimed first,
+ * as parse_ctx_reclaim() does.
+ * Returns `node` itself if it has no children, and NULL if memory runs out.
+ */
+EASY_PC_HIDDEN
+ATTR_NONNULL(1, 2)
+epc_cpt_node_t * parse_ctx_token_node(epc_parser_ctx_t * ctx, epc_cpt_node_t * node, parse_ctx_mark_t const * mark);
+
 EASY_PC_HIDDEN
 char const * epc_node_id(epc_cpt_node_t const * node);
 
 EASY_PC_HIDDEN
 void epc_parser_error_free(epc_parser_error_t * error);
 
+/**
+ * @brief Fills in the message, expected and found strings and the line/column of an error.
+ * Errors are created as compact records during a parse; this is only done for errors that are handed to the user.
+ * Calling it on an error that is already materialized does nothing.
+ */
+EASY_PC_HIDDEN
+void epc_parser_error_materialize(epc_parser_ctx_t * ctx, epc_parser_error_t * error);
+
+EASY_PC_HIDDEN
+ATTR_NONNULL(1)
+size_t epc_parser_error_get_offset(epc_parser_error_t const * error);
+
 EASY_PC_HIDDEN
 epc_parser_error_t * parser_furthest_error_copy(epc_parser_ctx_t * ctx);
 
-void epc_parser_free(epc_parser_t * parser);
+/** @brief Records `error`, from another context, as the furthest error if it is at least as far into the input. */
+EASY_PC_HIDDEN
+void parser_furthest_error_merge(epc_parser_ctx_t * ctx, epc_parser_error_t * error);
+
+/* The errors combinators report after running their children, so that the grammar VM can report the same ones. Each
+ * is recorded as the furthest error if it is at least as far into the input.
+ */
+
+/** @brief The error of an `epc_or()` none of whose alternatives matched at `input`. */
+EASY_PC_HIDDEN
+epc_parse_result_t parser_no_alternative_error_result(
+    epc_parser_ctx_t * ctx, epc_parser_t const * self, size_t input_offset, char const * input
+);
+
+/** @brief The error of an `epc_count()` whose child failed with `child_error` after `matched` matches. */
+EASY_PC_HIDDEN
+epc_parse_result_t parser_count_error_result(
+    epc_parser_ctx_t * ctx, size_t input_offset, size_t matched, epc_parser_error_t * child_error
+);
+
+/** @brief The error of an `epc_not()` whose child produced `match`. */
+EASY_PC_HIDDEN
+epc_parse_result_t parser_unexpected_match_error_result(
+    epc_parser_ctx_t * ctx, epc_parser_t const * self, size_t input_offset, epc_cpt_node_t const * match
+);
+
+/** @brief The error of a repetition whose child matched without consuming anything. */
+EASY_PC_HIDDEN
+epc_parse_result_t parser_no_progress_error_result(epc_parser_ctx_t * ctx, size_t input_offset);
 
+/** @brief The error reported when memory runs out while `self` is being parsed. */
 EASY_PC_HIDDEN
-epc_line_col_t epc_calculate_line_and_column(epc_parser_ctx_t * ctx, size_t offset);
+epc_parse_result_t
+parser_out_of_memory_error_result(epc_parser_ctx_t * ctx, epc_parser_t const * self, size_t input_offset);
+
+void epc_parser_free(epc_parser_t * parser);
 
 EASY_PC_HIDDEN
 char const * epc_parser_get_name(epc_parser_t const * p);
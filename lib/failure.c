@@ -0,0 +1,133 @@
+#include "failure.h"
+
+EASY_PC_HIDDEN
+void
+failure_init(failure_t * failure, epc_parser_ctx_t * ctx)
+{
+    *failure = (failure_t){.ctx = ctx};
+}
+
+EASY_PC_HIDDEN
+void
+failure_set(failure_t * failure, epc_parse_result_t result)
+{
+    epc_parser_error_free(failure->error);
+    failure->error = result.is_error ? result.data.error : NULL;
+    failure->failed_parser = NULL;
+}
+
+EASY_PC_HIDDEN
+void
+failure_set_parser(failure_t * failure, epc_parser_t * p, size_t pos)
+{
+    failure_set(failure, (epc_parse_result_t){0});
+    failure->failed_parser = p;
+    failure->failed_pos = pos;
+
+    // The interpreter would make it the furthest error if it is at least as far into the input.
+    bool is_furthest;
+
+    if (failure->pending_parser != NULL)
+    {
+        is_furthest = pos >= failure->pending_pos;
+    }
+    else
+    {
+        epc_parser_error_t const * furthest_error = parse_ctx_get_furthest_error(failure->ctx);
+
+        is_furthest = furthest_error == NULL || pos >= epc_parser_error_get_offset(furthest_error);
+    }
+    if (is_furthest)
+    {
+        failure->pending_parser = p;
+        failure->pending_pos = pos;
+    }
+}
+
+EASY_PC_HIDDEN
+void
+failure_flush(failure_t * failure)
+{
+    epc_parser_t * p = failure->pending_parser;
+
+    if (p == NULL)
+    {
+        return;
+    }
+    failure->pending_parser = NULL;
+
+    epc_parse_result_t const result = p->parse_fn(p, failure->ctx, failure->pending_pos);
+    epc_parser_error_t * error = result.is_error ? result.data.error : NULL;
+
+    if (failure->failed_parser == p && failure->failed_pos == failure->pending_pos)
+    {
+        // It is also the failure being unwound.
+        failure->failed_parser = NULL;
+        failure->error = error;
+    }
+    else
+    {
+        epc_parser_error_free(error);
+    }
+}
+
+EASY_PC_HIDDEN
+epc_parser_error_t *
+failure_build(failure_t * failure)
+{
+    failure_flush(failure);
+
+    epc_parser_t * p = failure->failed_parser;
+
+    if (p != NULL)
+    {
+        // It is behind the furthest error, which it leaves as it is.
+        failure->failed_parser = NULL;
+
+        epc_parse_result_t const result = p->parse_fn(p, failure->ctx, failure->failed_pos);
+
+        failure->error = result.is_error ? result.data.error : NULL;
+    }
+
+    return failure->error;
+}
+
+EASY_PC_HIDDEN
+epc_parser_error_t *
+failure_save_furthest(failure_t * failure)
+{
+    failure_flush(failure);
+
+    return parser_furthest_error_copy(failure->ctx);
+}
+
+EASY_PC_HIDDEN
+void
+failure_restore_furthest(failure_t * failure, epc_parser_error_t ** saved)
+{
+    // A pending furthest error is replaced before anything has seen it.
+    failure->pending_parser = NULL;
+    parser_ctx_set_furthest_error(failure->ctx, saved);
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+failure_result(failure_t * failure, epc_cpt_node_t * root, epc_parser_t const * p, size_t pos)
+{
+    if (root != NULL)
+    {
+        failure_flush(failure);
+        failure_set(failure, (epc_parse_result_t){0});
+        return (epc_parse_result_t){.data.success = root};
+    }
+
+    epc_parser_error_t * error = failure_build(failure);
+
+    if (error == NULL)
+    {
+        return parser_out_of_memory_error_result(failure->ctx, p, pos);
+    }
+    failure->error = NULL;
+
+    return (epc_parse_result_t){.is_error = true, .data.error = error};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "easy_pc_private.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// The errors of a program that matches the input of a graph parser without running its parse functions, as the grammar
+// VM and direct parsers do. It tracks the error of the failure being unwound, and keeps the furthest error of the
+// context as the interpreter would, so that errors are reported without parsing the input again.
+//
+// Most failures are caught by a choice that drops their error, so the error of a parser that failed without running a
+// child is only built when it is needed, by running its parse function where it failed. In the same way, such a
+// failure that becomes the furthest error is only recorded in the context when something is going to look at it, and
+// not at all if a combinator puts the furthest error back as it was first.
+typedef struct failure_t
+{
+    epc_parser_ctx_t * ctx;
+
+    // The error of the failure being unwound. While `failed_parser` is set it hasn't been built, and is the error that
+    // parser reports at `failed_pos`.
+    epc_parser_error_t * error;
+    epc_parser_t * failed_parser;
+    size_t failed_pos;
+
+    // The failure that is the furthest error, if it hasn't been recorded in the context yet.
+    epc_parser_t * pending_parser;
+    size_t pending_pos;
+} failure_t;
+
+EASY_PC_HIDDEN
+void
+failure_init(failure_t * failure, epc_parser_ctx_t * ctx);
+
+// Makes the error of `result`, if it is a failure, the error being unwound. Errors created with the context record
+// themselves as the furthest error, so failure_flush() must be called before they are.
+EASY_PC_HIDDEN
+void
+failure_set(failure_t * failure, epc_parse_result_t result);
+
+// Makes the failure of `p` at `pos` the one being unwound. `p` must have failed without running any child, as terminals
+// and the end of input check of combinators do, so that running it again where it failed gives its error.
+EASY_PC_HIDDEN
+void
+failure_set_parser(failure_t * failure, epc_parser_t * p, size_t pos);
+
+// Records the pending furthest error in the context, before anything looks at or changes it.
+EASY_PC_HIDDEN
+void
+failure_flush(failure_t * failure);
+
+// Builds the error of the failure being unwound, before the furthest error can change. Returns NULL if memory ran out.
+EASY_PC_HIDDEN
+epc_parser_error_t *
+failure_build(failure_t * failure);
+
+// Returns a copy of the furthest error, for a combinator that puts it back once its child has matched.
+EASY_PC_HIDDEN
+epc_parser_error_t *
+failure_save_furthest(failure_t * failure);
+
+// Makes `*saved` the furthest error again, taking ownership of it.
+EASY_PC_HIDDEN
+void
+failure_restore_furthest(failure_t * failure, epc_parser_error_t ** saved);
+
+// Returns the result of a program that produced `root`, or failed if it is NULL. `p` and `pos` are those of the program
+// for an out of memory error, if the failure has no error.
+EASY_PC_HIDDEN
+epc_parse_result_t
+failure_result(failure_t * failure, epc_cpt_node_t * root, epc_parser_t const * p, size_t pos);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// The bytes a parser can begin a non-empty match with, and whether it can match without consuming anything. If a
+// parser succeeds at a position then either it consumed the byte there, which is in `bytes`, or `nullable` is set.
+typedef struct first_set_t
+{
+    uint64_t bytes[4];
+    bool nullable;
+} first_set_t;
+
+static inline void
+first_set_add(first_set_t * set, unsigned char c)
+{
+    set->bytes[c >> 6] |= UINT64_C(1) << (c & 63);
+}
+
+static inline void
+first_set_add_range(first_set_t * set, unsigned char first, unsigned char last)
+{
+    for (unsigned c = first; c <= last; c++)
+    {
+        first_set_add(set, (unsigned char)c);
+    }
+}
+
+static inline void
+first_set_add_all(first_set_t * set)
+{
+    memset(set->bytes, 0xff, sizeof(set->bytes));
+}
+
+// Adds the bytes of `src` to `dst`. The nullable flag is left to the caller, as how it combines depends on the parser.
+static inline void
+first_set_union(first_set_t * dst, first_set_t const * src)
+{
+    for (size_t i = 0; i < sizeof(dst->bytes) / sizeof(dst->bytes[0]); i++)
+    {
+        dst->bytes[i] |= src->bytes[i];
+    }
+}
+
+static inline bool
+first_set_contains(first_set_t const * set, unsigned char c)
+{
+    return (set->bytes[c >> 6] >> (c & 63)) & 1;
+}
+
+// Returns true if a parser with this set could succeed where the next byte is `c`.
+static inline bool
+first_set_may_start_with(first_set_t const * set, unsigned char c)
+{
+    return set->nullable || first_set_contains(set, c);
+}
@@ -0,0 +1,208 @@
+#include "input_buffer.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+// The smallest range input_buffer_init_stream() will settle for.
+#define INPUT_BUFFER_MIN_STREAM_RESERVE ((size_t)1 << 20) /* 1 MiB */
+
+static size_t
+input_buffer_page_size(void)
+{
+    long const page_size = sysconf(_SC_PAGESIZE);
+
+    return page_size > 0 ? (size_t)page_size : 4096;
+}
+
+static size_t
+input_buffer_round_up(size_t size, size_t page_size)
+{
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+// Maps `size` bytes of inaccessible memory, either as a new range or over part of the existing one.
+static void *
+input_buffer_map_none(void * addr, size_t size)
+{
+    int const flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | (addr != NULL ? MAP_FIXED : 0);
+
+    return mmap(addr, size, PROT_NONE, flags, -1, 0);
+}
+
+static bool
+input_buffer_reserve(input_buffer_t * buffer, size_t size)
+{
+    void * mem = input_buffer_map_none(NULL, size);
+
+    if (mem == MAP_FAILED)
+    {
+        return false;
+    }
+    *buffer = (input_buffer_t){
+        .base = mem,
+        .reserved = size,
+    };
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+bool
+input_buffer_init_fixed(input_buffer_t * buffer, size_t size)
+{
+    size_t const page_size = input_buffer_page_size();
+
+    // The extra page is never committed, so it traps reads beyond the end of the input.
+    if (!input_buffer_reserve(buffer, input_buffer_round_up(size, page_size) + page_size))
+    {
+        return false;
+    }
+    if (!input_buffer_commit(buffer, size))
+    {
+        input_buffer_free(buffer);
+        return false;
+    }
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+bool
+input_buffer_reuse_fixed(input_buffer_t * buffer, size_t size)
+{
+    if (size <= buffer->committed && buffer->released == 0)
+    {
+        return true;
+    }
+
+    // Growing geometrically means a session whose inputs keep getting longer is only mapped again a few times.
+    input_buffer_t replacement;
+    size_t const grown = buffer->committed * 2;
+
+    if (!input_buffer_init_fixed(&replacement, size > grown ? size : grown))
+    {
+        return false;
+    }
+    input_buffer_free(buffer);
+    *buffer = replacement;
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+bool
+input_buffer_init_file(input_buffer_t * buffer, int fd, size_t size)
+{
+    if (size == 0)
+    {
+        return false;
+    }
+
+    size_t const page_size = input_buffer_page_size();
+    size_t const committed = input_buffer_round_up(size + 1, page_size);
+
+    if (!input_buffer_reserve(buffer, committed + page_size))
+    {
+        return false;
+    }
+    if (mmap(buffer->base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        input_buffer_free(buffer);
+        return false;
+    }
+    // The rest of the file's last page reads as zeros, which terminates the input. If the file fills its last page
+    // exactly, the terminator is in a page of its own.
+    if (size % page_size == 0 && mprotect(buffer->base + size, page_size, PROT_READ) != 0)
+    {
+        input_buffer_free(buffer);
+        return false;
+    }
+    buffer->committed = committed;
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+bool
+input_buffer_init_stream(input_buffer_t * buffer)
+{
+    for (size_t size = INPUT_BUFFER_STREAM_RESERVE; size >= INPUT_BUFFER_MIN_STREAM_RESERVE; size /= 2)
+    {
+        if (input_buffer_reserve(buffer, size))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+EASY_PC_HIDDEN
+bool
+input_buffer_commit(input_buffer_t * buffer, size_t size)
+{
+    if (size <= buffer->committed)
+    {
+        return true;
+    }
+    if (size > buffer->reserved)
+    {
+        errno = EFBIG;
+        return false;
+    }
+
+    size_t const page_size = input_buffer_page_size();
+    size_t target = input_buffer_round_up(size, page_size);
+
+    if (buffer->committed > 0 && target < buffer->committed * 2)
+    {
+        target = buffer->committed * 2;
+    }
+    if (target > buffer->reserved)
+    {
+        target = buffer->reserved;
+    }
+    if (mprotect(buffer->base + buffer->committed, target - buffer->committed, PROT_READ | PROT_WRITE) != 0)
+    {
+        return false;
+    }
+    buffer->committed = target;
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+void
+input_buffer_release_before(input_buffer_t * buffer, size_t offset)
+{
+    if (offset > buffer->committed)
+    {
+        offset = buffer->committed;
+    }
+
+    size_t const end = offset & ~(input_buffer_page_size() - 1);
+
+    // Mapping fresh inaccessible memory over the pages discards their contents, and keeps the addresses reserved so
+    // that nothing else is mapped where the input was.
+    if (end > buffer->released
+        && input_buffer_map_none(buffer->base + buffer->released, end - buffer->released) != MAP_FAILED)
+    {
+        buffer->released = end;
+    }
+}
+
+EASY_PC_HIDDEN
+void
+input_buffer_free(input_buffer_t * buffer)
+{
+    if (buffer->base != NULL)
+    {
+        munmap(buffer->base, buffer->reserved);
+    }
+    *buffer = (input_buffer_t){0};
+}
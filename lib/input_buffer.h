@@ -0,0 +1,70 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The memory holding the input of a parse. A range of address space is reserved up front but only committed as the
+// input grows, so the input never moves (parse tree nodes point into it) and streamed input isn't limited to a size
+// chosen in advance. Memory at the start of the input can be given back once the parse no longer needs it.
+// Reserved memory beyond the committed part is inaccessible, so it also acts as a guard against overruns.
+typedef struct input_buffer_t
+{
+    char * base;      // Start of the reserved range, which is offset 0 of the input.
+    size_t reserved;  // Size of the reserved range.
+    size_t committed; // Bytes from `base` that are readable, and writable unless mapped from a file.
+    size_t released;  // Bytes from `base` that have been given back to the system. A multiple of the page size.
+} input_buffer_t;
+
+// Address space reserved for streamed input. Reserving it costs no memory, and if the system won't allow this much,
+// successively smaller ranges are tried.
+#if SIZE_MAX > 0xFFFFFFFFu
+#define INPUT_BUFFER_STREAM_RESERVE ((size_t)1 << 40) /* 1 TiB */
+#else
+#define INPUT_BUFFER_STREAM_RESERVE ((size_t)1 << 30) /* 1 GiB */
+#endif
+
+// Reserves and commits space for an input of exactly `size` bytes.
+// Returns false if the memory could not be mapped.
+EASY_PC_HIDDEN
+bool
+input_buffer_init_fixed(input_buffer_t * buffer, size_t size);
+
+// Makes a buffer from input_buffer_init_fixed() hold an input of `size` bytes, for parsing another input with the same
+// session. Its memory is reused if it is big enough and none of it has been released, otherwise it is mapped again.
+// Returns false if the memory could not be mapped, in which case the buffer is left as it was.
+EASY_PC_HIDDEN
+bool
+input_buffer_reuse_fixed(input_buffer_t * buffer, size_t size);
+
+// Maps the first `size` bytes of the regular file open on `fd` read-only, followed by a NUL terminator and a guard
+// page, so that the file is parsed where it lies in the page cache rather than being copied.
+// Returns false if the file could not be mapped (e.g. it is empty), in which case it should be read instead.
+EASY_PC_HIDDEN
+bool
+input_buffer_init_file(input_buffer_t * buffer, int fd, size_t size);
+
+// Reserves space for an input whose size isn't known in advance. Nothing is committed until input_buffer_commit().
+// Returns false if the memory could not be mapped.
+EASY_PC_HIDDEN
+bool
+input_buffer_init_stream(input_buffer_t * buffer);
+
+// Ensures that at least the first `size` bytes of the buffer are committed. The committed part grows geometrically, so
+// filling a buffer a piece at a time only commits a logarithmic number of times.
+// Returns false, with errno set, if `size` exceeds the reserved range or the memory could not be committed.
+EASY_PC_HIDDEN
+bool
+input_buffer_commit(input_buffer_t * buffer, size_t size);
+
+// Gives the memory of the whole pages before `offset` back to the system. Any later access to it faults.
+EASY_PC_HIDDEN
+void
+input_buffer_release_before(input_buffer_t * buffer, size_t offset);
+
+// Unmaps the buffer.
+EASY_PC_HIDDEN
+void
+input_buffer_free(input_buffer_t * buffer);
@@ -0,0 +1,178 @@
+#include "keyword_trie.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    char const * keyword;
+    int index;
+} sorted_keyword_t;
+
+typedef struct
+{
+    keyword_trie_t * trie;
+    sorted_keyword_t const * sorted;
+    uint32_t node_count;
+    uint32_t edge_count;
+} trie_builder_t;
+
+static int
+sorted_keyword_compare(void const * a, void const * b)
+{
+    sorted_keyword_t const * ka = a;
+    sorted_keyword_t const * kb = b;
+    int const order = strcmp(ka->keyword, kb->keyword);
+
+    if (order != 0)
+    {
+        return order;
+    }
+    return (ka->index > kb->index) - (ka->index < kb->index);
+}
+
+// Adds the node for the keywords `lo` to `hi` of the sorted list, which all share their first `depth` bytes, and the
+// nodes below it. Returns the index of the node.
+static uint32_t
+trie_build_node(trie_builder_t * builder, size_t lo, size_t hi, size_t depth)
+{
+    keyword_trie_t * trie = builder->trie;
+    sorted_keyword_t const * sorted = builder->sorted;
+    uint32_t const node = builder->node_count++;
+
+    // The keywords that end here sort first, with the first of any duplicates ahead of the others.
+    trie->nodes[node].keyword = -1;
+    if (sorted[lo].keyword[depth] == '\0')
+    {
+        trie->nodes[node].keyword = sorted[lo].index;
+    }
+    while (lo < hi && sorted[lo].keyword[depth] == '\0')
+    {
+        lo++;
+    }
+
+    // The edges of a node have to be consecutive, so are all reserved before any of the nodes below it are added.
+    uint16_t edge_count = 0;
+
+    for (size_t i = lo; i < hi; i++)
+    {
+        if (i == lo || sorted[i].keyword[depth] != sorted[i - 1].keyword[depth])
+        {
+            edge_count++;
+        }
+    }
+    trie->nodes[node].first_edge = builder->edge_count;
+    trie->nodes[node].edge_count = edge_count;
+    builder->edge_count += edge_count;
+
+    uint32_t edge = trie->nodes[node].first_edge;
+
+    for (size_t first = lo; first < hi; edge++)
+    {
+        unsigned char const c = (unsigned char)sorted[first].keyword[depth];
+        size_t last = first + 1;
+
+        while (last < hi && (unsigned char)sorted[last].keyword[depth] == c)
+        {
+            last++;
+        }
+        trie->edge_bytes[edge] = c;
+        trie->edge_targets[edge] = trie_build_node(builder, first, last, depth + 1);
+        first = last;
+    }
+
+    return node;
+}
+
+EASY_PC_HIDDEN
+bool
+keyword_trie_init(keyword_trie_t * trie, char const * const * keywords, int count)
+{
+    *trie = (keyword_trie_t){0};
+
+    if (count <= 0)
+    {
+        return false;
+    }
+
+    sorted_keyword_t * sorted = malloc((size_t)count * sizeof(*sorted));
+    size_t total_len = 0;
+
+    if (sorted == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        size_t const len = strlen(keywords[i]);
+
+        sorted[i] = (sorted_keyword_t){.keyword = keywords[i], .index = i};
+        total_len += len;
+        if (len > trie->max_len)
+        {
+            trie->max_len = len;
+        }
+    }
+    if (total_len >= UINT32_MAX)
+    {
+        free(sorted);
+        return false;
+    }
+    qsort(sorted, (size_t)count, sizeof(*sorted), sorted_keyword_compare);
+
+    // Each byte of each keyword adds at most one node and the edge to it.
+    trie->nodes = malloc((total_len + 1) * sizeof(*trie->nodes));
+    trie->edge_bytes = malloc(total_len + 1);
+    trie->edge_targets = malloc((total_len + 1) * sizeof(*trie->edge_targets));
+    if (trie->nodes == NULL || trie->edge_bytes == NULL || trie->edge_targets == NULL)
+    {
+        free(sorted);
+        keyword_trie_free(trie);
+        return false;
+    }
+
+    trie_builder_t builder = {.trie = trie, .sorted = sorted};
+
+    trie_build_node(&builder, 0, (size_t)count, 0);
+    free(sorted);
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+void
+keyword_trie_free(keyword_trie_t * trie)
+{
+    free(trie->nodes);
+    free(trie->edge_bytes);
+    free(trie->edge_targets);
+    *trie = (keyword_trie_t){0};
+}
+
+EASY_PC_HIDDEN
+int
+keyword_trie_match(keyword_trie_t const * trie, char const * s, size_t len, size_t * match_len)
+{
+    keyword_trie_node_t const * node = &trie->nodes[0];
+    int keyword = node->keyword;
+
+    *match_len = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        unsigned char const * edges = &trie->edge_bytes[node->first_edge];
+        unsigned char const * edge = memchr(edges, (unsigned char)s[i], node->edge_count);
+
+        if (edge == NULL)
+        {
+            break;
+        }
+        node = &trie->nodes[trie->edge_targets[node->first_edge + (uint32_t)(edge - edges)]];
+        if (node->keyword >= 0)
+        {
+            keyword = node->keyword;
+            *match_len = i + 1;
+        }
+    }
+
+    return keyword;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A node of a keyword trie. Its edges are the `edge_count` entries of the trie's `edge_bytes` and `edge_targets` from
+// `first_edge`, so that the byte to follow can be found with memchr().
+typedef struct keyword_trie_node_t
+{
+    int keyword; // The index of the keyword that ends here, or -1.
+    uint32_t first_edge;
+    uint16_t edge_count;
+} keyword_trie_node_t;
+
+// The keywords of an epc_keywords parser, as a trie that finds the longest of them at the start of the input in a
+// single pass over it. Node 0 is the root.
+typedef struct keyword_trie_t
+{
+    keyword_trie_node_t * nodes;
+    unsigned char * edge_bytes;
+    uint32_t * edge_targets;
+    size_t max_len; // The length of the longest keyword.
+} keyword_trie_t;
+
+// Builds the trie of `count` keywords. Where a keyword is given more than once, the first is the one matched.
+EASY_PC_HIDDEN
+bool
+keyword_trie_init(keyword_trie_t * trie, char const * const * keywords, int count);
+
+EASY_PC_HIDDEN
+void
+keyword_trie_free(keyword_trie_t * trie);
+
+// Returns the index of the longest keyword at the start of the `len` bytes at `s`, setting `*match_len` to its length,
+// or -1 if none of them is there.
+EASY_PC_HIDDEN
+int
+keyword_trie_match(keyword_trie_t const * trie, char const * s, size_t len, size_t * match_len);
@@ -0,0 +1,113 @@
+#include "line_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LINE_INDEX_INITIAL_CAPACITY 64
+
+EASY_PC_HIDDEN
+void
+line_index_init(line_index_t * index)
+{
+    index->newline_offsets = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->scanned_len = 0;
+}
+
+static bool
+line_index_append(line_index_t * index, size_t offset)
+{
+    if (index->count == index->capacity)
+    {
+        size_t const new_capacity = index->capacity == 0 ? LINE_INDEX_INITIAL_CAPACITY : index->capacity * 2;
+        size_t * new_offsets = realloc(index->newline_offsets, new_capacity * sizeof(*new_offsets));
+
+        if (new_offsets == NULL)
+        {
+            return false;
+        }
+        index->newline_offsets = new_offsets;
+        index->capacity = new_capacity;
+    }
+    index->newline_offsets[index->count++] = offset;
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+bool
+line_index_extend(line_index_t * index, char const * input_start, size_t input_len)
+{
+    size_t const original_count = index->count;
+    size_t offset = index->scanned_len;
+
+    while (offset < input_len)
+    {
+        char const * nl = memchr(input_start + offset, '\n', input_len - offset);
+        if (nl == NULL)
+        {
+            break;
+        }
+        if (!line_index_append(index, (size_t)(nl - input_start)))
+        {
+            index->count = original_count;
+            return false;
+        }
+        offset = (size_t)(nl - input_start) + 1;
+    }
+    if (input_len > index->scanned_len)
+    {
+        index->scanned_len = input_len;
+    }
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+epc_line_col_t
+line_index_lookup(line_index_t const * index, size_t offset)
+{
+    // Find the number of newlines at or before `offset`; that is the (0 based) line number.
+    size_t low = 0;
+    size_t high = index->count;
+
+    while (low < high)
+    {
+        size_t const mid = low + (high - low) / 2;
+
+        if (index->newline_offsets[mid] <= offset)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    // Columns on later lines are measured from the newline that starts them, matching how positions have always been
+    // reported.
+    size_t const line_start = low == 0 ? 0 : index->newline_offsets[low - 1];
+
+    return (epc_line_col_t){
+        .line = low,
+        .col = offset - line_start,
+    };
+}
+
+EASY_PC_HIDDEN
+void
+line_index_reset(line_index_t * index)
+{
+    index->count = 0;
+    index->scanned_len = 0;
+}
+
+EASY_PC_HIDDEN
+void
+line_index_release(line_index_t * index)
+{
+    free(index->newline_offsets);
+    line_index_init(index);
+}
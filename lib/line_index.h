@@ -0,0 +1,41 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// The offsets of every newline in the part of the input scanned so far, in ascending order, so that an offset can be
+// converted to a line and column with a binary search instead of a scan from the start of the input.
+typedef struct line_index_t
+{
+    size_t * newline_offsets;
+    size_t count;
+    size_t capacity;
+    size_t scanned_len; // Input before this offset has been scanned for newlines.
+} line_index_t;
+
+EASY_PC_HIDDEN
+void
+line_index_init(line_index_t * index);
+
+// Scans the input between the end of the previous scan and `input_len`, so each byte is only ever scanned once even
+// when the input grows as streamed data arrives.
+// Returns false if the table could not be grown, in which case the index is left as it was.
+EASY_PC_HIDDEN
+bool
+line_index_extend(line_index_t * index, char const * input_start, size_t input_len);
+
+// Returns the line and column of `offset`, which must be within the scanned input.
+EASY_PC_HIDDEN
+epc_line_col_t
+line_index_lookup(line_index_t const * index, size_t offset);
+
+// Empties the index, keeping its table for reuse.
+EASY_PC_HIDDEN
+void
+line_index_reset(line_index_t * index);
+
+EASY_PC_HIDDEN
+void
+line_index_release(line_index_t * index);
@@ -0,0 +1,263 @@
+#include "memo.h"
+#include "easy_pc_private.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+EASY_PC_HIDDEN
+void
+memo_table_init(memo_table_t * table, size_t budget)
+{
+    table->entries = NULL;
+    table->set_count = 0;
+    table->budget = budget > 0 ? budget : MEMO_DEFAULT_BUDGET;
+    table->stored = NULL;
+    table->stored_count = 0;
+    table->stored_capacity = 0;
+    table->success_stores = 0;
+    table->kept = NULL;
+    table->kept_count = 0;
+    table->kept_capacity = 0;
+    table->kept_bytes = 0;
+}
+
+// Makes room for one more item in a growable array.
+static bool
+memo_grow(void ** items, size_t * capacity, size_t count, size_t item_size)
+{
+    if (count < *capacity)
+    {
+        return true;
+    }
+
+    size_t const new_capacity = *capacity == 0 ? 64 : *capacity * 2;
+    void * grown = realloc(*items, new_capacity * item_size);
+
+    if (grown == NULL)
+    {
+        return false;
+    }
+    *items = grown;
+    *capacity = new_capacity;
+
+    return true;
+}
+
+static bool
+memo_table_allocate(memo_table_t * table)
+{
+    size_t const max_sets = table->budget / (sizeof(memo_entry_t) * MEMO_TABLE_WAYS);
+    size_t set_count = 1;
+
+    while (set_count * 2 <= max_sets)
+    {
+        set_count *= 2;
+    }
+
+    table->entries = calloc(set_count * MEMO_TABLE_WAYS, sizeof(*table->entries));
+    if (table->entries == NULL)
+    {
+        return false;
+    }
+    table->set_count = set_count;
+
+    return true;
+}
+
+static memo_entry_t *
+memo_table_set(memo_table_t const * table, epc_parser_t const * parser, size_t input_offset)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)parser ^ ((uint64_t)input_offset * UINT64_C(0x9E3779B97F4A7C15));
+
+    hash ^= hash >> 29;
+
+    return &table->entries[(hash & (table->set_count - 1)) * MEMO_TABLE_WAYS];
+}
+
+EASY_PC_HIDDEN
+memo_entry_t const *
+memo_table_lookup(memo_table_t const * table, epc_parser_t const * parser, size_t input_offset)
+{
+    if (table->entries == NULL)
+    {
+        return NULL;
+    }
+
+    memo_entry_t const * set = memo_table_set(table, parser, input_offset);
+
+    for (size_t i = 0; i < MEMO_TABLE_WAYS; i++)
+    {
+        if (set[i].parser == parser && set[i].input_offset == input_offset)
+        {
+            return &set[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void
+memo_entry_clear(memo_entry_t * entry)
+{
+    if (entry->parser != NULL && entry->result.is_error)
+    {
+        epc_parser_error_free(entry->result.data.error);
+    }
+    epc_parser_error_free(entry->furthest_error);
+    *entry = (memo_entry_t){0};
+}
+
+static bool
+memo_stored_is_live(memo_stored_t stored)
+{
+    return stored.entry->parser != NULL && !stored.entry->result.is_error && stored.entry->sequence == stored.sequence;
+}
+
+// Makes room to record one more successful result, first dropping the records of slots that have been reused if they
+// make up most of the journal.
+static bool
+memo_table_reserve_stored(memo_table_t * table)
+{
+    if (table->stored_count == table->stored_capacity
+        && table->stored_count >= 2 * table->set_count * MEMO_TABLE_WAYS)
+    {
+        size_t live = 0;
+
+        for (size_t i = 0; i < table->stored_count; i++)
+        {
+            if (memo_stored_is_live(table->stored[i]))
+            {
+                table->stored[live++] = table->stored[i];
+            }
+        }
+        table->stored_count = live;
+    }
+
+    return memo_grow((void **)&table->stored, &table->stored_capacity, table->stored_count, sizeof(*table->stored));
+}
+
+EASY_PC_HIDDEN
+bool
+memo_table_store(
+    memo_table_t * table,
+    epc_parser_t const * parser,
+    size_t input_offset,
+    epc_parse_result_t result,
+    epc_parser_error_t * furthest_error
+)
+{
+    if (table->entries == NULL && !memo_table_allocate(table))
+    {
+        return false;
+    }
+    if (!result.is_error && !memo_table_reserve_stored(table))
+    {
+        return false;
+    }
+
+    memo_entry_t * set = memo_table_set(table, parser, input_offset);
+    memo_entry_t * victim = &set[0];
+
+    for (size_t i = 0; i < MEMO_TABLE_WAYS; i++)
+    {
+        if (set[i].parser == NULL)
+        {
+            victim = &set[i];
+            break;
+        }
+        if (set[i].input_offset < victim->input_offset)
+        {
+            victim = &set[i];
+        }
+    }
+
+    memo_entry_clear(victim);
+    victim->parser = parser;
+    victim->input_offset = input_offset;
+    victim->result = result;
+    victim->furthest_error = furthest_error;
+    if (!result.is_error)
+    {
+        victim->sequence = table->success_stores++;
+        table->stored[table->stored_count++] = (memo_stored_t){.entry = victim, .sequence = victim->sequence};
+    }
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+bool
+memo_table_keep(memo_table_t * table, size_t success_stores, size_t from, size_t to)
+{
+    // Ranges kept by parsers that ran within this one are part of the new range.
+    while (table->kept_count > 0 && table->kept[table->kept_count - 1].from >= from)
+    {
+        table->kept_bytes -= table->kept[--table->kept_count].len;
+    }
+
+    size_t const len = to - from;
+
+    if (table->kept_bytes + len <= table->budget
+        && memo_grow((void **)&table->kept, &table->kept_capacity, table->kept_count, sizeof(*table->kept)))
+    {
+        table->kept[table->kept_count++] = (memo_kept_range_t){.from = from, .len = len};
+        table->kept_bytes += len;
+        return true;
+    }
+
+    while (table->stored_count > 0 && table->stored[table->stored_count - 1].sequence >= success_stores)
+    {
+        memo_stored_t const stored = table->stored[--table->stored_count];
+
+        if (memo_stored_is_live(stored))
+        {
+            memo_entry_clear(stored.entry);
+        }
+    }
+    table->success_stores = success_stores;
+
+    return false;
+}
+
+static void
+memo_table_free_entries(memo_table_t * table)
+{
+    if (table->entries != NULL)
+    {
+        for (size_t i = 0; i < table->set_count * MEMO_TABLE_WAYS; i++)
+        {
+            memo_entry_clear(&table->entries[i]);
+        }
+        free(table->entries);
+    }
+    table->entries = NULL;
+    table->set_count = 0;
+}
+
+EASY_PC_HIDDEN
+void
+memo_table_reset(memo_table_t * table)
+{
+    memo_table_free_entries(table);
+    table->stored_count = 0;
+    table->success_stores = 0;
+    table->kept_count = 0;
+    table->kept_bytes = 0;
+}
+
+EASY_PC_HIDDEN
+void
+memo_table_release(memo_table_t * table)
+{
+    memo_table_free_entries(table);
+    free(table->stored);
+    table->stored = NULL;
+    table->stored_count = 0;
+    table->stored_capacity = 0;
+    table->success_stores = 0;
+    free(table->kept);
+    table->kept = NULL;
+    table->kept_count = 0;
+    table->kept_capacity = 0;
+    table->kept_bytes = 0;
+}
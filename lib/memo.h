@@ -0,0 +1,99 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A cached `(parser, input_offset) -> result` pair used by packrat mode.
+typedef struct memo_entry_t
+{
+    epc_parser_t const * parser; // NULL for an unused slot.
+    size_t input_offset;
+    epc_parse_result_t result; // On success the CPT node is shared; on failure the error is owned by the entry.
+    epc_parser_error_t * furthest_error; // The furthest error reached while finding the result, or NULL. Owned.
+    size_t sequence;           // On success, the value of memo_table_t.success_stores when it was cached.
+} memo_entry_t;
+
+// Number of slots a key may occupy. When all are taken, the entry for the lowest input offset is evicted, on the
+// basis that a packrat parser rarely returns to positions well behind the furthest point reached.
+#define MEMO_TABLE_WAYS 4
+
+#define MEMO_DEFAULT_BUDGET (16 * 1024 * 1024)
+
+// A successful result cached in a slot, unless the slot has been reused since.
+typedef struct memo_stored_t
+{
+    memo_entry_t * entry;
+    size_t sequence;
+} memo_stored_t;
+
+// Arena memory, from one arena_t.allocated position to another, that a parser couldn't reclaim when it failed because
+// results cached while it ran may refer to it.
+typedef struct memo_kept_range_t
+{
+    size_t from;
+    size_t len;
+} memo_kept_range_t;
+
+// A bounded, set associative memo table. Its slots are allocated on first use.
+typedef struct memo_table_t
+{
+    memo_entry_t * entries;
+    size_t set_count; // Always a power of two.
+    size_t budget;    // Memory budget in bytes for the slots, and again for the arena memory they keep alive.
+
+    // The successful results cached, in order, so that those cached since a point can be dropped. Entries for reused
+    // slots are pruned when it fills up, so it stays in proportion to the slots.
+    // `success_stores` doesn't change unless a successful result is cached or dropped.
+    memo_stored_t * stored;
+    size_t stored_count;
+    size_t stored_capacity;
+    size_t success_stores;
+
+    // The arena memory that is only kept for cached results. The ranges are disjoint, and in order.
+    memo_kept_range_t * kept;
+    size_t kept_count;
+    size_t kept_capacity;
+    size_t kept_bytes;
+} memo_table_t;
+
+EASY_PC_HIDDEN
+void
+memo_table_init(memo_table_t * table, size_t budget);
+
+// Returns the cached entry for the key, or NULL if there is none.
+EASY_PC_HIDDEN
+memo_entry_t const *
+memo_table_lookup(memo_table_t const * table, epc_parser_t const * parser, size_t input_offset);
+
+// Caches `result` for the key, with the furthest error reached while finding it. The table takes ownership of the
+// error of a failed result and of `furthest_error`.
+// Returns false if the result could not be cached, in which case ownership stays with the caller.
+EASY_PC_HIDDEN
+bool
+memo_table_store(
+    memo_table_t * table,
+    epc_parser_t const * parser,
+    size_t input_offset,
+    epc_parse_result_t result,
+    epc_parser_error_t * furthest_error
+);
+
+// Records that the arena memory from `from` to `to` can't be reclaimed, as the successful results cached since there
+// were `success_stores` of them may refer to it. Returns false if keeping it would take the memory kept for cached
+// results over the budget, in which case those results have been dropped and the memory must be reclaimed.
+EASY_PC_HIDDEN
+bool
+memo_table_keep(memo_table_t * table, size_t success_stores, size_t from, size_t to);
+
+// Empties the table for another input, keeping its bookkeeping for reuse. The slots are freed rather than cleared, as
+// they are sized by the budget rather than the input, and are allocated again on first use.
+EASY_PC_HIDDEN
+void
+memo_table_reset(memo_table_t * table);
+
+// Frees the slots and any errors held in them.
+EASY_PC_HIDDEN
+void
+memo_table_release(memo_table_t * table);
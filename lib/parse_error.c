@@ -0,0 +1,153 @@
+#include "parse_error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PARSE_ERROR_CHUNK_SIZE 64
+
+struct parse_error_chunk_t
+{
+    parse_error_chunk_t * next;
+    parse_error_t records[PARSE_ERROR_CHUNK_SIZE];
+};
+
+EASY_PC_HIDDEN
+void
+parse_error_pool_init(parse_error_pool_t * pool)
+{
+    pool->free_list = NULL;
+    pool->chunks = NULL;
+    pool->free_strings = NULL;
+}
+
+static bool
+parse_error_pool_grow(parse_error_pool_t * pool)
+{
+    parse_error_chunk_t * chunk = malloc(sizeof(*chunk));
+    if (chunk == NULL)
+    {
+        return false;
+    }
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+
+    for (size_t i = 0; i < PARSE_ERROR_CHUNK_SIZE; i++)
+    {
+        chunk->records[i].strings = NULL;
+        chunk->records[i].next_free = pool->free_list;
+        pool->free_list = &chunk->records[i];
+    }
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+parse_error_t *
+parse_error_pool_alloc(parse_error_pool_t * pool)
+{
+    if (pool == NULL)
+    {
+        return calloc(1, sizeof(parse_error_t));
+    }
+
+    if (pool->free_list == NULL && !parse_error_pool_grow(pool))
+    {
+        return NULL;
+    }
+
+    parse_error_t * error = pool->free_list;
+    pool->free_list = error->next_free;
+    memset(error, 0, sizeof(*error));
+    error->pool = pool;
+
+    return error;
+}
+
+EASY_PC_HIDDEN
+void
+parse_error_pool_free(parse_error_t * error)
+{
+    if (error == NULL)
+    {
+        return;
+    }
+
+    parse_error_pool_t * pool = error->pool;
+    if (pool == NULL)
+    {
+        free(error->strings);
+        free(error);
+        return;
+    }
+    if (error->strings != NULL)
+    {
+        error->strings->next_free = pool->free_strings;
+        pool->free_strings = error->strings;
+        error->strings = NULL;
+    }
+    error->next_free = pool->free_list;
+    pool->free_list = error;
+}
+
+EASY_PC_HIDDEN
+bool
+parse_error_strings_reserve(parse_error_t * error, size_t len)
+{
+    parse_error_pool_t * pool = error->pool;
+
+    if (error->strings == NULL && pool != NULL && pool->free_strings != NULL)
+    {
+        error->strings = pool->free_strings;
+        pool->free_strings = error->strings->next_free;
+    }
+    if (error->strings != NULL && len <= error->strings->capacity)
+    {
+        return true;
+    }
+
+    size_t capacity = error->strings != NULL ? error->strings->capacity : 128;
+
+    while (capacity < len)
+    {
+        capacity *= 2;
+    }
+
+    parse_error_strings_t * strings = realloc(error->strings, sizeof(*strings) + capacity);
+    if (strings == NULL)
+    {
+        return false;
+    }
+    strings->capacity = capacity;
+    error->strings = strings;
+
+    return true;
+}
+
+EASY_PC_HIDDEN
+void
+parse_error_pool_release(parse_error_pool_t * pool)
+{
+    parse_error_chunk_t * chunk = pool->chunks;
+
+    while (chunk != NULL)
+    {
+        parse_error_chunk_t * next = chunk->next;
+
+        // Records still in use haven't given their strings back.
+        for (size_t i = 0; i < PARSE_ERROR_CHUNK_SIZE; i++)
+        {
+            free(chunk->records[i].strings);
+        }
+        free(chunk);
+        chunk = next;
+    }
+    while (pool->free_strings != NULL)
+    {
+        parse_error_strings_t * next = pool->free_strings->next_free;
+
+        free(pool->free_strings);
+        pool->free_strings = next;
+    }
+    pool->chunks = NULL;
+    pool->free_list = NULL;
+}
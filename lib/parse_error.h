@@ -0,0 +1,98 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FOUND_BUFFER_SIZE 21
+
+// How the error message is produced when the error is materialized.
+typedef enum parse_error_reason_t
+{
+    PARSE_ERROR_REASON_MESSAGE,        // `message` is a string held by reference.
+    PARSE_ERROR_REASON_COUNT_MISMATCH, // "Count failed to match child at count <arg>".
+} parse_error_reason_t;
+
+// How the expected string is produced when the error is materialized.
+typedef enum parse_error_expected_t
+{
+    PARSE_ERROR_EXPECTED_TEXT,         // `expected` is a string held by reference.
+    PARSE_ERROR_EXPECTED_ALTERNATIVES, // "<a> or <b> ..." built from the alternatives of `parser`.
+    PARSE_ERROR_EXPECTED_NOT,          // "not <x>" where <x> is what the child of `parser` expects.
+    PARSE_ERROR_EXPECTED_CHAR_RANGE,   // "character in range [a-z]" built from the range of `parser`.
+    PARSE_ERROR_EXPECTED_ONE_OF,       // "character in set '...'" built from the set of `parser`.
+    PARSE_ERROR_EXPECTED_NONE_OF,      // "character not in set '...'" built from the set of `parser`.
+} parse_error_expected_t;
+
+typedef struct parse_error_pool_t parse_error_pool_t;
+
+// A buffer the strings of a materialized error are written to, one after another. Freed records give theirs back to
+// the pool, so that reporting an error in a session that has reported one before doesn't allocate.
+typedef struct parse_error_strings_t
+{
+    struct parse_error_strings_t * next_free;
+    size_t capacity; // Bytes at `text`.
+    char text[];
+} parse_error_strings_t;
+
+// The internal form of a parse error. It is a plain record that holds everything by reference, apart from a short
+// copy of the text that was found. The strings and line/column of the public `error` view are only filled in when
+// the error is materialized, which happens once for the error finally handed back to the caller.
+typedef struct parse_error_t
+{
+    epc_parser_error_t error; // Must be first; the public view handed out in parse results.
+    size_t input_offset;
+    parse_error_reason_t reason;
+    parse_error_expected_t expected_kind;
+    char const * message;
+    char const * expected;
+    char const * found; // Either into the input or at `found_buf`.
+    epc_parser_t const * parser;
+    size_t arg;
+    char found_buf[FOUND_BUFFER_SIZE];
+    bool materialized;
+    parse_error_strings_t * strings; // Holds the materialized strings, or NULL before the error is materialized.
+
+    parse_error_pool_t * pool; // The pool the record is returned to, or NULL if it was heap allocated.
+    struct parse_error_t * next_free;
+} parse_error_t;
+
+typedef struct parse_error_chunk_t parse_error_chunk_t;
+
+// A free list of error records, allocated in chunks, so that a parse doesn't allocate per failure.
+struct parse_error_pool_t
+{
+    parse_error_t * free_list;
+    parse_error_chunk_t * chunks;
+    parse_error_strings_t * free_strings;
+};
+
+static inline parse_error_t *
+parse_error_from_public(epc_parser_error_t * error)
+{
+    return (parse_error_t *)error;
+}
+
+EASY_PC_HIDDEN
+void
+parse_error_pool_init(parse_error_pool_t * pool);
+
+// Returns a zeroed record. A NULL pool gives a heap allocated record.
+EASY_PC_HIDDEN
+parse_error_t *
+parse_error_pool_alloc(parse_error_pool_t * pool);
+
+// Returns a record, and its strings buffer, to the pool it came from.
+EASY_PC_HIDDEN
+void
+parse_error_pool_free(parse_error_t * error);
+
+// Makes the record's strings buffer hold at least `len` bytes, reusing one the pool has spare if it has none.
+EASY_PC_HIDDEN
+bool
+parse_error_strings_reserve(parse_error_t * error, size_t len);
+
+EASY_PC_HIDDEN
+void
+parse_error_pool_release(parse_error_pool_t * pool);
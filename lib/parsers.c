@@ -1,16 +1,20 @@
 #include "child_list.h"
+#include "direct.h"
 #include "easy_pc_private.h"
 #include "parsers.h"
+#include "profile.h"
+#include "split.h"
 
 #include <ctype.h> // For isdigit
 #include <errno.h>
+#include <limits.h>
 #include <stdarg.h> // For va_list, va_start, va_arg, va_end
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define FOUND_BUFFER_SIZE 21
-
 // --- Internal Helper Functions ---
 // --- Parser List free. ---
 static void
@@ -69,6 +73,77 @@ string_set(char const ** const dst, char const * src)
     }
 }
 
+static void
+keywords_data_free(keywords_data_t * keywords)
+{
+    if (keywords == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < keywords->count; ++i)
+    {
+        free(keywords->keywords[i]);
+    }
+    free(keywords->keywords);
+    free(keywords->expected);
+    keyword_trie_free(&keywords->trie);
+    free(keywords);
+}
+
+static keywords_data_t *
+keywords_data_create(char const * const * keywords, int count)
+{
+    // The node a keyword matches records its index in 16 bits.
+    if (count <= 0 || count > UINT16_MAX)
+    {
+        return NULL;
+    }
+
+    keywords_data_t * data = calloc(1, sizeof(*data));
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    data->keywords = calloc(count, sizeof(*data->keywords));
+    if (data->keywords == NULL)
+    {
+        free(data);
+        return NULL;
+    }
+
+    size_t expected_len = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        data->keywords[i] = keywords[i] != NULL ? strdup(keywords[i]) : NULL;
+        if (data->keywords[i] == NULL)
+        {
+            keywords_data_free(data);
+            return NULL;
+        }
+        data->count = i + 1;
+        expected_len += strlen(keywords[i]) + strlen(" or ");
+    }
+
+    data->expected = malloc(expected_len + 1);
+    if (data->expected == NULL || !keyword_trie_init(&data->trie, (char const * const *)data->keywords, count))
+    {
+        keywords_data_free(data);
+        return NULL;
+    }
+    data->expected[0] = '\0';
+    for (int i = 0; i < count; ++i)
+    {
+        strcat(data->expected, data->keywords[i]);
+        if (i < count - 1)
+        {
+            strcat(data->expected, " or ");
+        }
+    }
+
+    return data;
+}
+
 static void
 parser_data_free(parser_data_type_st * data)
 {
@@ -95,10 +170,32 @@ parser_data_free(parser_data_type_st * data)
         parser_list_free(data->parser_list);
         data->parser_list = NULL;
         break;
+
+    case PARSER_DATA_TYPE_DIRECT:
+        free(data->direct.sites);
+        data->direct.sites = NULL;
+        break;
+
+    case PARSER_DATA_TYPE_KEYWORDS:
+        keywords_data_free(data->keywords);
+        data->keywords = NULL;
+        break;
     }
     data->type = PARSER_DATA_TYPE_NONE;
 }
 
+static void
+parser_plans_free(parser_plan_t * plan)
+{
+    while (plan != NULL)
+    {
+        parser_plan_t * retired = plan->retired;
+
+        free(plan);
+        plan = retired;
+    }
+}
+
 void
 epc_parser_free(epc_parser_t * parser)
 {
@@ -108,6 +205,8 @@ epc_parser_free(epc_parser_t * parser)
     }
     parser_data_free(&parser->data);
     string_set(&parser->name, NULL);
+    parser_plans_free(parser->plan);
+    parser_plans_free(parser->retired_plans);
     free(parser);
 }
 
@@ -127,7 +226,7 @@ epc_parsers_free(size_t const count, ...)
 
 ATTR_NONNULL(2)
 static epc_parser_t *
-epc_parser_allocate(char const * name, char const * tag, parse_fn_t parse_fn)
+epc_parser_allocate(char const * name, char const * tag, parse_fn_t parse_fn, first_set_fn_t first_set_fn)
 {
     epc_parser_t * p = calloc(1, sizeof(*p));
 
@@ -138,6 +237,7 @@ epc_parser_allocate(char const * name, char const * tag, parse_fn_t parse_fn)
     string_set(&p->name, name);
     p->tag = tag;
     p->parse_fn = parse_fn;
+    p->first_set_fn = first_set_fn;
 
     return p;
 }
@@ -145,7 +245,7 @@ epc_parser_allocate(char const * name, char const * tag, parse_fn_t parse_fn)
 epc_parser_t *
 epc_parser_fwd_decl(char const * name)
 {
-    return epc_parser_allocate(name, "forward_decl", NULL);
+    return epc_parser_allocate(name, "forward_decl", NULL, NULL);
 }
 
 EASY_PC_HIDDEN
@@ -156,43 +256,7 @@ epc_parser_error_free(epc_parser_error_t * error)
     {
         return;
     }
-    free((char *)error->message);
-    free((char *)error->expected);
-    free((char *)error->found);
-    free(error);
-}
-
-EASY_PC_HIDDEN
-epc_line_col_t
-epc_calculate_line_and_column(epc_parser_ctx_t * ctx, size_t const offset)
-{
-    epc_line_col_t res = {0};
-    char const * const input_start = parse_ctx_get_input_start(ctx);
-    size_t const input_len = parse_ctx_get_input_len(ctx);
-
-    if (input_start == NULL || offset >= input_len)
-    {
-        return res;
-    }
-
-    char const * current = input_start + offset;
-    if (current > input_start + input_len)
-    {
-        return res;
-    }
-
-    {
-        char const * line_start = input_start;
-
-        for (char const * nl = strchr(input_start, '\n'); nl != NULL && nl <= current; nl = strchr(nl + 1, '\n'))
-        {
-            res.line++;
-            line_start = nl;
-        }
-        res.col = current - line_start;
-    }
-
-    return res;
+    parse_error_pool_free(parse_error_from_public(error));
 }
 
 EASY_PC_HIDDEN
@@ -217,30 +281,194 @@ epc_parser_get_name(epc_parser_t const * p)
     }
 }
 
-epc_parser_error_t *
-epc_parser_error_alloc(
+// Creates an error record. `message` and `expected` are held by reference so must outlive the parse (string
+// literals or strings owned by a parser); `found` is copied.
+static parse_error_t *
+parse_error_new(
     epc_parser_ctx_t * ctx, size_t input_offset, char const * message, char const * expected, char const * found
 )
 {
-    epc_parser_error_t * error = calloc(1, sizeof(*error));
+    parse_error_t * error = parse_error_pool_alloc(ctx != NULL ? parse_ctx_get_error_pool(ctx) : NULL);
     if (error == NULL)
     {
-        return error;
+        return NULL;
+    }
+
+    error->input_offset = input_offset;
+    error->reason = PARSE_ERROR_REASON_MESSAGE;
+    error->message = message;
+    error->expected_kind = PARSE_ERROR_EXPECTED_TEXT;
+    error->expected = expected;
+    if (found != NULL)
+    {
+        strncpy(error->found_buf, found, sizeof(error->found_buf) - 1);
+        error->found = error->found_buf;
     }
 
-    char const * input_start = parse_ctx_get_input_start(ctx);
-    char const * current = input_start + input_offset;
+    return error;
+}
+
+static void
+parse_error_copy_into(parse_error_t * dst, parse_error_t const * src)
+{
+    parse_error_pool_t * pool = dst->pool;
+    parse_error_strings_t * const strings = dst->strings;
+
+    *dst = *src;
+    dst->error = (epc_parser_error_t){0};
+    dst->materialized = false;
+    dst->strings = strings;
+    dst->pool = pool;
+    dst->next_free = NULL;
+    if (src->found == src->found_buf)
+    {
+        dst->found = dst->found_buf;
+    }
+}
 
-    error->input_position = current;
-    error->position = epc_calculate_line_and_column(ctx, input_offset);
+static parse_error_t *
+parse_error_copy(epc_parser_ctx_t * ctx, parse_error_t const * src)
+{
+    if (src == NULL)
+    {
+        return NULL;
+    }
 
-    error->message = strdup(message != NULL ? message : "");
-    error->expected = strdup(expected != NULL ? expected : "");
-    error->found = strdup(found != NULL ? found : "");
+    parse_error_t * error = parse_error_pool_alloc(ctx != NULL ? parse_ctx_get_error_pool(ctx) : NULL);
+    if (error == NULL)
+    {
+        return NULL;
+    }
+    parse_error_copy_into(error, src);
 
     return error;
 }
 
+static char const * parser_get_expected_str(epc_parser_t const * p);
+
+// Appends to the string ending at `*len` in the record's strings buffer, and keeps it terminated.
+static bool
+parse_error_strings_printf(parse_error_t * error, size_t * len, char const * format, ...)
+{
+    size_t const available = error->strings->capacity - *len;
+    va_list args;
+
+    va_start(args, format);
+    int const needed = vsnprintf(error->strings->text + *len, available, format, args);
+    va_end(args);
+    if (needed < 0)
+    {
+        return false;
+    }
+    if ((size_t)needed >= available)
+    {
+        if (!parse_error_strings_reserve(error, *len + (size_t)needed + 1))
+        {
+            return false;
+        }
+        va_start(args, format);
+        vsnprintf(error->strings->text + *len, (size_t)needed + 1, format, args);
+        va_end(args);
+    }
+    *len += (size_t)needed;
+
+    return true;
+}
+
+static bool
+parse_error_write_alternatives_expected(parse_error_t * error, size_t * len, epc_parser_t const * p);
+
+static bool
+parse_error_write_expected(parse_error_t * error, size_t * len)
+{
+    char buf[64];
+    epc_parser_t const * p = error->parser;
+
+    switch (error->expected_kind)
+    {
+    case PARSE_ERROR_EXPECTED_ALTERNATIVES:
+        return parse_error_write_alternatives_expected(error, len, p);
+
+    case PARSE_ERROR_EXPECTED_NOT:
+        snprintf(buf, sizeof(buf), "not %s", parser_get_expected_str(p->data.parser));
+        return parse_error_strings_printf(error, len, "%s", buf);
+
+    case PARSE_ERROR_EXPECTED_CHAR_RANGE:
+        snprintf(buf, 32, "character in range [%c-%c]", p->data.range.start, p->data.range.end);
+        return parse_error_strings_printf(error, len, "%s", buf);
+
+    case PARSE_ERROR_EXPECTED_ONE_OF:
+        snprintf(buf, sizeof(buf), "character in set '%s'", p->data.string);
+        return parse_error_strings_printf(error, len, "%s", buf);
+
+    case PARSE_ERROR_EXPECTED_NONE_OF:
+        snprintf(buf, sizeof(buf), "character not in set '%s'", p->data.string);
+        return parse_error_strings_printf(error, len, "%s", buf);
+
+    case PARSE_ERROR_EXPECTED_TEXT:
+        break;
+    }
+
+    return parse_error_strings_printf(error, len, "%s", error->expected != NULL ? error->expected : "");
+}
+
+static bool
+parse_error_write_message(parse_error_t * error, size_t * len)
+{
+    if (error->reason == PARSE_ERROR_REASON_COUNT_MISMATCH)
+    {
+        return parse_error_strings_printf(error, len, "Count failed to match child at count %zu", error->arg);
+    }
+
+    return parse_error_strings_printf(error, len, "%s", error->message != NULL ? error->message : "");
+}
+
+EASY_PC_HIDDEN
+void
+epc_parser_error_materialize(epc_parser_ctx_t * ctx, epc_parser_error_t * public_error)
+{
+    if (public_error == NULL)
+    {
+        return;
+    }
+
+    parse_error_t * error = parse_error_from_public(public_error);
+    if (error->materialized)
+    {
+        return;
+    }
+
+    char const * input_start = ctx != NULL ? parse_ctx_get_input_start(ctx) : NULL;
+
+    error->error.input_position = input_start != NULL ? input_start + error->input_offset : NULL;
+    error->error.position = epc_parse_ctx_get_line_col(ctx, error->input_offset);
+
+    // The three strings go one after another into a buffer the session keeps between parses. They are located once
+    // the buffer has stopped moving.
+    size_t len = 0;
+    bool is_written = parse_error_strings_reserve(error, 1) && parse_error_write_message(error, &len);
+    size_t const expected_start = ++len;
+
+    is_written = is_written && parse_error_write_expected(error, &len);
+
+    size_t const found_start = ++len;
+
+    is_written = is_written
+                 && parse_error_strings_printf(error, &len, "%s", error->found != NULL ? error->found : "");
+
+    error->error.message = is_written ? error->strings->text : "";
+    error->error.expected = is_written ? error->strings->text + expected_start : "";
+    error->error.found = is_written ? error->strings->text + found_start : "";
+    error->materialized = true;
+}
+
+EASY_PC_HIDDEN
+size_t
+epc_parser_error_get_offset(epc_parser_error_t const * error)
+{
+    return ((parse_error_t const *)error)->input_offset;
+}
+
 void
 epc_parser_result_cleanup(epc_parse_result_t * result)
 {
@@ -258,10 +486,15 @@ epc_parser_result_cleanup(epc_parse_result_t * result)
 epc_parse_result_t
 epc_unparsed_error_result(size_t input_offset, char const * message, char const * expected, char const * found)
 {
+    parse_error_t * error = parse_error_new(NULL, input_offset, message, expected, found);
     epc_parse_result_t result = {
         .is_error = true,
-        .data.error = epc_parser_error_alloc(NULL, input_offset, message, expected, found),
+        .data.error = error != NULL ? &error->error : NULL,
     };
+
+    // There is no parse context to hold on to, so build the strings straight away.
+    epc_parser_error_materialize(NULL, result.data.error);
+
     return result;
 }
 
@@ -278,41 +511,169 @@ parser_error_copy(epc_parser_ctx_t * ctx, epc_parser_error_t * e)
     {
         return NULL;
     }
-    return epc_parser_error_alloc(
-        ctx, parse_ctx_get_offset_from_input(ctx, e->input_position), e->message, e->expected, e->found
-    );
+
+    parse_error_t * copy = parse_error_copy(ctx, parse_error_from_public(e));
+
+    return copy != NULL ? &copy->error : NULL;
 }
 
 static void
-update_furthest_error(epc_parser_ctx_t * ctx, epc_parser_error_t * new_error)
+update_furthest_error(epc_parser_ctx_t * ctx, parse_error_t const * new_error)
 {
     if (ctx == NULL || new_error == NULL)
     {
         return;
     }
 
-    epc_parser_error_t const * furthest_error = parse_ctx_get_furthest_error(ctx);
+    epc_parser_error_t * furthest_error = parse_ctx_get_furthest_error(ctx);
+
+    if (furthest_error == NULL)
+    {
+        parse_error_t * e_copy = parse_error_copy(ctx, new_error);
+        epc_parser_error_t * replacement = e_copy != NULL ? &e_copy->error : NULL;
 
-    if (furthest_error == NULL || (new_error->input_position >= furthest_error->input_position))
+        parser_furthest_error_restore(ctx, &replacement);
+    }
+    else if (new_error->input_offset >= parse_error_from_public(furthest_error)->input_offset)
     {
-        epc_parser_error_t * e_copy = parser_error_copy(ctx, new_error);
-        parser_furthest_error_restore(ctx, &e_copy);
+        // Overwrite the existing record rather than allocating a new one.
+        parse_error_copy_into(parse_error_from_public(furthest_error), new_error);
     }
 }
 
+// Wraps an error record in a failed result, and records it as the furthest error if appropriate.
 static epc_parse_result_t
-epc_parser_error_result(
-    epc_parser_ctx_t * ctx, size_t input_offset, char const * message, char const * expected, char const * found
-)
+parse_error_result(epc_parser_ctx_t * ctx, parse_error_t * error)
 {
     epc_parse_result_t result = {
         .is_error = true,
-        .data.error = epc_parser_error_alloc(ctx, input_offset, message, expected, found),
+        .data.error = error != NULL ? &error->error : NULL,
     };
-    update_furthest_error(ctx, result.data.error);
+    update_furthest_error(ctx, error);
     return result;
 }
 
+static epc_parse_result_t
+epc_parser_error_result(
+    epc_parser_ctx_t * ctx, size_t input_offset, char const * message, char const * expected, char const * found
+)
+{
+    return parse_error_result(ctx, parse_error_new(ctx, input_offset, message, expected, found));
+}
+
+// Creates a failed result whose expected string is derived from the parser (see parse_error_expected_t).
+static epc_parse_result_t
+parser_derived_error_result(
+    epc_parser_ctx_t * ctx,
+    epc_parser_t const * self,
+    size_t input_offset,
+    char const * message,
+    parse_error_expected_t expected_kind,
+    char const * found
+)
+{
+    parse_error_t * error = parse_error_new(ctx, input_offset, message, NULL, found);
+    if (error != NULL)
+    {
+        error->expected_kind = expected_kind;
+        error->parser = self;
+    }
+
+    return parse_error_result(ctx, error);
+}
+
+// Creates an error at `input_offset` that reports what a failed child expected and found, with its own message.
+static parse_error_t *
+parse_error_from_child(
+    epc_parser_ctx_t * ctx, size_t input_offset, char const * message, epc_parser_error_t * child_error
+)
+{
+    if (child_error == NULL)
+    {
+        return parse_error_new(ctx, input_offset, message, NULL, NULL);
+    }
+
+    parse_error_t * error = parse_error_copy(ctx, parse_error_from_public(child_error));
+    if (error == NULL)
+    {
+        return NULL;
+    }
+    error->input_offset = input_offset;
+    error->reason = PARSE_ERROR_REASON_MESSAGE;
+    error->message = message;
+
+    return error;
+}
+
+// The errors combinators report once their children have run. The grammar VM reports the same ones.
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+parser_no_alternative_error_result(
+    epc_parser_ctx_t * ctx, epc_parser_t const * self, size_t input_offset, char const * input
+)
+{
+    char found_buffer[FOUND_BUFFER_SIZE];
+    snprintf(found_buffer, sizeof(found_buffer), "%.*s", (int)sizeof(found_buffer) - 1, input);
+
+    // The "a or b or ..." expected string is only built if this error is reported.
+    parse_error_t * error = parse_error_new(ctx, input_offset, "No alternative matched", NULL, found_buffer);
+    if (error != NULL)
+    {
+        error->expected_kind = PARSE_ERROR_EXPECTED_ALTERNATIVES;
+        error->parser = self;
+    }
+
+    return parse_error_result(ctx, error);
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+parser_count_error_result(
+    epc_parser_ctx_t * ctx, size_t input_offset, size_t matched, epc_parser_error_t * child_error
+)
+{
+    parse_error_t * error = parse_error_from_child(ctx, input_offset, NULL, child_error);
+    if (error != NULL)
+    {
+        error->reason = PARSE_ERROR_REASON_COUNT_MISMATCH;
+        error->arg = matched + 1;
+    }
+
+    return parse_error_result(ctx, error);
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+parser_unexpected_match_error_result(
+    epc_parser_ctx_t * ctx, epc_parser_t const * self, size_t input_offset, epc_cpt_node_t const * match
+)
+{
+    parse_error_t * error = parse_error_new(ctx, input_offset, "Parser unexpectedly matched", NULL, NULL);
+    if (error != NULL)
+    {
+        error->expected_kind = PARSE_ERROR_EXPECTED_NOT;
+        error->parser = self;
+        error->found = match->content; // Points into the input, which outlives the error.
+    }
+
+    return parse_error_result(ctx, error);
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+parser_no_progress_error_result(epc_parser_ctx_t * ctx, size_t input_offset)
+{
+    return epc_parser_error_result(ctx, input_offset, "Infinite recursion detected", "Progress", "No progress");
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+parser_out_of_memory_error_result(epc_parser_ctx_t * ctx, epc_parser_t const * self, size_t input_offset)
+{
+    return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
+}
+
 epc_parse_result_t
 epc_parser_success_result(epc_cpt_node_t * success_node)
 {
@@ -330,6 +691,16 @@ parser_furthest_error_copy(epc_parser_ctx_t * ctx)
     return parser_error_copy(ctx, parse_ctx_get_furthest_error(ctx));
 }
 
+EASY_PC_HIDDEN
+void
+parser_furthest_error_merge(epc_parser_ctx_t * ctx, epc_parser_error_t * error)
+{
+    if (error != NULL)
+    {
+        update_furthest_error(ctx, parse_error_from_public(error));
+    }
+}
+
 static char const *
 parser_get_expected_str(epc_parser_t const * p)
 {
@@ -349,19 +720,293 @@ parser_get_expected_str(epc_parser_t const * p)
 
 #define WITH_PARSE_DEBUG 0
 
-// Parser helper function
+// Rebuilds a parse result from a memo entry. Cached nodes are shared; cached errors are copied as the caller owns
+// the error it receives. The furthest error that finding the result reached is recorded again, as running the parser
+// would have done.
 static epc_parse_result_t
-parse(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+memo_entry_result(epc_parser_ctx_t * ctx, memo_entry_t const * entry)
 {
-#if WITH_PARSE_DEBUG
-    parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
+    if (entry->furthest_error != NULL)
+    {
+        update_furthest_error(ctx, parse_error_from_public(entry->furthest_error));
+    }
+    if (!entry->result.is_error)
+    {
+        return entry->result;
+    }
 
-    char const * input = input_result.next_input;
+    epc_parse_result_t result = {
+        .is_error = true,
+        .data.error = parser_error_copy(ctx, entry->result.data.error),
+    };
+
+    return result;
+}
+
+static void
+memo_store_result(
+    epc_parser_ctx_t * ctx, memo_table_t * memo, epc_parser_t const * self, size_t input_offset, epc_parse_result_t result
+)
+{
+    epc_parser_error_t * furthest_error = parser_furthest_error_copy(ctx);
+
+    if (result.is_error)
+    {
+        result.data.error = parser_error_copy(ctx, result.data.error);
+        if (result.data.error == NULL)
+        {
+            epc_parser_error_free(furthest_error);
+            return;
+        }
+    }
+    if (!memo_table_store(memo, self, input_offset, result, furthest_error))
+    {
+        if (result.is_error)
+        {
+            epc_parser_error_free(result.data.error);
+        }
+        epc_parser_error_free(furthest_error);
+    }
+}
+
+// Puts back the furthest error from before a memoized parser ran, merged with the one the parser reached.
+static void
+memo_furthest_error_merge(epc_parser_ctx_t * ctx, epc_parser_error_t ** outer)
+{
+    epc_parser_error_t * inner = parse_ctx_take_furthest_error(ctx);
+    bool const inner_is_further
+        = inner != NULL
+          && (*outer == NULL
+              || parse_error_from_public(inner)->input_offset >= parse_error_from_public(*outer)->input_offset);
+
+    parser_ctx_set_furthest_error(ctx, inner_is_further ? &inner : outer);
+    epc_parser_error_free(inner);
+    epc_parser_error_free(*outer);
+    *outer = NULL;
+}
+
+// Runs the AST actions for the result of a parser that started at `mark`, when the AST is built during the parse. The
+// nodes below a match are reclaimed once its actions have run, leaving a leaf in its place.
+static epc_parse_result_t
+parse_build_ast(
+    epc_parser_ctx_t * ctx,
+    epc_ast_builder_ctx_t * builder,
+    epc_parser_t const * self,
+    size_t input_offset,
+    epc_parse_result_t result,
+    parse_ctx_mark_t const * mark,
+    ast_builder_mark_t const * ast_mark
+)
+{
+    if (result.is_error)
+    {
+        ast_builder_rollback(builder, ast_mark);
+        return result;
+    }
+
+    ast_builder_reduce(builder, result.data.success, ast_mark);
+
+    epc_cpt_node_t * leaf = parse_ctx_token_node(ctx, result.data.success, mark);
+
+    if (leaf == NULL)
+    {
+        ast_builder_rollback(builder, ast_mark);
+        return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
+    }
+    ast_builder_record(builder, leaf, ast_mark);
+
+    return epc_parser_success_result(leaf);
+}
+
+// Parser helper function
+// Returns the growth of `self` at `input_offset`, or NULL if it isn't being grown there.
+static left_recursion_t const *
+parse_left_recursion_find(epc_parser_ctx_t const * ctx, epc_parser_t const * self, size_t input_offset)
+{
+    for (left_recursion_t const * growing = parse_ctx_get_left_recursion(ctx); growing != NULL;
+         growing = growing->outer)
+    {
+        if (growing->parser == self && growing->input_offset == input_offset)
+        {
+            return growing;
+        }
+    }
+
+    return NULL;
+}
+
+// The result of a left-recursive call to a parser being grown: its longest match so far.
+static epc_parse_result_t
+parse_seed_result(epc_parser_ctx_t * ctx, left_recursion_t const * growing)
+{
+    if (growing->seed != NULL)
+    {
+        return epc_parser_success_result(growing->seed);
+    }
+
+    // The recursion fails until there is a match to grow. That says nothing about the input, so unlike other
+    // failures it isn't a candidate for the furthest error.
+    parse_error_t * error = parse_error_new(
+        ctx, growing->input_offset, "Left recursion", epc_parser_get_name(growing->parser), "N/A"
+    );
+
+    return (epc_parse_result_t){.is_error = true, .data.error = error != NULL ? &error->error : NULL};
+}
+
+// Parses a left-recursive parser by growing a seed (Warth et al., "Packrat Parsers Can Support Left Recursion"). The
+// first run matches without the left-recursive alternatives, as the recursion fails. Each further run gets the match
+// of the run before wherever it recurses at `input_offset`, until a run matches no more of the input than the one
+// before. The AST actions run once, on the final match, as it contains all the others.
+static epc_parse_result_t
+parse_grow(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+{
+    left_recursion_t growing = {
+        .parser = self,
+        .input_offset = input_offset,
+        .outer = parse_ctx_get_left_recursion(ctx),
+    };
+
+    parse_ctx_set_left_recursion(ctx, &growing);
+
+    epc_parse_result_t result = self->parse_fn(self, ctx, input_offset);
+
+    while (!result.is_error)
+    {
+        growing.seed = result.data.success;
+
+        parse_ctx_mark_t const mark = parse_ctx_mark(ctx);
+        epc_parse_result_t grown = self->parse_fn(self, ctx, input_offset);
+
+        if (grown.is_error || grown.data.success->len <= growing.seed->len)
+        {
+            epc_parser_result_cleanup(&grown);
+            parse_ctx_reclaim(ctx, &mark);
+            break;
+        }
+        result = grown;
+    }
+
+    parse_ctx_set_left_recursion(ctx, growing.outer);
+
+    return result;
+}
+
+// The plan and checked generation fields aren't declared _Atomic, as the header is also included from C++, so they
+// are accessed through these. A plan is published with a release store, so a parse that loads it sees all of it.
+static parser_plan_t *
+parser_plan_load(epc_parser_t const * p)
+{
+    return atomic_load_explicit((parser_plan_t * _Atomic const *)&p->plan, memory_order_acquire);
+}
+
+static void
+parser_plan_store(epc_parser_t * p, parser_plan_t * plan)
+{
+    atomic_store_explicit((parser_plan_t * _Atomic *)&p->plan, plan, memory_order_release);
+}
+
+static unsigned long
+parser_checked_generation_load(epc_parser_t const * p)
+{
+    return atomic_load_explicit((unsigned long _Atomic const *)&p->checked_generation, memory_order_acquire);
+}
+
+static void
+parser_checked_generation_store(epc_parser_t * p, unsigned long generation)
+{
+    atomic_store_explicit((unsigned long _Atomic *)&p->checked_generation, generation, memory_order_release);
+}
+
+static epc_parse_result_t
+parse_unprofiled(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+{
+#if WITH_PARSE_DEBUG
+    parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
+
+    char const * input = input_result.next_input;
 
     fprintf(stderr, "parsing: name: %s. input `%s`, offset: %zu\n", epc_parser_get_name(self), input, input_offset);
 #endif
 
-    epc_parse_result_t result = self->parse_fn(self, ctx, input_offset);
+    if (parse_ctx_is_abandoned(ctx))
+    {
+        return epc_parser_error_result(ctx, input_offset, "Parse abandoned", epc_parser_get_name(self), "N/A");
+    }
+
+    parser_plan_t const * const plan = parser_plan_load(self);
+    bool const is_left_recursive = plan != NULL && plan->is_left_recursive;
+
+    if (is_left_recursive)
+    {
+        left_recursion_t const * growing = parse_left_recursion_find(ctx, self, input_offset);
+
+        if (growing != NULL)
+        {
+            return parse_seed_result(ctx, growing);
+        }
+    }
+
+    memo_table_t * const memo = parse_ctx_get_memo_table(ctx);
+    bool const memoize = parse_ctx_should_memoize(ctx, self, input_offset);
+
+    if (memoize)
+    {
+        memo_entry_t const * entry = memo_table_lookup(memo, self, input_offset);
+        if (entry != NULL)
+        {
+            return memo_entry_result(ctx, entry);
+        }
+    }
+
+    // A memoized parser starts from no furthest error, so that the one it reaches can be cached with its result, to be
+    // recorded again when the result is reused. The furthest error from before is merged back in afterwards.
+    epc_parser_error_t * outer_furthest_error = memoize ? parse_ctx_take_furthest_error(ctx) : NULL;
+    parse_ctx_mark_t const mark = parse_ctx_mark(ctx);
+    epc_ast_builder_ctx_t * const ast_builder = parse_ctx_get_ast_builder(ctx);
+    ast_builder_mark_t const ast_mark = ast_builder != NULL ? ast_builder_mark(ast_builder) : (ast_builder_mark_t){0};
+    epc_parse_result_t result
+        = is_left_recursive ? parse_grow(self, ctx, input_offset) : self->parse_fn(self, ctx, input_offset);
+
+    if (self->is_token && !result.is_error)
+    {
+        // The actions of a token's children don't run, as they aren't part of the CPT.
+        if (ast_builder != NULL)
+        {
+            ast_builder_rollback(ast_builder, &ast_mark);
+        }
+        epc_cpt_node_t * token = parse_ctx_token_node(ctx, result.data.success, &mark);
+
+        if (token == NULL)
+        {
+            result = epc_parser_error_result(
+                ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A"
+            );
+            if (memoize)
+            {
+                memo_furthest_error_merge(ctx, &outer_furthest_error);
+            }
+            return result;
+        }
+        result.data.success = token;
+    }
+
+    if (ast_builder != NULL)
+    {
+        result = parse_build_ast(ctx, ast_builder, self, input_offset, result, &mark, &ast_mark);
+    }
+
+    if (memoize)
+    {
+        memo_store_result(ctx, memo, self, input_offset, result);
+        memo_furthest_error_merge(ctx, &outer_furthest_error);
+    }
+
+    // A failed parser leaves no live nodes behind, so anything it allocated can be reclaimed, unless a successful
+    // sub-result memoized meanwhile refers to it.
+    if (result.is_error)
+    {
+        parse_ctx_reclaim(ctx, &mark);
+    }
 
 #if WITH_PARSE_DEBUG
     if (result.is_error)
@@ -379,6 +1024,132 @@ parse(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
     return result;
 }
 
+static epc_parse_result_t
+parse(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+{
+#ifdef WITH_PARSE_PROFILING
+    profile_t * const profile = parse_ctx_get_profile(ctx);
+
+    if (profile != NULL)
+    {
+        profile_frame_t frame;
+
+        profile_enter(profile, &frame, self, input_offset);
+
+        epc_parse_result_t const result = parse_unprofiled(self, ctx, input_offset);
+        size_t const len = !result.is_error && result.data.success != NULL ? result.data.success->len : 0;
+
+        profile_exit(profile, &frame, result.is_error, len);
+
+        return result;
+    }
+#endif
+
+    return parse_unprofiled(self, ctx, input_offset);
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+epc_parser_parse(epc_parser_t * p, epc_parser_ctx_t * ctx, size_t input_offset)
+{
+    return parse(p, ctx, input_offset);
+}
+
+// --- FIRST sets ---
+
+static first_set_t const first_set_anything = {
+    .bytes = {UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX},
+    .nullable = true,
+};
+
+// Bumped whenever a parser is redefined. Each grammar's parsers are only planned again if one they reach was.
+static atomic_ulong grammar_generation = 1;
+
+// Set while epc_parser_first_set_from() runs, to look up the FIRST sets of children instead.
+static _Thread_local first_set_lookup_fn first_set_lookup;
+static _Thread_local void * first_set_lookup_data;
+
+// Returns the FIRST set of `p`. While its grammar is finalized, that of a parser being planned again is worked out.
+static first_set_t const *
+parser_first_set(epc_parser_t * p)
+{
+    if (first_set_lookup != NULL)
+    {
+        return first_set_lookup(p, first_set_lookup_data);
+    }
+    if (p == NULL)
+    {
+        return &first_set_anything;
+    }
+
+    parser_plan_t * pending = p->pending_plan;
+
+    if (pending == NULL)
+    {
+        parser_plan_t const * plan = parser_plan_load(p);
+
+        return plan != NULL ? &plan->first_set : &first_set_anything;
+    }
+    if (p->first_set_known)
+    {
+        return &pending->first_set;
+    }
+    if (p->first_set_computing)
+    {
+        // Left recursion; nothing can be ruled out. Every cycle comes back to a parser this way, so its matches are
+        // grown from a seed when it is parsed.
+        pending->is_left_recursive = true;
+        return &first_set_anything;
+    }
+
+    first_set_t first = {0};
+
+    p->first_set_computing = true;
+    if (p->first_set_fn != NULL)
+    {
+        p->first_set_fn(p, &first);
+    }
+    else
+    {
+        first = first_set_anything;
+    }
+    p->first_set_computing = false;
+
+    pending->first_set = first;
+    p->first_set_known = true;
+
+    return &pending->first_set;
+}
+
+// Adds the bytes accepted by a <ctype.h> classifier. Bytes outside of ASCII are always added, as whether they are
+// accepted depends on the locale and the signedness of char.
+static void
+first_set_add_class(first_set_t * first, int (*is_class)(int))
+{
+    for (int c = 0; c <= SCHAR_MAX; c++)
+    {
+        if (is_class(c))
+        {
+            first_set_add(first, (unsigned char)c);
+        }
+    }
+    first_set_add_range(first, SCHAR_MAX + 1, UCHAR_MAX);
+}
+
+// The FIRST set of parsers that are matched one after the other.
+static void
+first_set_of_sequence(first_set_t * first, epc_parser_t * const * parsers, int count)
+{
+    first->nullable = true;
+    for (int i = 0; i < count && first->nullable; i++)
+    {
+        first_set_t const * child = parser_first_set(parsers[i]);
+
+        first_set_union(first, child);
+        first->nullable = child->nullable;
+    }
+}
+
 // --- Terminal Parser Implementations ---
 
 static epc_parse_result_t
@@ -397,7 +1168,7 @@ pchar_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
 
     if (input[0] == expected_char)
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -417,10 +1188,16 @@ pchar_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     return epc_parser_error_result(ctx, input_offset, "Unexpected character", expected_str, found_str);
 }
 
+static void
+pchar_first_set(epc_parser_t * self, first_set_t * first)
+{
+    first_set_add(first, (unsigned char)self->data.string[0]);
+}
+
 epc_parser_t *
 epc_char(char const * name, char c)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "char", pchar_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "char", pchar_parse_fn, pchar_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -467,7 +1244,7 @@ pstring_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
 
     if (strncmp(input, expected_str, expected_len) == 0)
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -488,10 +1265,25 @@ pstring_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
     return epc_parser_error_result(ctx, input_offset, "Unexpected string", expected_str, found_buffer);
 }
 
+static void
+pstring_first_set(epc_parser_t * self, first_set_t * first)
+{
+    char const * expected_str = self->data.string;
+
+    if (expected_str[0] == '\0')
+    {
+        first->nullable = true;
+    }
+    else
+    {
+        first_set_add(first, (unsigned char)expected_str[0]);
+    }
+}
+
 epc_parser_t *
 epc_string(char const * name, char const * s)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "string", pstring_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "string", pstring_parse_fn, pstring_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -510,46 +1302,190 @@ epc_string(char const * name, char const * s)
 }
 
 static epc_parse_result_t
-peoi_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+pkeywords_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
 {
-    parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
+    keywords_data_t const * keywords = self->data.keywords;
+    parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, keywords->trie.max_len);
+    char const * input = input_result.next_input;
+    size_t const available = input != NULL ? input_result.available : 0;
+    size_t len;
+    int const keyword = keyword_trie_match(&keywords->trie, input, available, &len);
 
-    if (!input_result.is_eof)
+    if (keyword >= 0)
     {
-        /* Still some input left. */
-        char buf[FOUND_BUFFER_SIZE];
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
+        if (node == NULL)
+        {
+            return epc_parser_error_result(
+                ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A"
+            );
+        }
 
-        strncpy(buf, input_result.next_input, sizeof(buf));
-        buf[sizeof(buf) - 1] = '\0';
+        node->content = input;
+        node->len = len;
+        node->keyword = (uint16_t)(keyword + 1);
 
-        return epc_parser_error_result(ctx, input_offset, "End of input not found", "<end of input>", buf);
+        return epc_parser_success_result(node);
     }
 
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
-    if (node == NULL)
+    if (available == 0)
     {
-        return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
+        return epc_parser_error_result(ctx, input_offset, "Unexpected end of input", keywords->expected, "EOF");
     }
 
-    node->content = input_result.next_input;
-    node->len = 0;
+    char found_buffer[FOUND_BUFFER_SIZE];
+    snprintf(found_buffer, sizeof(found_buffer), "%.*s", (int)sizeof(found_buffer) - 1, input);
 
-    return epc_parser_success_result(node);
+    return epc_parser_error_result(ctx, input_offset, "No keyword matched", keywords->expected, found_buffer);
 }
 
-epc_parser_t *
-epc_eoi(char const * name)
+static void
+pkeywords_first_set(epc_parser_t * self, first_set_t * first)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "eoi", peoi_parse_fn);
-    if (p == NULL)
+    keywords_data_t const * keywords = self->data.keywords;
+
+    for (int i = 0; i < keywords->count; ++i)
     {
-        return NULL;
+        if (keywords->keywords[i][0] == '\0')
+        {
+            first->nullable = true;
+        }
+        else
+        {
+            first_set_add(first, (unsigned char)keywords->keywords[i][0]);
+        }
     }
-    return p;
 }
 
-static epc_parse_result_t
-pdigit_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+epc_parser_t *
+epc_keywords_array(char const * name, int count, char const * const * keywords)
+{
+    if (keywords == NULL)
+    {
+        return NULL;
+    }
+
+    epc_parser_t * p = epc_parser_allocate(name, "keywords", pkeywords_parse_fn, pkeywords_first_set);
+    keywords_data_t * data = p != NULL ? keywords_data_create(keywords, count) : NULL;
+
+    if (data == NULL)
+    {
+        epc_parser_free(p);
+        return NULL;
+    }
+    p->data.type = PARSER_DATA_TYPE_KEYWORDS;
+    p->data.keywords = data;
+    p->expected_value = data->expected;
+
+    return p;
+}
+
+epc_parser_t *
+epc_keywords_array_l(epc_parser_list * list, char const * name, int count, char const * const * keywords)
+{
+    epc_parser_t * p = epc_keywords_array(name, count, keywords);
+
+    epc_parser_list_add(list, p);
+    return p;
+}
+
+static epc_parser_t *
+vepc_keywords(char const * name, int count, va_list args)
+{
+    if (count <= 0 || count > UINT16_MAX)
+    {
+        return NULL;
+    }
+
+    char const ** strings = calloc(count, sizeof(*strings));
+    if (strings == NULL)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        strings[i] = va_arg(args, char const *);
+    }
+
+    epc_parser_t * p = epc_keywords_array(name, count, strings);
+
+    free(strings);
+    return p;
+}
+
+epc_parser_t *
+epc_keywords(char const * name, int count, ...)
+{
+    va_list args;
+
+    va_start(args, count);
+    epc_parser_t * p = vepc_keywords(name, count, args);
+    va_end(args);
+
+    return p;
+}
+
+epc_parser_t *
+epc_keywords_l(epc_parser_list * list, char const * name, int count, ...)
+{
+    va_list args;
+
+    va_start(args, count);
+    epc_parser_t * p = vepc_keywords(name, count, args);
+    va_end(args);
+
+    epc_parser_list_add(list, p);
+    return p;
+}
+
+static epc_parse_result_t
+peoi_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
+{
+    parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
+
+    if (!input_result.is_eof)
+    {
+        /* Still some input left. */
+        char buf[FOUND_BUFFER_SIZE];
+
+        strncpy(buf, input_result.next_input, sizeof(buf));
+        buf[sizeof(buf) - 1] = '\0';
+
+        return epc_parser_error_result(ctx, input_offset, "End of input not found", "<end of input>", buf);
+    }
+
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
+    if (node == NULL)
+    {
+        return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
+    }
+
+    node->content = input_result.next_input;
+    node->len = 0;
+
+    return epc_parser_success_result(node);
+}
+
+static void
+peoi_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first->nullable = true;
+}
+
+epc_parser_t *
+epc_eoi(char const * name)
+{
+    epc_parser_t * p = epc_parser_allocate(name, "eoi", peoi_parse_fn, peoi_first_set);
+    if (p == NULL)
+    {
+        return NULL;
+    }
+    return p;
+}
+
+static epc_parse_result_t
+pdigit_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
 {
     parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
 
@@ -562,7 +1498,7 @@ pdigit_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
 
     if (isdigit(input[0]))
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -581,10 +1517,17 @@ pdigit_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
     return epc_parser_error_result(ctx, input_offset, "Unexpected character", "digit", found_str);
 }
 
+static void
+pdigit_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add_class(first, isdigit);
+}
+
 epc_parser_t *
 epc_digit(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "digit", pdigit_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "digit", pdigit_parse_fn, pdigit_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -613,58 +1556,42 @@ is_double_prefix(char const * s, size_t len)
 static epc_parse_result_t
 pint_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
 {
-    size_t parsed_len = 0;
-    char const * input = NULL;
+    parse_get_input_result_t input_result = parse_ctx_get_input_window(ctx, input_offset);
 
-    {
-        size_t current_len = 0;
-        while (1)
-        {
-            parse_get_input_result_t res = parse_ctx_get_input_at_offset(ctx, input_offset, current_len + 1);
-            if (res.is_eof)
-            {
-                break;
-            }
-
-            input = res.next_input;
-            current_len = res.available;
-
-            char * endptr;
-            (void)strtoll(input, &endptr, 10);
-            parsed_len = (size_t)(endptr - input);
-
-            if (parsed_len < current_len)
-            {
-                // If it parsed 0 but the first char is a sign, we wait for more digits.
-                if (parsed_len > 0 || input[0] != '-')
-                {
-                    break;
-                }
-                // Continue loop to wait for more data or EOF
-            }
-        }
-    }
-
-    parse_get_input_result_t input_result
-        = parse_ctx_get_input_at_offset(ctx, input_offset, parsed_len > 0 ? parsed_len : 1);
-
-    if (input_result.is_eof && parsed_len == 0)
+    if (input_result.is_eof)
     {
         return epc_parser_error_result(ctx, input_offset, "Unexpected end of input", "integer", "EOF");
     }
 
-    input = input_result.next_input;
-    if (parsed_len == 0)
+    // Scan an optional '-' and the digits after it. If they run to the end of the window, more of them may be on
+    // their way.
+    char const * input = input_result.next_input;
+    size_t available = input_result.available;
+    size_t parsed_len = input[0] == '-' ? 1 : 0;
+
+    while (1)
     {
-        char * endptr;
-        (void)strtoll(input, &endptr, 10);
-        parsed_len = (size_t)(endptr - input);
+        while (parsed_len < available && isdigit((unsigned char)input[parsed_len]))
+        {
+            parsed_len++;
+        }
+        if (parsed_len < available)
+        {
+            break;
+        }
+        input_result = parse_ctx_get_input_at_offset(ctx, input_offset, parsed_len + 1);
+        if (input_result.is_eof)
+        {
+            break;
+        }
+        input = input_result.next_input;
+        available = input_result.available;
     }
 
     // A valid integer must parse at least one digit
-    if (parsed_len > 0 && (isdigit(input[0]) || (input[0] == '-' && parsed_len > 1 && isdigit(input[1]))))
+    if (isdigit((unsigned char)input[0]) || parsed_len > 1)
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -679,24 +1606,24 @@ pint_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
     }
 
     /* No match to an integer. */
-    char found_buffer[FOUND_BUFFER_SIZE];
-    if (input_result.is_eof)
-    {
-        strncpy(found_buffer, "EOF", sizeof(found_buffer) - 1);
-    }
-    else
-    {
-        snprintf(found_buffer, sizeof(found_buffer), "%.*s", 1, input);
-    }
-    found_buffer[sizeof(found_buffer) - 1] = '\0';
+    char found_buffer[2] = {input[0], '\0'};
 
     return epc_parser_error_result(ctx, input_offset, "Expected an integer", "integer", found_buffer);
 }
 
+static void
+pint_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    // A match must start with a digit, or with a '-' followed by a digit.
+    first_set_add_class(first, isdigit);
+    first_set_add(first, '-');
+}
+
 epc_parser_t *
 epc_int(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "integer", pint_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "integer", pint_parse_fn, pint_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -721,7 +1648,7 @@ pspace_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
 
     if (isspace(input[0]))
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -741,10 +1668,17 @@ pspace_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
     return epc_parser_error_result(ctx, input_offset, "Unexpected character", "whitespace", found_str);
 }
 
+static void
+pspace_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add_class(first, isspace);
+}
+
 epc_parser_t *
 epc_space(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "space", pspace_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "space", pspace_parse_fn, pspace_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -767,7 +1701,7 @@ palpha_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
 
     if (isalpha(input[0]))
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -787,10 +1721,17 @@ palpha_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
     return epc_parser_error_result(ctx, input_offset, "Unexpected character", "alpha", found_str);
 }
 
+static void
+palpha_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add_class(first, isalpha);
+}
+
 epc_parser_t *
 epc_alpha(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "alpha", palpha_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "alpha", palpha_parse_fn, palpha_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -813,7 +1754,7 @@ palphanum_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t in
 
     if (isalnum(input[0]))
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -833,10 +1774,17 @@ palphanum_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t in
     return epc_parser_error_result(ctx, input_offset, "Unexpected character", "alphanum", found_str);
 }
 
+static void
+palphanum_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add_class(first, isalnum);
+}
+
 epc_parser_t *
 epc_alphanum(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "alphanum", palphanum_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "alphanum", palphanum_parse_fn, palphanum_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -920,7 +1868,7 @@ pdouble_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
         return epc_parser_error_result(ctx, input_offset, "Expected a double", "double", found_str);
     }
 
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
@@ -932,10 +1880,19 @@ pdouble_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
     return epc_parser_success_result(node);
 }
 
+// strtod() accepts too many forms (inf, nan, hex, locale specific decimal points) to list the bytes a double may start
+// with, but it always consumes something.
+static void
+pdouble_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add_all(first);
+}
+
 epc_parser_t *
 epc_double(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "double", pdouble_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "double", pdouble_parse_fn, pdouble_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -944,6 +1901,56 @@ epc_double(char const * name)
     return p;
 }
 
+static bool
+parse_error_write_alternatives_expected(parse_error_t * error, size_t * len, epc_parser_t const * p)
+{
+    parser_list_t const * alternatives = p->data.parser_list;
+    size_t estimated_len = 0;
+
+    for (int i = 0; i < alternatives->count; ++i)
+    {
+        if (alternatives->parsers[i])
+        {
+            char const * temp_expected = parser_get_expected_str(alternatives->parsers[i]);
+
+            estimated_len += strlen(temp_expected);
+            if (i < alternatives->count - 1)
+            {
+                estimated_len += strlen(" or ");
+            }
+        }
+    }
+
+    if (estimated_len == 0)
+    {
+        return parse_error_strings_printf(error, len, "%s", epc_parser_get_name(p));
+    }
+
+    for (int i = 0; i < alternatives->count; ++i)
+    {
+        if (alternatives->parsers[i])
+        {
+            char const * child_expected = parser_get_expected_str(alternatives->parsers[i]);
+            if (child_expected
+                && !parse_error_strings_printf(
+                    error, len, "%s%s", child_expected, i < alternatives->count - 1 ? " or " : ""
+                ))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// The number of words in each row of the dispatch table of an epc_or.
+static size_t
+or_dispatch_words(parser_list_t const * alternatives)
+{
+    return ((size_t)alternatives->count + 63) / 64;
+}
+
 static epc_parse_result_t
 por_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
 {
@@ -966,16 +1973,31 @@ por_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_of
 
     original_furthest_error = parser_furthest_error_copy(ctx);
 
+    // Alternatives that can't match the next byte are skipped. They would only have failed at this offset, and any
+    // such failure is superseded by the error reported below if no alternative matches.
+    parser_plan_t const * const plan = parser_plan_load(self);
+    uint64_t const * candidates = NULL;
+    if (plan != NULL && plan->dispatch != NULL)
+    {
+        unsigned char const next = (unsigned char)input_result.next_input[0];
+
+        candidates = &plan->dispatch[next * or_dispatch_words(alternatives)];
+    }
+
     for (int i = 0; i < alternatives->count; ++i)
     {
         epc_parser_t * current_parser = alternatives->parsers[i];
+        if (candidates != NULL && (candidates[i / 64] & (UINT64_C(1) << (i % 64))) == 0)
+        {
+            continue;
+        }
         if (current_parser)
         {
             epc_parse_result_t child_result = parse(current_parser, ctx, input_offset);
             if (!child_result.is_error)
             {
                 // Return the child's success, but mark the CPT node with this 'or' parser
-                epc_cpt_node_t * or_node = epc_node_alloc(self, self->tag);
+                epc_cpt_node_t * or_node = parse_ctx_node_alloc(ctx, self, self->tag);
                 if (or_node == NULL)
                 {
                     epc_parser_result_cleanup(&child_result);
@@ -988,7 +2010,7 @@ por_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_of
 
                 or_node->content = child_result.data.success->content;
                 or_node->len = child_result.data.success->len;
-                or_node->children = calloc(1, sizeof(*or_node->children));
+                or_node->children = parse_ctx_children_alloc(ctx, 1);
                 if (or_node->children == NULL)
                 {
                     epc_parser_result_cleanup(&child_result);
@@ -1002,115 +2024,498 @@ por_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_of
                 or_node->children[0] = child_result.data.success;
                 or_node->children_count = 1;
 
-                parser_furthest_error_restore(ctx, &original_furthest_error);
+                parser_furthest_error_restore(ctx, &original_furthest_error);
+
+                return epc_parser_success_result(or_node);
+            }
+            else
+            {
+                epc_parser_result_cleanup(&child_result);
+            }
+        }
+    }
+
+    /* No alternatives matched if we get here. */
+    epc_parser_error_free(original_furthest_error);
+
+    return parser_no_alternative_error_result(ctx, self, input_offset, input_result.next_input);
+}
+
+static void
+por_first_set(epc_parser_t * self, first_set_t * first)
+{
+    parser_list_t const * alternatives = self->data.parser_list;
+
+    if (alternatives == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < alternatives->count; ++i)
+    {
+        if (alternatives->parsers[i] != NULL)
+        {
+            first_set_t const * alternative = parser_first_set(alternatives->parsers[i]);
+
+            first_set_union(first, alternative);
+            first->nullable = first->nullable || alternative->nullable;
+        }
+    }
+}
+
+static epc_parser_t *
+vepc_or(char const * name, int count, va_list args)
+{
+    epc_parser_t * p = epc_parser_allocate(name, "or", por_parse_fn, por_first_set);
+    if (p == NULL)
+    {
+        return NULL;
+    }
+    p->data.parser_list = parser_list_create_v(count, args);
+    p->data.type = PARSER_DATA_TYPE_PARSER_LIST;
+
+    return p;
+}
+
+epc_parser_t *
+epc_or(char const * name, int count, ...)
+{
+    va_list args;
+
+    va_start(args, count);
+    epc_parser_t * p = vepc_or(name, count, args);
+    va_end(args);
+
+    return p;
+}
+
+epc_parser_t *
+epc_or_l(epc_parser_list * list, char const * name, int count, ...)
+{
+    va_list args;
+
+    va_start(args, count);
+    epc_parser_t * p = vepc_or(name, count, args);
+    va_end(args);
+
+    epc_parser_list_add(list, p);
+    return p;
+}
+
+// --- Grammar finalization ---
+
+static atomic_flag grammar_finalize_lock = ATOMIC_FLAG_INIT;
+
+// Returns true if an epc_or has a table of the alternatives that may match each byte.
+static bool
+or_has_dispatch(epc_parser_t const * p)
+{
+    return p->parse_fn == por_parse_fn && p->data.parser_list != NULL && p->data.parser_list->count >= 2;
+}
+
+// Returns true if an epc_many or epc_plus repeats a parser that matches a single character, so that runs of them can
+// be scanned in one go.
+static bool
+repeats_single_char(epc_parser_t const * p)
+{
+    if (epc_parser_get_kind(p) != PARSER_KIND_MANY && epc_parser_get_kind(p) != PARSER_KIND_PLUS)
+    {
+        return false;
+    }
+
+    epc_parser_t const * repeated = p->data.parser;
+
+    if (repeated == NULL)
+    {
+        return false;
+    }
+    switch (epc_parser_get_kind(repeated))
+    {
+    case PARSER_KIND_CHAR:
+    case PARSER_KIND_ANY:
+    case PARSER_KIND_DIGIT:
+    case PARSER_KIND_ALPHA:
+    case PARSER_KIND_ALPHANUM:
+    case PARSER_KIND_SPACE:
+    case PARSER_KIND_HEX_DIGIT:
+    case PARSER_KIND_CHAR_RANGE:
+    case PARSER_KIND_ONE_OF:
+    case PARSER_KIND_NONE_OF:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// Allocates an empty plan for `p`, with room for the tables it needs.
+static parser_plan_t *
+parser_plan_create(epc_parser_t const * p)
+{
+    size_t const dispatch_len = or_has_dispatch(p) ? (UCHAR_MAX + 1) * or_dispatch_words(p->data.parser_list) : 0;
+    parser_plan_t * plan = calloc(1, sizeof(*plan) + dispatch_len * sizeof(plan->dispatch_storage[0]));
+
+    if (plan != NULL)
+    {
+        plan->dispatch = dispatch_len > 0 ? plan->dispatch_storage : NULL;
+        plan->run_class = repeats_single_char(p) ? &plan->run_class_storage : NULL;
+    }
+    return plan;
+}
+
+// Fills in the table epc_or uses to only try the alternatives whose FIRST set allows them to match the next byte.
+static void
+or_dispatch_build(epc_parser_t * p, parser_plan_t * plan)
+{
+    parser_list_t const * alternatives = p->data.parser_list;
+    size_t const words = or_dispatch_words(alternatives);
+
+    for (int i = 0; i < alternatives->count; ++i)
+    {
+        if (alternatives->parsers[i] == NULL)
+        {
+            continue;
+        }
+
+        first_set_t const * first = parser_first_set(alternatives->parsers[i]);
+
+        for (int c = 0; c <= UCHAR_MAX; c++)
+        {
+            if (first_set_may_start_with(first, (unsigned char)c))
+            {
+                plan->dispatch[(size_t)c * words + (size_t)i / 64] |= UINT64_C(1) << (i % 64);
+            }
+        }
+    }
+}
+
+// Fills in the class of bytes accepted by the single character parser an epc_many or epc_plus repeats.
+static void
+run_class_build(epc_parser_t * p, parser_plan_t * plan)
+{
+    epc_parser_t const * repeated = p->data.parser;
+    first_set_t set = {0};
+
+    for (int c = 0; c <= UCHAR_MAX; c++)
+    {
+        if (epc_parser_accepts_char(repeated, (char)c))
+        {
+            first_set_add(&set, (unsigned char)c);
+        }
+    }
+    char_class_init(plan->run_class, &set);
+}
+
+EASY_PC_HIDDEN
+void
+epc_parser_visit_children(epc_parser_t * p, parser_visit_fn_t visit, void * data)
+{
+    switch (p->data.type)
+    {
+    case PARSER_DATA_TYPE_NONE:
+    case PARSER_DATA_TYPE_STRING:
+    case PARSER_DATA_TYPE_CHAR_RANGE:
+    case PARSER_DATA_TYPE_KEYWORDS:
+        break;
+
+    case PARSER_DATA_TYPE_PARSER:
+        visit(p->data.parser, data);
+        break;
+
+    case PARSER_DATA_TYPE_PARSER_LIST:
+        if (p->data.parser_list != NULL)
+        {
+            for (int i = 0; i < p->data.parser_list->count; ++i)
+            {
+                visit(p->data.parser_list->parsers[i], data);
+            }
+        }
+        break;
+
+    case PARSER_DATA_TYPE_COUNT:
+        visit(p->data.count.parser, data);
+        break;
+
+    case PARSER_DATA_TYPE_BETWEEN:
+        visit(p->data.between.open, data);
+        visit(p->data.between.parser, data);
+        visit(p->data.between.close, data);
+        break;
+
+    case PARSER_DATA_TYPE_DELIMITED:
+        visit(p->data.delimited.item, data);
+        visit(p->data.delimited.delimiter, data);
+        break;
+
+    case PARSER_DATA_TYPE_LEXEME:
+        visit(p->data.lexeme.parser, data);
+        break;
+
+    case PARSER_DATA_TYPE_PREDICATE:
+        visit(p->data.predicate.parser, data);
+        break;
+
+    case PARSER_DATA_TYPE_WRAP:
+        visit(p->data.wrap.parser, data);
+        break;
+
+    case PARSER_DATA_TYPE_DIRECT:
+        visit(p->data.direct.fallback, data);
+        for (size_t i = 0; i < p->data.direct.site_count; ++i)
+        {
+            visit(p->data.direct.sites[i], data);
+        }
+        break;
+    }
+}
+
+// Visits each parser reachable from the one a walk starts at once, calling `before` on the way down and `after` on the
+// way back up.
+typedef struct grammar_walk_t grammar_walk_t;
+
+struct grammar_walk_t
+{
+    unsigned long pass;
+    void (*before)(epc_parser_t * p, grammar_walk_t * walk);
+    void (*after)(epc_parser_t * p, grammar_walk_t * walk);
+    unsigned long generation;
+    bool changed;
+    bool is_first;
+    bool failed;
+};
+
+// Only used while grammar_finalize_lock is held.
+static unsigned long grammar_walk_pass;
+
+static void
+grammar_walk_visit(epc_parser_t * p, void * data)
+{
+    grammar_walk_t * walk = data;
+
+    if (p == NULL || p->walk_pass == walk->pass)
+    {
+        return;
+    }
+    p->walk_pass = walk->pass;
+    if (walk->before != NULL)
+    {
+        walk->before(p, walk);
+    }
+    epc_parser_visit_children(p, grammar_walk_visit, walk);
+    if (walk->after != NULL)
+    {
+        walk->after(p, walk);
+    }
+}
+
+static void
+grammar_walk(epc_parser_t * top_parser, grammar_walk_t * walk)
+{
+    walk->pass = ++grammar_walk_pass;
+    grammar_walk_visit(top_parser, walk);
+}
+
+static void
+reach_generation_max(epc_parser_t * child, void * data)
+{
+    unsigned long * reach = data;
+
+    if (child != NULL && child->reach_generation > *reach)
+    {
+        *reach = child->reach_generation;
+    }
+}
+
+static void
+reach_generation_update(epc_parser_t * p, grammar_walk_t * walk)
+{
+    unsigned long reach = walk->is_first ? p->defined_generation : p->reach_generation;
+
+    epc_parser_visit_children(p, reach_generation_max, &reach);
+    walk->changed = walk->changed || reach != p->reach_generation;
+    p->reach_generation = reach;
+}
+
+// A parser's plan is out of date if a parser it reaches has been redefined since the plan was worked out.
+static void
+plan_if_out_of_date(epc_parser_t * p, grammar_walk_t * walk)
+{
+    parser_plan_t const * plan = parser_plan_load(p);
+
+    p->first_set_computing = false;
+    p->first_set_known = false;
+    if (plan != NULL && p->reach_generation <= plan->generation)
+    {
+        return;
+    }
+    p->pending_plan = parser_plan_create(p);
+    walk->changed = true;
+    walk->failed = walk->failed || p->pending_plan == NULL;
+}
+
+static void
+plan_first_set(epc_parser_t * p, grammar_walk_t * walk)
+{
+    (void)walk;
+    if (p->pending_plan != NULL)
+    {
+        (void)parser_first_set(p);
+    }
+}
+
+// Builds the tables of a pending plan, which may use the FIRST sets of any parser in the grammar.
+static void
+plan_tables(epc_parser_t * p, grammar_walk_t * walk)
+{
+    (void)walk;
+    if (p->pending_plan != NULL && p->pending_plan->dispatch != NULL)
+    {
+        or_dispatch_build(p, p->pending_plan);
+    }
+    if (p->pending_plan != NULL && p->pending_plan->run_class != NULL)
+    {
+        run_class_build(p, p->pending_plan);
+    }
+}
+
+// Publishes a pending plan in place of the current one. The current one may still be in use by a parse on another
+// thread, so it is kept until the parser is freed.
+static void
+plan_publish(epc_parser_t * p, grammar_walk_t * walk)
+{
+    parser_plan_t * pending = p->pending_plan;
+
+    if (pending == NULL)
+    {
+        return;
+    }
+    p->pending_plan = NULL;
+    if (walk->failed)
+    {
+        free(pending);
+        return;
+    }
+
+    parser_plan_t * retired = parser_plan_load(p);
 
-                return epc_parser_success_result(or_node);
-            }
-            else
-            {
-                epc_parser_result_cleanup(&child_result);
-            }
-        }
+    pending->generation = walk->generation;
+    parser_plan_store(p, pending);
+    if (retired != NULL)
+    {
+        retired->retired = p->retired_plans;
+        p->retired_plans = retired;
     }
+}
 
-    /* No alternatives matched if we get here. */
-    epc_parser_error_free(original_furthest_error);
+// Plans the parsers reachable from `top_parser` whose plans are out of date. Returns false if memory ran out, leaving
+// every plan as it was.
+static bool
+grammar_plan(epc_parser_t * top_parser, unsigned long generation)
+{
+    grammar_walk_t walk = {.after = reach_generation_update, .is_first = true};
 
-    size_t estimated_len = 0;
-    for (int i = 0; i < alternatives->count; ++i)
+    // Cycles are common, so the latest redefinition is spread through the grammar until nothing changes.
+    do
     {
-        if (alternatives->parsers[i])
-        {
-            char const * temp_expected = parser_get_expected_str(alternatives->parsers[i]);
+        walk.changed = false;
+        grammar_walk(top_parser, &walk);
+        walk.is_first = false;
+    } while (walk.changed);
 
-            estimated_len += strlen(temp_expected);
-            if (i < alternatives->count - 1)
-            {
-                estimated_len += strlen(" or ");
-            }
-        }
+    walk = (grammar_walk_t){.before = plan_if_out_of_date, .generation = generation};
+    grammar_walk(top_parser, &walk);
+    if (!walk.changed)
+    {
+        return true;
+    }
+    if (!walk.failed)
+    {
+        // FIRST sets are worked out from the top down, so that left recursion is found where a cycle is entered.
+        walk.before = plan_first_set;
+        grammar_walk(top_parser, &walk);
+        walk.before = plan_tables;
+        grammar_walk(top_parser, &walk);
     }
+    walk.before = plan_publish;
+    grammar_walk(top_parser, &walk);
 
-    char const * expected_str;
-    char * aggregated_expected_str = NULL;
-    if (estimated_len > 0)
+    return !walk.failed;
+}
+
+EASY_PC_HIDDEN
+void
+epc_grammar_finalize(epc_parser_t * top_parser)
+{
+    unsigned long const generation = atomic_load(&grammar_generation);
+
+    // Redefining a parser in any grammar bumps the generation, but only the grammars that reach it are planned again.
+    if (top_parser == NULL || parser_checked_generation_load(top_parser) == generation)
     {
-        aggregated_expected_str = malloc(estimated_len + 1);
+        return;
+    }
 
-        if (aggregated_expected_str != NULL)
-        {
-            aggregated_expected_str[0] = '\0';
-            for (int i = 0; i < alternatives->count; ++i)
-            {
-                if (alternatives->parsers[i])
-                {
-                    char const * child_expected = parser_get_expected_str(alternatives->parsers[i]);
-                    if (child_expected)
-                    {
-                        strcat(aggregated_expected_str, child_expected);
-                        if (i < alternatives->count - 1)
-                        {
-                            strcat(aggregated_expected_str, " or ");
-                        }
-                    }
-                }
-            }
-        }
-        expected_str = aggregated_expected_str;
+    // Grammars are shared by sessions that may be running on other threads, so only one may be finalized at a time.
+    while (atomic_flag_test_and_set_explicit(&grammar_finalize_lock, memory_order_acquire))
+    {
+        sched_yield(); // Finalizing a large grammar takes a while; let the thread doing it run.
     }
-    else
+    if (parser_checked_generation_load(top_parser) != generation && grammar_plan(top_parser, generation))
     {
-        expected_str = epc_parser_get_name(self);
+        parser_checked_generation_store(top_parser, generation);
     }
+    atomic_flag_clear_explicit(&grammar_finalize_lock, memory_order_release);
+}
 
-    char const * input = input_result.next_input;
-    char found_buffer[FOUND_BUFFER_SIZE];
-    snprintf(found_buffer, sizeof(found_buffer), "%.*s", (int)sizeof(found_buffer) - 1, input);
+EASY_PC_HIDDEN
+unsigned long
+epc_grammar_generation(epc_parser_t const * top_parser)
+{
+    parser_plan_t const * plan = parser_plan_load(top_parser);
 
-    epc_parse_result_t result
-        = epc_parser_error_result(ctx, input_offset, "No alternative matched", expected_str, found_buffer);
-    free(aggregated_expected_str);
+    return plan != NULL ? plan->generation : 0;
+}
 
-    return result;
+EASY_PC_HIDDEN
+parser_plan_t const *
+epc_parser_get_plan(epc_parser_t const * p)
+{
+    return parser_plan_load(p);
 }
 
-static epc_parser_t *
-vepc_or(char const * name, int count, va_list args)
+EASY_PC_HIDDEN
+bool
+epc_parser_is_left_recursive(epc_parser_t const * p)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "or", por_parse_fn);
-    if (p == NULL)
-    {
-        return NULL;
-    }
-    p->data.parser_list = parser_list_create_v(count, args);
-    p->data.type = PARSER_DATA_TYPE_PARSER_LIST;
+    parser_plan_t const * plan = parser_plan_load(p);
 
-    return p;
+    return plan != NULL && plan->is_left_recursive;
 }
 
-epc_parser_t *
-epc_or(char const * name, int count, ...)
+EASY_PC_HIDDEN
+first_set_t const *
+epc_parser_get_first_set(epc_parser_t * p)
 {
-    va_list args;
-
-    va_start(args, count);
-    epc_parser_t * p = vepc_or(name, count, args);
-    va_end(args);
+    parser_plan_t const * plan = p != NULL ? parser_plan_load(p) : NULL;
 
-    return p;
+    return plan != NULL ? &plan->first_set : &first_set_anything;
 }
 
-epc_parser_t *
-epc_or_l(epc_parser_list * list, char const * name, int count, ...)
+EASY_PC_HIDDEN
+bool
+epc_parser_first_set_from(epc_parser_t * p, first_set_lookup_fn lookup, void * data, first_set_t * first)
 {
-    va_list args;
+    if (p->first_set_fn == NULL)
+    {
+        return false;
+    }
 
-    va_start(args, count);
-    epc_parser_t * p = vepc_or(name, count, args);
-    va_end(args);
+    *first = (first_set_t){0};
+    first_set_lookup = lookup;
+    first_set_lookup_data = data;
+    p->first_set_fn(p, first);
+    first_set_lookup = NULL;
+    first_set_lookup_data = NULL;
 
-    epc_parser_list_add(list, p);
-    return p;
+    return true;
 }
 
 static epc_parse_result_t
@@ -1132,7 +2537,7 @@ pand_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
         );
     }
 
-    epc_cpt_node_t ** children_nodes = calloc(sequence->count, sizeof(*children_nodes));
+    epc_cpt_node_t ** children_nodes = parse_ctx_children_alloc(ctx, sequence->count);
 
     if (children_nodes == NULL)
     {
@@ -1176,7 +2581,6 @@ pand_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
         {
             epc_node_free(children_nodes[i]);
         }
-        free(children_nodes);
     }
 
     if (null_child_result.is_error)
@@ -1190,7 +2594,7 @@ pand_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
 
     /* No child errors, so the AND condition has succeeded. */
 
-    epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (parent_node == NULL)
     {
         for (int i = 0; i < sequence->count; i++)
@@ -1208,6 +2612,62 @@ pand_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
     return epc_parser_success_result(parent_node);
 }
 
+// Returns the length of the input from `offset` up to and including the next newline, scanning a window of the
+// input at a time. If the input ends first, the length to the end is returned and *at_eof is set.
+static size_t
+scan_line(epc_parser_ctx_t * ctx, size_t offset, bool * at_eof)
+{
+    size_t len = 0;
+
+    while (1)
+    {
+        parse_get_input_result_t window = parse_ctx_get_input_window(ctx, offset + len);
+        if (window.is_eof)
+        {
+            *at_eof = true;
+            return len;
+        }
+
+        char const * newline = memchr(window.next_input, '\n', window.available);
+        if (newline != NULL)
+        {
+            *at_eof = false;
+            return len + (size_t)(newline - window.next_input) + 1;
+        }
+        len += window.available;
+    }
+}
+
+// Returns the length of the run of whitespace at `offset`, scanning a window of the input at a time.
+// *at_eof is set if the run reaches the end of the input.
+static size_t
+scan_whitespace(epc_parser_ctx_t * ctx, size_t offset, bool * at_eof)
+{
+    size_t len = 0;
+
+    while (1)
+    {
+        parse_get_input_result_t window = parse_ctx_get_input_window(ctx, offset + len);
+        if (window.is_eof)
+        {
+            *at_eof = true;
+            return len;
+        }
+
+        size_t i = 0;
+        while (i < window.available && isspace((unsigned char)window.next_input[i]))
+        {
+            i++;
+        }
+        len += i;
+        if (i < window.available)
+        {
+            *at_eof = false;
+            return len;
+        }
+    }
+}
+
 // --- C++ Comment Parser Implementation ---
 // Matches "//" followed by any characters until a newline or EOF.
 static epc_parse_result_t
@@ -1237,26 +2697,12 @@ pcpp_comment_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t
         return epc_parser_error_result(ctx, input_offset, "Expected '//'", "//", found);
     }
 
-    size_t current_len = 2;
-
     // 2. Match content until newline or EOF
-    while (1)
-    {
-        parse_get_input_result_t res = parse_ctx_get_input_at_offset(ctx, input_offset + current_len, 1);
-        if (res.is_eof)
-        {
-            break;
-        }
-        if (res.next_input[0] == '\n')
-        {
-            current_len++; // Consume newline
-            break;
-        }
-        current_len++;
-    }
+    bool at_eof;
+    size_t const current_len = 2 + scan_line(ctx, input_offset + 2, &at_eof);
 
     // Success - create a CPT node for the whole comment
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
@@ -1268,10 +2714,17 @@ pcpp_comment_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t
     return epc_parser_success_result(node);
 }
 
+static void
+pslash_comment_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add(first, '/');
+}
+
 epc_parser_t *
 epc_cpp_comment(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "cpp_comment", pcpp_comment_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "cpp_comment", pcpp_comment_parse_fn, pslash_comment_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1320,7 +2773,16 @@ pc_comment_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
         {
             return epc_parser_error_result(ctx, input_offset, "Unterminated C-style comment", "*/", "EOF");
         }
-        if (res.next_input[0] == '*' && res.next_input[1] == '/')
+        // Only a '*' with a byte after it in this window can be checked here. A '*' at the very end is looked at again
+        // once the next window arrives.
+        char const * star = memchr(res.next_input, '*', res.available - 1);
+        if (star == NULL)
+        {
+            current_len += res.available - 1;
+            continue;
+        }
+        current_len += (size_t)(star - res.next_input);
+        if (star[1] == '/')
         {
             current_len += 2; // Consume "*/"
             break;
@@ -1329,7 +2791,7 @@ pc_comment_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
     }
 
     // Success - create a CPT node for the whole comment
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
@@ -1344,7 +2806,7 @@ pc_comment_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
 EASY_PC_API epc_parser_t *
 epc_c_comment(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "c_comment", pc_comment_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "c_comment", pc_comment_parse_fn, pslash_comment_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1375,26 +2837,12 @@ pbash_comment_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_
         return epc_parser_error_result(ctx, input_offset, "Expected '#'", "#", found);
     }
 
-    size_t current_len = 1;
-
     // 2. Match content until newline or EOF
-    while (1)
-    {
-        parse_get_input_result_t res = parse_ctx_get_input_at_offset(ctx, input_offset + current_len, 1);
-        if (res.is_eof)
-        {
-            break;
-        }
-        if (res.next_input[0] == '\n')
-        {
-            current_len++; // Consume newline
-            break;
-        }
-        current_len++;
-    }
+    bool at_eof;
+    size_t const current_len = 1 + scan_line(ctx, input_offset + 1, &at_eof);
 
     // Success - create a CPT node for the whole comment
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
@@ -1406,10 +2854,17 @@ pbash_comment_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_
     return epc_parser_success_result(node);
 }
 
+static void
+pbash_comment_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add(first, '#');
+}
+
 epc_parser_t *
 epc_bash_comment(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "bash_comment", pbash_comment_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "bash_comment", pbash_comment_parse_fn, pbash_comment_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1419,10 +2874,23 @@ epc_bash_comment(char const * name)
     return p;
 }
 
+static void
+pand_first_set(epc_parser_t * self, first_set_t * first)
+{
+    parser_list_t const * list = self->data.parser_list;
+
+    if (list == NULL)
+    {
+        first->nullable = true;
+        return;
+    }
+    first_set_of_sequence(first, list->parsers, list->count);
+}
+
 static epc_parser_t *
 vepc_and(char const * name, int count, va_list args)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "and", pand_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "and", pand_parse_fn, pand_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1507,7 +2975,7 @@ pskip_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
         epc_parser_result_cleanup(&child_result);
     }
 
-    epc_cpt_node_t * dummy_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * dummy_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (dummy_node == NULL)
     {
         return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
@@ -1521,10 +2989,18 @@ pskip_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     return epc_parser_success_result(dummy_node);
 }
 
+// For parsers that succeed even when their child doesn't match (skip, many, optional).
+static void
+pzero_or_more_first_set(epc_parser_t * self, first_set_t * first)
+{
+    *first = *parser_first_set(self->data.parser);
+    first->nullable = true;
+}
+
 epc_parser_t *
 epc_skip(char const * name, epc_parser_t * parser_to_skip)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "skip", pskip_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "skip", pskip_parse_fn, pzero_or_more_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1535,6 +3011,65 @@ epc_skip(char const * name, epc_parser_t * parser_to_skip)
     return p;
 }
 
+// Nodes for a run of single characters are allocated this many at a time.
+#define RUN_NODE_BATCH 256
+
+// Appends a node to `children` for each character of the run of `run_class` at `input_offset`, just as running
+// the repeated parser once per character would, and sets *run_len to the length of the run. The repeated parser is
+// left to fail where the run ends, so that it reports the error it always has.
+// Returns false if the nodes could not be allocated.
+static bool
+run_class_append(
+    epc_parser_t * self,
+    char_class_t const * run_class,
+    epc_parser_ctx_t * ctx,
+    size_t input_offset,
+    child_list_t * children,
+    size_t * run_len
+)
+{
+    epc_parser_t * repeated = self->data.parser;
+    size_t len = 0;
+
+    while (1)
+    {
+        parse_get_input_result_t window = parse_ctx_get_input_window(ctx, input_offset + len);
+        if (window.is_eof)
+        {
+            break;
+        }
+
+        size_t const span = char_class_span(run_class, window.next_input, window.available);
+
+        for (size_t done = 0; done < span;)
+        {
+            size_t const batch = span - done < RUN_NODE_BATCH ? span - done : RUN_NODE_BATCH;
+            epc_cpt_node_t * nodes = parse_ctx_nodes_alloc(ctx, repeated, repeated->tag, batch);
+
+            if (nodes == NULL || !child_list_reserve(children, children->count + batch))
+            {
+                *run_len = len + done;
+                return false;
+            }
+            for (size_t i = 0; i < batch; i++)
+            {
+                nodes[i].content = window.next_input + done + i;
+                nodes[i].len = 1;
+                child_list_append(children, &nodes[i]);
+            }
+            done += batch;
+        }
+        len += span;
+        if (span < window.available)
+        {
+            break;
+        }
+    }
+    *run_len = len;
+
+    return true;
+}
+
 static epc_parse_result_t
 pplus_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
 {
@@ -1554,7 +3089,7 @@ pplus_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     }
 
     child_list_t children = {0};
-    if (!child_list_init(&children, 4))
+    if (!child_list_init(&children, ctx, 4))
     {
         return epc_parser_error_result(
             ctx, input_offset, "Memory allocation failure for p_plus children", epc_parser_get_name(self), "N/A"
@@ -1565,21 +3100,41 @@ pplus_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     size_t plus_start_input_offset = input_offset;
     char const * plus_start_input = input_result.next_input;
 
-    epc_parse_result_t first_child_result = parse(parser_to_repeat, ctx, current_input_offset);
-    if (first_child_result.is_error)
-    {
-        child_list_release(&children);
-        return first_child_result;
-    }
-
-    if (!child_list_append(&children, first_child_result.data.success))
+    // A run of single characters is matched in one go, leaving the repeated parser to run where the run ends.
+    parser_plan_t const * const plan = parser_plan_load(self);
+    char_class_t const * const run_class = plan != NULL ? plan->run_class : NULL;
+    size_t run_len = 0;
+    if (run_class != NULL && !run_class_append(self, run_class, ctx, current_input_offset, &children, &run_len))
     {
         child_list_release(&children);
         return epc_parser_error_result(
             ctx, current_input_offset, "Memory allocation failure for p_plus children", epc_parser_get_name(self), "N/A"
         );
     }
-    current_input_offset += first_child_result.data.success->len;
+    current_input_offset += run_len;
+
+    if (children.count == 0)
+    {
+        epc_parse_result_t first_child_result = parse(parser_to_repeat, ctx, current_input_offset);
+        if (first_child_result.is_error)
+        {
+            child_list_release(&children);
+            return first_child_result;
+        }
+
+        if (!child_list_append(&children, first_child_result.data.success))
+        {
+            child_list_release(&children);
+            return epc_parser_error_result(
+                ctx,
+                current_input_offset,
+                "Memory allocation failure for p_plus children",
+                epc_parser_get_name(self),
+                "N/A"
+            );
+        }
+        current_input_offset += first_child_result.data.success->len;
+    }
 
     bool infinite_recursion_detected = false;
     while (!infinite_recursion_detected)
@@ -1612,12 +3167,10 @@ pplus_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     if (infinite_recursion_detected)
     {
         child_list_release(&children);
-        return epc_parser_error_result(
-            ctx, current_input_offset, "Infinite recursion detected", "Progress", "No progress"
-        );
+        return parser_no_progress_error_result(ctx, current_input_offset);
     }
 
-    epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (parent_node == NULL)
     {
         child_list_release(&children);
@@ -1637,10 +3190,16 @@ pplus_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     return epc_parser_success_result(parent_node);
 }
 
+static void
+pplus_first_set(epc_parser_t * self, first_set_t * first)
+{
+    *first = *parser_first_set(self->data.parser);
+}
+
 epc_parser_t *
 epc_plus(char const * name, epc_parser_t * parser_to_repeat)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "plus", pplus_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "plus", pplus_parse_fn, pplus_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1657,19 +3216,18 @@ pchar_range_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t
     char_range_data_t * range = &self->data.range;
     parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
 
-    char expected_str[32]; // e.g., "character in range [a-z]"
-    snprintf(expected_str, sizeof(expected_str), "character in range [%c-%c]", range->start, range->end);
-
     if (input_result.is_eof)
     {
-        return epc_parser_error_result(ctx, input_offset, "Unexpected end of input", expected_str, "EOF");
+        return parser_derived_error_result(
+            ctx, self, input_offset, "Unexpected end of input", PARSE_ERROR_EXPECTED_CHAR_RANGE, "EOF"
+        );
     }
 
     char const * input = input_result.next_input;
 
     if (input[0] >= range->start && input[0] <= range->end)
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -1685,13 +3243,29 @@ pchar_range_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t
     /* else not in range. */
     char found_str[2] = {input[0], '\0'};
 
-    return epc_parser_error_result(ctx, input_offset, "Unexpected character", expected_str, found_str);
+    return parser_derived_error_result(
+        ctx, self, input_offset, "Unexpected character", PARSE_ERROR_EXPECTED_CHAR_RANGE, found_str
+    );
+}
+
+static void
+pchar_range_first_set(epc_parser_t * self, first_set_t * first)
+{
+    char_range_data_t const * range = &self->data.range;
+
+    for (int c = CHAR_MIN; c <= CHAR_MAX; c++)
+    {
+        if ((char)c >= range->start && (char)c <= range->end)
+        {
+            first_set_add(first, (unsigned char)c);
+        }
+    }
 }
 
 EASY_PC_API epc_parser_t *
 epc_char_range(char const * name, char char_start, char char_end)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "char_range", pchar_range_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "char_range", pchar_range_parse_fn, pchar_range_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1715,7 +3289,7 @@ pany_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
 
     char const * input = input_result.next_input;
 
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A");
@@ -1726,10 +3300,17 @@ pany_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
     return epc_parser_success_result(node);
 }
 
+static void
+pany_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add_all(first);
+}
+
 EASY_PC_API epc_parser_t *
 epc_any(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "any", pany_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "any", pany_parse_fn, pany_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1743,41 +3324,54 @@ pnone_of_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
 {
     char const * chars_to_avoid = self->data.string;
     parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
-    char expected_str[64];
-
-    snprintf(expected_str, sizeof(expected_str), "character not in set '%s'", chars_to_avoid);
 
     if (input_result.is_eof)
     {
-        return epc_parser_error_result(ctx, input_offset, "Unexpected end of input", expected_str, "EOF");
+        return parser_derived_error_result(
+            ctx, self, input_offset, "Unexpected end of input", PARSE_ERROR_EXPECTED_NONE_OF, "EOF"
+        );
     }
 
     char const * input = input_result.next_input;
 
     if (strchr(chars_to_avoid, input[0]) == NULL)
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
                 ctx, input_offset, "Memory allocation error", epc_parser_get_name(self), "N/A"
             );
         }
-        node->content = input;
-        node->len = 1;
-
-        return epc_parser_success_result(node);
+        node->content = input;
+        node->len = 1;
+
+        return epc_parser_success_result(node);
+    }
+
+    char found_str[2] = {input[0], '\0'};
+
+    return parser_derived_error_result(
+        ctx, self, input_offset, "Character found in forbidden set", PARSE_ERROR_EXPECTED_NONE_OF, found_str
+    );
+}
+
+static void
+pnone_of_first_set(epc_parser_t * self, first_set_t * first)
+{
+    for (int c = CHAR_MIN; c <= CHAR_MAX; c++)
+    {
+        if (strchr(self->data.string, c) == NULL)
+        {
+            first_set_add(first, (unsigned char)c);
+        }
     }
-
-    char found_str[2] = {input[0], '\0'};
-
-    return epc_parser_error_result(ctx, input_offset, "Character found in forbidden set", expected_str, found_str);
 }
 
 EASY_PC_API epc_parser_t *
 epc_none_of(char const * name, char const * chars_to_avoid)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "none_of", pnone_of_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "none_of", pnone_of_parse_fn, pnone_of_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1818,15 +3412,32 @@ pmany_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     size_t current_input_offset = input_offset;
     child_list_t children = {0};
 
-    if (!child_list_init(&children, 4))
+    if (!child_list_init(&children, ctx, 4))
+    {
+        return epc_parser_error_result(
+            ctx, current_input_offset, "Memory allocation failure for p_many children", epc_parser_get_name(self), "N/A"
+        );
+    }
+
+    // A run of single characters is matched in one go, leaving the repeated parser to run where the run ends.
+    parser_plan_t const * const plan = parser_plan_load(self);
+    char_class_t const * const run_class = plan != NULL ? plan->run_class : NULL;
+    size_t run_len = 0;
+    if (run_class != NULL && !run_class_append(self, run_class, ctx, current_input_offset, &children, &run_len))
     {
+        child_list_release(&children);
         return epc_parser_error_result(
             ctx, current_input_offset, "Memory allocation failure for p_many children", epc_parser_get_name(self), "N/A"
         );
     }
+    current_input_offset += run_len;
+
+    // Long input may have been parsed in chunks on several threads, which leaves nothing for the loop to do.
+    bool const is_split = self->split != NULL && run_class == NULL
+                          && split_parse(self, ctx, current_input_offset, &children, &current_input_offset);
 
     bool infinite_recursion_detected = false;
-    while (!infinite_recursion_detected) // Loop as long as child parser matches
+    while (!is_split && !infinite_recursion_detected) // Loop as long as child parser matches
     {
         size_t loop_start_input_offset = current_input_offset;
         epc_parse_result_t child_result = parse(parser_to_repeat, ctx, current_input_offset);
@@ -1854,12 +3465,10 @@ pmany_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     if (infinite_recursion_detected)
     {
         child_list_release(&children);
-        return epc_parser_error_result(
-            ctx, current_input_offset, "Infinite recursion detected", "Progress", "No progress"
-        );
+        return parser_no_progress_error_result(ctx, current_input_offset);
     }
 
-    epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (parent_node == NULL)
     {
         child_list_release(&children);
@@ -1877,10 +3486,43 @@ pmany_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     return epc_parser_success_result(parent_node);
 }
 
+// The loop of pmany_parse_fn, over one chunk of its input.
+static bool
+pmany_parse_chunk(
+    epc_parser_t * self,
+    epc_parser_ctx_t * ctx,
+    size_t start,
+    size_t end,
+    bool is_last,
+    child_list_t * items,
+    size_t * end_offset
+)
+{
+    size_t current_input_offset = start;
+
+    while (is_last || current_input_offset < end)
+    {
+        epc_parse_result_t child_result = parse(self->data.parser, ctx, current_input_offset);
+        if (child_result.is_error)
+        {
+            epc_parser_result_cleanup(&child_result);
+            break;
+        }
+        if (!child_list_append(items, child_result.data.success) || child_result.data.success->len == 0)
+        {
+            return false;
+        }
+        current_input_offset += child_result.data.success->len;
+    }
+    *end_offset = current_input_offset;
+
+    return is_last || current_input_offset == end;
+}
+
 EASY_PC_API epc_parser_t *
 epc_many(char const * name, epc_parser_t * p_to_repeat)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "many", pmany_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "many", pmany_parse_fn, pzero_or_more_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -1916,7 +3558,7 @@ pcount_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
 
     if (num_to_match <= 0) // Matching 0 times is always a success (empty match)
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -1932,7 +3574,7 @@ pcount_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
     size_t current_input_offset = input_offset;
     child_list_t children = {0};
 
-    if (!child_list_init(&children, 4))
+    if (!child_list_init(&children, ctx, 4))
     {
         return epc_parser_error_result(
             ctx,
@@ -1949,12 +3591,8 @@ pcount_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
         if (child_result.is_error)
         {
             // Child parser failed to match required number of times
-            char msg[64];
-
-            snprintf(msg, sizeof(msg), "Count failed to match child at count %u", i + 1);
-            epc_parse_result_t error_result = epc_parser_error_result(
-                ctx, current_input_offset, msg, child_result.data.error->expected, child_result.data.error->found
-            );
+            epc_parse_result_t error_result
+                = parser_count_error_result(ctx, current_input_offset, (size_t)i, child_result.data.error);
 
             epc_parser_result_cleanup(&child_result);
 
@@ -1974,7 +3612,7 @@ pcount_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
         current_input_offset += child_result.data.success->len;
     }
 
-    epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (parent_node == NULL)
     {
         child_list_release(&children);
@@ -1990,10 +3628,17 @@ pcount_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input
     return epc_parser_success_result(parent_node);
 }
 
+static void
+pcount_first_set(epc_parser_t * self, first_set_t * first)
+{
+    *first = *parser_first_set(self->data.count.parser);
+    first->nullable = first->nullable || self->data.count.count <= 0;
+}
+
 EASY_PC_API epc_parser_t *
 epc_count(char const * name, int num, epc_parser_t * p_to_repeat)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "count", pcount_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "count", pcount_parse_fn, pcount_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2065,7 +3710,7 @@ pbetween_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
     epc_parser_result_cleanup(&close_result);
 
     // Success - create a node for 'between'
-    epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (parent_node == NULL)
     {
         epc_parser_result_cleanup(&wrapped_result);
@@ -2076,7 +3721,7 @@ pbetween_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
         );
     }
 
-    parent_node->children = calloc(1, sizeof(*parent_node->children));
+    parent_node->children = parse_ctx_children_alloc(ctx, 1);
     if (parent_node->children == NULL)
     {
         epc_parser_result_cleanup(&wrapped_result);
@@ -2105,10 +3750,22 @@ pbetween_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
     return epc_parser_success_result(parent_node);
 }
 
+static void
+pbetween_first_set(epc_parser_t * self, first_set_t * first)
+{
+    epc_parser_t * const sequence[] = {
+        self->data.between.open,
+        self->data.between.parser,
+        self->data.between.close,
+    };
+
+    first_set_of_sequence(first, sequence, 3);
+}
+
 EASY_PC_API epc_parser_t *
 epc_between(char const * name, epc_parser_t * p_open, epc_parser_t * p_wrapped, epc_parser_t * p_close)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "between", pbetween_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "between", pbetween_parse_fn, pbetween_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2146,7 +3803,7 @@ pdelimited_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
     size_t current_input_offset = input_offset;
     child_list_t children = {0};
 
-    if (!child_list_init(&children, 4))
+    if (!child_list_init(&children, ctx, 4))
     {
         return epc_parser_error_result(
             ctx, input_offset, "Memory allocation failure for p_delimited children", epc_parser_get_name(self), "N/A"
@@ -2171,10 +3828,14 @@ pdelimited_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
 
     current_input_offset += first_item_result.data.success->len;
 
+    // Long input may have been parsed in chunks on several threads, which leaves nothing for the loop to do.
+    bool const is_split
+        = self->split != NULL && split_parse(self, ctx, current_input_offset, &children, &current_input_offset);
+
     // Remaining items (item + delimiter)
     bool infinite_recursion_detected = false;
 
-    while (!infinite_recursion_detected)
+    while (!is_split && !infinite_recursion_detected)
     {
         size_t loop_start_input_offset = current_input_offset;
 
@@ -2240,12 +3901,10 @@ pdelimited_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
     if (infinite_recursion_detected)
     {
         child_list_release(&children);
-        return epc_parser_error_result(
-            ctx, current_input_offset, "Infinite recursion detected", "Progress", "No progress"
-        );
+        return parser_no_progress_error_result(ctx, current_input_offset);
     }
 
-    epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (parent_node == NULL)
     {
         child_list_release(&children);
@@ -2263,10 +3922,92 @@ pdelimited_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
     return epc_parser_success_result(parent_node);
 }
 
+// The loop of pdelimited_parse_fn, over one chunk of its input. The first chunk starts with a delimiter, after the
+// first item, and the others with an item.
+static bool
+pdelimited_parse_chunk(
+    epc_parser_t * self,
+    epc_parser_ctx_t * ctx,
+    size_t start,
+    size_t end,
+    bool is_first,
+    bool is_last,
+    child_list_t * items,
+    size_t * end_offset
+)
+{
+    epc_parser_t * item_parser = self->data.delimited.item;
+    epc_parser_t * delimiter_parser = self->data.delimited.delimiter;
+    size_t current_input_offset = start;
+    bool expects_item = !is_first;
+
+    for (;;)
+    {
+        size_t loop_start_input_offset = current_input_offset;
+
+        if (!expects_item && delimiter_parser != NULL)
+        {
+            epc_parser_error_t * original_furthest_error = parser_furthest_error_copy(ctx);
+            epc_parse_result_t delim_result = parse(delimiter_parser, ctx, current_input_offset);
+
+            if (delim_result.is_error)
+            {
+                epc_parser_result_cleanup(&delim_result);
+                parser_furthest_error_restore(ctx, &original_furthest_error);
+                break;
+            }
+            epc_parser_error_free(original_furthest_error);
+            current_input_offset += delim_result.data.success->len;
+            epc_parser_result_cleanup(&delim_result);
+        }
+        // A chunk the next one follows ends just after a delimiter.
+        if (!is_last && !expects_item && current_input_offset >= end)
+        {
+            *end_offset = current_input_offset;
+            return current_input_offset == end;
+        }
+
+        epc_parser_error_t * original_furthest_error = parser_furthest_error_copy(ctx);
+        epc_parse_result_t item_result = parse(item_parser, ctx, current_input_offset);
+
+        parser_furthest_error_restore(ctx, &original_furthest_error);
+        if (item_result.is_error)
+        {
+            // After a delimiter, that is a trailing delimiter, which is left to the sequential parse to report.
+            epc_parser_result_cleanup(&item_result);
+            if (delimiter_parser != NULL)
+            {
+                return false;
+            }
+            break;
+        }
+        if (!child_list_append(items, item_result.data.success))
+        {
+            return false;
+        }
+        current_input_offset += item_result.data.success->len;
+        if (!expects_item && current_input_offset == loop_start_input_offset)
+        {
+            return false;
+        }
+        expects_item = false;
+    }
+    *end_offset = current_input_offset;
+
+    return is_last;
+}
+
+// Also used by chainl1/chainr1, which keep their item and operator in the same fields.
+static void
+pdelimited_first_set(epc_parser_t * self, first_set_t * first)
+{
+    *first = *parser_first_set(self->data.delimited.item);
+}
+
 EASY_PC_API epc_parser_t *
 epc_delimited(char const * name, epc_parser_t * item_parser, epc_parser_t * delimiter_parser)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "delimited", pdelimited_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "delimited", pdelimited_parse_fn, pdelimited_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2278,6 +4019,27 @@ epc_delimited(char const * name, epc_parser_t * item_parser, epc_parser_t * deli
     return p;
 }
 
+EASY_PC_HIDDEN
+bool
+split_parse_chunk(
+    epc_parser_t * self,
+    epc_parser_ctx_t * ctx,
+    size_t start,
+    size_t end,
+    bool is_first,
+    bool is_last,
+    child_list_t * items,
+    size_t * end_offset
+)
+{
+    if (self->parse_fn == pdelimited_parse_fn)
+    {
+        return pdelimited_parse_chunk(self, ctx, start, end, is_first, is_last, items, end_offset);
+    }
+
+    return pmany_parse_chunk(self, ctx, start, end, is_last, items, end_offset);
+}
+
 static epc_parse_result_t
 poptional_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
 {
@@ -2304,7 +4066,7 @@ poptional_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t in
     if (!child_result.is_error)
     {
         // Child matched, return its success result wrapped in an optional node
-        epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (parent_node == NULL)
         {
             epc_parser_result_cleanup(&child_result);
@@ -2317,7 +4079,7 @@ poptional_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t in
                 "N/A"
             );
         }
-        parent_node->children = calloc(1, sizeof(*parent_node->children));
+        parent_node->children = parse_ctx_children_alloc(ctx, 1);
         if (parent_node->children == NULL)
         {
             epc_parser_result_cleanup(&child_result);
@@ -2345,7 +4107,7 @@ poptional_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t in
     epc_parser_result_cleanup(&child_result);
     epc_parser_error_free(original_furthest_error);
 
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(
@@ -2364,7 +4126,7 @@ poptional_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t in
 EASY_PC_API epc_parser_t *
 epc_optional(char const * name, epc_parser_t * p_to_make_optional)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "optional", poptional_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "optional", poptional_parse_fn, pzero_or_more_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2409,7 +4171,7 @@ plookahead_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
 
     // Child matched, but p_lookahead consumes no input.
     // Return a dummy success node of length 0.
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(
@@ -2425,10 +4187,18 @@ plookahead_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
     return epc_parser_success_result(node);
 }
 
+// For parsers that never consume input when they succeed.
+static void
+pconsumes_nothing_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first->nullable = true;
+}
+
 EASY_PC_API epc_parser_t *
 epc_lookahead(char const * name, epc_parser_t * p_to_lookahead)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "lookahead", plookahead_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "lookahead", plookahead_parse_fn, pconsumes_nothing_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2468,7 +4238,7 @@ pnot_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
         // Child failed, p_not succeeds.
         epc_parser_result_cleanup(&child_result);
         // Return a dummy success node of length 0.
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -2486,13 +4256,7 @@ pnot_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
 
     // Child succeeded, p_not fails.
     // Create a specific error message for p_not.
-    char expected_str[64];
-
-    snprintf(expected_str, sizeof(expected_str), "not %s", parser_get_expected_str(child_parser));
-
-    epc_parse_result_t result = epc_parser_error_result(
-        ctx, input_offset, "Parser unexpectedly matched", expected_str, child_result.data.success->content
-    );
+    epc_parse_result_t result = parser_unexpected_match_error_result(ctx, self, input_offset, child_result.data.success);
     epc_parser_result_cleanup(&child_result);
 
     return result;
@@ -2501,7 +4265,7 @@ pnot_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_o
 EASY_PC_API epc_parser_t *
 epc_not(char const * name, epc_parser_t * p_to_not_match)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "not", pnot_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "not", pnot_parse_fn, pconsumes_nothing_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2520,10 +4284,18 @@ pfail_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_
     return epc_parser_error_result(ctx, input_offset, failure_message, "Failure", "Failure");
 }
 
+static void
+pfail_first_set(epc_parser_t * self, first_set_t * first)
+{
+    // Never succeeds, so the set is empty.
+    (void)self;
+    (void)first;
+}
+
 EASY_PC_API epc_parser_t *
 epc_fail(char const * name, char const * message)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "fail", pfail_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "fail", pfail_parse_fn, pfail_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2550,7 +4322,7 @@ psucceed_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
         return epc_parser_error_result(ctx, input_offset, "Unexpected end of input", "succeed", "EOF");
     }
 
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (node == NULL)
     {
         return epc_parser_error_result(
@@ -2569,7 +4341,7 @@ psucceed_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
 EASY_PC_API epc_parser_t *
 epc_succeed(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "succeed", psucceed_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "succeed", psucceed_parse_fn, pconsumes_nothing_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2592,7 +4364,7 @@ phex_digit_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
 
     if (isxdigit(input[0]))
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -2612,10 +4384,17 @@ phex_digit_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t i
     return epc_parser_error_result(ctx, input_offset, "Unexpected character", "hex_digit", found_str);
 }
 
+static void
+phex_digit_first_set(epc_parser_t * self, first_set_t * first)
+{
+    (void)self;
+    first_set_add_class(first, isxdigit);
+}
+
 EASY_PC_API epc_parser_t *
 epc_hex_digit(char const * name)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "hex_digit", phex_digit_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "hex_digit", phex_digit_parse_fn, phex_digit_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2629,20 +4408,19 @@ pone_of_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
 {
     char const * chars_to_match = self->data.string;
     parse_get_input_result_t input_result = parse_ctx_get_input_at_offset(ctx, input_offset, 1);
-    char expected_str[64];
-
-    snprintf(expected_str, sizeof(expected_str), "character in set '%s'", chars_to_match);
 
     if (input_result.is_eof)
     {
-        return epc_parser_error_result(ctx, input_offset, "Unexpected end of input", expected_str, "EOF");
+        return parser_derived_error_result(
+            ctx, self, input_offset, "Unexpected end of input", PARSE_ERROR_EXPECTED_ONE_OF, "EOF"
+        );
     }
 
     char const * input = input_result.next_input;
 
     if (strchr(chars_to_match, input[0]) != NULL) // If char is found in the set
     {
-        epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (node == NULL)
         {
             return epc_parser_error_result(
@@ -2657,13 +4435,27 @@ pone_of_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
 
     char found_str[2] = {input[0], '\0'};
 
-    return epc_parser_error_result(ctx, input_offset, "Character not found in set", expected_str, found_str);
+    return parser_derived_error_result(
+        ctx, self, input_offset, "Character not found in set", PARSE_ERROR_EXPECTED_ONE_OF, found_str
+    );
+}
+
+static void
+pone_of_first_set(epc_parser_t * self, first_set_t * first)
+{
+    for (int c = CHAR_MIN; c <= CHAR_MAX; c++)
+    {
+        if (strchr(self->data.string, c) != NULL)
+        {
+            first_set_add(first, (unsigned char)c);
+        }
+    }
 }
 
 EASY_PC_API epc_parser_t *
 epc_one_of(char const * name, char const * chars_to_match)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "one_of", pone_of_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "one_of", pone_of_parse_fn, pone_of_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -2697,22 +4489,14 @@ consume_whitespace(epc_parser_ctx_t * ctx, size_t offset, bool consume_comments)
     {
         consumed_something = false;
 
-        while (1)
+        bool at_eof;
+        size_t const spaces = scan_whitespace(ctx, offset + len, &at_eof);
+
+        len += spaces;
+        consumed_something = spaces > 0;
+        if (at_eof)
         {
-            parse_get_input_result_t res = parse_ctx_get_input_at_offset(ctx, offset + len, 1);
-            if (res.is_eof)
-            {
-                return (consume_ws_result_t){.len = len, .interrupted = is_streaming && !parse_ctx_is_eof(ctx)};
-            }
-            if (isspace((unsigned char)res.next_input[0]))
-            {
-                len++;
-                consumed_something = true;
-            }
-            else
-            {
-                break;
-            }
+            return (consume_ws_result_t){.len = len, .interrupted = is_streaming && !parse_ctx_is_eof(ctx)};
         }
 
         if (consume_comments)
@@ -2720,20 +4504,10 @@ consume_whitespace(epc_parser_ctx_t * ctx, size_t offset, bool consume_comments)
             parse_get_input_result_t res = parse_ctx_get_input_at_offset(ctx, offset + len, 2);
             if (!res.is_eof && res.available >= 2 && res.next_input[0] == '/' && res.next_input[1] == '/')
             {
-                len += 2;
-                while (1)
+                len += 2 + scan_line(ctx, offset + len + 2, &at_eof);
+                if (at_eof)
                 {
-                    res = parse_ctx_get_input_at_offset(ctx, offset + len, 1);
-                    if (res.is_eof)
-                    {
-                        return (consume_ws_result_t){.len = len, .interrupted = is_streaming && !parse_ctx_is_eof(ctx)};
-                    }
-                    if (res.next_input[0] == '\n')
-                    {
-                        len++;
-                        break;
-                    }
-                    len++;
+                    return (consume_ws_result_t){.len = len, .interrupted = is_streaming && !parse_ctx_is_eof(ctx)};
                 }
                 consumed_something = true;
             }
@@ -2811,7 +4585,7 @@ plexeme_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
     current_input_offset += trailing_ws_len;
 
     // Success - create a node for 'lexeme'
-    epc_cpt_node_t * parent_node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
     if (parent_node == NULL)
     {
         epc_parser_result_cleanup(&item_result);
@@ -2821,7 +4595,7 @@ plexeme_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
         );
     }
 
-    parent_node->children = calloc(1, sizeof(*parent_node->children));
+    parent_node->children = parse_ctx_children_alloc(ctx, 1);
     if (parent_node->children == NULL)
     {
         epc_parser_result_cleanup(&item_result);
@@ -2847,10 +4621,28 @@ plexeme_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inpu
     return epc_parser_success_result(parent_node);
 }
 
+static void
+plexeme_first_set(epc_parser_t * self, first_set_t * first)
+{
+    *first = *parser_first_set(self->data.lexeme.parser);
+    // Leading whitespace and comments are skipped before the child is tried.
+    for (int c = 0; c <= UCHAR_MAX; c++)
+    {
+        if (isspace(c))
+        {
+            first_set_add(first, (unsigned char)c);
+        }
+    }
+    if (self->data.lexeme.consume_comments)
+    {
+        first_set_add(first, '/');
+    }
+}
+
 EASY_PC_API epc_parser_t *
 epc_lexeme(char const * name, epc_parser_t * p)
 {
-    epc_parser_t * lex = epc_parser_allocate(name, "lexeme", plexeme_parse_fn);
+    epc_parser_t * lex = epc_parser_allocate(name, "lexeme", plexeme_parse_fn, plexeme_first_set);
     if (lex == NULL)
     {
         return NULL;
@@ -2923,7 +4715,7 @@ pchainl1_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
         current_input_offset += right_result.data.success->len;
 
         // Combine left_result, op_result, and right_result into a new left_result
-        epc_cpt_node_t * new_parent_node = epc_node_alloc(self, self->tag);
+        epc_cpt_node_t * new_parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
         if (new_parent_node == NULL)
         {
             epc_parser_result_cleanup(&op_result);
@@ -2935,7 +4727,7 @@ pchainl1_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
             );
         }
 
-        new_parent_node->children = calloc(3, sizeof(*new_parent_node->children));
+        new_parent_node->children = parse_ctx_children_alloc(ctx, 3);
         if (new_parent_node->children == NULL)
         {
             epc_parser_result_cleanup(&op_result);
@@ -2970,7 +4762,7 @@ pchainl1_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
 EASY_PC_API epc_parser_t *
 epc_chainl1(char const * name, epc_parser_t * item_parser, epc_parser_t * op_parser)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "chainl1", pchainl1_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "chainl1", pchainl1_parse_fn, pdelimited_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -3112,7 +4904,7 @@ pchainr1_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
         // to form the structure: Left_Operand op Right_Subtree
         for (int i = pair_count - 1; i >= 0; --i)
         {
-            epc_cpt_node_t * new_parent_node = epc_node_alloc(self, self->tag);
+            epc_cpt_node_t * new_parent_node = parse_ctx_node_alloc(ctx, self, self->tag);
             if (new_parent_node == NULL)
             {
                 epc_node_free(current_right_operand);
@@ -3143,7 +4935,7 @@ pchainr1_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
             }
             epc_cpt_node_t * operator_node = pairs[i].op_node;
 
-            new_parent_node->children = calloc(3, sizeof(*new_parent_node->children));
+            new_parent_node->children = parse_ctx_children_alloc(ctx, 3);
             if (new_parent_node->children == NULL)
             {
                 epc_node_free(current_right_operand);
@@ -3194,7 +4986,7 @@ pchainr1_parse_fn(struct epc_parser_t * self, epc_parser_ctx_t * ctx, size_t inp
 EASY_PC_API epc_parser_t *
 epc_chainr1(char const * name, epc_parser_t * item_parser, epc_parser_t * op_parser)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "chainr1", pchainr1_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "chainr1", pchainr1_parse_fn, pdelimited_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -3237,7 +5029,24 @@ void
 epc_parser_duplicate(epc_parser_t * const dst, epc_parser_t const * const src)
 {
     dst->parse_fn = src->parse_fn;
+    dst->first_set_fn = src->first_set_fn;
     dst->ast_config = src->ast_config;
+    dst->memoize = src->memoize;
+    dst->split = src->split;
+    dst->split_data = src->split_data;
+    dst->is_token = src->is_token;
+
+    // The plans of `dst`, and of the parsers that reach it, were worked out from its old definition. They are
+    // planned again when their grammars are next finalized; other grammars are left alone.
+    parser_plan_t * retired = parser_plan_load(dst);
+
+    parser_plan_store(dst, NULL);
+    if (retired != NULL)
+    {
+        retired->retired = dst->retired_plans;
+        dst->retired_plans = retired;
+    }
+    dst->defined_generation = atomic_fetch_add(&grammar_generation, 1) + 1;
     string_set(&dst->name, src->name);
     dst->tag = src->tag;
 
@@ -3264,9 +5073,31 @@ epc_parser_duplicate(epc_parser_t * const dst, epc_parser_t const * const src)
     case PARSER_DATA_TYPE_PARSER_LIST:
         dst->data.parser_list = parser_list_duplicate(src->data.parser_list);
         break;
+
+    case PARSER_DATA_TYPE_DIRECT:
+    {
+        size_t const sites_size = src->data.direct.site_count * sizeof(*src->data.direct.sites);
+
+        dst->data.direct = src->data.direct;
+        dst->data.direct.sites = sites_size > 0 ? malloc(sites_size) : NULL;
+        if (dst->data.direct.sites != NULL)
+        {
+            memcpy(dst->data.direct.sites, src->data.direct.sites, sites_size);
+        }
+        break;
+    }
+
+    case PARSER_DATA_TYPE_KEYWORDS:
+        dst->data.keywords
+            = keywords_data_create((char const * const *)src->data.keywords->keywords, src->data.keywords->count);
+        break;
     }
 
-    if (src->expected_value == src->data.string)
+    if (src->data.type == PARSER_DATA_TYPE_KEYWORDS)
+    {
+        dst->expected_value = dst->data.keywords != NULL ? dst->data.keywords->expected : NULL;
+    }
+    else if (src->expected_value == src->data.string)
     {
         dst->expected_value = dst->data.string;
     }
@@ -3285,12 +5116,11 @@ psatisfy_parse_fn(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offs
     if (token_result.is_error)
     {
         parser_furthest_error_restore(ctx, &original_furthest_error);
-        epc_parse_result_t result = epc_parser_error_result(
+        epc_parse_result_t result = parse_error_result(
             ctx,
-            input_offset,
-            "Failed to match the satisfy token parser",
-            token_result.data.error->expected,
-            token_result.data.error->found
+            parse_error_from_child(
+                ctx, input_offset, "Failed to match the satisfy token parser", token_result.data.error
+            )
         );
         epc_parser_result_cleanup(&token_result);
 
@@ -3298,6 +5128,10 @@ psatisfy_parse_fn(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offs
     }
     epc_parser_error_free(original_furthest_error);
 
+    if (parse_ctx_is_abandoned(ctx))
+    {
+        return token_result;
+    }
     if (!self->data.predicate.predicate_fn(token_result.data.success, ctx, self->data.predicate.parser_data))
     {
         char found_str[FOUND_BUFFER_SIZE];
@@ -3317,7 +5151,7 @@ psatisfy_parse_fn(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offs
         return result;
     }
 
-    epc_cpt_node_t * node = epc_node_alloc(self, self->tag);
+    epc_cpt_node_t * node = parse_ctx_node_alloc(ctx, self, self->tag);
 
     if (node == NULL)
     {
@@ -3334,6 +5168,12 @@ psatisfy_parse_fn(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offs
     return epc_parser_success_result(node);
 }
 
+static void
+psatisfy_first_set(epc_parser_t * self, first_set_t * first)
+{
+    *first = *parser_first_set(self->data.predicate.parser);
+}
+
 EASY_PC_API epc_parser_t *
 epc_satisfy(
     char const * name,
@@ -3343,7 +5183,7 @@ epc_satisfy(
     void * parser_data
 )
 {
-    epc_parser_t * p = epc_parser_allocate(name, "satisfy", psatisfy_parse_fn);
+    epc_parser_t * p = epc_parser_allocate(name, "satisfy", psatisfy_parse_fn, psatisfy_first_set);
     if (p == NULL)
     {
         return NULL;
@@ -3372,6 +5212,18 @@ pwrap_parse_fn(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
     epc_parser_error_t * original_furthest_error = parser_furthest_error_copy(ctx);
     epc_parse_result_t result = parse(wrapped_parser, ctx, input_offset);
 
+    // The callbacks are only told about parses that are still going to produce a result.
+    if (parse_ctx_is_abandoned(ctx))
+    {
+        epc_parser_error_free(original_furthest_error);
+        return result;
+    }
+
+    if (callbacks.on_exit != NULL && result.is_error)
+    {
+        // The callback may inspect the error, so give it the full strings.
+        epc_parser_error_materialize(ctx, result.data.error);
+    }
     if (callbacks.on_exit != NULL && !callbacks.on_exit(result, ctx, parser_data))
     {
         // If on_exit returns false, we treat it as a failure of the wrapper parser.
@@ -3396,7 +5248,8 @@ pwrap_parse_fn(epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset)
 EASY_PC_API epc_parser_t *
 epc_wrap(char const * name, epc_parser_t * wrapped_parser, epc_wrap_callbacks_t callbacks, void * parser_data)
 {
-    epc_parser_t * p = epc_parser_allocate(name, "wrap", pwrap_parse_fn);
+    // No FIRST set, so a wrap is never skipped and its callbacks see every attempt to match it.
+    epc_parser_t * p = epc_parser_allocate(name, "wrap", pwrap_parse_fn, NULL);
     if (p == NULL)
     {
         return NULL;
@@ -3409,6 +5262,45 @@ epc_wrap(char const * name, epc_parser_t * wrapped_parser, epc_wrap_callbacks_t
     return p;
 }
 
+static void
+pdirect_first_set(epc_parser_t * self, first_set_t * first)
+{
+    *first = *parser_first_set(self->data.direct.fallback);
+}
+
+EASY_PC_API epc_parser_t *
+epc_direct(
+    char const * name, epc_direct_fn fn, epc_parser_t * fallback, epc_parser_t * const * sites, size_t site_count
+)
+{
+    if (fn == NULL || fallback == NULL)
+    {
+        return NULL;
+    }
+
+    epc_parser_t * p = epc_parser_allocate(name, "direct", direct_parse, pdirect_first_set);
+    if (p == NULL)
+    {
+        return NULL;
+    }
+    p->data.type = PARSER_DATA_TYPE_DIRECT;
+    p->data.direct.fn = fn;
+    p->data.direct.fallback = fallback;
+    if (site_count > 0)
+    {
+        p->data.direct.sites = malloc(site_count * sizeof(*p->data.direct.sites));
+        if (p->data.direct.sites == NULL)
+        {
+            epc_parser_free(p);
+            return NULL;
+        }
+        memcpy(p->data.direct.sites, sites, site_count * sizeof(*p->data.direct.sites));
+    }
+    p->data.direct.site_count = site_count;
+
+    return p;
+}
+
 void
 epc_parser_set_ast_action(epc_parser_t * p, int action_type)
 {
@@ -3419,3 +5311,121 @@ epc_parser_set_ast_action(epc_parser_t * p, int action_type)
     p->ast_config.action = action_type;
     p->ast_config.assigned = true;
 }
+
+void
+epc_parser_set_memoize(epc_parser_t * p, bool memoize)
+{
+    if (p == NULL)
+    {
+        return;
+    }
+    p->memoize = memoize;
+}
+
+EASY_PC_API epc_parser_t *
+epc_parser_set_split(epc_parser_t * p, epc_split_fn split, void * user_data)
+{
+    if (p != NULL)
+    {
+        p->split = split;
+        p->split_data = user_data;
+    }
+
+    return p;
+}
+
+EASY_PC_API bool
+epc_split_at_line_start(char const * input, size_t input_len, size_t offset, void * user_data)
+{
+    (void)input_len;
+    (void)user_data;
+
+    return offset > 0 && input[offset - 1] == '\n';
+}
+
+EASY_PC_API void
+epc_parser_set_token(epc_parser_t * p, bool is_token)
+{
+    if (p == NULL)
+    {
+        return;
+    }
+    p->is_token = is_token;
+}
+
+EASY_PC_HIDDEN
+parser_kind_t
+epc_parser_get_kind(epc_parser_t const * p)
+{
+    static struct
+    {
+        parse_fn_t parse_fn;
+        parser_kind_t kind;
+    } const kinds[] = {
+        {pchar_parse_fn, PARSER_KIND_CHAR},
+        {pstring_parse_fn, PARSER_KIND_STRING},
+        {pany_parse_fn, PARSER_KIND_ANY},
+        {pdigit_parse_fn, PARSER_KIND_DIGIT},
+        {palpha_parse_fn, PARSER_KIND_ALPHA},
+        {palphanum_parse_fn, PARSER_KIND_ALPHANUM},
+        {pspace_parse_fn, PARSER_KIND_SPACE},
+        {phex_digit_parse_fn, PARSER_KIND_HEX_DIGIT},
+        {pchar_range_parse_fn, PARSER_KIND_CHAR_RANGE},
+        {pone_of_parse_fn, PARSER_KIND_ONE_OF},
+        {pnone_of_parse_fn, PARSER_KIND_NONE_OF},
+        {peoi_parse_fn, PARSER_KIND_EOI},
+        {psucceed_parse_fn, PARSER_KIND_SUCCEED},
+        {pand_parse_fn, PARSER_KIND_AND},
+        {por_parse_fn, PARSER_KIND_OR},
+        {pmany_parse_fn, PARSER_KIND_MANY},
+        {pplus_parse_fn, PARSER_KIND_PLUS},
+        {poptional_parse_fn, PARSER_KIND_OPTIONAL},
+        {pcount_parse_fn, PARSER_KIND_COUNT},
+        {plookahead_parse_fn, PARSER_KIND_LOOKAHEAD},
+        {pnot_parse_fn, PARSER_KIND_NOT},
+        {pskip_parse_fn, PARSER_KIND_SKIP},
+        {pkeywords_parse_fn, PARSER_KIND_KEYWORDS},
+    };
+
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++)
+    {
+        if (p->parse_fn == kinds[i].parse_fn)
+        {
+            return kinds[i].kind;
+        }
+    }
+
+    return PARSER_KIND_OTHER;
+}
+
+EASY_PC_HIDDEN
+bool
+epc_parser_accepts_char(epc_parser_t const * p, char c)
+{
+    // These mirror the tests made by the parse functions, so must be kept in step with them.
+    switch (epc_parser_get_kind(p))
+    {
+    case PARSER_KIND_CHAR:
+        return c == p->data.string[0];
+    case PARSER_KIND_ANY:
+        return true;
+    case PARSER_KIND_DIGIT:
+        return isdigit(c);
+    case PARSER_KIND_ALPHA:
+        return isalpha(c);
+    case PARSER_KIND_ALPHANUM:
+        return isalnum(c);
+    case PARSER_KIND_SPACE:
+        return isspace(c);
+    case PARSER_KIND_HEX_DIGIT:
+        return isxdigit(c);
+    case PARSER_KIND_CHAR_RANGE:
+        return c >= p->data.range.start && c <= p->data.range.end;
+    case PARSER_KIND_ONE_OF:
+        return strchr(p->data.string, c) != NULL;
+    case PARSER_KIND_NONE_OF:
+        return strchr(p->data.string, c) == NULL;
+    default:
+        return false;
+    }
+}
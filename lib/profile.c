@@ -0,0 +1,238 @@
+#include "profile.h"
+#include "easy_pc_private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PROFILE_INITIAL_CAPACITY 64
+
+static uint64_t
+profile_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static size_t
+profile_slot(profile_t const * profile, epc_parser_t const * parser)
+{
+    uintptr_t const key = (uintptr_t)parser;
+
+    return (size_t)((key >> 4) * UINT64_C(0x9E3779B97F4A7C15) >> 17) & (profile->slot_count - 1);
+}
+
+static bool
+profile_grow(profile_t * profile)
+{
+    size_t const capacity = profile->capacity == 0 ? PROFILE_INITIAL_CAPACITY : profile->capacity * 2;
+    profile_entry_t * entries = realloc(profile->entries, capacity * sizeof(*entries));
+    if (entries == NULL)
+    {
+        return false;
+    }
+    profile->entries = entries;
+    profile->capacity = capacity;
+
+    size_t * slots = calloc(capacity * 2, sizeof(*slots));
+    if (slots == NULL)
+    {
+        return false;
+    }
+    free(profile->slots);
+    profile->slots = slots;
+    profile->slot_count = capacity * 2;
+
+    for (size_t i = 0; i < profile->count; i++)
+    {
+        size_t slot = profile_slot(profile, profile->entries[i].parser);
+
+        while (profile->slots[slot] != 0)
+        {
+            slot = (slot + 1) & (profile->slot_count - 1);
+        }
+        profile->slots[slot] = i + 1;
+    }
+
+    return true;
+}
+
+// Returns the index of the entry for `parser`, adding one if it has none, or SIZE_MAX if there's no room for it.
+static size_t
+profile_entry_index(profile_t * profile, epc_parser_t const * parser)
+{
+    if (profile->slot_count > 0)
+    {
+        size_t slot = profile_slot(profile, parser);
+
+        for (; profile->slots[slot] != 0; slot = (slot + 1) & (profile->slot_count - 1))
+        {
+            if (profile->entries[profile->slots[slot] - 1].parser == parser)
+            {
+                return profile->slots[slot] - 1;
+            }
+        }
+    }
+
+    if (profile->count == profile->capacity && !profile_grow(profile))
+    {
+        profile->is_out_of_memory = true;
+        return SIZE_MAX;
+    }
+
+    size_t slot = profile_slot(profile, parser);
+
+    while (profile->slots[slot] != 0)
+    {
+        slot = (slot + 1) & (profile->slot_count - 1);
+    }
+    profile->slots[slot] = profile->count + 1;
+    profile->entries[profile->count] = (profile_entry_t){
+        .parser = parser,
+        .counts.name = epc_parser_get_name(parser),
+    };
+
+    return profile->count++;
+}
+
+EASY_PC_HIDDEN
+void
+profile_init(profile_t * profile)
+{
+    *profile = (profile_t){0};
+}
+
+EASY_PC_HIDDEN
+void
+profile_enter(profile_t * profile, profile_frame_t * frame, epc_parser_t const * parser, size_t input_offset)
+{
+    size_t const entry = profile_entry_index(profile, parser);
+
+    *frame = (profile_frame_t){
+        .parent = profile->current,
+        .entry = entry,
+        .start_offset = input_offset,
+        .reached = input_offset,
+    };
+    if (entry != SIZE_MAX)
+    {
+        profile->entries[entry].active++;
+    }
+    profile->current = frame;
+    frame->start_ns = profile_now_ns();
+}
+
+EASY_PC_HIDDEN
+void
+profile_exit(profile_t * profile, profile_frame_t * frame, bool is_error, size_t len)
+{
+    uint64_t const elapsed = profile_now_ns() - frame->start_ns;
+    profile_frame_t * parent = frame->parent;
+
+    profile->current = parent;
+    if (parent != NULL)
+    {
+        parent->children_ns += elapsed;
+        if (!is_error && frame->start_offset + len > parent->reached)
+        {
+            parent->reached = frame->start_offset + len;
+        }
+    }
+    if (frame->entry == SIZE_MAX)
+    {
+        return;
+    }
+
+    profile_entry_t * entry = &profile->entries[frame->entry];
+
+    entry->counts.invocations++;
+    if (is_error)
+    {
+        entry->counts.failures++;
+        entry->counts.backtracked_bytes += frame->reached - frame->start_offset;
+    }
+    else
+    {
+        entry->counts.successes++;
+        entry->counts.bytes_consumed += len;
+    }
+    entry->counts.exclusive_ns += elapsed > frame->children_ns ? elapsed - frame->children_ns : 0;
+    if (--entry->active == 0)
+    {
+        entry->counts.inclusive_ns += elapsed;
+    }
+}
+
+static uint64_t
+profile_measure(epc_parser_profile_t const * counts, epc_profile_order_t order)
+{
+    switch (order)
+    {
+    case EPC_PROFILE_BY_INCLUSIVE_TIME:
+        return counts->inclusive_ns;
+    case EPC_PROFILE_BY_INVOCATIONS:
+        return counts->invocations;
+    case EPC_PROFILE_BY_BACKTRACKED_BYTES:
+        return counts->backtracked_bytes;
+    case EPC_PROFILE_BY_EXCLUSIVE_TIME:
+    default:
+        return counts->exclusive_ns;
+    }
+}
+
+EASY_PC_HIDDEN
+size_t
+profile_top(profile_t const * profile, epc_profile_order_t order, size_t n, epc_parser_profile_t top[])
+{
+    size_t count = 0;
+
+    // An insertion into the sorted top `n`, as `n` is small next to the number of parsers.
+    for (size_t i = 0; i < profile->count; i++)
+    {
+        epc_parser_profile_t const * counts = &profile->entries[i].counts;
+        uint64_t const measure = profile_measure(counts, order);
+        size_t position = count;
+
+        while (position > 0 && profile_measure(&top[position - 1], order) < measure)
+        {
+            position--;
+        }
+        if (position == n)
+        {
+            continue;
+        }
+        if (count < n)
+        {
+            count++;
+        }
+        memmove(&top[position + 1], &top[position], (count - 1 - position) * sizeof(*top));
+        top[position] = *counts;
+    }
+
+    return count;
+}
+
+EASY_PC_HIDDEN
+void
+profile_reset(profile_t * profile)
+{
+    profile->count = 0;
+    if (profile->slots != NULL)
+    {
+        memset(profile->slots, 0, profile->slot_count * sizeof(*profile->slots));
+    }
+    profile->current = NULL;
+    profile->is_out_of_memory = false;
+}
+
+EASY_PC_HIDDEN
+void
+profile_release(profile_t * profile)
+{
+    free(profile->entries);
+    free(profile->slots);
+    *profile = (profile_t){0};
+}
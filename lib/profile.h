@@ -0,0 +1,67 @@
+#pragma once
+
+#include <easy_pc/easy_pc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct profile_entry_t
+{
+    epc_parser_t const * parser;
+    epc_parser_profile_t counts;
+    size_t active; // Runs of the parser in progress, so that recursive runs only count their outermost time.
+} profile_entry_t;
+
+// A parser being run, which lives on the stack of the parse() that runs it.
+typedef struct profile_frame_t
+{
+    struct profile_frame_t * parent;
+    size_t entry;
+    size_t start_offset;
+    size_t reached; // The furthest offset its children's matches reached.
+    uint64_t start_ns;
+    uint64_t children_ns;
+} profile_frame_t;
+
+// The counts of each parser run in a parse, in the order they were first run.
+typedef struct profile_t
+{
+    profile_entry_t * entries;
+    size_t count;
+    size_t capacity;
+
+    size_t * slots; // Open addressed hash of parser to entry index + 1, where 0 is empty.
+    size_t slot_count; // A power of two, at least twice `capacity`.
+
+    profile_frame_t * current;
+    bool is_out_of_memory; // Parsers that couldn't be given an entry aren't counted.
+} profile_t;
+
+EASY_PC_HIDDEN
+void
+profile_init(profile_t * profile);
+
+// Starts timing a run of `parser` from `input_offset`.
+EASY_PC_HIDDEN
+void
+profile_enter(profile_t * profile, profile_frame_t * frame, epc_parser_t const * parser, size_t input_offset);
+
+// Stops timing the run in `frame`, which matched `len` bytes unless it failed.
+EASY_PC_HIDDEN
+void
+profile_exit(profile_t * profile, profile_frame_t * frame, bool is_error, size_t len);
+
+// Copies the top `n` entries by `order` to `top`. Returns how many were copied.
+EASY_PC_HIDDEN
+size_t
+profile_top(profile_t const * profile, epc_profile_order_t order, size_t n, epc_parser_profile_t top[]);
+
+// Forgets every count, keeping the tables for reuse.
+EASY_PC_HIDDEN
+void
+profile_reset(profile_t * profile);
+
+EASY_PC_HIDDEN
+void
+profile_release(profile_t * profile);
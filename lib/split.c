@@ -0,0 +1,204 @@
+#include "split.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+// Input shorter than this per thread isn't worth splitting.
+#define SPLIT_MIN_CHUNK_SIZE (64 * 1024)
+
+typedef struct split_chunk_t
+{
+    epc_parser_t * self;
+    epc_parser_ctx_t * ctx; // The chunk's own context.
+    size_t start;
+    size_t end; // Where the next chunk starts.
+    bool is_first;
+    bool is_last;
+    child_list_t items;
+    size_t end_offset;
+    bool is_parsed; // The chunk's records parsed, and ended where they had to.
+    pthread_t thread;
+    bool is_started;
+} split_chunk_t;
+
+static void *
+split_chunk_run(void * arg)
+{
+    split_chunk_t * chunk = arg;
+
+    chunk->is_parsed = child_list_init(&chunk->items, chunk->ctx, 64)
+                       && split_parse_chunk(
+                           chunk->self,
+                           chunk->ctx,
+                           chunk->start,
+                           chunk->end,
+                           chunk->is_first,
+                           chunk->is_last,
+                           &chunk->items,
+                           &chunk->end_offset
+                       );
+
+    return NULL;
+}
+
+// Returns the first offset from `offset` at which a record may start, or `input_len` if there isn't one.
+static size_t
+split_find_boundary(epc_parser_t * self, char const * input, size_t input_len, size_t offset)
+{
+    first_set_t const * first = epc_parser_get_first_set(self);
+
+    for (; offset < input_len; offset++)
+    {
+        if (first_set_contains(first, (unsigned char)input[offset])
+            && self->split(input, input_len, offset, self->split_data))
+        {
+            break;
+        }
+    }
+
+    return offset;
+}
+
+// Divides the input from `input_offset` among at most `count` chunks. Returns how many there are.
+static size_t
+split_chunks_init(
+    split_chunk_t * chunks, size_t count, epc_parser_t * self, char const * input, size_t input_len, size_t input_offset
+)
+{
+    size_t chunk_count = 0;
+    size_t start = input_offset;
+
+    while (chunk_count < count)
+    {
+        split_chunk_t * chunk = &chunks[chunk_count++];
+
+        *chunk = (split_chunk_t){
+            .self = self,
+            .start = start,
+            .end = input_len,
+            .is_first = chunk_count == 1,
+            .is_last = true,
+        };
+        if (chunk_count == count)
+        {
+            break;
+        }
+
+        // The next chunk starts where a record may, after an equal share of the input.
+        size_t const share = input_offset + (input_len - input_offset) * chunk_count / count;
+        size_t const next_start = split_find_boundary(self, input, input_len, share > start ? share : start + 1);
+
+        if (next_start >= input_len)
+        {
+            break;
+        }
+        chunk->end = next_start;
+        chunk->is_last = false;
+        start = next_start;
+    }
+
+    return chunk_count;
+}
+
+static void
+split_chunks_free(split_chunk_t * chunks, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (chunks[i].ctx != NULL)
+        {
+            child_list_release(&chunks[i].items);
+            parse_ctx_destroy_chunk(chunks[i].ctx);
+        }
+    }
+    free(chunks);
+}
+
+EASY_PC_HIDDEN
+bool
+split_parse(
+    epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset, child_list_t * items, size_t * end_offset
+)
+{
+    size_t const thread_count = parse_ctx_split_thread_count(ctx);
+    size_t const input_len = parse_ctx_get_input_len(ctx);
+
+    if (thread_count < 2 || input_offset >= input_len || (input_len - input_offset) / SPLIT_MIN_CHUNK_SIZE < 2)
+    {
+        return false;
+    }
+
+    size_t count = (input_len - input_offset) / SPLIT_MIN_CHUNK_SIZE;
+    if (count > thread_count)
+    {
+        count = thread_count;
+    }
+
+    split_chunk_t * chunks = calloc(count, sizeof(*chunks));
+    if (chunks == NULL)
+    {
+        return false;
+    }
+
+    char const * input = parse_ctx_get_input_at_offset(ctx, 0, 0).next_input;
+    count = split_chunks_init(chunks, count, self, input, input_len, input_offset);
+    if (count < 2)
+    {
+        free(chunks);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        chunks[i].ctx = parse_ctx_create_chunk(ctx);
+        if (chunks[i].ctx == NULL)
+        {
+            split_chunks_free(chunks, count);
+            return false;
+        }
+    }
+
+    // The last chunk is parsed on this thread, as is any other that a thread can't be started for.
+    for (size_t i = 0; i < count - 1; i++)
+    {
+        chunks[i].is_started = pthread_create(&chunks[i].thread, NULL, split_chunk_run, &chunks[i]) == 0;
+    }
+    split_chunk_run(&chunks[count - 1]);
+
+    bool is_parsed = true;
+    size_t item_count = items->count;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (chunks[i].is_started)
+        {
+            pthread_join(chunks[i].thread, NULL);
+        }
+        else if (i < count - 1)
+        {
+            split_chunk_run(&chunks[i]);
+        }
+        is_parsed = is_parsed && chunks[i].is_parsed;
+        item_count += chunks[i].items.count;
+    }
+
+    if (!is_parsed || !child_list_reserve(items, item_count))
+    {
+        split_chunks_free(chunks, count);
+        return false;
+    }
+
+    // The chunks' nodes now belong to the caller's context, in input order.
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = 0; j < chunks[i].items.count; j++)
+        {
+            child_list_append(items, chunks[i].items.children[j]);
+        }
+        chunks[i].items = (child_list_t){0};
+        parse_ctx_adopt_chunk(ctx, chunks[i].ctx);
+    }
+    *end_offset = chunks[count - 1].end_offset;
+    split_chunks_free(chunks, count);
+
+    return true;
+}
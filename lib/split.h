@@ -0,0 +1,34 @@
+#pragma once
+
+#include "child_list.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Parses the records of `self`, an epc_many or epc_delimited parser with a split predicate, from `input_offset` in
+// chunks on several threads. On success their nodes are appended to `items`, `*end_offset` is where the records end,
+// and the nodes and furthest error of the chunks belong to `ctx`. Returns false, with nothing changed, if the input
+// can't be split or a split wasn't at a record boundary, in which case the caller parses the records itself.
+// For epc_delimited, the records start after its first item, with a delimiter.
+EASY_PC_HIDDEN
+bool
+split_parse(
+    epc_parser_t * self, epc_parser_ctx_t * ctx, size_t input_offset, child_list_t * items, size_t * end_offset
+);
+
+// Parses the records of a chunk from `start` into `items`, the way `self` parses them, and sets `*end_offset` to where
+// they end. The last chunk parses as many records as there are. Any other must end exactly at `end`, where the next
+// chunk starts, or false is returned. For epc_delimited, the first chunk starts with a delimiter and the others with an
+// item, and a chunk other than the last must end just after a delimiter. Defined in parsers.c.
+EASY_PC_HIDDEN
+bool
+split_parse_chunk(
+    epc_parser_t * self,
+    epc_parser_ctx_t * ctx,
+    size_t start,
+    size_t end,
+    bool is_first,
+    bool is_last,
+    child_list_t * items,
+    size_t * end_offset
+);
@@ -0,0 +1,1125 @@
+#include "vm.h"
+#include "failure.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The largest epc_count() that is unrolled into the program. Larger counts are run by the interpreter.
+#define VM_MAX_UNROLLED_COUNT 32
+
+// The program always starts with a FAIL instruction, so that a jump to it fails.
+#define VM_FAIL_PC 0
+
+typedef enum vm_opcode_t
+{
+    VM_OP_CHAR,           // Match the byte `arg`.
+    VM_OP_STRING,         // Match the `arg` bytes of the parser's string.
+    VM_OP_SET,            // Match a byte in set `arg`.
+    VM_OP_EOI,            // Match the end of the input.
+    VM_OP_EMPTY,          // Push a zero-length node for the parser.
+    VM_OP_REQUIRE_INPUT,  // Fail at the end of the input.
+    VM_OP_TEST_SET,       // Jump to `arg` unless the next byte is in set `aux`. There must be a next byte.
+    VM_OP_OPEN,           // Start collecting the nodes that become the children of a CLOSE.
+    VM_OP_CLOSE,          // Replace the nodes pushed since the OPEN with a node that has them as children.
+    VM_OP_WRAP,           // Replace the top node with a node that covers the same input and has it as its child.
+    VM_OP_TOKEN,          // Replace the node pushed since the OPEN with a node without children; free its subtree.
+    VM_OP_CHOICE,         // Push a backtrack entry of kind `aux` that resumes at `arg`.
+    VM_OP_COMMIT,         // Pop the backtrack entry and jump to `arg`.
+    VM_OP_PARTIAL_COMMIT, // Update the backtrack entry to the current state and jump to `arg`; fail if no progress.
+    VM_OP_BACK_COMMIT,    // Pop the backtrack entry, restoring the state it holds, and jump to `arg`.
+    VM_OP_FAIL_TWICE,     // Pop the backtrack entry and fail, as an epc_not() whose child matched.
+    VM_OP_FAIL,
+    VM_OP_CALL, // Call the rule at `arg`.
+    VM_OP_RET,
+    VM_OP_CALLOUT, // Run the parser with its parse function.
+    VM_OP_END,
+} vm_opcode_t;
+
+// What a choice does about errors, following the combinator it was compiled from. A choice that resumes at
+// VM_FAIL_PC passes the failure on once it has done its part.
+typedef enum vm_choice_kind_t
+{
+    VM_CHOICE_PLAIN,        // Backtracking between alternatives or out of a repetition.
+    VM_CHOICE_ALTERNATIVES, // Around an epc_or(). Reports that no alternative matched if none did.
+    VM_CHOICE_OPTIONAL,     // Around the child of an epc_optional().
+    VM_CHOICE_PREDICATE,    // Around the child of an epc_lookahead() or epc_not().
+    VM_CHOICE_COUNT,        // Around a child of an epc_count(). Reports a failure as a count mismatch.
+} vm_choice_kind_t;
+
+typedef struct vm_instruction_t
+{
+    vm_opcode_t op;
+    size_t arg;
+    size_t aux;
+    epc_parser_t * parser; // The parser that nodes are created for.
+} vm_instruction_t;
+
+typedef struct vm_rule_t
+{
+    epc_parser_t * parser;
+    size_t pc;
+} vm_rule_t;
+
+struct epc_compiled_grammar_t
+{
+    epc_parser_t * top_parser;
+    unsigned long generation; // The grammar generation the program was compiled from.
+
+    vm_instruction_t * code;
+    size_t code_count;
+    size_t code_capacity;
+
+    first_set_t * sets;
+    size_t set_count;
+    size_t set_capacity;
+
+    vm_rule_t * rules; // Only needed while compiling.
+    size_t rule_count;
+    size_t rule_capacity;
+
+    bool failed;
+};
+
+// --- Compiler ---
+
+static bool
+vm_grow(void ** items, size_t * capacity, size_t count, size_t item_size)
+{
+    if (count < *capacity)
+    {
+        return true;
+    }
+
+    size_t const new_capacity = *capacity == 0 ? 64 : *capacity * 2;
+    void * new_items = realloc(*items, new_capacity * item_size);
+    if (new_items == NULL)
+    {
+        return false;
+    }
+    *items = new_items;
+    *capacity = new_capacity;
+
+    return true;
+}
+
+static size_t
+emit(epc_compiled_grammar_t * g, vm_opcode_t op, size_t arg, epc_parser_t * parser)
+{
+    if (!vm_grow((void **)&g->code, &g->code_capacity, g->code_count, sizeof(*g->code)))
+    {
+        g->failed = true;
+        return VM_FAIL_PC;
+    }
+    g->code[g->code_count] = (vm_instruction_t){.op = op, .arg = arg, .parser = parser};
+
+    return g->code_count++;
+}
+
+static size_t
+emit_choice(epc_compiled_grammar_t * g, size_t resume_pc, vm_choice_kind_t kind, epc_parser_t * parser)
+{
+    size_t const pc = emit(g, VM_OP_CHOICE, resume_pc, parser);
+
+    if (!g->failed)
+    {
+        g->code[pc].aux = kind;
+    }
+
+    return pc;
+}
+
+// Sets the jump target of the instruction at `pc` to the next instruction to be emitted.
+static void
+patch_here(epc_compiled_grammar_t * g, size_t pc)
+{
+    if (!g->failed)
+    {
+        g->code[pc].arg = g->code_count;
+    }
+}
+
+static size_t
+add_set(epc_compiled_grammar_t * g, first_set_t const * set)
+{
+    if (!vm_grow((void **)&g->sets, &g->set_capacity, g->set_count, sizeof(*g->sets)))
+    {
+        g->failed = true;
+        return 0;
+    }
+    g->sets[g->set_count] = *set;
+
+    return g->set_count++;
+}
+
+// Returns the index of the rule for `p`, queueing it to be compiled if this is the first time it is needed.
+static size_t
+rule_for(epc_compiled_grammar_t * g, epc_parser_t * p)
+{
+    for (size_t i = 0; i < g->rule_count; i++)
+    {
+        if (g->rules[i].parser == p)
+        {
+            return i;
+        }
+    }
+
+    if (!vm_grow((void **)&g->rules, &g->rule_capacity, g->rule_count, sizeof(*g->rules)))
+    {
+        g->failed = true;
+        return 0;
+    }
+    g->rules[g->rule_count] = (vm_rule_t){.parser = p};
+
+    return g->rule_count++;
+}
+
+static bool
+parser_list_is_compilable(parser_list_t const * list)
+{
+    if (list == NULL || list->count == 0)
+    {
+        return false;
+    }
+    for (int i = 0; i < list->count; i++)
+    {
+        if (list->parsers[i] == NULL)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Combinators are compiled to their own rule unless they are malformed, in which case the interpreter is left to
+// report the error.
+static bool
+combinator_is_compilable(epc_parser_t const * p, parser_kind_t kind)
+{
+    switch (kind)
+    {
+    case PARSER_KIND_AND:
+    case PARSER_KIND_OR:
+        return parser_list_is_compilable(p->data.parser_list);
+
+    case PARSER_KIND_MANY:
+    case PARSER_KIND_PLUS:
+    case PARSER_KIND_OPTIONAL:
+    case PARSER_KIND_LOOKAHEAD:
+    case PARSER_KIND_NOT:
+        return p->data.parser != NULL;
+
+    case PARSER_KIND_COUNT:
+        return p->data.count.parser != NULL && p->data.count.count <= VM_MAX_UNROLLED_COUNT;
+
+    default:
+        return false;
+    }
+}
+
+// Emits the code that matches `p` at the current position and pushes its node.
+static void
+compile_parser(epc_compiled_grammar_t * g, epc_parser_t * p)
+{
+    parser_kind_t const kind = epc_parser_get_kind(p);
+
+    // Memoized parsers go through the interpreter, which owns the memo table, as do those that may split their input
+    // and left-recursive ones, whose matches are grown there.
+    if (p->memoize || p->split != NULL || epc_parser_is_left_recursive(p))
+    {
+        emit(g, VM_OP_CALLOUT, 0, p);
+        return;
+    }
+
+    switch (kind)
+    {
+    case PARSER_KIND_CHAR:
+        emit(g, VM_OP_CHAR, (unsigned char)p->data.string[0], p);
+        break;
+
+    case PARSER_KIND_STRING:
+        emit(g, VM_OP_STRING, strlen(p->data.string), p);
+        break;
+
+    case PARSER_KIND_ANY:
+    case PARSER_KIND_DIGIT:
+    case PARSER_KIND_ALPHA:
+    case PARSER_KIND_ALPHANUM:
+    case PARSER_KIND_SPACE:
+    case PARSER_KIND_HEX_DIGIT:
+    case PARSER_KIND_CHAR_RANGE:
+    case PARSER_KIND_ONE_OF:
+    case PARSER_KIND_NONE_OF:
+    {
+        first_set_t set = {0};
+
+        for (int c = 0; c <= UCHAR_MAX; c++)
+        {
+            if (epc_parser_accepts_char(p, (char)c))
+            {
+                first_set_add(&set, (unsigned char)c);
+            }
+        }
+        emit(g, VM_OP_SET, add_set(g, &set), p);
+        break;
+    }
+
+    case PARSER_KIND_EOI:
+        emit(g, VM_OP_EOI, 0, p);
+        break;
+
+    case PARSER_KIND_SUCCEED:
+        emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+        emit(g, VM_OP_EMPTY, 0, p);
+        break;
+
+    default:
+        if (combinator_is_compilable(p, kind) && p->is_token)
+        {
+            emit(g, VM_OP_OPEN, 0, p);
+            emit(g, VM_OP_CALL, rule_for(g, p), p);
+            emit(g, VM_OP_TOKEN, 0, p);
+        }
+        else if (combinator_is_compilable(p, kind))
+        {
+            emit(g, VM_OP_CALL, rule_for(g, p), p);
+        }
+        else
+        {
+            emit(g, VM_OP_CALLOUT, 0, p);
+        }
+        break;
+    }
+}
+
+static void
+compile_or(epc_compiled_grammar_t * g, epc_parser_t * p)
+{
+    parser_list_t const * alternatives = p->data.parser_list;
+    size_t commits = SIZE_MAX; // The COMMITs to patch, chained through their jump targets.
+
+    emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+    emit_choice(g, VM_FAIL_PC, VM_CHOICE_ALTERNATIVES, p);
+    for (int i = 0; i < alternatives->count; i++)
+    {
+        epc_parser_t * alternative = alternatives->parsers[i];
+        first_set_t const * first = epc_parser_get_first_set(alternative);
+        bool const is_last = i == alternatives->count - 1;
+        size_t test = SIZE_MAX;
+        size_t choice = SIZE_MAX;
+
+        // Alternatives that can't start with the next byte are skipped, as epc_or does with its dispatch table.
+        if (!first->nullable)
+        {
+            test = emit(g, VM_OP_TEST_SET, VM_FAIL_PC, p);
+            if (!g->failed)
+            {
+                g->code[test].aux = add_set(g, first);
+            }
+        }
+        if (!is_last)
+        {
+            choice = emit_choice(g, 0, VM_CHOICE_PLAIN, p);
+        }
+        compile_parser(g, alternative);
+        if (!is_last)
+        {
+            commits = emit(g, VM_OP_COMMIT, commits, p);
+            patch_here(g, choice);
+            if (test != SIZE_MAX)
+            {
+                patch_here(g, test);
+            }
+        }
+    }
+    while (commits != SIZE_MAX && !g->failed)
+    {
+        size_t const next = g->code[commits].arg;
+
+        patch_here(g, commits);
+        commits = next;
+    }
+    patch_here(g, emit(g, VM_OP_COMMIT, 0, p));
+    emit(g, VM_OP_WRAP, 0, p);
+}
+
+// Emits a loop that matches `child` until it fails, failing if an iteration doesn't consume anything.
+static void
+compile_repeat(epc_compiled_grammar_t * g, epc_parser_t * p, epc_parser_t * child)
+{
+    size_t const loop = emit_choice(g, 0, VM_CHOICE_PLAIN, p);
+
+    compile_parser(g, child);
+    emit(g, VM_OP_PARTIAL_COMMIT, loop + 1, p);
+    patch_here(g, loop);
+}
+
+// Emits the body of the rule for a combinator.
+static void
+compile_rule(epc_compiled_grammar_t * g, epc_parser_t * p)
+{
+    switch (epc_parser_get_kind(p))
+    {
+    case PARSER_KIND_AND:
+    {
+        parser_list_t const * sequence = p->data.parser_list;
+
+        emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+        emit(g, VM_OP_OPEN, 0, p);
+        for (int i = 0; i < sequence->count; i++)
+        {
+            compile_parser(g, sequence->parsers[i]);
+        }
+        emit(g, VM_OP_CLOSE, 0, p);
+        break;
+    }
+
+    case PARSER_KIND_OR:
+        compile_or(g, p);
+        break;
+
+    case PARSER_KIND_MANY:
+        emit(g, VM_OP_OPEN, 0, p);
+        compile_repeat(g, p, p->data.parser);
+        emit(g, VM_OP_CLOSE, 0, p);
+        break;
+
+    case PARSER_KIND_PLUS:
+        emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+        emit(g, VM_OP_OPEN, 0, p);
+        compile_parser(g, p->data.parser);
+        compile_repeat(g, p, p->data.parser);
+        emit(g, VM_OP_CLOSE, 0, p);
+        break;
+
+    case PARSER_KIND_OPTIONAL:
+    {
+        emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+        size_t const choice = emit_choice(g, 0, VM_CHOICE_OPTIONAL, p);
+        compile_parser(g, p->data.parser);
+        emit(g, VM_OP_WRAP, 0, p);
+        size_t const commit = emit(g, VM_OP_COMMIT, 0, p);
+        patch_here(g, choice);
+        emit(g, VM_OP_EMPTY, 0, p);
+        patch_here(g, commit);
+        break;
+    }
+
+    case PARSER_KIND_COUNT:
+        emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+        if (p->data.count.count <= 0)
+        {
+            emit(g, VM_OP_EMPTY, 0, p);
+            break;
+        }
+        emit(g, VM_OP_OPEN, 0, p);
+        for (int i = 0; i < p->data.count.count; i++)
+        {
+            emit_choice(g, VM_FAIL_PC, VM_CHOICE_COUNT, p);
+            compile_parser(g, p->data.count.parser);
+            patch_here(g, emit(g, VM_OP_COMMIT, 0, p));
+        }
+        emit(g, VM_OP_CLOSE, 0, p);
+        break;
+
+    case PARSER_KIND_LOOKAHEAD:
+    {
+        emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+        emit_choice(g, VM_FAIL_PC, VM_CHOICE_PREDICATE, p);
+        compile_parser(g, p->data.parser);
+        size_t const commit = emit(g, VM_OP_BACK_COMMIT, 0, p);
+        patch_here(g, commit);
+        emit(g, VM_OP_EMPTY, 0, p);
+        break;
+    }
+
+    case PARSER_KIND_NOT:
+    {
+        emit(g, VM_OP_REQUIRE_INPUT, 0, p);
+        size_t const choice = emit_choice(g, 0, VM_CHOICE_PREDICATE, p);
+        compile_parser(g, p->data.parser);
+        emit(g, VM_OP_FAIL_TWICE, 0, p);
+        patch_here(g, choice);
+        emit(g, VM_OP_EMPTY, 0, p);
+        break;
+    }
+
+    default:
+        // Only combinators accepted by combinator_is_compilable() get a rule.
+        g->failed = true;
+        break;
+    }
+}
+
+static void
+check_resolved(epc_parser_t * p, void * data)
+{
+    bool * resolved = data;
+
+    if (p != NULL && p->parse_fn == NULL)
+    {
+        *resolved = false;
+    }
+}
+
+EASY_PC_API
+void
+epc_compiled_grammar_free(epc_compiled_grammar_t * grammar)
+{
+    if (grammar == NULL)
+    {
+        return;
+    }
+    free(grammar->code);
+    free(grammar->sets);
+    free(grammar->rules);
+    free(grammar);
+}
+
+EASY_PC_API
+epc_compiled_grammar_t *
+epc_grammar_compile(epc_parser_t * top_parser)
+{
+    if (top_parser == NULL || top_parser->parse_fn == NULL)
+    {
+        return NULL;
+    }
+
+    epc_compiled_grammar_t * g = calloc(1, sizeof(*g));
+    if (g == NULL)
+    {
+        return NULL;
+    }
+
+    epc_grammar_finalize(top_parser);
+    g->top_parser = top_parser;
+    g->generation = epc_grammar_generation(top_parser);
+
+    emit(g, VM_OP_FAIL, 0, top_parser); // VM_FAIL_PC
+    compile_parser(g, top_parser);
+    emit(g, VM_OP_END, 0, top_parser);
+
+    // Compiling a rule can queue more rules, so rule_count may grow during the loop.
+    for (size_t i = 0; i < g->rule_count && !g->failed; i++)
+    {
+        epc_parser_t * p = g->rules[i].parser;
+        bool resolved = true;
+
+        epc_parser_visit_children(p, check_resolved, &resolved);
+        if (!resolved)
+        {
+            // An unresolved forward declaration can't be run at all.
+            g->failed = true;
+            break;
+        }
+        g->rules[i].pc = g->code_count;
+        compile_rule(g, p);
+        emit(g, VM_OP_RET, 0, p);
+    }
+
+    if (g->failed)
+    {
+        epc_compiled_grammar_free(g);
+        return NULL;
+    }
+
+    for (size_t pc = 0; pc < g->code_count; pc++)
+    {
+        if (g->code[pc].op == VM_OP_CALL)
+        {
+            g->code[pc].arg = g->rules[g->code[pc].arg].pc;
+        }
+    }
+    free(g->rules);
+    g->rules = NULL;
+    g->rule_count = 0;
+    g->rule_capacity = 0;
+
+    return g;
+}
+
+EASY_PC_HIDDEN
+epc_parser_t *
+vm_grammar_top_parser(epc_compiled_grammar_t const * grammar)
+{
+    return grammar->top_parser;
+}
+
+EASY_PC_HIDDEN
+unsigned long
+vm_grammar_generation(epc_compiled_grammar_t const * grammar)
+{
+    return grammar->generation;
+}
+
+// --- Interpreter ---
+
+typedef struct vm_frame_t
+{
+    size_t start;     // Input offset the node being built starts at.
+    size_t node_base; // Index of the first node that belongs to it.
+    parse_ctx_mark_t mark;
+} vm_frame_t;
+
+typedef struct vm_backtrack_t
+{
+    size_t pc; // Where a choice resumes, or where a call returns to.
+    bool is_choice;
+    vm_choice_kind_t kind;
+    epc_parser_t * parser; // The combinator the choice was compiled from.
+    size_t pos;
+    size_t node_top;
+    size_t frame_top;
+    parse_ctx_mark_t mark;
+    epc_parser_error_t * saved_error; // The furthest error when the choice was made, for the kinds that restore it.
+} vm_backtrack_t;
+
+typedef struct vm_t
+{
+    epc_parser_ctx_t * ctx;
+    char const * input;
+    size_t input_len; // The amount of input known to be available.
+    bool is_streaming;
+
+    epc_cpt_node_t ** nodes;
+    size_t node_top;
+    size_t node_capacity;
+
+    vm_frame_t * frames;
+    size_t frame_top;
+    size_t frame_capacity;
+
+    vm_backtrack_t * stack;
+    size_t stack_top;
+    size_t stack_capacity;
+
+    failure_t failure;
+} vm_t;
+
+// Waits until `count` bytes are available at `pos` of a streamed input. Returns false if the input ends first.
+static bool
+vm_wait_for_input(vm_t * vm, size_t pos, size_t count)
+{
+    parse_get_input_result_t const input_result = parse_ctx_get_input_at_offset(vm->ctx, pos, count);
+
+    if (input_result.next_input != NULL)
+    {
+        vm->input_len = pos + input_result.available;
+    }
+
+    return !input_result.is_eof;
+}
+
+static inline bool
+vm_has_input(vm_t * vm, size_t pos, size_t count)
+{
+    if (pos + count <= vm->input_len)
+    {
+        return true;
+    }
+
+    return vm->is_streaming && vm_wait_for_input(vm, pos, count);
+}
+
+static inline bool
+vm_push_node(vm_t * vm, epc_cpt_node_t * node)
+{
+    if (node == NULL || !vm_grow((void **)&vm->nodes, &vm->node_capacity, vm->node_top, sizeof(*vm->nodes)))
+    {
+        return false;
+    }
+    vm->nodes[vm->node_top++] = node;
+
+    return true;
+}
+
+static inline epc_cpt_node_t *
+vm_new_node(vm_t * vm, epc_parser_t * p, size_t start, size_t len)
+{
+    epc_cpt_node_t * node = parse_ctx_node_alloc(vm->ctx, p, p->tag);
+
+    if (node != NULL)
+    {
+        node->content = vm->input + start;
+        node->len = len;
+    }
+
+    return node;
+}
+
+static bool
+vm_close(vm_t * vm, epc_parser_t * p, size_t pos)
+{
+    vm_frame_t const frame = vm->frames[--vm->frame_top];
+    size_t const child_count = vm->node_top - frame.node_base;
+    epc_cpt_node_t * node = vm_new_node(vm, p, frame.start, pos - frame.start);
+
+    if (node == NULL)
+    {
+        return false;
+    }
+    if (child_count > 0)
+    {
+        node->children = parse_ctx_children_alloc(vm->ctx, child_count);
+        if (node->children == NULL)
+        {
+            return false;
+        }
+        memcpy(node->children, &vm->nodes[frame.node_base], child_count * sizeof(*node->children));
+        node->children_count = (int)child_count;
+    }
+    vm->node_top = frame.node_base;
+
+    return vm_push_node(vm, node);
+}
+
+static bool
+vm_wrap(vm_t * vm, epc_parser_t * p)
+{
+    epc_cpt_node_t * child = vm->nodes[vm->node_top - 1];
+    epc_cpt_node_t * node = parse_ctx_node_alloc(vm->ctx, p, p->tag);
+
+    if (node == NULL)
+    {
+        return false;
+    }
+    node->children = parse_ctx_children_alloc(vm->ctx, 1);
+    if (node->children == NULL)
+    {
+        return false;
+    }
+    node->content = child->content;
+    node->len = child->len;
+    node->children[0] = child;
+    node->children_count = 1;
+    vm->nodes[vm->node_top - 1] = node;
+
+    return true;
+}
+
+static bool
+vm_token(vm_t * vm)
+{
+    vm_frame_t const frame = vm->frames[--vm->frame_top];
+    epc_cpt_node_t * node = parse_ctx_token_node(vm->ctx, vm->nodes[frame.node_base], &frame.mark);
+
+    if (node == NULL)
+    {
+        return false;
+    }
+    vm->nodes[frame.node_base] = node;
+
+    return true;
+}
+
+// The kinds of choice whose combinator puts the furthest error back as it was once its child has matched.
+static inline bool
+vm_choice_saves_error(vm_choice_kind_t kind)
+{
+    return kind == VM_CHOICE_ALTERNATIVES || kind == VM_CHOICE_OPTIONAL || kind == VM_CHOICE_PREDICATE;
+}
+
+static bool
+vm_push_backtrack(vm_t * vm, vm_instruction_t const * instruction, bool is_choice, size_t pc, size_t pos)
+{
+    if (!vm_grow((void **)&vm->stack, &vm->stack_capacity, vm->stack_top, sizeof(*vm->stack)))
+    {
+        return false;
+    }
+    vm_backtrack_t * entry = &vm->stack[vm->stack_top++];
+
+    entry->pc = pc;
+    entry->is_choice = is_choice;
+    if (is_choice)
+    {
+        entry->kind = (vm_choice_kind_t)instruction->aux;
+        entry->parser = instruction->parser;
+        entry->pos = pos;
+        entry->node_top = vm->node_top;
+        entry->frame_top = vm->frame_top;
+        entry->mark = parse_ctx_mark(vm->ctx);
+        entry->saved_error = NULL;
+        if (vm_choice_saves_error(entry->kind))
+        {
+            entry->saved_error = failure_save_furthest(&vm->failure);
+        }
+    }
+
+    return true;
+}
+
+// Pops the choice on top of the stack once its child has matched.
+static vm_backtrack_t *
+vm_commit(vm_t * vm)
+{
+    vm_backtrack_t * entry = &vm->stack[--vm->stack_top];
+
+    if (vm_choice_saves_error(entry->kind))
+    {
+        failure_restore_furthest(&vm->failure, &entry->saved_error);
+    }
+
+    return entry;
+}
+
+static epc_cpt_node_t *
+vm_out_of_memory(vm_t * vm, epc_parser_t * p, size_t pos)
+{
+    failure_flush(&vm->failure);
+    failure_set(&vm->failure, parser_out_of_memory_error_result(vm->ctx, p, pos));
+
+    return NULL;
+}
+
+// Does what the combinator a choice was compiled from does when its child fails, after the state has been restored.
+// Returns true if the program resumes at the choice, or false if the failure goes on.
+static bool
+vm_catch(vm_t * vm, vm_backtrack_t * entry)
+{
+    if (entry->kind == VM_CHOICE_COUNT || (entry->pc == VM_FAIL_PC && entry->kind != VM_CHOICE_ALTERNATIVES))
+    {
+        // The error is passed on, before the furthest error can change.
+        failure_build(&vm->failure);
+    }
+
+    switch (entry->kind)
+    {
+    case VM_CHOICE_PLAIN:
+        break;
+
+    case VM_CHOICE_ALTERNATIVES:
+        epc_parser_error_free(entry->saved_error);
+        failure_flush(&vm->failure);
+        failure_set(
+            &vm->failure,
+            parser_no_alternative_error_result(vm->ctx, entry->parser, entry->pos, vm->input + entry->pos)
+        );
+        break;
+
+    case VM_CHOICE_OPTIONAL:
+        epc_parser_error_free(entry->saved_error);
+        break;
+
+    case VM_CHOICE_PREDICATE:
+        failure_restore_furthest(&vm->failure, &entry->saved_error);
+        break;
+
+    case VM_CHOICE_COUNT:
+    {
+        size_t const matched = entry->node_top - vm->frames[entry->frame_top - 1].node_base;
+
+        failure_set(&vm->failure, parser_count_error_result(vm->ctx, entry->pos, matched, vm->failure.error));
+        break;
+    }
+    }
+
+    if (entry->pc == VM_FAIL_PC)
+    {
+        return false;
+    }
+    failure_set(&vm->failure, (epc_parse_result_t){0});
+
+    return true;
+}
+
+// Runs the program. Returns the root node, or NULL if the input doesn't match or memory ran out.
+static epc_cpt_node_t *
+vm_run(epc_compiled_grammar_t const * g, vm_t * vm)
+{
+    vm_instruction_t const * const code = g->code;
+    size_t pc = VM_FAIL_PC + 1;
+    size_t pos = 0;
+
+    for (;;)
+    {
+        vm_instruction_t const * instruction = &code[pc];
+
+        switch (instruction->op)
+        {
+        case VM_OP_CHAR:
+            if (!vm_has_input(vm, pos, 1) || (unsigned char)vm->input[pos] != instruction->arg)
+            {
+                failure_set_parser(&vm->failure, instruction->parser, pos);
+                goto fail;
+            }
+            if (!vm_push_node(vm, vm_new_node(vm, instruction->parser, pos, 1)))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pos++;
+            pc++;
+            break;
+
+        case VM_OP_STRING:
+            if (!vm_has_input(vm, pos, instruction->arg)
+                || memcmp(vm->input + pos, instruction->parser->data.string, instruction->arg) != 0)
+            {
+                failure_set_parser(&vm->failure, instruction->parser, pos);
+                goto fail;
+            }
+            if (!vm_push_node(vm, vm_new_node(vm, instruction->parser, pos, instruction->arg)))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pos += instruction->arg;
+            pc++;
+            break;
+
+        case VM_OP_SET:
+            if (!vm_has_input(vm, pos, 1)
+                || !first_set_contains(&g->sets[instruction->arg], (unsigned char)vm->input[pos]))
+            {
+                failure_set_parser(&vm->failure, instruction->parser, pos);
+                goto fail;
+            }
+            if (!vm_push_node(vm, vm_new_node(vm, instruction->parser, pos, 1)))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pos++;
+            pc++;
+            break;
+
+        case VM_OP_EOI:
+            if (vm_has_input(vm, pos, 1))
+            {
+                failure_set_parser(&vm->failure, instruction->parser, pos);
+                goto fail;
+            }
+            if (!vm_push_node(vm, vm_new_node(vm, instruction->parser, pos, 0)))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pc++;
+            break;
+
+        case VM_OP_EMPTY:
+            if (!vm_push_node(vm, vm_new_node(vm, instruction->parser, pos, 0)))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pc++;
+            break;
+
+        case VM_OP_REQUIRE_INPUT:
+            if (!vm_has_input(vm, pos, 1))
+            {
+                failure_set_parser(&vm->failure, instruction->parser, pos);
+                goto fail;
+            }
+            pc++;
+            break;
+
+        case VM_OP_TEST_SET:
+            if (first_set_contains(&g->sets[instruction->aux], (unsigned char)vm->input[pos]))
+            {
+                pc++;
+            }
+            else
+            {
+                pc = instruction->arg;
+            }
+            break;
+
+        case VM_OP_OPEN:
+            if (!vm_grow((void **)&vm->frames, &vm->frame_capacity, vm->frame_top, sizeof(*vm->frames)))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            vm->frames[vm->frame_top++] = (vm_frame_t){
+                .start = pos,
+                .node_base = vm->node_top,
+                .mark = parse_ctx_mark(vm->ctx),
+            };
+            pc++;
+            break;
+
+        case VM_OP_CLOSE:
+            if (!vm_close(vm, instruction->parser, pos))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pc++;
+            break;
+
+        case VM_OP_WRAP:
+            if (!vm_wrap(vm, instruction->parser))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pc++;
+            break;
+
+        case VM_OP_TOKEN:
+            if (!vm_token(vm))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pc++;
+            break;
+
+        case VM_OP_CHOICE:
+            if (!vm_push_backtrack(vm, instruction, true, instruction->arg, pos))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pc++;
+            break;
+
+        case VM_OP_COMMIT:
+            vm_commit(vm);
+            pc = instruction->arg;
+            break;
+
+        case VM_OP_PARTIAL_COMMIT:
+        {
+            vm_backtrack_t * entry = &vm->stack[vm->stack_top - 1];
+
+            if (entry->pos == pos)
+            {
+                // The repeated parser matched without consuming anything, so it would loop forever.
+                vm->stack_top--;
+                failure_flush(&vm->failure);
+                failure_set(&vm->failure, parser_no_progress_error_result(vm->ctx, pos));
+                goto fail;
+            }
+            entry->pos = pos;
+            entry->node_top = vm->node_top;
+            entry->frame_top = vm->frame_top;
+            entry->mark = parse_ctx_mark(vm->ctx);
+            pc = instruction->arg;
+            break;
+        }
+
+        case VM_OP_BACK_COMMIT:
+        {
+            vm_backtrack_t const * entry = vm_commit(vm);
+
+            pos = entry->pos;
+            vm->node_top = entry->node_top;
+            vm->frame_top = entry->frame_top;
+            parse_ctx_reclaim(vm->ctx, &entry->mark);
+            pc = instruction->arg;
+            break;
+        }
+
+        case VM_OP_FAIL_TWICE:
+        {
+            vm_backtrack_t const * entry = vm_commit(vm);
+            epc_cpt_node_t const * match = vm->nodes[vm->node_top - 1];
+
+            failure_set(
+                &vm->failure, parser_unexpected_match_error_result(vm->ctx, entry->parser, entry->pos, match)
+            );
+            goto fail;
+        }
+
+        case VM_OP_FAIL:
+            goto fail;
+
+        case VM_OP_CALL:
+            if (!vm_push_backtrack(vm, instruction, false, pc + 1, pos))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pc = instruction->arg;
+            break;
+
+        case VM_OP_RET:
+            pc = vm->stack[--vm->stack_top].pc;
+            break;
+
+        case VM_OP_CALLOUT:
+        {
+            failure_flush(&vm->failure);
+
+            epc_parse_result_t result = epc_parser_parse(instruction->parser, vm->ctx, pos);
+
+            if (result.is_error)
+            {
+                failure_set(&vm->failure, result);
+                goto fail;
+            }
+            if (!vm_push_node(vm, result.data.success))
+            {
+                return vm_out_of_memory(vm, instruction->parser, pos);
+            }
+            pos += result.data.success->len;
+            pc++;
+            break;
+        }
+
+        case VM_OP_END:
+            return vm->nodes[vm->node_top - 1];
+        }
+        continue;
+
+    fail:
+        // Unwind to the most recent choice that resumes the program, discarding any calls made since.
+        for (;;)
+        {
+            while (vm->stack_top > 0 && !vm->stack[vm->stack_top - 1].is_choice)
+            {
+                vm->stack_top--;
+            }
+            if (vm->stack_top == 0)
+            {
+                return NULL;
+            }
+
+            vm_backtrack_t * entry = &vm->stack[--vm->stack_top];
+
+            pos = entry->pos;
+            vm->node_top = entry->node_top;
+            vm->frame_top = entry->frame_top;
+            parse_ctx_reclaim(vm->ctx, &entry->mark);
+            if (vm_catch(vm, entry))
+            {
+                pc = entry->pc;
+                break;
+            }
+        }
+    }
+}
+
+EASY_PC_HIDDEN
+epc_parse_result_t
+vm_parse(epc_compiled_grammar_t const * grammar, epc_parser_ctx_t * ctx)
+{
+    vm_t vm = {
+        .ctx = ctx,
+        .input = parse_ctx_get_input_start(ctx),
+        .is_streaming = parse_ctx_is_streaming(ctx),
+    };
+
+    if (!vm.is_streaming)
+    {
+        vm.input_len = parse_ctx_get_input_len(ctx);
+    }
+
+    if (vm.input == NULL)
+    {
+        // Nothing can be matched, and the top parser fails straight away.
+        return epc_parser_parse(grammar->top_parser, ctx, 0);
+    }
+
+    failure_init(&vm.failure, ctx);
+
+    epc_cpt_node_t * root = vm_run(grammar, &vm);
+
+    // Choices are only left on the stack if memory ran out.
+    for (size_t i = 0; i < vm.stack_top; i++)
+    {
+        if (vm.stack[i].is_choice)
+        {
+            epc_parser_error_free(vm.stack[i].saved_error);
+        }
+    }
+    free(vm.nodes);
+    free(vm.frames);
+    free(vm.stack);
+
+    return failure_result(&vm.failure, root, grammar->top_parser, 0);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "easy_pc_private.h"
+
+// Runs a compiled grammar over the input held by `ctx`. The result is the one the top parser of the grammar would
+// give if it was run by its parse function.
+EASY_PC_HIDDEN
+epc_parse_result_t
+vm_parse(epc_compiled_grammar_t const * grammar, epc_parser_ctx_t * ctx);
+
+// Returns the parser the grammar was compiled from.
+EASY_PC_HIDDEN
+epc_parser_t *
+vm_grammar_top_parser(epc_compiled_grammar_t const * grammar);
+
+// Returns the grammar generation (see epc_grammar_generation()) the grammar was compiled from.
+EASY_PC_HIDDEN
+unsigned long
+vm_grammar_generation(epc_compiled_grammar_t const * grammar);
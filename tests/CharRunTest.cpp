@@ -0,0 +1,174 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h> // For malloc, free
+#include <string.h> // For memset
+}
+
+TEST_GROUP(CharRunTest)
+{
+    epc_parse_session_t session = {0};
+    epc_parser_list * list = NULL;
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0}; // Reset session before each test
+        list = epc_parser_list_create();
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    epc_parse_result_t parse(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_destroy(&session);
+        session = epc_parse_str(parser, input, NULL);
+        return session.result;
+    }
+
+    // Checks that `node` has a child of length 1 for each of its characters, made by `repeated`.
+    void check_char_children(epc_cpt_node_t * node, epc_parser_t * repeated)
+    {
+        LONGS_EQUAL(node->len, node->children_count);
+        for (int i = 0; i < node->children_count; i++)
+        {
+            epc_cpt_node_t const * child = node->children[i];
+
+            POINTERS_EQUAL(node->content + i, child->content);
+            LONGS_EQUAL(1, child->len);
+            STRCMP_EQUAL(repeated->tag, child->tag);
+            LONGS_EQUAL(0, child->children_count);
+        }
+    }
+
+    void check_error(char const * message, char const * expected, char const * found, size_t col)
+    {
+        CHECK_TRUE(session.result.is_error);
+        STRCMP_EQUAL(message, session.result.data.error->message);
+        STRCMP_EQUAL(expected, session.result.data.error->expected);
+        STRCMP_EQUAL(found, session.result.data.error->found);
+        LONGS_EQUAL(col, session.result.data.error->position.col);
+    }
+};
+
+TEST(CharRunTest, ManyDigitsMakesANodePerDigit)
+{
+    epc_parser_t * digit = epc_digit_l(list, "d");
+    epc_parser_t * p = epc_many_l(list, NULL, digit);
+
+    epc_parse_result_t result = parse(p, "0123456789012345678901234567890123456789x");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(40, result.data.success->len);
+    check_char_children(result.data.success, digit);
+    STRCMP_EQUAL("d", result.data.success->children[39]->name);
+}
+
+TEST(CharRunTest, RunEndsAtEveryPositionWithinAVector)
+{
+    epc_parser_t * alpha = epc_alpha_l(list, NULL);
+    epc_parser_t * p = epc_many_l(list, NULL, alpha);
+    char input[80];
+
+    for (size_t len = 0; len < 70; len++)
+    {
+        memset(input, 'q', len);
+        input[len] = '!';
+        input[len + 1] = '\0';
+
+        epc_parse_result_t result = parse(p, input);
+
+        CHECK_FALSE(result.is_error);
+        LONGS_EQUAL(len, result.data.success->len);
+        check_char_children(result.data.success, alpha);
+    }
+}
+
+TEST(CharRunTest, RunToTheEndOfTheInput)
+{
+    epc_parser_t * space = epc_space_l(list, NULL);
+    epc_parser_t * p = epc_and_l(list, NULL, 2, epc_plus_l(list, NULL, space), epc_eoi_l(list, NULL));
+
+    epc_parse_result_t result = parse(p, " \t\r\n \v\f                                  \n");
+
+    CHECK_FALSE(result.is_error);
+    check_char_children(result.data.success->children[0], space);
+}
+
+TEST(CharRunTest, NoneOfRunStopsAtAForbiddenChar)
+{
+    epc_parser_t * none_of = epc_none_of_l(list, NULL, "\"\\");
+    epc_parser_t * p = epc_plus_l(list, NULL, none_of);
+
+    epc_parse_result_t result = parse(p, "a string of more than thirty-two characters\\\" and more");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(43, result.data.success->len);
+    check_char_children(result.data.success, none_of);
+}
+
+TEST(CharRunTest, ClassOfManyRangesIsMatched)
+{
+    epc_parser_t * one_of = epc_one_of_l(list, NULL, "acegikmoqsuwy");
+    epc_parser_t * p = epc_many_l(list, NULL, one_of);
+
+    epc_parse_result_t result = parse(p, "acegikmoqsuwyyyyyyyyyyyyyyyyyyyywaceb");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(36, result.data.success->len);
+    check_char_children(result.data.success, one_of);
+}
+
+TEST(CharRunTest, BytesAboveAsciiAreMatched)
+{
+    epc_parser_t * range = epc_char_range_l(list, NULL, (char)0x80, (char)0xFF);
+    epc_parser_t * p = epc_plus_l(list, NULL, range);
+
+    epc_parse_result_t result = parse(p, "\xc3\xa9t\xc3\xa9");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(2, result.data.success->len);
+    check_char_children(result.data.success, range);
+}
+
+TEST(CharRunTest, RunOfAChar)
+{
+    epc_parser_t * x = epc_char_l(list, NULL, 'x');
+    epc_parser_t * p = epc_many_l(list, NULL, x);
+
+    epc_parse_result_t result = parse(p, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(37, result.data.success->len);
+    check_char_children(result.data.success, x);
+}
+
+TEST(CharRunTest, ErrorsAreThoseOfTheRepeatedParser)
+{
+    epc_parser_t * p = epc_and_l(
+        list, NULL, 2, epc_plus_l(list, NULL, epc_hex_digit_l(list, NULL)), epc_eoi_l(list, NULL)
+    );
+
+    parse(p, "g");
+    check_error("Unexpected character", "hex_digit", "g", 0);
+    parse(p, "0123456789abcdefABCDEFg");
+    check_error("End of input not found", "<end of input>", "g", 22);
+}
+
+TEST(CharRunTest, RepeatedParserRedefinedAfterParsing)
+{
+    epc_parser_t * item = epc_parser_fwd_decl_l(list, "item");
+    epc_parser_t * p = epc_many_l(list, NULL, item);
+
+    epc_parser_duplicate(item, epc_digit_l(list, NULL));
+    LONGS_EQUAL(3, parse(p, "123abc").data.success->len);
+
+    epc_parser_duplicate(item, epc_alpha_l(list, NULL));
+    LONGS_EQUAL(0, parse(p, "123abc").data.success->len);
+    LONGS_EQUAL(3, parse(p, "abc123").data.success->len);
+}
@@ -172,3 +172,46 @@ TEST(CombinatorTest, PPlusMatchesMultipleThenFails)
     STRNCMP_EQUAL("a", result.data.success->children[1]->content, 1);
     STRNCMP_EQUAL("a", result.data.success->children[2]->content, 1);
 }
+
+TEST(CombinatorTest, PStarMatchesInputSpanningManyArenaSlabs)
+{
+    size_t const input_len = 100000;
+    char * input = (char *)malloc(input_len + 1);
+    memset(input, 'a', input_len);
+    input[input_len] = '\0';
+
+    epc_parser_t * p_char_a = epc_char(NULL, 'a');
+    epc_parser_t * p_star_a = epc_many(NULL, p_char_a);
+
+    result = parse(p_star_a, input);
+    free(input);
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(input_len, result.data.success->len);
+    LONGS_EQUAL(input_len, result.data.success->children_count);
+    STRCMP_EQUAL("char", result.data.success->children[0]->tag);
+    STRCMP_EQUAL("char", result.data.success->children[input_len - 1]->tag);
+    LONGS_EQUAL(1, result.data.success->children[input_len - 1]->len);
+}
+
+TEST(CombinatorTest, POrKeepsTreeOfMatchingAlternativeAfterBacktracking)
+{
+    epc_parser_t * p_a = epc_char(NULL, 'a');
+    epc_parser_t * p_b = epc_char(NULL, 'b');
+    epc_parser_t * p_c = epc_char(NULL, 'c');
+    epc_parser_t * p_abc = epc_and(NULL, 3, p_a, p_b, p_c);
+    epc_parser_t * p_ab = epc_and("ab", 2, p_a, p_b);
+    epc_parser_t * p_or = epc_or(NULL, 2, p_abc, p_ab);
+    epc_parser_t * p_star = epc_many(NULL, p_or);
+
+    result = parse(p_star, "ababcab");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(7, result.data.success->len);
+    LONGS_EQUAL(3, result.data.success->children_count);
+    STRCMP_EQUAL("ab", result.data.success->children[0]->children[0]->name);
+    LONGS_EQUAL(3, result.data.success->children[1]->children[0]->children_count);
+    STRNCMP_EQUAL("abc", result.data.success->children[1]->content, 3);
+    STRCMP_EQUAL("ab", result.data.success->children[2]->children[0]->name);
+    STRNCMP_EQUAL("b", result.data.success->children[2]->children[0]->children[1]->content, 1);
+}
@@ -120,4 +120,68 @@ TEST(CptVisitor, HandlesNullCallbacks)
     epc_cpt_visit_nodes(root, &visitor_no_exit);
     STRCMP_EQUAL("ENTER:ROOT ", visitor_data.log);
     CHECK_EQUAL(1, visitor_data.node_count); // enter_node was called
-}
\ No newline at end of file
+}
+typedef struct
+{
+    int depth;
+    int max_depth;
+    int entered;
+    int exited;
+} DepthVisitorData;
+
+static void
+depth_enter_node(epc_cpt_node_t * node, void * user_data)
+{
+    DepthVisitorData * data = (DepthVisitorData *)user_data;
+
+    (void)node;
+    data->entered++;
+    if (++data->depth > data->max_depth)
+    {
+        data->max_depth = data->depth;
+    }
+}
+
+static void
+depth_exit_node(epc_cpt_node_t * node, void * user_data)
+{
+    DepthVisitorData * data = (DepthVisitorData *)user_data;
+
+    (void)node;
+    data->exited++;
+    data->depth--;
+}
+
+TEST(CptVisitor, VisitsDeepTreeWithoutRecursing)
+{
+    // A right associative chain nests one level per operator.
+    int const item_count = 1000000;
+    char * input = (char *)malloc(item_count * 2);
+    for (int i = 0; i < item_count; i++)
+    {
+        input[i * 2] = '1';
+        input[i * 2 + 1] = '-';
+    }
+    input[item_count * 2 - 1] = '\0';
+
+    epc_parser_list * list = epc_parser_list_create();
+    epc_parser_t * chain = epc_chainr1_l(list, "chain", epc_digit_l(list, "digit"), epc_char_l(list, "minus", '-'));
+    epc_parse_session_t session = epc_parse_str(chain, input, NULL);
+
+    CHECK_FALSE(session.result.is_error);
+
+    DepthVisitorData visitor_data = {0};
+    epc_cpt_visitor_t visitor
+        = {.enter_node = depth_enter_node, .exit_node = depth_exit_node, .user_data = &visitor_data};
+
+    epc_cpt_visit_nodes(session.result.data.success, &visitor);
+
+    LONGS_EQUAL(item_count * 3 - 2, visitor_data.entered);
+    LONGS_EQUAL(visitor_data.entered, visitor_data.exited);
+    LONGS_EQUAL(0, visitor_data.depth);
+    CHECK_TRUE(visitor_data.max_depth >= item_count);
+
+    epc_parse_session_destroy(&session);
+    epc_parser_list_free(list);
+    free(input);
+}
@@ -0,0 +1,341 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <ctype.h>
+#include <stdlib.h> // For free
+}
+
+// A direct parser written as gdl_compiler --emit=direct would generate it for:
+//   Item = 'a' | digit+ | int;   (the int is a callout)
+//   Program = Item* eoi;
+enum
+{
+    SITE_ITEM,
+    SITE_A,
+    SITE_DIGITS,
+    SITE_DIGIT,
+    SITE_INT,
+    SITE_PROGRAM,
+    SITE_ITEMS,
+    SITE_EOI,
+    SITE_COUNT,
+};
+
+static bool
+direct_Item_1(epc_direct_t * d, size_t * pos)
+{
+    if (!epc_direct_has_input(d, *pos, 1))
+    {
+        return epc_direct_fail(d, SITE_DIGITS, *pos);
+    }
+
+    size_t const start = *pos;
+    size_t const mark = epc_direct_mark(d);
+
+    if (mark == EPC_DIRECT_NO_MARK)
+    {
+        return false;
+    }
+    if (!((epc_direct_has_input(d, *pos, 1) && isdigit(d->input[*pos])) ? epc_direct_token(d, SITE_DIGIT, pos, 1)
+                                                                    : epc_direct_fail(d, SITE_DIGIT, *pos)))
+    {
+        epc_direct_reset(d, mark);
+        *pos = start;
+        return false;
+    }
+    for (;;)
+    {
+        size_t const before = *pos;
+
+        if (!((epc_direct_has_input(d, *pos, 1) && isdigit(d->input[*pos])) ? epc_direct_token(d, SITE_DIGIT, pos, 1)
+                                                                    : epc_direct_fail(d, SITE_DIGIT, *pos)))
+        {
+            break;
+        }
+        if (*pos == before)
+        {
+            epc_direct_no_progress(d, *pos);
+            epc_direct_reset(d, mark);
+            *pos = start;
+            return false;
+        }
+    }
+
+    return epc_direct_close(d, mark, SITE_DIGITS, start, pos);
+}
+
+static bool
+direct_Item(epc_direct_t * d, size_t * pos)
+{
+    if (!epc_direct_has_input(d, *pos, 1))
+    {
+        return epc_direct_fail(d, SITE_ITEM, *pos);
+    }
+
+    size_t const saved = epc_direct_save_error(d);
+    bool matched;
+
+    switch ((unsigned char)d->input[*pos])
+    {
+    case 'a':
+        matched = epc_direct_char(d, SITE_A, pos, 'a') || epc_direct_callout(d, SITE_INT, pos);
+        break;
+    default:
+        matched = direct_Item_1(d, pos) || epc_direct_callout(d, SITE_INT, pos);
+        break;
+    }
+    if (!matched)
+    {
+        return epc_direct_no_alternative(d, saved, SITE_ITEM, *pos);
+    }
+    epc_direct_restore_error(d, saved);
+
+    return epc_direct_wrap(d, SITE_ITEM, pos);
+}
+
+static bool
+direct_Program_1(epc_direct_t * d, size_t * pos)
+{
+    size_t const start = *pos;
+    size_t const mark = epc_direct_mark(d);
+
+    if (mark == EPC_DIRECT_NO_MARK)
+    {
+        return false;
+    }
+    for (;;)
+    {
+        size_t const before = *pos;
+
+        if (!direct_Item(d, pos))
+        {
+            break;
+        }
+        if (*pos == before)
+        {
+            epc_direct_no_progress(d, *pos);
+            epc_direct_reset(d, mark);
+            *pos = start;
+            return false;
+        }
+    }
+
+    return epc_direct_close(d, mark, SITE_ITEMS, start, pos);
+}
+
+static bool
+direct_Program(epc_direct_t * d, size_t * pos)
+{
+    if (!epc_direct_has_input(d, *pos, 1))
+    {
+        return epc_direct_fail(d, SITE_PROGRAM, *pos);
+    }
+
+    size_t const start = *pos;
+    size_t const mark = epc_direct_mark(d);
+
+    if (mark == EPC_DIRECT_NO_MARK)
+    {
+        return false;
+    }
+    if (!direct_Program_1(d, pos)
+        || !(!epc_direct_has_input(d, *pos, 1) ? epc_direct_token(d, SITE_EOI, pos, 0)
+                                               : epc_direct_fail(d, SITE_EOI, *pos)))
+    {
+        epc_direct_reset(d, mark);
+        *pos = start;
+        return false;
+    }
+
+    return epc_direct_close(d, mark, SITE_PROGRAM, start, pos);
+}
+
+// Sequence = int eoi; with its sites in that order.
+static bool
+direct_Sequence(epc_direct_t * d, size_t * pos)
+{
+    if (!epc_direct_has_input(d, *pos, 1))
+    {
+        return epc_direct_fail(d, 0, *pos);
+    }
+
+    size_t const start = *pos;
+    size_t const mark = epc_direct_mark(d);
+
+    if (mark == EPC_DIRECT_NO_MARK)
+    {
+        return false;
+    }
+    if (!epc_direct_callout(d, 1, pos)
+        || !(!epc_direct_has_input(d, *pos, 1) ? epc_direct_token(d, 2, pos, 0) : epc_direct_fail(d, 2, *pos)))
+    {
+        epc_direct_reset(d, mark);
+        *pos = start;
+        return false;
+    }
+
+    return epc_direct_close(d, mark, 0, start, pos);
+}
+
+static bool
+count_exit(epc_parse_result_t result, epc_parser_ctx_t * ctx, void * user_ctx)
+{
+    (void)result;
+    (void)ctx;
+    (*(int *)user_ctx)++;
+    return true;
+}
+
+TEST_GROUP(DirectParserTest)
+{
+    epc_parser_list * list = NULL;
+    epc_parser_t * graph = NULL;
+    epc_parser_t * direct = NULL;
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+
+        epc_parser_t * item = epc_or_l(
+            list,
+            "Item",
+            3,
+            epc_char_l(list, NULL, 'a'),
+            epc_plus_l(list, NULL, epc_digit_l(list, "digit")),
+            epc_int_l(list, "int")
+        );
+        epc_parser_set_ast_action(item, 1);
+        graph = epc_and_l(list, "Program", 2, epc_many_l(list, NULL, item), epc_eoi_l(list, "eoi"));
+
+        epc_parser_t * const sites[SITE_COUNT] = {
+            item,
+            epc_direct_child(item, 0),
+            epc_direct_child(item, 1),
+            epc_direct_child(epc_direct_child(item, 1), 0),
+            epc_direct_child(item, 2),
+            graph,
+            epc_direct_child(graph, 0),
+            epc_direct_child(graph, 1),
+        };
+        direct = epc_direct_l(list, "Program", direct_Program, graph, sites, SITE_COUNT);
+    }
+
+    void teardown() override
+    {
+        epc_parser_list_free(list);
+    }
+
+    // Parses `input` with both the graph and the direct parser, and checks that the results are the same.
+    // Returns true if the input was accepted.
+    bool check_same_result(char const * input)
+    {
+        epc_parse_session_t expected_session = epc_parse_str(graph, input, NULL);
+        epc_parse_session_t actual_session = epc_parse_str(direct, input, NULL);
+        bool const accepted = !expected_session.result.is_error;
+
+        CHECK_EQUAL(expected_session.result.is_error, actual_session.result.is_error);
+        if (accepted)
+        {
+            char * expected
+                = epc_cpt_to_string(expected_session.internal_parse_ctx, expected_session.result.data.success);
+            char * actual = epc_cpt_to_string(actual_session.internal_parse_ctx, actual_session.result.data.success);
+
+            STRCMP_EQUAL(expected, actual);
+            free(expected);
+            free(actual);
+        }
+        else
+        {
+            epc_parser_error_t const * expected = expected_session.result.data.error;
+            epc_parser_error_t const * actual = actual_session.result.data.error;
+
+            STRCMP_EQUAL(expected->message, actual->message);
+            STRCMP_EQUAL(expected->expected, actual->expected);
+            STRCMP_EQUAL(expected->found, actual->found);
+            CHECK_EQUAL(expected->position.col, actual->position.col);
+        }
+
+        epc_parse_session_destroy(&expected_session);
+        epc_parse_session_destroy(&actual_session);
+
+        return accepted;
+    }
+};
+
+TEST(DirectParserTest, ChildrenAreFoundInParseOrder)
+{
+    epc_parser_t * first = epc_char_l(list, "first", 'x');
+    epc_parser_t * second = epc_char_l(list, "second", 'y');
+    epc_parser_t * sequence = epc_and_l(list, "sequence", 2, first, second);
+
+    POINTERS_EQUAL(first, epc_direct_child(sequence, 0));
+    POINTERS_EQUAL(second, epc_direct_child(sequence, 1));
+    POINTERS_EQUAL(NULL, epc_direct_child(sequence, 2));
+    POINTERS_EQUAL(NULL, epc_direct_child(first, 0));
+}
+
+TEST(DirectParserTest, MatchingInputBuildsTheSameTree)
+{
+    CHECK_TRUE(check_same_result("a12a3"));
+    CHECK_TRUE(check_same_result("a"));
+}
+
+TEST(DirectParserTest, CallOutsToTheGraphBuildTheSameTree)
+{
+    CHECK_TRUE(check_same_result("-12a"));
+}
+
+TEST(DirectParserTest, MismatchesReportTheErrorOfTheGraph)
+{
+    CHECK_FALSE(check_same_result("a1b"));
+    CHECK_FALSE(check_same_result("-"));
+    CHECK_FALSE(check_same_result(""));
+}
+
+TEST(DirectParserTest, AstActionsComeFromTheGraphParsers)
+{
+    epc_parse_session_t session = epc_parse_str(direct, "a", NULL);
+
+    CHECK_FALSE(session.result.is_error);
+    epc_cpt_node_t * item = session.result.data.success->children[0]->children[0];
+    STRCMP_EQUAL("Item", item->name);
+    CHECK_TRUE(item->ast_config.assigned);
+    CHECK_EQUAL(1, item->ast_config.action);
+
+    epc_parse_session_destroy(&session);
+}
+
+TEST(DirectParserTest, TokensBuildTheSameTree)
+{
+    epc_parser_t * item = epc_direct_child(epc_direct_child(graph, 0), 0);
+
+    // A token made with epc_direct_close(), and one made with epc_direct_wrap().
+    epc_parser_set_token(epc_direct_child(item, 1), true);
+    CHECK_TRUE(check_same_result("a12a3"));
+    epc_parser_set_token(item, true);
+    CHECK_TRUE(check_same_result("a12a3-4"));
+
+    epc_parse_session_t session = epc_parse_str(direct, "123", NULL);
+
+    CHECK_FALSE(session.result.is_error);
+    LONGS_EQUAL(0, session.result.data.success->children[0]->children[0]->children_count);
+    epc_parse_session_destroy(&session);
+}
+
+TEST(DirectParserTest, CallbacksRunOnceWhenTheInputDoesNotMatch)
+{
+    int exit_calls = 0;
+    epc_wrap_callbacks_t callbacks = {NULL, count_exit};
+    epc_parser_t * number = epc_wrap_l(list, "number", epc_int_l(list, NULL), callbacks, &exit_calls);
+    epc_parser_t * sequence = epc_and_l(list, "Sequence", 2, number, epc_eoi_l(list, "eoi"));
+    epc_parser_t * const sites[] = {sequence, number, epc_direct_child(sequence, 1)};
+    epc_parser_t * p = epc_direct_l(list, "direct", direct_Sequence, sequence, sites, 3);
+    epc_parse_session_t session = epc_parse_str(p, "12X", NULL);
+
+    CHECK_TRUE(session.result.is_error);
+    STRCMP_EQUAL("X", session.result.data.error->found);
+    LONGS_EQUAL(1, exit_calls);
+    epc_parse_session_destroy(&session);
+}
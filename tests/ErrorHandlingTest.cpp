@@ -186,3 +186,34 @@ TEST(ErrorHandling, POrReportsErrorWhenAllAlternativesFail)
     STRCMP_EQUAL("x or y", result.data.error->expected);
     STRCMP_EQUAL("abc", result.data.error->found);
 }
+
+TEST(ErrorHandling, PCountReportsIndexOfFailingChild)
+{
+    epc_parser_t * p_digit = epc_digit(NULL);
+    epc_parser_t * p_count = epc_count(NULL, 3, p_digit);
+
+    result = parse(p_count, "12a");
+
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL("Count failed to match child at count 3", result.data.error->message);
+    STRCMP_EQUAL("a", result.data.error->input_position);
+    STRCMP_EQUAL("digit", result.data.error->expected);
+    STRCMP_EQUAL("a", result.data.error->found);
+    LONGS_EQUAL(2, result.data.error->position.col);
+
+    epc_parser_free(p_count);
+    epc_parser_free(p_digit);
+}
+
+TEST(ErrorHandling, PCharRangeReportsRangeInExpected)
+{
+    epc_parser_t * p_range = epc_char_range(NULL, 'a', 'f');
+
+    result = parse(p_range, "z");
+
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL("character in range [a-f]", result.data.error->expected);
+    STRCMP_EQUAL("z", result.data.error->found);
+
+    epc_parser_free(p_range);
+}
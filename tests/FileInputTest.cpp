@@ -0,0 +1,114 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdio.h>
+#include <stdlib.h> // For malloc, free
+#include <string.h> // For memset
+#include <unistd.h> // For sysconf, unlink
+}
+
+TEST_GROUP(FileInputTest)
+{
+    epc_parse_session_t session = {0};
+    epc_parser_list * list = NULL;
+    char filename[32];
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0}; // Reset session before each test
+        list = epc_parser_list_create();
+        strcpy(filename, "file_input_test_XXXXXX");
+        int fd = mkstemp(filename);
+        CHECK_TRUE(fd >= 0);
+        close(fd);
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+        unlink(filename);
+    }
+
+    void write_file(char const * content, size_t len)
+    {
+        FILE * fp = fopen(filename, "wb");
+
+        CHECK_TRUE(fp != NULL);
+        LONGS_EQUAL(len, fwrite(content, 1, len, fp));
+        fclose(fp);
+    }
+};
+
+TEST(FileInputTest, ParsesFileByName)
+{
+    write_file("hello world", 11);
+    epc_parser_t * p = epc_and_l(list, NULL, 2, epc_string_l(list, NULL, "hello world"), epc_eoi_l(list, NULL));
+
+    session = epc_parse_file(p, filename, NULL);
+
+    CHECK_FALSE(session.result.is_error);
+    STRNCMP_EQUAL("hello world", session.result.data.success->content, 11);
+    LONGS_EQUAL(11, session.result.data.success->len);
+}
+
+TEST(FileInputTest, ParsesOpenFile)
+{
+    write_file("abc", 3);
+    epc_parser_t * p = epc_and_l(list, NULL, 2, epc_string_l(list, NULL, "abc"), epc_eoi_l(list, NULL));
+    FILE * fp = fopen(filename, "r");
+
+    session = epc_parse_fp(p, fp, NULL);
+    fclose(fp);
+
+    // The input remains valid after the file is closed.
+    CHECK_FALSE(session.result.is_error);
+    STRNCMP_EQUAL("abc", session.result.data.success->content, 3);
+}
+
+TEST(FileInputTest, ParsesEmptyFile)
+{
+    write_file("", 0);
+    epc_parser_t * p = epc_eoi_l(list, NULL);
+
+    session = epc_parse_file(p, filename, NULL);
+
+    CHECK_FALSE(session.result.is_error);
+    LONGS_EQUAL(0, session.result.data.success->len);
+}
+
+TEST(FileInputTest, FileFillingItsLastPageIsTerminated)
+{
+    // A number runs to the very end of a file that is exactly a page long. Number parsing stops at the terminator
+    // that follows the file.
+    size_t const len = (size_t)sysconf(_SC_PAGESIZE);
+    char * content = (char *)malloc(len);
+
+    memset(content, '0', len);
+    content[1] = '.';
+    content[2] = '5';
+    write_file(content, len);
+    free(content);
+    epc_parser_t * p = epc_and_l(list, NULL, 2, epc_double_l(list, NULL), epc_eoi_l(list, NULL));
+
+    session = epc_parse_file(p, filename, NULL);
+
+    CHECK_FALSE(session.result.is_error);
+    LONGS_EQUAL(len, session.result.data.success->len);
+    LONGS_EQUAL('\0', session.result.data.success->content[len]);
+}
+
+TEST(FileInputTest, ErrorsAreReportedAtTheirPositionInTheFile)
+{
+    write_file("line one\nline two\n", 18);
+    epc_parser_t * p = epc_and_l(
+        list, NULL, 2, epc_string_l(list, NULL, "line one\n"), epc_string_l(list, NULL, "line three")
+    );
+
+    session = epc_parse_file(p, filename, NULL);
+
+    CHECK_TRUE(session.result.is_error);
+    LONGS_EQUAL(1, session.result.data.error->position.line);
+}
@@ -0,0 +1,160 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h> // For malloc, free
+#include <string.h> // For memset
+}
+
+TEST_GROUP(FirstSetTest)
+{
+    epc_parse_session_t session = {0};
+    epc_parse_result_t result;
+    epc_parser_list * list = NULL;
+    int wrap_entries = 0;
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0}; // Reset session before each test
+        list = epc_parser_list_create();
+        wrap_entries = 0;
+    }
+
+    epc_parse_result_t parse(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_destroy(&session);
+        session = epc_parse_str(parser, input, NULL);
+        return session.result;
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    static bool dispatch_allows(epc_parser_t const * or_parser, unsigned char c, int alternative)
+    {
+        // A single word per row is enough for the grammars in these tests.
+        return (or_parser->plan->dispatch[c] >> alternative) & 1;
+    }
+
+    static void count_wrap_entry(epc_parser_t * parser, epc_parser_ctx_t * parse_ctx, void * parser_data)
+    {
+        (void)parser;
+        (void)parse_ctx;
+        (*(int *)parser_data)++;
+    }
+};
+
+TEST(FirstSetTest, OrOnlyTriesAlternativesThatCanMatchTheNextByte)
+{
+    epc_parser_t * p_keyword = epc_or_l(
+        list,
+        "keyword",
+        3,
+        epc_string_l(list, "if", "if"),
+        epc_string_l(list, "while", "while"),
+        epc_string_l(list, "return", "return")
+    );
+
+    result = parse(p_keyword, "while");
+    CHECK_FALSE(result.is_error);
+    STRNCMP_EQUAL("while", result.data.success->content, 5);
+
+    CHECK_TRUE(p_keyword->plan->dispatch != NULL);
+    CHECK_FALSE(dispatch_allows(p_keyword, 'w', 0));
+    CHECK_TRUE(dispatch_allows(p_keyword, 'w', 1));
+    CHECK_FALSE(dispatch_allows(p_keyword, 'w', 2));
+    CHECK_TRUE(dispatch_allows(p_keyword, 'i', 0));
+    CHECK_FALSE(dispatch_allows(p_keyword, 'x', 0));
+    CHECK_FALSE(dispatch_allows(p_keyword, 'x', 1));
+    CHECK_FALSE(dispatch_allows(p_keyword, 'x', 2));
+}
+
+TEST(FirstSetTest, FirstSetLooksPastNullablePrefixes)
+{
+    epc_parser_t * p_signed = epc_and_l(
+        list, "signed", 2, epc_optional_l(list, "sign", epc_char_l(list, "minus", '-')), epc_digit_l(list, "digit")
+    );
+    epc_parser_t * p_value = epc_or_l(list, "value", 2, epc_alpha_l(list, "alpha"), p_signed);
+
+    result = parse(p_value, "7");
+    CHECK_FALSE(result.is_error);
+
+    CHECK_TRUE(dispatch_allows(p_value, '-', 1));
+    CHECK_TRUE(dispatch_allows(p_value, '7', 1));
+    CHECK_FALSE(dispatch_allows(p_value, '7', 0));
+    CHECK_FALSE(dispatch_allows(p_value, 'a', 1));
+    CHECK_FALSE(p_signed->plan->first_set.nullable);
+}
+
+TEST(FirstSetTest, NullableAlternativesAreAlwaysTried)
+{
+    epc_parser_t * p_or = epc_or_l(
+        list, "or", 2, epc_char_l(list, "a", 'a'), epc_optional_l(list, "maybe_b", epc_char_l(list, "b", 'b'))
+    );
+
+    result = parse(p_or, "c");
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(0, result.data.success->len);
+}
+
+TEST(FirstSetTest, LexemeAlternativeMatchesAfterLeadingWhitespace)
+{
+    epc_parser_t * p_or = epc_or_l(
+        list, "or", 2, epc_lexeme_l(list, "foo", epc_string_l(list, "foo", "foo")), epc_string_l(list, "bar", "bar")
+    );
+
+    result = parse(p_or, "  foo");
+    CHECK_FALSE(result.is_error);
+
+    result = parse(p_or, "// comment\nfoo");
+    CHECK_FALSE(result.is_error);
+}
+
+TEST(FirstSetTest, ErrorIsUnchangedWhenAlternativesAreSkipped)
+{
+    epc_parser_t * p_or = epc_or_l(
+        list, "or", 3, epc_char_l(list, "x", 'x'), epc_string_l(list, "abd", "abd"), epc_char_l(list, "y", 'y')
+    );
+
+    result = parse(p_or, "abc");
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL("No alternative matched", result.data.error->message);
+    STRCMP_EQUAL("x or abd or y", result.data.error->expected);
+    STRCMP_EQUAL("abc", result.data.error->found);
+}
+
+TEST(FirstSetTest, WrappedAlternativesAreNeverSkipped)
+{
+    epc_wrap_callbacks_t callbacks = {.on_entry = count_wrap_entry, .on_exit = NULL};
+    epc_parser_t * p_or = epc_or_l(
+        list,
+        "or",
+        2,
+        epc_char_l(list, "a", 'a'),
+        epc_wrap_l(list, "wrapped_b", epc_char_l(list, "b", 'b'), callbacks, &wrap_entries)
+    );
+
+    result = parse(p_or, "c");
+    CHECK_TRUE(result.is_error);
+    LONGS_EQUAL(1, wrap_entries);
+}
+
+TEST(FirstSetTest, RedefiningAParserIsSeenByTheOrsThatUseIt)
+{
+    epc_parser_t * p_item = epc_parser_fwd_decl_l(list, "item");
+    epc_parser_t * p_or = epc_or_l(list, "or", 2, p_item, epc_char_l(list, "z", 'z'));
+
+    epc_parser_duplicate(p_item, epc_char_l(list, "a", 'a'));
+    result = parse(p_or, "a");
+    CHECK_FALSE(result.is_error);
+
+    epc_parser_duplicate(p_item, epc_char_l(list, "b", 'b'));
+    result = parse(p_or, "b");
+    CHECK_FALSE(result.is_error);
+    result = parse(p_or, "a");
+    CHECK_TRUE(result.is_error);
+}
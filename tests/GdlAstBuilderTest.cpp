@@ -340,3 +340,60 @@ TEST(GdlAstBuilderTest, RuleDefinitionWithComplexOptional)
     LONGS_EQUAL(GDL_AST_NODE_TYPE_REPETITION_OPERATOR, repetition_op_node->type);
     LONGS_EQUAL('?', repetition_op_node->data.repetition_op.operator_char);
 }
+
+TEST(GdlAstBuilderTest, TokenPrefixMarksTheRule)
+{
+    // A rule may also be named 'token', or have a name that starts with it.
+    char const * gdl_input = "token Word = alpha+ @my_action;\n"
+                             "token = Word;\n"
+                             "tokens = token*;\n"
+                             "token token_list = tokens;\n";
+    session = parse(gdl_grammar, gdl_input);
+
+    CHECK_FALSE(session.result.is_error);
+    ast_build_result = epc_ast_build(session.result.data.success, ast_registry, NULL);
+
+    CHECK_FALSE(ast_build_result.has_error);
+    gdl_ast_node_t * program_node = (gdl_ast_node_t *)ast_build_result.ast_root;
+    LONGS_EQUAL(4, program_node->data.program.rules.count);
+
+    char const * const names[] = {"Word", "token", "tokens", "token_list"};
+    bool const is_token[] = {true, false, false, true};
+    gdl_ast_list_node_t * rule_list_node = program_node->data.program.rules.head;
+
+    for (int i = 0; i < 4; i++, rule_list_node = rule_list_node->next)
+    {
+        gdl_ast_node_t * rule_def_node = rule_list_node->item;
+
+        LONGS_EQUAL(GDL_AST_NODE_TYPE_RULE_DEFINITION, rule_def_node->type);
+        STRCMP_EQUAL(names[i], rule_def_node->data.rule_def.name);
+        CHECK_EQUAL(is_token[i], rule_def_node->data.rule_def.is_token);
+    }
+
+    gdl_ast_node_t * semantic_action_node = program_node->data.program.rules.head->item->data.rule_def.semantic_action;
+    CHECK(semantic_action_node != NULL);
+    STRCMP_EQUAL("my_action", semantic_action_node->data.semantic_action.action_name);
+}
+
+TEST(GdlAstBuilderTest, SplitCallNamesThePredicate)
+{
+    char const * gdl_input = "Lines = split(Line*, epc_split_at_line_start, NULL);\n";
+    session = parse(gdl_grammar, gdl_input);
+
+    CHECK_FALSE(session.result.is_error);
+    ast_build_result = epc_ast_build(session.result.data.success, ast_registry, NULL);
+
+    CHECK_FALSE(ast_build_result.has_error);
+    gdl_ast_node_t * program_node = (gdl_ast_node_t *)ast_build_result.ast_root;
+    gdl_ast_node_t * expression_node = program_node->data.program.rules.head->item->data.rule_def.definition;
+
+    // The call is the only element of the rule's only alternative.
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_ALTERNATIVE, expression_node->type);
+    gdl_ast_node_t * sequence_node = expression_node->data.alternative.alternatives.head->item;
+    gdl_ast_node_t * split_node = sequence_node->data.sequence.elements.head->item;
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_SPLIT_CALL, split_node->type);
+    STRCMP_EQUAL("epc_split_at_line_start", split_node->data.split_call.split_fn_name);
+    STRCMP_EQUAL("NULL", split_node->data.split_call.split_data_name);
+    CHECK(split_node->data.split_call.expr != NULL);
+}
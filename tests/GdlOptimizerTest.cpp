@@ -0,0 +1,278 @@
+#include "CppUTest/TestHarness.h"
+#include "easy_pc/easy_pc.h"
+
+extern "C" {
+#include "gdl_compiler_ast_actions.h"
+#include "gdl_grammar_builder.h"
+#include "gdl_optimizer.h"
+#include "gdl_parser.h"
+}
+
+#include <string.h>
+
+TEST_GROUP(GdlOptimizerTest)
+{
+    epc_parser_list * parser_list;
+    epc_parser_t * gdl_grammar;
+    epc_ast_hook_registry_t * ast_registry = NULL;
+    gdl_ast_node_t * plain_ast = NULL;
+    gdl_ast_node_t * optimized_ast = NULL;
+    epc_parser_t * plain = NULL;
+    epc_parser_t * optimized = NULL;
+
+    void setup() override
+    {
+        parser_list = epc_parser_list_create();
+        gdl_grammar = create_gdl_parser(parser_list);
+        ast_registry = epc_ast_hook_registry_create(GDL_AST_ACTION_MAX);
+        gdl_ast_hook_registry_init(ast_registry, NULL);
+    }
+
+    void teardown() override
+    {
+        gdl_ast_node_free(plain_ast, NULL);
+        gdl_ast_node_free(optimized_ast, NULL);
+        epc_ast_hook_registry_free(ast_registry);
+        epc_parser_list_free(parser_list);
+    }
+
+    gdl_ast_node_t * build_ast(char const * gdl_input)
+    {
+        epc_parse_session_t session = epc_parse_str(gdl_grammar, gdl_input, NULL);
+
+        CHECK_FALSE(session.result.is_error);
+
+        epc_ast_result_t result = epc_ast_build(session.result.data.success, ast_registry, NULL);
+
+        epc_parse_session_destroy(&session);
+        CHECK_FALSE(result.has_error);
+        return (gdl_ast_node_t *)result.ast_root;
+    }
+
+    // Builds the grammar both as written and optimised, so that what they match can be compared.
+    void build(char const * gdl_input)
+    {
+        plain_ast = build_ast(gdl_input);
+        optimized_ast = build_ast(gdl_input);
+        CHECK_TRUE(gdl_optimize_ast(optimized_ast));
+
+        plain = gdl_build_grammar(plain_ast, parser_list);
+        optimized = gdl_build_grammar(optimized_ast, parser_list);
+        CHECK_TRUE(plain != NULL);
+        CHECK_TRUE(optimized != NULL);
+    }
+
+    // Returns the length matched, or -1 if the input doesn't match.
+    int match(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_t session = epc_parse_str(parser, input, NULL);
+        int len = session.result.is_error ? -1 : (int)epc_cpt_node_get_len(session.result.data.success);
+
+        epc_parse_session_destroy(&session);
+        return len;
+    }
+
+    void check_same(char const * input)
+    {
+        LONGS_EQUAL(match(plain, input), match(optimized, input));
+    }
+
+    // Returns the printed parse tree, which names the parser of each node, or NULL if the input doesn't match.
+    char * print(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_t session = epc_parse_str(parser, input, NULL);
+        char * printed = session.result.is_error
+                             ? NULL
+                             : epc_cpt_to_string(session.internal_parse_ctx, session.result.data.success);
+
+        epc_parse_session_destroy(&session);
+        return printed;
+    }
+
+    gdl_ast_node_t * rule(char const * name)
+    {
+        for (gdl_ast_list_node_t * item = optimized_ast->data.program.rules.head; item != NULL; item = item->next)
+        {
+            if (strcmp(item->item->data.rule_def.name, name) == 0)
+            {
+                return item->item->data.rule_def.definition;
+            }
+        }
+        return NULL;
+    }
+
+    // Skips single-element sequences and alternatives, and terminals, to get to what a rule really is.
+    gdl_ast_node_t * unwrap(gdl_ast_node_t * node)
+    {
+        for (;;)
+        {
+            if (node->type == GDL_AST_NODE_TYPE_TERMINAL)
+            {
+                node = node->data.terminal.expression;
+            }
+            else if (node->type == GDL_AST_NODE_TYPE_SEQUENCE && node->data.sequence.elements.count == 1)
+            {
+                node = node->data.sequence.elements.head->item;
+            }
+            else if (node->type == GDL_AST_NODE_TYPE_ALTERNATIVE && node->data.alternative.alternatives.count == 1)
+            {
+                node = node->data.alternative.alternatives.head->item;
+            }
+            else
+            {
+                return node;
+            }
+        }
+    }
+};
+
+TEST(GdlOptimizerTest, SingleCharacterAlternativesBecomeOneOf)
+{
+    build("Op = '+' | '-' | [0-2] | oneof(\"xy\") @OP;\n"
+          "Program = Op eoi;\n");
+
+    gdl_ast_node_t * op = unwrap(rule("Op"));
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_COMBINATOR_ONEOF, op->type);
+    STRCMP_EQUAL("+-012xy", op->data.none_or_one_of_call.args);
+
+    char const * inputs[] = {"+", "-", "0", "2", "3", "x", "y", "z", ""};
+
+    for (size_t i = 0; i < sizeof inputs / sizeof inputs[0]; i++)
+    {
+        check_same(inputs[i]);
+    }
+}
+
+TEST(GdlOptimizerTest, CommonPrefixesAreFactoredOut)
+{
+    build("Kw = \"abc\" digit | \"abd\" digit '/' | \"ab\" @KW;\n"
+          "Program = Kw eoi;\n");
+
+    // "ab" ('c' digit | 'd' digit '/') | "ab": the last alternative isn't taken into the others, as what would be left
+    // of it matches nothing, which an epc_or won't do at the end of the input.
+    gdl_ast_node_t * kw = unwrap(rule("Kw"));
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_ALTERNATIVE, kw->type);
+    LONGS_EQUAL(2, kw->data.alternative.alternatives.count);
+
+    gdl_ast_node_t * factored = unwrap(kw->data.alternative.alternatives.head->item);
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_SEQUENCE, factored->type);
+
+    gdl_ast_node_t * prefix = unwrap(factored->data.sequence.elements.head->item);
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_STRING_LITERAL, prefix->type);
+    STRCMP_EQUAL("ab", prefix->data.string_literal.value);
+
+    char const * inputs[] = {"abc1", "abd2/", "abd/", "ab", "abc", "abd", "abe", "a", ""};
+
+    for (size_t i = 0; i < sizeof inputs / sizeof inputs[0]; i++)
+    {
+        check_same(inputs[i]);
+    }
+}
+
+TEST(GdlOptimizerTest, AdjacentLiteralsAreMerged)
+{
+    build("Arrow = '-' '>' \"=\" '\\n' @ARROW;\n"
+          "Program = Arrow eoi;\n");
+
+    gdl_ast_node_t * arrow = unwrap(rule("Arrow"));
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_STRING_LITERAL, arrow->type);
+    STRCMP_EQUAL("->=\\n", arrow->data.string_literal.value);
+    LONGS_EQUAL(4, match(optimized, "->=\n"));
+    check_same("->=");
+}
+
+TEST(GdlOptimizerTest, SingleUseTerminalRulesAreInlined)
+{
+    build("Sign = '+' | '-';\n"
+          "Digit = [0-9] @DIGIT;\n"
+          "Number = Sign? Digit+ @NUMBER;\n");
+
+    CHECK_TRUE(rule("Sign") == NULL);
+    CHECK_TRUE(rule("Digit") != NULL);
+    CHECK_TRUE(rule("Number") != NULL);
+    check_same("+12");
+    check_same("7");
+    check_same("-");
+}
+
+TEST(GdlOptimizerTest, InlinedRulesKeepTheirName)
+{
+    build("Underscore = '_';\n"
+          "Name = 'a' Underscore 'b' @NAME;\n");
+
+    CHECK_TRUE(rule("Underscore") == NULL);
+
+    gdl_ast_node_t * name = unwrap(rule("Name"));
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_SEQUENCE, name->type);
+    LONGS_EQUAL(3, name->data.sequence.elements.count);
+
+    gdl_ast_node_t * underscore = name->data.sequence.elements.head->next->item;
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_TERMINAL, underscore->type);
+    STRCMP_EQUAL("Underscore", underscore->data.terminal.expression->name);
+
+    char * plain_tree = print(plain, "a_b");
+    char * optimized_tree = print(optimized, "a_b");
+
+    STRCMP_CONTAINS("Underscore", optimized_tree);
+    STRCMP_EQUAL(plain_tree, optimized_tree);
+    free(plain_tree);
+    free(optimized_tree);
+    check_same("a-b");
+}
+
+TEST(GdlOptimizerTest, RulesUsedMoreThanOnceAreKept)
+{
+    build("Sign = '+' | '-';\n"
+          "Pair = Sign digit Sign @PAIR;\n");
+
+    CHECK_TRUE(rule("Sign") != NULL);
+    check_same("+1-");
+    check_same("+1");
+}
+
+TEST(GdlOptimizerTest, LiteralAlternativesBecomeKeywords)
+{
+    build("Type = \"integer\" | \"int\" | \"char\" | 'c' @TYPE;\n"
+          "Program = Type eoi;\n");
+
+    gdl_ast_node_t * type = unwrap(rule("Type"));
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS, type->type);
+    LONGS_EQUAL(4, type->data.keywords_call.keywords.count);
+    STRCMP_EQUAL("integer", type->data.keywords_call.keywords.head->item->data.string_literal.value);
+    STRCMP_EQUAL("c", type->data.keywords_call.keywords.tail->item->data.string_literal.value);
+
+    char const * inputs[] = {"integer", "int", "inte", "char", "c", "ch", "i", ""};
+
+    for (size_t i = 0; i < sizeof inputs / sizeof inputs[0]; i++)
+    {
+        check_same(inputs[i]);
+    }
+}
+
+TEST(GdlOptimizerTest, KeywordsDontTakeALiteralThatAnEarlierOneIsAPrefixOf)
+{
+    build("Kw = \"in\" | \"int\" | \"do\" @KW;\n"
+          "Program = Kw;\n");
+
+    // "in" always matches before "int" could, where the longest match would be "int".
+    gdl_ast_node_t * kw = unwrap(rule("Kw"));
+
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_ALTERNATIVE, kw->type);
+    LONGS_EQUAL(2, kw->data.alternative.alternatives.count);
+    LONGS_EQUAL(GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS, unwrap(kw->data.alternative.alternatives.tail->item)->type);
+
+    char const * inputs[] = {"int", "in", "do", "d", ""};
+
+    for (size_t i = 0; i < sizeof inputs / sizeof inputs[0]; i++)
+    {
+        check_same(inputs[i]);
+    }
+}
@@ -101,23 +101,28 @@ TEST(GdlParserTest, ParseSimpleIdentifierRule)
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
     CHECK_EQUAL(
-        5, rule_def_node->children_count
-    ); // Identifier, EqualsChar, DefinitionExpression, OptionalSemanticAction, SemicolonChar
+        6, rule_def_node->children_count
+    ); // OptionalTokenPrefix, Identifier, EqualsChar, DefinitionExpression, OptionalSemanticAction, SemicolonChar
+
+    // Check OptionalTokenPrefix (first child of RuleDefinition) - should be empty
+    epc_cpt_node_t * optional_token_prefix_node = rule_def_node->children[0];
+    STRCMP_EQUAL("OptionalTokenPrefix", optional_token_prefix_node->name);
+    CHECK_EQUAL(0, optional_token_prefix_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count); // ExpressionTerm and ManyAlternatives
 
@@ -158,13 +163,13 @@ TEST(GdlParserTest, ParseSimpleIdentifierRule)
     STRCMP_EQUAL("ManyAlternatives", many_alternatives_node->name);
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
-    // Check OptionalSemanticAction (fourth child of RuleDefinition) - should be empty
-    epc_cpt_node_t * optional_semantic_action_node = rule_def_node->children[3];
+    // Check OptionalSemanticAction (fifth child of RuleDefinition) - should be empty
+    epc_cpt_node_t * optional_semantic_action_node = rule_def_node->children[4];
     STRCMP_EQUAL("OptionalSemanticAction", optional_semantic_action_node->name);
     CHECK_EQUAL(0, optional_semantic_action_node->children_count);
 
-    // Check SemicolonChar (fifth child of RuleDefinition)
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    // Check SemicolonChar (sixth child of RuleDefinition)
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -200,10 +205,10 @@ TEST(GdlParserTest, ParseSimpleStringLiteralRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyStringRule",
@@ -212,12 +217,12 @@ TEST(GdlParserTest, ParseSimpleStringLiteralRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to StringLiteral
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     epc_cpt_node_t * expr_term_node = def_expr_node->children[0];
     epc_cpt_node_t * expr_factor_node = expr_term_node->children[0];
     epc_cpt_node_t * primary_expr_node = expr_factor_node->children[0];
@@ -237,7 +242,7 @@ TEST(GdlParserTest, ParseSimpleStringLiteralRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -268,22 +273,22 @@ TEST(GdlParserTest, ParseSimpleCharLiteralRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyCharRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to CharLiteral
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     epc_cpt_node_t * expr_term_node = def_expr_node->children[0];
     epc_cpt_node_t * expr_factor_node = expr_term_node->children[0];
     epc_cpt_node_t * primary_expr_node = expr_factor_node->children[0];
@@ -301,7 +306,7 @@ TEST(GdlParserTest, ParseSimpleCharLiteralRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -332,10 +337,10 @@ TEST(GdlParserTest, ParseSimpleCharRangeRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyRangeRule",
@@ -344,12 +349,12 @@ TEST(GdlParserTest, ParseSimpleCharRangeRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to CharRange
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     epc_cpt_node_t * expr_term_node = def_expr_node->children[0];
     epc_cpt_node_t * expr_factor_node = expr_term_node->children[0];
     epc_cpt_node_t * primary_expr_node = expr_factor_node->children[0];
@@ -365,7 +370,7 @@ TEST(GdlParserTest, ParseSimpleCharRangeRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -396,22 +401,22 @@ TEST(GdlParserTest, ParseSimpleSequenceRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MySeqRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path for sequence
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     epc_cpt_node_t * expr_term_node = def_expr_node->children[0]; // This is the sequence (alpha digit)
 
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
@@ -461,7 +466,7 @@ TEST(GdlParserTest, ParseSimpleSequenceRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -492,10 +497,10 @@ TEST(GdlParserTest, ParseSimpleChoiceRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyChoiceRule",
@@ -504,12 +509,12 @@ TEST(GdlParserTest, ParseSimpleChoiceRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -579,7 +584,7 @@ TEST(GdlParserTest, ParseSimpleChoiceRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -614,10 +619,10 @@ TEST(GdlParserTest, ParseSimpleOptionalRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyOptionalRule",
@@ -626,12 +631,12 @@ TEST(GdlParserTest, ParseSimpleOptionalRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count); // ExpressionTerm and ManyAlternatives
 
@@ -689,7 +694,7 @@ TEST(GdlParserTest, ParseSimpleOptionalRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -720,22 +725,22 @@ TEST(GdlParserTest, ParseSimplePlusRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyPlusRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count); // ExpressionTerm and ManyAlternatives
 
@@ -791,7 +796,7 @@ TEST(GdlParserTest, ParseSimplePlusRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -822,22 +827,22 @@ TEST(GdlParserTest, ParseSimpleStarRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyStarRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count); // ExpressionTerm and ManyAlternatives
 
@@ -893,7 +898,7 @@ TEST(GdlParserTest, ParseSimpleStarRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -924,10 +929,10 @@ TEST(GdlParserTest, ParseOneofCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyOneofRule",
@@ -936,12 +941,12 @@ TEST(GdlParserTest, ParseOneofCallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to OneofCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -997,7 +1002,7 @@ TEST(GdlParserTest, ParseOneofCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1028,10 +1033,10 @@ TEST(GdlParserTest, ParseNoneofCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyNoneofRule",
@@ -1040,12 +1045,12 @@ TEST(GdlParserTest, ParseNoneofCallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to NoneofCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -1102,7 +1107,7 @@ TEST(GdlParserTest, ParseNoneofCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1133,10 +1138,10 @@ TEST(GdlParserTest, ParseCountCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyCountRule",
@@ -1145,12 +1150,12 @@ TEST(GdlParserTest, ParseCountCallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to CountCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -1246,7 +1251,7 @@ TEST(GdlParserTest, ParseCountCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1277,10 +1282,10 @@ TEST(GdlParserTest, ParseBetweenCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyBetweenRule",
@@ -1289,12 +1294,12 @@ TEST(GdlParserTest, ParseBetweenCallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to BetweenCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -1404,7 +1409,7 @@ TEST(GdlParserTest, ParseBetweenCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1435,10 +1440,10 @@ TEST(GdlParserTest, ParseDelimitedCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyDelimitedRule",
@@ -1447,12 +1452,12 @@ TEST(GdlParserTest, ParseDelimitedCallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to DelimitedCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -1544,7 +1549,7 @@ TEST(GdlParserTest, ParseDelimitedCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1575,10 +1580,10 @@ TEST(GdlParserTest, ParseLookaheadCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyLookaheadRule",
@@ -1587,12 +1592,12 @@ TEST(GdlParserTest, ParseLookaheadCallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to LookaheadCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -1673,7 +1678,7 @@ TEST(GdlParserTest, ParseLookaheadCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1704,22 +1709,22 @@ TEST(GdlParserTest, ParseNotCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyNotRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to NotCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -1796,7 +1801,7 @@ TEST(GdlParserTest, ParseNotCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1827,10 +1832,10 @@ TEST(GdlParserTest, ParseLexemeCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyLexemeRule",
@@ -1839,12 +1844,12 @@ TEST(GdlParserTest, ParseLexemeCallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to LexemeCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -1923,7 +1928,7 @@ TEST(GdlParserTest, ParseLexemeCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -1954,22 +1959,22 @@ TEST(GdlParserTest, ParseSkipCallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MySkipRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to SkipCall
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -2046,7 +2051,7 @@ TEST(GdlParserTest, ParseSkipCallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -2077,10 +2082,10 @@ TEST(GdlParserTest, ParseChainl1CallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyChainl1Rule",
@@ -2089,12 +2094,12 @@ TEST(GdlParserTest, ParseChainl1CallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to ChainL1Call
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -2184,7 +2189,7 @@ TEST(GdlParserTest, ParseChainl1CallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -2215,10 +2220,10 @@ TEST(GdlParserTest, ParseChainr1CallRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyChainr1Rule",
@@ -2227,12 +2232,12 @@ TEST(GdlParserTest, ParseChainr1CallRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to ChainR1Call
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -2322,7 +2327,7 @@ TEST(GdlParserTest, ParseChainr1CallRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -2353,26 +2358,26 @@ TEST(GdlParserTest, ParseSemanticActionRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier (MyRule)
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyRule", epc_cpt_node_get_semantic_content(identifier_node), epc_cpt_node_get_semantic_len(identifier_node)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression (alpha)
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
 
     // Check OptionalSemanticAction (for @my_action)
-    epc_cpt_node_t * optional_semantic_action_node = rule_def_node->children[3];
+    epc_cpt_node_t * optional_semantic_action_node = rule_def_node->children[4];
     STRCMP_EQUAL("OptionalSemanticAction", optional_semantic_action_node->name);
     CHECK_EQUAL(1, optional_semantic_action_node->children_count);
 
@@ -2393,7 +2398,7 @@ TEST(GdlParserTest, ParseSemanticActionRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -2424,10 +2429,10 @@ TEST(GdlParserTest, ParseNumberLiteralRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyNumberRule",
@@ -2436,12 +2441,12 @@ TEST(GdlParserTest, ParseNumberLiteralRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to NumberLiteral
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -2466,7 +2471,7 @@ TEST(GdlParserTest, ParseNumberLiteralRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -2497,10 +2502,10 @@ TEST(GdlParserTest, ParseParenthesizedExpressionRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyParenthesizedRule",
@@ -2509,12 +2514,12 @@ TEST(GdlParserTest, ParseParenthesizedExpressionRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to ParenthesizedExpression
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -2574,7 +2579,7 @@ TEST(GdlParserTest, ParseParenthesizedExpressionRule)
     );
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
@@ -2605,10 +2610,10 @@ TEST(GdlParserTest, ParseDoubleKeywordRule)
 
     epc_cpt_node_t * rule_def_node = many_rule_defs_node->children[0];
     STRCMP_EQUAL("RuleDefinition", rule_def_node->name);
-    CHECK_EQUAL(5, rule_def_node->children_count);
+    CHECK_EQUAL(6, rule_def_node->children_count);
 
     // Check Identifier
-    epc_cpt_node_t * identifier_node = rule_def_node->children[0];
+    epc_cpt_node_t * identifier_node = rule_def_node->children[1];
     STRCMP_EQUAL("Identifier", identifier_node->name);
     STRNCMP_EQUAL(
         "MyDoubleRule",
@@ -2617,12 +2622,12 @@ TEST(GdlParserTest, ParseDoubleKeywordRule)
     );
 
     // Check EqualsChar
-    epc_cpt_node_t * equals_node = rule_def_node->children[1];
+    epc_cpt_node_t * equals_node = rule_def_node->children[2];
     STRCMP_EQUAL("EqualsChar", equals_node->name);
     STRNCMP_EQUAL("=", epc_cpt_node_get_semantic_content(equals_node), epc_cpt_node_get_semantic_len(equals_node));
 
     // Check DefinitionExpression path to Keyword (double)
-    epc_cpt_node_t * def_expr_node = rule_def_node->children[2];
+    epc_cpt_node_t * def_expr_node = rule_def_node->children[3];
     STRCMP_EQUAL("DefinitionExpression", def_expr_node->name);
     CHECK_EQUAL(2, def_expr_node->children_count);
 
@@ -2659,12 +2664,12 @@ TEST(GdlParserTest, ParseDoubleKeywordRule)
     CHECK_EQUAL(0, many_alternatives_node->children_count);
 
     // Check OptionalSemanticAction (empty)
-    epc_cpt_node_t * optional_semantic_action_node = rule_def_node->children[3];
+    epc_cpt_node_t * optional_semantic_action_node = rule_def_node->children[4];
     STRCMP_EQUAL("OptionalSemanticAction", optional_semantic_action_node->name);
     CHECK_EQUAL(0, optional_semantic_action_node->children_count);
 
     // Check SemicolonChar
-    epc_cpt_node_t * semicolon_node = rule_def_node->children[4];
+    epc_cpt_node_t * semicolon_node = rule_def_node->children[5];
     STRCMP_EQUAL("SemicolonChar", semicolon_node->name);
     STRNCMP_EQUAL(
         ";", epc_cpt_node_get_semantic_content(semicolon_node), epc_cpt_node_get_semantic_len(semicolon_node)
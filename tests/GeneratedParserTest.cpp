@@ -99,3 +99,55 @@ TEST(GeneratedParserTest, GeneratesFilesWithFwdRefSuccessfully)
 
     CHECK_TRUE(gdl_generate_c_code((gdl_ast_node_t *)ast_build_result.ast_root, base_name, output_dir));
 }
+
+TEST(GeneratedParserTest, GeneratesDirectFilesSuccessfully)
+{
+    // Output directory for generated files in the test environment
+    char const * output_dir = ".";
+    char const * base_name = "direct_test_language";
+    // Covers each construct that has a direct form, and some that call out to the graph.
+    char const * gdl_input = "Digit = digit;\n"
+                             "Number = Digit+;\n"
+                             "token Word = alpha (alphanum | '_')*;\n"
+                             "Sign = oneof(\"+-\")?;\n"
+                             "Pair = count(2, 'x');\n"
+                             "Keyword = \"if\" not(alphanum);\n"
+                             "Peek = lookahead('(') '(' noneof(\")\")* ')';\n"
+                             "Spaced = lexeme(Word);\n"
+                             "Item = Number | Word | Pair | Keyword | Peek | Spaced | int | [a-c];\n"
+                             "Program = Sign Item* eoi @EPC_AST_SEMANTIC_ACTION_PROGRAM_RULE;\n";
+
+    generate_ast(gdl_input);
+
+    CHECK_TRUE(gdl_generate_c_code_with_mode(
+        (gdl_ast_node_t *)ast_build_result.ast_root, base_name, output_dir, GDL_EMIT_DIRECT
+    ));
+}
+
+TEST(GeneratedParserTest, LeftRecursiveRuleCallsOutToItsGraphParser)
+{
+    char const * output_dir = ".";
+    char const * base_name = "left_recursive_test_language";
+    char const * gdl_input = "Number = digit+;\n"
+                             "Expr = Expr '-' Number | Number;\n"
+                             "Program = Expr eoi;\n";
+
+    generate_ast(gdl_input);
+
+    CHECK_TRUE(gdl_generate_c_code_with_mode(
+        (gdl_ast_node_t *)ast_build_result.ast_root, base_name, output_dir, GDL_EMIT_DIRECT
+    ));
+
+    FILE * fp = fopen("left_recursive_test_language.c", "r");
+    CHECK_TRUE(fp != NULL);
+
+    static char source[65536];
+    size_t const len = fread(source, 1, sizeof(source) - 1, fp);
+    fclose(fp);
+    source[len] = '\0';
+
+    // Only the graph parser grows the matches of a left-recursive rule.
+    char const * expr = strstr(source, "// Rule: Expr");
+    CHECK_TRUE(expr != NULL);
+    CHECK_TRUE(strncmp(strstr(expr, "{\n") + 2, "    return epc_direct_callout(d, ", 33) == 0);
+}
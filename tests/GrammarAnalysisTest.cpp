@@ -0,0 +1,212 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include <easy_pc/easy_pc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+static bool
+set_has(uint64_t const set[4], unsigned char c)
+{
+    return (set[c / 64] & (UINT64_C(1) << (c % 64))) != 0;
+}
+
+TEST_GROUP(GrammarAnalysisTest)
+{
+    epc_parser_list * list = NULL;
+    epc_grammar_analysis_t * analysis = NULL;
+    epc_grammar_issue_t const * issues = NULL;
+    size_t issue_count = 0;
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+    }
+
+    void teardown() override
+    {
+        epc_grammar_analysis_free(analysis);
+        epc_parser_list_free(list);
+    }
+
+    void analyze(epc_parser_t * top)
+    {
+        analysis = epc_grammar_analyze(top);
+        CHECK_TRUE(analysis != NULL);
+        issue_count = epc_grammar_analysis_get_issues(analysis, &issues);
+    }
+
+    epc_grammar_issue_t const * find_issue(epc_grammar_issue_kind_t kind)
+    {
+        for (size_t i = 0; i < issue_count; i++)
+        {
+            if (issues[i].kind == kind)
+            {
+                return &issues[i];
+            }
+        }
+        return NULL;
+    }
+};
+
+TEST(GrammarAnalysisTest, FirstAndFollowSetsOfASequence)
+{
+    // top: 'a' ('b' | 'c')* eoi
+    epc_parser_t * a = epc_char_l(list, "a", 'a');
+    epc_parser_t * bc = epc_or_l(list, "bc", 2, epc_char_l(list, NULL, 'b'), epc_char_l(list, NULL, 'c'));
+    epc_parser_t * top = epc_and_l(list, "top", 3, a, epc_many_l(list, NULL, bc), epc_eoi_l(list, NULL));
+    epc_grammar_sets_t sets;
+
+    analyze(top);
+    LONGS_EQUAL(0, issue_count);
+
+    CHECK_TRUE(epc_grammar_analysis_get_sets(analysis, top, &sets));
+    CHECK_FALSE(sets.nullable);
+    CHECK_TRUE(set_has(sets.first, 'a'));
+    CHECK_FALSE(set_has(sets.first, 'b'));
+    CHECK_TRUE(sets.may_end_input);
+
+    CHECK_TRUE(epc_grammar_analysis_get_sets(analysis, a, &sets));
+    CHECK_TRUE(set_has(sets.follow, 'b'));
+    CHECK_TRUE(set_has(sets.follow, 'c'));
+    CHECK_FALSE(set_has(sets.follow, 'a'));
+    CHECK_TRUE(sets.may_end_input);
+
+    CHECK_TRUE(epc_grammar_analysis_get_sets(analysis, bc, &sets));
+    CHECK_TRUE(set_has(sets.first, 'b'));
+    CHECK_TRUE(set_has(sets.first, 'c'));
+    CHECK_TRUE(set_has(sets.follow, 'b'));
+}
+
+TEST(GrammarAnalysisTest, ParsersOutsideTheGrammarHaveNoSets)
+{
+    epc_parser_t * other = epc_char_l(list, "other", 'x');
+    epc_grammar_sets_t sets;
+
+    analyze(epc_char_l(list, "top", 'a'));
+    CHECK_FALSE(epc_grammar_analysis_get_sets(analysis, other, &sets));
+}
+
+TEST(GrammarAnalysisTest, LeftRecursionIsReportedAsANote)
+{
+    // expr: expr '-' num | num
+    epc_parser_t * expr = epc_parser_fwd_decl_l(list, "expr");
+    epc_parser_t * num = epc_plus_l(list, "num", epc_digit_l(list, NULL));
+    epc_grammar_sets_t sets;
+
+    epc_parser_duplicate(
+        expr, epc_or_l(list, "expr", 2, epc_and_l(list, "sub", 3, expr, epc_char_l(list, NULL, '-'), num), num)
+    );
+    analyze(expr);
+
+    epc_grammar_issue_t const * issue = find_issue(EPC_GRAMMAR_LEFT_RECURSION);
+
+    CHECK_TRUE(issue != NULL);
+    STRCMP_EQUAL("expr", issue->name);
+    CHECK_TRUE(find_issue(EPC_GRAMMAR_UNBOUNDED_RECURSION) == NULL);
+
+    // The FIRST set comes from the seed alternative, rather than giving up on the cycle.
+    CHECK_TRUE(epc_grammar_analysis_get_sets(analysis, expr, &sets));
+    CHECK_FALSE(sets.nullable);
+    CHECK_TRUE(set_has(sets.first, '1'));
+    CHECK_FALSE(set_has(sets.first, '-'));
+    CHECK_TRUE(set_has(sets.follow, '-'));
+}
+
+TEST(GrammarAnalysisTest, LeftRecursionThroughAWrapIsAnError)
+{
+    epc_parser_t * w = epc_parser_fwd_decl_l(list, "w");
+    epc_parser_t * wrapped = epc_wrap_l(list, NULL, w, (epc_wrap_callbacks_t){}, NULL);
+
+    epc_parser_t * recurse = epc_and_l(list, NULL, 2, wrapped, epc_char_l(list, NULL, 'x'));
+
+    epc_parser_duplicate(w, epc_or_l(list, "w", 2, recurse, epc_char_l(list, NULL, 'y')));
+    analyze(w);
+
+    epc_grammar_issue_t const * issue = find_issue(EPC_GRAMMAR_UNBOUNDED_RECURSION);
+
+    CHECK_TRUE(issue != NULL);
+    STRCMP_EQUAL("w", issue->name);
+}
+
+TEST(GrammarAnalysisTest, RepeatingANullableParserIsAnError)
+{
+    epc_parser_t * bad = epc_many_l(list, "bad", epc_optional_l(list, NULL, epc_char_l(list, NULL, 'x')));
+
+    analyze(bad);
+
+    epc_grammar_issue_t const * issue = find_issue(EPC_GRAMMAR_NULLABLE_REPETITION);
+
+    CHECK_TRUE(issue != NULL);
+    POINTERS_EQUAL(bad, issue->parser);
+}
+
+TEST(GrammarAnalysisTest, RepeatingADoubleIsFine)
+{
+    analyze(epc_many_l(list, "numbers", epc_lexeme_l(list, NULL, epc_double_l(list, NULL))));
+    CHECK_TRUE(find_issue(EPC_GRAMMAR_NULLABLE_REPETITION) == NULL);
+}
+
+TEST(GrammarAnalysisTest, LiteralPrefixShadowsALaterAlternative)
+{
+    epc_parser_t * kw = epc_or_l(list, "kw", 2, epc_string_l(list, NULL, "int"), epc_string_l(list, NULL, "integer"));
+
+    analyze(kw);
+
+    epc_grammar_issue_t const * issue = find_issue(EPC_GRAMMAR_SHADOWED_ALTERNATIVE);
+
+    CHECK_TRUE(issue != NULL);
+    POINTERS_EQUAL(kw, issue->parser);
+    LONGS_EQUAL(1, issue->alternative);
+    LONGS_EQUAL(0, issue->shadowed_by);
+}
+
+TEST(GrammarAnalysisTest, LongerLiteralFirstIsFine)
+{
+    analyze(epc_or_l(list, "kw", 2, epc_string_l(list, NULL, "integer"), epc_string_l(list, NULL, "int")));
+    CHECK_TRUE(find_issue(EPC_GRAMMAR_SHADOWED_ALTERNATIVE) == NULL);
+}
+
+TEST(GrammarAnalysisTest, AlternativeThatNeverFailsShadowsTheRest)
+{
+    epc_parser_t * alt = epc_or_l(
+        list, "alt", 2, epc_many_l(list, NULL, epc_char_l(list, NULL, 'a')), epc_char_l(list, NULL, 'b')
+    );
+
+    analyze(alt);
+
+    epc_grammar_issue_t const * issue = find_issue(EPC_GRAMMAR_SHADOWED_ALTERNATIVE);
+
+    CHECK_TRUE(issue != NULL);
+    LONGS_EQUAL(1, issue->alternative);
+}
+
+TEST(GrammarAnalysisTest, UndefinedForwardDeclarationIsAnError)
+{
+    epc_parser_t * missing = epc_parser_fwd_decl_l(list, "missing");
+
+    analyze(epc_and_l(list, "top", 2, epc_char_l(list, NULL, 'a'), missing));
+
+    epc_grammar_issue_t const * issue = find_issue(EPC_GRAMMAR_UNDEFINED_PARSER);
+
+    CHECK_TRUE(issue != NULL);
+    STRCMP_EQUAL("missing", issue->name);
+}
+
+TEST(GrammarAnalysisTest, PrintListsNamedParsersAndIssues)
+{
+    char * text = NULL;
+    size_t len = 0;
+    FILE * fp = open_memstream(&text, &len);
+
+    analyze(epc_or_l(list, "kw", 2, epc_string_l(list, "short", "ab"), epc_string_l(list, "long", "abc")));
+    LONGS_EQUAL(1, epc_grammar_analysis_print(analysis, fp));
+    fclose(fp);
+
+    CHECK_TRUE(strstr(text, "kw\n    FIRST:  [a]\n    FOLLOW: $\n") != NULL);
+    CHECK_TRUE(strstr(text, "warning: alternative 2 of 'kw'") != NULL);
+    free(text);
+}
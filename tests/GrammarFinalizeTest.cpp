@@ -0,0 +1,178 @@
+#include "CppUTest/TestHarness.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdio.h>
+#include <string.h>
+}
+
+#define PARSER_THREADS 4
+#define PARSES_PER_THREAD 200
+
+// Builds a grammar with a left-recursive rule, an epc_or with a dispatch table and runs of single characters, the
+// three things finalizing plans.
+// expr: expr '-' num | num | '(' word ')'
+static epc_parser_t *
+expr_grammar(epc_parser_list * list, epc_parser_t ** num)
+{
+    epc_parser_t * expr = epc_parser_fwd_decl_l(list, "expr");
+    epc_parser_t * word = epc_many_l(list, "word", epc_alpha_l(list, NULL));
+
+    *num = epc_plus_l(list, "num", epc_digit_l(list, NULL));
+    epc_parser_duplicate(
+        expr,
+        epc_or_l(
+            list,
+            "expr",
+            3,
+            epc_and_l(list, "sub", 3, expr, epc_char_l(list, NULL, '-'), *num),
+            *num,
+            epc_between_l(list, "group", epc_char_l(list, NULL, '('), word, epc_char_l(list, NULL, ')'))
+        )
+    );
+    return expr;
+}
+
+// Builds, parses with and frees a grammar that has nothing to do with any other, as a grammar compiler would.
+static bool
+build_unrelated_grammar(void)
+{
+    epc_parser_list * list = epc_parser_list_create();
+    epc_parser_t * item = epc_parser_fwd_decl_l(list, "item");
+    epc_parser_t * items = epc_or_l(list, "items", 2, item, epc_char_l(list, "z", 'z'));
+
+    epc_parser_duplicate(item, epc_many_l(list, "letters", epc_one_of_l(list, NULL, "ab")));
+
+    epc_parse_session_t session = epc_parse_str(items, "abba", NULL);
+    bool const is_error = session.result.is_error;
+
+    epc_parse_session_destroy(&session);
+    epc_parser_list_free(list);
+
+    return !is_error;
+}
+
+TEST_GROUP(GrammarFinalizeTest)
+{
+    epc_parser_list * list = NULL;
+    epc_parser_t * num = NULL;
+    char input[256];
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+
+        char * end = input;
+        for (int i = 0; i < 40; i++)
+        {
+            end += sprintf(end, "%d-", 100 + i);
+        }
+        strcpy(end, "7");
+    }
+
+    void teardown() override
+    {
+        epc_parser_list_free(list);
+    }
+
+    // Returns the length matched, or -1 if the input doesn't match.
+    static int match(epc_parser_t * parser, char const * text)
+    {
+        // Left-recursive parsers are memoized; a small table keeps the many short parses quick.
+        epc_parse_options_t options = {.memo_budget = 64 * 1024};
+        epc_parse_input_t input = {.type = EPC_PARSE_TYPE_STRING, .input_string = text};
+        epc_parse_session_t session = epc_parse_with_options(parser, input, NULL, &options);
+        int len = session.result.is_error ? -1 : (int)session.result.data.success->len;
+
+        epc_parse_session_destroy(&session);
+        return len;
+    }
+};
+
+TEST(GrammarFinalizeTest, PlansAreKeptWhenAnUnrelatedGrammarIsRedefined)
+{
+    epc_parser_t * expr = expr_grammar(list, &num);
+
+    LONGS_EQUAL((int)strlen(input), match(expr, input));
+
+    parser_plan_t const * expr_plan = expr->plan;
+    parser_plan_t const * num_plan = num->plan;
+
+    CHECK_TRUE(expr_plan->is_left_recursive);
+    CHECK_TRUE(expr_plan->dispatch != NULL);
+    CHECK_TRUE(num_plan->run_class != NULL);
+
+    CHECK_TRUE(build_unrelated_grammar());
+    LONGS_EQUAL((int)strlen(input), match(expr, input));
+
+    POINTERS_EQUAL(expr_plan, expr->plan);
+    POINTERS_EQUAL(num_plan, num->plan);
+}
+
+TEST(GrammarFinalizeTest, OnlyParsersThatReachARedefinedOneArePlannedAgain)
+{
+    epc_parser_t * item = epc_parser_fwd_decl_l(list, "item");
+    epc_parser_t * letters = epc_plus_l(list, "letters", epc_alpha_l(list, NULL));
+    epc_parser_t * top = epc_or_l(list, "top", 2, item, letters);
+
+    epc_parser_duplicate(item, epc_char_l(list, "a", '1'));
+    LONGS_EQUAL(1, match(top, "1"));
+
+    parser_plan_t const * top_plan = top->plan;
+    parser_plan_t const * letters_plan = letters->plan;
+
+    epc_parser_duplicate(item, epc_char_l(list, "b", '2'));
+    LONGS_EQUAL(1, match(top, "2"));
+    LONGS_EQUAL(-1, match(top, "1"));
+
+    CHECK_TRUE(top->plan != top_plan);
+    POINTERS_EQUAL(letters_plan, letters->plan);
+}
+
+// Run this under ThreadSanitizer (configure with WITH_THREAD_SANITIZER) to check that parsing a grammar never reads
+// what finalizing another writes.
+TEST(GrammarFinalizeTest, GrammarsCanBeBuiltWhileAnotherIsParsedOnOtherThreads)
+{
+    epc_parser_t * expr = expr_grammar(list, &num);
+    int const expected_len = (int)strlen(input);
+    std::atomic<int> mismatches(0);
+    std::atomic<int> parsers_running(PARSER_THREADS);
+    std::atomic<int> grammars_built(0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < PARSER_THREADS; t++)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < PARSES_PER_THREAD; i++)
+            {
+                if (match(expr, input) != expected_len || match(expr, "(abc)") != 5)
+                {
+                    mismatches++;
+                }
+            }
+            parsers_running--;
+        });
+    }
+    threads.emplace_back([&]() {
+        while (parsers_running > 0)
+        {
+            if (!build_unrelated_grammar())
+            {
+                mismatches++;
+            }
+            grammars_built++;
+        }
+    });
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    LONGS_EQUAL(0, mismatches);
+    CHECK_TRUE(grammars_built > 0);
+}
@@ -0,0 +1,276 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h> // For free
+}
+
+TEST_GROUP(GrammarVmTest)
+{
+    epc_parser_list * list = NULL;
+    epc_compiled_grammar_t * compiled = NULL;
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+        compiled = NULL;
+    }
+
+    void teardown() override
+    {
+        epc_compiled_grammar_free(compiled);
+        epc_parser_list_free(list);
+    }
+
+    epc_parse_session_t parse_compiled(char const * input)
+    {
+        epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = input};
+
+        return epc_parse_compiled(compiled, parse_input, NULL, NULL);
+    }
+
+    // Parses `input` with both the interpreter and the compiled grammar, and checks that the results are the same.
+    // Returns true if the input was accepted.
+    bool check_same_result(epc_parser_t * top, char const * input)
+    {
+        if (compiled == NULL)
+        {
+            compiled = epc_grammar_compile(top);
+            CHECK_TRUE(compiled != NULL);
+        }
+
+        epc_parse_session_t interpreted = epc_parse_str(top, input, NULL);
+        epc_parse_session_t vm = parse_compiled(input);
+        bool const accepted = !interpreted.result.is_error;
+
+        CHECK_EQUAL(interpreted.result.is_error, vm.result.is_error);
+        if (accepted)
+        {
+            char * expected = epc_cpt_to_string(interpreted.internal_parse_ctx, interpreted.result.data.success);
+            char * actual = epc_cpt_to_string(vm.internal_parse_ctx, vm.result.data.success);
+
+            STRCMP_EQUAL(expected, actual);
+            free(expected);
+            free(actual);
+        }
+        else
+        {
+            epc_parser_error_t const * expected = interpreted.result.data.error;
+            epc_parser_error_t const * actual = vm.result.data.error;
+
+            STRCMP_EQUAL(expected->message, actual->message);
+            STRCMP_EQUAL(expected->expected, actual->expected);
+            STRCMP_EQUAL(expected->found, actual->found);
+            CHECK_EQUAL(expected->position.line, actual->position.line);
+            CHECK_EQUAL(expected->position.col, actual->position.col);
+        }
+
+        epc_parse_session_destroy(&interpreted);
+        epc_parse_session_destroy(&vm);
+
+        return accepted;
+    }
+};
+
+TEST(GrammarVmTest, SequencesAndAlternativesBuildTheSameTree)
+{
+    epc_parser_t * p_keyword = epc_or_l(
+        list,
+        "keyword",
+        3,
+        epc_string_l(list, "if", "if"),
+        epc_string_l(list, "in", "in"),
+        epc_string_l(list, "int", "int")
+    );
+    epc_parser_t * p_top = epc_and_l(
+        list, "top", 3, p_keyword, epc_char_l(list, "space", ' '), epc_alpha_l(list, "letter")
+    );
+
+    CHECK_TRUE(check_same_result(p_top, "in x"));
+    CHECK_TRUE(check_same_result(p_top, "if y"));
+    CHECK_FALSE(check_same_result(p_top, "int z"));
+    CHECK_FALSE(check_same_result(p_top, "while"));
+    CHECK_FALSE(check_same_result(p_top, ""));
+}
+
+TEST(GrammarVmTest, RepetitionBuildsTheSameTree)
+{
+    epc_parser_t * p_digits = epc_plus_l(list, "digits", epc_digit_l(list, "digit"));
+    epc_parser_t * p_spaces = epc_many_l(list, "spaces", epc_space_l(list, "space"));
+    epc_parser_t * p_sign = epc_optional_l(list, "sign", epc_one_of_l(list, "sign_char", "+-"));
+    epc_parser_t * p_number = epc_and_l(list, "number", 3, p_spaces, p_sign, p_digits);
+    epc_parser_t * p_top = epc_and_l(list, "top", 2, epc_many_l(list, "numbers", p_number), epc_eoi_l(list, "eoi"));
+
+    CHECK_TRUE(check_same_result(p_top, "1 +22  -333 4"));
+    CHECK_TRUE(check_same_result(p_top, "7"));
+    CHECK_FALSE(check_same_result(p_top, "1 2 x"));
+    CHECK_FALSE(check_same_result(p_top, "1 -"));
+}
+
+TEST(GrammarVmTest, CountAndPredicatesBuildTheSameTree)
+{
+    epc_parser_t * p_hex = epc_count_l(list, "hex", 4, epc_hex_digit_l(list, "hex_digit"));
+    epc_parser_t * p_escape = epc_and_l(list, "escape", 2, epc_string_l(list, "prefix", "\\u"), p_hex);
+    epc_parser_t * p_plain = epc_and_l(
+        list,
+        "plain",
+        2,
+        epc_not_l(list, "not_quote", epc_char_l(list, "quote", '"')),
+        epc_none_of_l(list, "plain_char", "\\")
+    );
+    epc_parser_t * p_chars = epc_many_l(list, "chars", epc_or_l(list, "char", 2, p_escape, p_plain));
+    epc_parser_t * p_string = epc_and_l(
+        list,
+        "string",
+        4,
+        epc_char_l(list, "open", '"'),
+        p_chars,
+        epc_char_l(list, "close", '"'),
+        epc_lookahead_l(list, "followed_by_end", epc_char_range_l(list, "end", ';', ';'))
+    );
+
+    CHECK_TRUE(check_same_result(p_string, "\"ab\\u12eFc\";"));
+    CHECK_FALSE(check_same_result(p_string, "\"ab\\u12g\";"));
+    CHECK_FALSE(check_same_result(p_string, "\"abc\"x"));
+    CHECK_FALSE(check_same_result(p_string, "\"abc"));
+}
+
+TEST(GrammarVmTest, RecursiveGrammarsAndCallOutsBuildTheSameTree)
+{
+    // expr = term ('+' term)*; term = int | '(' expr ')'
+    epc_parser_t * p_expr = epc_parser_fwd_decl("expr");
+    epc_parser_t * p_term = epc_or_l(
+        list,
+        "term",
+        2,
+        epc_lexeme_l(list, "number", epc_int_l(list, "int")),
+        epc_and_l(
+            list,
+            "group",
+            3,
+            epc_lexeme_l(list, "open", epc_char_l(list, "(", '(')),
+            p_expr,
+            epc_lexeme_l(list, "close", epc_char_l(list, ")", ')'))
+        )
+    );
+    epc_parser_t * p_expr_def = epc_and_l(
+        list,
+        "expr_def",
+        2,
+        p_term,
+        epc_many_l(
+            list, "more", epc_and_l(list, "add", 2, epc_lexeme_l(list, "plus", epc_char_l(list, "+", '+')), p_term)
+        )
+    );
+    epc_parser_duplicate(p_expr, p_expr_def);
+    epc_parser_t * p_top = epc_and_l(list, "top", 2, p_expr, epc_eoi_l(list, "eoi"));
+
+    CHECK_TRUE(check_same_result(p_top, "1 + (2 + 3) + ((4))"));
+    CHECK_TRUE(check_same_result(p_top, "42"));
+    CHECK_FALSE(check_same_result(p_top, "1 + (2 + )"));
+    CHECK_FALSE(check_same_result(p_top, "(1"));
+
+    epc_parser_free(p_expr);
+}
+
+TEST(GrammarVmTest, ZeroLengthRepetitionFailsAsTheInterpreterDoes)
+{
+    epc_parser_t * p_top = epc_many_l(list, "loop", epc_optional_l(list, "maybe_x", epc_char_l(list, "x", 'x')));
+
+    CHECK_FALSE(check_same_result(p_top, "xxy"));
+}
+
+TEST(GrammarVmTest, UndefinedForwardDeclarationIsNotCompiled)
+{
+    epc_parser_t * p_undefined = epc_parser_fwd_decl("undefined");
+    epc_parser_t * p_top = epc_and_l(list, "top", 2, epc_char_l(list, "a", 'a'), p_undefined);
+
+    POINTERS_EQUAL(NULL, epc_grammar_compile(p_top));
+
+    epc_parser_free(p_undefined);
+}
+
+TEST(GrammarVmTest, RedefiningAParserAfterCompilingIsHonoured)
+{
+    epc_parser_t * p_item = epc_parser_fwd_decl("item");
+    epc_parser_duplicate(p_item, epc_char_l(list, "a", 'a'));
+    epc_parser_t * p_top = epc_plus_l(list, "items", p_item);
+
+    compiled = epc_grammar_compile(p_top);
+    CHECK_TRUE(compiled != NULL);
+
+    epc_parser_duplicate(p_item, epc_char_l(list, "b", 'b'));
+
+    epc_parse_session_t session = parse_compiled("bbb");
+    CHECK_FALSE(session.result.is_error);
+    CHECK_EQUAL(3, session.result.data.success->len);
+    epc_parse_session_destroy(&session);
+
+    epc_parser_free(p_item);
+}
+
+TEST(GrammarVmTest, ErrorsWithinCombinatorsAreReportedAsTheInterpreterDoes)
+{
+    epc_parser_t * p_word = epc_plus_l(list, "word", epc_alpha_l(list, "letter"));
+    epc_parser_t * p_pair = epc_count_l(list, "pair", 2, epc_lexeme_l(list, "item", p_word));
+    epc_parser_t * p_keyword = epc_and_l(
+        list, "keyword", 2, epc_string_l(list, "let", "let"), epc_not_l(list, "not_letter", epc_alpha_l(list, "a"))
+    );
+    epc_parser_t * p_statement = epc_or_l(
+        list,
+        "statement",
+        2,
+        epc_and_l(list, "binding", 2, p_keyword, p_pair),
+        epc_and_l(
+            list,
+            "call",
+            2,
+            epc_lookahead_l(list, "called", epc_char_range_l(list, "lower", 'a', 'z')),
+            epc_optional_l(list, "args", p_word)
+        )
+    );
+    epc_parser_t * p_top = epc_and_l(
+        list, "top", 3, p_statement, epc_char_l(list, "semicolon", ';'), epc_eoi_l(list, "eoi")
+    );
+
+    CHECK_TRUE(check_same_result(p_top, "let x y;"));
+    CHECK_TRUE(check_same_result(p_top, "call;"));
+    CHECK_FALSE(check_same_result(p_top, "let x;"));
+    CHECK_TRUE(check_same_result(p_top, "letter;"));
+    CHECK_FALSE(check_same_result(p_top, "let1;"));
+    CHECK_FALSE(check_same_result(p_top, "Call;"));
+    CHECK_FALSE(check_same_result(p_top, "call 1;"));
+    CHECK_FALSE(check_same_result(p_top, "let x y"));
+    CHECK_FALSE(check_same_result(p_top, "1"));
+}
+
+static bool
+count_exit(epc_parse_result_t result, epc_parser_ctx_t * ctx, void * user_ctx)
+{
+    (void)result;
+    (void)ctx;
+    (*(int *)user_ctx)++;
+    return true;
+}
+
+TEST(GrammarVmTest, CallbacksRunOnceWhenTheInputDoesNotMatch)
+{
+    int exit_calls = 0;
+    epc_wrap_callbacks_t callbacks = {NULL, count_exit};
+    epc_parser_t * p_a = epc_wrap_l(list, "a", epc_char_l(list, NULL, 'a'), callbacks, &exit_calls);
+    epc_parser_t * p_top = epc_and_l(list, "top", 2, epc_many_l(list, "as", p_a), epc_eoi_l(list, "eoi"));
+
+    compiled = epc_grammar_compile(p_top);
+    CHECK_TRUE(compiled != NULL);
+
+    epc_parse_session_t session = parse_compiled("aaaX");
+    CHECK_TRUE(session.result.is_error);
+    LONGS_EQUAL(4, exit_calls);
+    epc_parse_session_destroy(&session);
+
+    exit_calls = 0;
+    session = epc_parse_str(p_top, "aaaX", NULL);
+    LONGS_EQUAL(4, exit_calls);
+    epc_parse_session_destroy(&session);
+}
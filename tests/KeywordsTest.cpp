@@ -0,0 +1,131 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_GROUP(KeywordsTest)
+{
+    epc_parse_session_t session = {0};
+    epc_parser_list * list = NULL;
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0};
+        list = epc_parser_list_create();
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    epc_parse_result_t parse(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_destroy(&session);
+        session = epc_parse_str(parser, input, NULL);
+        return session.result;
+    }
+
+    // Checks that `parser` matches the first `len` bytes of `input`, as the keyword at `keyword`.
+    void check_match(epc_parser_t * parser, char const * input, size_t len, int keyword)
+    {
+        epc_parse_result_t result = parse(parser, input);
+
+        CHECK_FALSE(result.is_error);
+        LONGS_EQUAL(len, epc_cpt_node_get_len(result.data.success));
+        LONGS_EQUAL(keyword, epc_cpt_node_get_keyword_index(result.data.success));
+    }
+};
+
+TEST(KeywordsTest, MatchesTheLongestKeyword)
+{
+    epc_parser_t * p = epc_keywords_l(list, "type", 4, "int", "integer", "interface", "in");
+
+    check_match(p, "int x", 3, 0);
+    check_match(p, "integer", 7, 1);
+    check_match(p, "interface;", 9, 2);
+    check_match(p, "inter", 3, 0);
+    check_match(p, "in", 2, 3);
+}
+
+TEST(KeywordsTest, ReportsTheKeywordsExpectedWhenNoneMatch)
+{
+    epc_parser_t * p = epc_keywords_l(list, "kw", 3, "if", "else", "while");
+    epc_parse_result_t result = parse(p, "iz");
+
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL("No keyword matched", result.data.error->message);
+    STRCMP_EQUAL("if or else or while", result.data.error->expected);
+    STRCMP_EQUAL("iz", result.data.error->found);
+
+    result = parse(p, "");
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL("Unexpected end of input", result.data.error->message);
+    STRCMP_EQUAL("EOF", result.data.error->found);
+}
+
+TEST(KeywordsTest, TheFirstOfADuplicatedKeywordIsReported)
+{
+    epc_parser_t * p = epc_keywords_l(list, "kw", 3, "do", "done", "do");
+
+    check_match(p, "do", 2, 0);
+    check_match(p, "done", 4, 1);
+}
+
+TEST(KeywordsTest, AnEmptyKeywordMatchesWhenNoOtherDoes)
+{
+    epc_parser_t * p = epc_keywords_l(list, "kw", 2, "", "x");
+
+    check_match(p, "x", 1, 1);
+    check_match(p, "y", 0, 0);
+}
+
+TEST(KeywordsTest, NodesOfOtherParsersHaveNoKeyword)
+{
+    epc_parse_result_t result = parse(epc_string_l(list, "s", "int"), "int");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(-1, epc_cpt_node_get_keyword_index(result.data.success));
+    LONGS_EQUAL(-1, epc_cpt_node_get_keyword_index(NULL));
+}
+
+TEST(KeywordsTest, KeywordsInASequence)
+{
+    // decl: type ' ' name
+    epc_parser_t * type = epc_keywords_l(list, "type", 3, "char", "short", "long");
+    epc_parser_t * decl = epc_and_l(
+        list, "decl", 3, type, epc_char_l(list, NULL, ' '), epc_plus_l(list, "name", epc_alpha_l(list, NULL))
+    );
+    epc_parse_result_t result = parse(decl, "short x");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(7, epc_cpt_node_get_len(result.data.success));
+    LONGS_EQUAL(1, epc_cpt_node_get_keyword_index(result.data.success->children[0]));
+}
+
+TEST(KeywordsTest, FirstSetHoldsTheFirstByteOfEachKeyword)
+{
+    // The epc_or only tries the keywords where the next byte may start one.
+    epc_parser_t * p = epc_or_l(
+        list, "or", 2, epc_keywords_l(list, "kw", 2, "true", "false"), epc_plus_l(list, "num", epc_digit_l(list, NULL))
+    );
+
+    CHECK_FALSE(parse(p, "false").is_error);
+    CHECK_FALSE(parse(p, "42").is_error);
+    CHECK_TRUE(parse(p, "nil").is_error);
+}
+
+TEST(KeywordsTest, KeywordsCanBeGivenAsAnArray)
+{
+    char const * keywords[] = {"true", "false", "null"};
+    epc_parser_t * p = epc_keywords_array_l(list, "literal", 3, keywords);
+
+    check_match(p, "null", 4, 2);
+    check_match(p, "false", 5, 1);
+    POINTERS_EQUAL(NULL, epc_keywords_array_l(list, "none", 0, keywords));
+}
@@ -0,0 +1,295 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <easy_pc/easy_pc_ast.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+// AST nodes are strings, such as "sub[sub[1 2] 3]", so that trees are easily compared.
+enum LeftRecursionActions
+{
+    ACTION_NUMBER,
+    ACTION_SUB,
+    ACTION_COUNT
+};
+
+static void
+free_node(void * node, void * user_data)
+{
+    free(node);
+    (*(int *)user_data)--;
+}
+
+static void
+action_number(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    (void)children;
+    (void)count;
+    (*(int *)user_data)++;
+    epc_ast_push(ctx, strndup(epc_cpt_node_get_content(node), epc_cpt_node_get_len(node)));
+}
+
+static void
+action_sub(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    char text[256];
+
+    (void)node;
+    LONGS_EQUAL(2, count);
+    snprintf(text, sizeof(text), "sub[%s %s]", (char *)children[0], (char *)children[1]);
+    free_node(children[0], user_data);
+    free_node(children[1], user_data);
+    (*(int *)user_data)++;
+    epc_ast_push(ctx, strdup(text));
+}
+
+static void
+init_registry(epc_ast_hook_registry_t * registry)
+{
+    epc_ast_hook_registry_set_free_node(registry, free_node);
+    epc_ast_hook_registry_set_action(registry, ACTION_NUMBER, action_number);
+    epc_ast_hook_registry_set_action(registry, ACTION_SUB, action_sub);
+}
+
+TEST_GROUP(LeftRecursionTest)
+{
+    epc_parser_list * list = NULL;
+    epc_parse_session_t session = {0};
+    epc_parser_t * num = NULL;
+    epc_parser_t * sub = NULL;
+    char edge[64];
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+        session = (epc_parse_session_t){0};
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    // expr: expr '-' num | num
+    epc_parser_t * expr_grammar()
+    {
+        epc_parser_t * expr = epc_parser_fwd_decl_l(list, "expr");
+
+        num = epc_plus_l(list, "num", epc_digit_l(list, NULL));
+        sub = epc_and_l(list, "sub", 3, expr, epc_char_l(list, NULL, '-'), num);
+        epc_parser_duplicate(expr, epc_or_l(list, "expr", 2, sub, num));
+
+        return expr;
+    }
+
+    epc_parse_result_t parse(epc_parser_t * parser, char const * input, epc_parse_options_t const * options = NULL)
+    {
+        epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = input};
+
+        session = epc_parse_with_options(parser, parse_input, NULL, options);
+        return session.result;
+    }
+
+    // The lengths of the matches of `name` down the left edge of the tree, outermost first, e.g. "5 3 1".
+    char const * left_edge(epc_cpt_node_t * node, char const * name)
+    {
+        size_t len = 0;
+
+        edge[0] = '\0';
+        for (; node != NULL; node = node->children_count > 0 ? node->children[0] : NULL)
+        {
+            if (node->name != NULL && strcmp(node->name, name) == 0)
+            {
+                len += snprintf(edge + len, sizeof(edge) - len, len == 0 ? "%zu" : " %zu", node->len);
+            }
+        }
+
+        return edge;
+    }
+};
+
+TEST(LeftRecursionTest, DirectLeftRecursionMatchesAllTheInput)
+{
+    epc_parse_result_t result = parse(expr_grammar(), "1-22-333");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(8, result.data.success->len);
+}
+
+TEST(LeftRecursionTest, MatchIsLeftAssociative)
+{
+    epc_parse_result_t result = parse(expr_grammar(), "1-2-3");
+
+    CHECK_FALSE(result.is_error);
+    STRCMP_EQUAL("5 3 1", left_edge(result.data.success, "expr"));
+    STRCMP_EQUAL("5 3", left_edge(result.data.success, "sub"));
+}
+
+TEST(LeftRecursionTest, GrowingStopsWhereTheInputNoLongerMatches)
+{
+    epc_parse_result_t result = parse(expr_grammar(), "1-2-x");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(3, result.data.success->len);
+}
+
+TEST(LeftRecursionTest, ParserWhereTheCycleIsEnteredIsMarked)
+{
+    epc_parser_t * expr = expr_grammar();
+
+    parse(expr, "1");
+
+    CHECK_TRUE(expr->plan->is_left_recursive);
+    CHECK_FALSE(sub->plan->is_left_recursive);
+    CHECK_FALSE(num->plan->is_left_recursive);
+}
+
+TEST(LeftRecursionTest, FailureReportsTheInput)
+{
+    epc_parse_result_t result = parse(expr_grammar(), "-1");
+
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL("-1", result.data.error->input_position);
+    CHECK_TRUE(strcmp("Left recursion", result.data.error->message) != 0);
+}
+
+TEST(LeftRecursionTest, IndirectLeftRecursion)
+{
+    // a: b 'x' | 'y'
+    // b: a 'z' | 'w'
+    epc_parser_t * a = epc_parser_fwd_decl_l(list, "a");
+    epc_parser_t * b = epc_or_l(
+        list, "b", 2, epc_and_l(list, NULL, 2, a, epc_char_l(list, NULL, 'z')), epc_char_l(list, NULL, 'w')
+    );
+
+    epc_parser_t * bx = epc_and_l(list, NULL, 2, b, epc_char_l(list, NULL, 'x'));
+
+    epc_parser_duplicate(a, epc_or_l(list, "a", 2, bx, epc_char_l(list, NULL, 'y')));
+
+    epc_parse_result_t result = parse(a, "yzxzx");
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(5, result.data.success->len);
+    epc_parse_session_destroy(&session);
+
+    result = parse(a, "wxzx");
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(4, result.data.success->len);
+    epc_parse_session_destroy(&session);
+
+    // Parsing may also start part way round the cycle.
+    result = parse(b, "yzxz");
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(4, result.data.success->len);
+}
+
+TEST(LeftRecursionTest, NestedLeftRecursiveRules)
+{
+    // expr: expr '-' term | term
+    // term: term '*' atom | atom
+    // atom: num | '(' expr ')'
+    epc_parser_t * expr = epc_parser_fwd_decl_l(list, "expr");
+    epc_parser_t * term = epc_parser_fwd_decl_l(list, "term");
+    epc_parser_t * number = epc_plus_l(list, "num", epc_digit_l(list, NULL));
+    epc_parser_t * atom = epc_or_l(
+        list,
+        "atom",
+        2,
+        number,
+        epc_and_l(list, NULL, 3, epc_char_l(list, NULL, '('), expr, epc_char_l(list, NULL, ')'))
+    );
+
+    epc_parser_duplicate(
+        term, epc_or_l(list, "term", 2, epc_and_l(list, "mul", 3, term, epc_char_l(list, NULL, '*'), atom), atom)
+    );
+    epc_parser_duplicate(
+        expr, epc_or_l(list, "expr", 2, epc_and_l(list, "sub", 3, expr, epc_char_l(list, NULL, '-'), term), term)
+    );
+
+    epc_parse_result_t result = parse(expr, "1*2-(3-4)*5-6");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(13, result.data.success->len);
+    STRCMP_EQUAL("13 11 3", left_edge(result.data.success, "expr"));
+    STRCMP_EQUAL("3 1", left_edge(result.data.success, "term"));
+}
+
+TEST(LeftRecursionTest, PackratParseGivesTheSameMatch)
+{
+    epc_parse_options_t options = {.memoize = true};
+    epc_parse_result_t result = parse(expr_grammar(), "1-2-3", &options);
+
+    CHECK_FALSE(result.is_error);
+    STRCMP_EQUAL("5 3 1", left_edge(result.data.success, "expr"));
+}
+
+TEST(LeftRecursionTest, LeftRecursiveParserIsOnlyGrownOnceAtAnOffset)
+{
+    // Both alternatives start with expr, so the second one gets the first one's match from the memo table.
+    epc_parser_t * expr = expr_grammar();
+    epc_parser_t * statement = epc_or_l(
+        list,
+        "statement",
+        2,
+        epc_and_l(list, NULL, 2, expr, epc_char_l(list, NULL, ';')),
+        epc_and_l(list, NULL, 2, expr, epc_char_l(list, NULL, '.'))
+    );
+    epc_parse_options_t options = {.profile = true};
+
+    epc_parse_result_t result = parse(statement, "1-2-3.", &options);
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(6, result.data.success->len);
+#ifdef WITH_PARSE_PROFILING
+    epc_parser_profile_t top[16];
+    size_t const count = epc_parse_session_profile_report(&session, EPC_PROFILE_BY_INVOCATIONS, 16, top, NULL);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strcmp(top[i].name, "sub") == 0)
+        {
+            // Once before there is a seed, once for each of the two matches grown from it and once more to find
+            // that it can't grow any further.
+            LONGS_EQUAL(4, top[i].invocations);
+        }
+    }
+#endif
+}
+
+TEST(LeftRecursionTest, CompiledGrammarGivesTheSameMatch)
+{
+    epc_parser_t * expr = expr_grammar();
+    epc_compiled_grammar_t * compiled = epc_grammar_compile(expr);
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = "1-2-3"};
+
+    CHECK_TRUE(compiled != NULL);
+    session = epc_parse_compiled(compiled, parse_input, NULL, NULL);
+
+    CHECK_FALSE(session.result.is_error);
+    STRCMP_EQUAL("5 3 1", left_edge(session.result.data.success, "expr"));
+    epc_compiled_grammar_free(compiled);
+}
+
+TEST(LeftRecursionTest, AstIsBuiltOnceFromTheFinalMatch)
+{
+    epc_parser_t * expr = expr_grammar();
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = "1-2-3"};
+    int live_nodes = 0;
+
+    epc_parser_set_ast_action(num, ACTION_NUMBER);
+    epc_parser_set_ast_action(sub, ACTION_SUB);
+
+    epc_compile_result_t result = epc_parse_to_ast(expr, parse_input, ACTION_COUNT, init_registry, NULL, &live_nodes);
+
+    CHECK_TRUE(result.success);
+    STRCMP_EQUAL("sub[sub[1 2] 3]", (char *)result.ast);
+    LONGS_EQUAL(1, live_nodes);
+
+    epc_compile_result_cleanup(&result, free_node, &live_nodes);
+    LONGS_EQUAL(0, live_nodes);
+}
@@ -0,0 +1,123 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h> // For malloc, free
+#include <string.h> // For memset
+}
+
+TEST_GROUP(LineIndexTest)
+{
+    epc_parse_session_t session = {0};
+    epc_parse_result_t result;
+    epc_parser_list * list = NULL;
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0}; // Reset session before each test
+        list = epc_parser_list_create();
+    }
+
+    epc_parse_result_t parse(epc_parser_t * parser, char const * input)
+    {
+        session = epc_parse_str(parser, input, NULL);
+        return session.result;
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    void check_line_col(size_t offset, size_t expected_line, size_t expected_col)
+    {
+        epc_line_col_t const position = epc_parse_ctx_get_line_col(session.internal_parse_ctx, offset);
+
+        LONGS_EQUAL(expected_line, position.line);
+        LONGS_EQUAL(expected_col, position.col);
+    }
+};
+
+TEST(LineIndexTest, OffsetsOnFirstLineUseOffsetAsColumn)
+{
+    epc_parser_t * p_all = epc_many_l(list, "all", epc_any_l(list, "any"));
+
+    result = parse(p_all, "abc\ndef");
+    CHECK_FALSE(result.is_error);
+
+    check_line_col(0, 0, 0);
+    check_line_col(2, 0, 2);
+}
+
+TEST(LineIndexTest, OffsetsOnLaterLinesAreMeasuredFromThePrecedingNewline)
+{
+    epc_parser_t * p_all = epc_many_l(list, "all", epc_any_l(list, "any"));
+
+    result = parse(p_all, "ab\ncd\n\nef");
+    CHECK_FALSE(result.is_error);
+
+    // Looked up out of order to check the index doesn't depend on the order of lookups.
+    check_line_col(8, 3, 2);
+    check_line_col(2, 1, 0);
+    check_line_col(3, 1, 1);
+    check_line_col(5, 2, 0);
+    check_line_col(6, 3, 0);
+    check_line_col(7, 3, 1);
+}
+
+TEST(LineIndexTest, EndOfTheInputHasAPosition)
+{
+    epc_parser_t * p_all = epc_many_l(list, "all", epc_any_l(list, "any"));
+
+    result = parse(p_all, "ab\ncd");
+    CHECK_FALSE(result.is_error);
+
+    check_line_col(5, 1, 3);
+}
+
+TEST(LineIndexTest, OffsetsPastTheEndOfTheInputGiveZeroPosition)
+{
+    epc_parser_t * p_all = epc_many_l(list, "all", epc_any_l(list, "any"));
+
+    result = parse(p_all, "ab\ncd");
+    CHECK_FALSE(result.is_error);
+
+    check_line_col(6, 0, 0);
+    check_line_col(100, 0, 0);
+
+    epc_line_col_t const position = epc_parse_ctx_get_line_col(NULL, 1);
+    LONGS_EQUAL(0, position.line);
+    LONGS_EQUAL(0, position.col);
+}
+
+TEST(LineIndexTest, CptNodePositionIsTheStartOfItsContent)
+{
+    epc_parser_t * p_first = epc_string_l(list, "first", "ab\nc");
+    epc_parser_t * p_second = epc_string_l(list, "second", "de");
+    epc_parser_t * p_seq = epc_and_l(list, "seq", 2, p_first, p_second);
+
+    result = parse(p_seq, "ab\ncde");
+    CHECK_FALSE(result.is_error);
+
+    epc_cpt_node_t * second = result.data.success->children[1];
+    epc_line_col_t const position = epc_cpt_node_get_line_col(session.internal_parse_ctx, second);
+
+    LONGS_EQUAL(1, position.line);
+    LONGS_EQUAL(2, position.col);
+}
+
+TEST(LineIndexTest, ErrorPositionMatchesLineColLookup)
+{
+    epc_parser_t * p_first = epc_string_l(list, "first", "ab\ncd\n");
+    epc_parser_t * p_second = epc_char_l(list, "second", 'x');
+    epc_parser_t * p_seq = epc_and_l(list, "seq", 2, p_first, p_second);
+
+    result = parse(p_seq, "ab\ncd\ny");
+    CHECK_TRUE(result.is_error);
+
+    LONGS_EQUAL(2, result.data.error->position.line);
+    LONGS_EQUAL(1, result.data.error->position.col);
+    check_line_col(6, 2, 1);
+}
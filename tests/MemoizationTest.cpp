@@ -0,0 +1,214 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h> // For malloc, free
+#include <string.h> // For memset
+}
+
+TEST_GROUP(MemoizationTest)
+{
+    epc_parse_session_t session = {0};
+    epc_parse_result_t result;
+    epc_parser_list * list = NULL;
+    int predicate_calls = 0;
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0}; // Reset session before each test
+        list = epc_parser_list_create();
+        predicate_calls = 0;
+    }
+
+    epc_parse_result_t parse(epc_parser_t * parser, char const * input, epc_parse_options_t const * options)
+    {
+        epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = input};
+
+        session = epc_parse_with_options(parser, parse_input, NULL, options);
+        return session.result;
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    static bool counting_predicate(epc_cpt_node_t * node, epc_parser_ctx_t * parse_ctx, void * user_ctx)
+    {
+        (void)node;
+        (void)parse_ctx;
+        (*(int *)user_ctx)++;
+        return true;
+    }
+
+    // Builds: prefix 'b' | prefix 'c' | prefix 'd', where prefix counts how many times it is parsed.
+    epc_parser_t * create_shared_prefix_grammar(epc_parser_t ** prefix)
+    {
+        epc_parser_t * p_ident = epc_plus_l(list, "ident", epc_char_range_l(list, NULL, 'a', 'a'));
+        *prefix = epc_satisfy_l(list, "prefix", p_ident, "prefix", counting_predicate, &predicate_calls);
+
+        return epc_or_l(
+            list,
+            "alternatives",
+            3,
+            epc_and_l(list, "alt_b", 2, *prefix, epc_char_l(list, NULL, 'b')),
+            epc_and_l(list, "alt_c", 2, *prefix, epc_char_l(list, NULL, 'c')),
+            epc_and_l(list, "alt_d", 2, *prefix, epc_char_l(list, NULL, 'd'))
+        );
+    }
+};
+
+TEST(MemoizationTest, WithoutMemoizationSharedPrefixIsReparsed)
+{
+    epc_parser_t * prefix;
+    epc_parser_t * grammar = create_shared_prefix_grammar(&prefix);
+
+    result = parse(grammar, "aaad", NULL);
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(3, predicate_calls);
+}
+
+TEST(MemoizationTest, SessionMemoizationParsesSharedPrefixOnce)
+{
+    epc_parser_t * prefix;
+    epc_parser_t * grammar = create_shared_prefix_grammar(&prefix);
+    epc_parse_options_t options = {.memoize = true};
+
+    result = parse(grammar, "aaad", &options);
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(1, predicate_calls);
+    LONGS_EQUAL(4, result.data.success->len);
+    epc_cpt_node_t * alt_d = result.data.success->children[0];
+    STRCMP_EQUAL("alt_d", alt_d->name);
+    STRCMP_EQUAL("prefix", alt_d->children[0]->name);
+    LONGS_EQUAL(3, alt_d->children[0]->len);
+    STRNCMP_EQUAL("d", alt_d->children[1]->content, 1);
+}
+
+TEST(MemoizationTest, PerParserMemoizationParsesSharedPrefixOnce)
+{
+    epc_parser_t * prefix;
+    epc_parser_t * grammar = create_shared_prefix_grammar(&prefix);
+    epc_parser_set_memoize(prefix, true);
+
+    result = parse(grammar, "aaac", NULL);
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(1, predicate_calls);
+    STRCMP_EQUAL("alt_c", result.data.success->children[0]->name);
+}
+
+TEST(MemoizationTest, MemoizedFailureReportsSameError)
+{
+    epc_parser_t * prefix;
+    epc_parser_t * grammar = create_shared_prefix_grammar(&prefix);
+    epc_parse_options_t options = {.memoize = true};
+
+    result = parse(grammar, "aaax", &options);
+
+    CHECK_TRUE(result.is_error);
+    LONGS_EQUAL(1, predicate_calls);
+    STRCMP_EQUAL("Unexpected character", result.data.error->message);
+    STRCMP_EQUAL("x", result.data.error->found);
+    LONGS_EQUAL(3, result.data.error->position.col);
+}
+
+TEST(MemoizationTest, ReusedSuccessReportsTheErrorsItReached)
+{
+    // head matches one character, but first tries words followed by '!', and fails at the end of "b2cc". The first
+    // use of head is within an alternative that is abandoned, which forgets that failure, so the second use, from the
+    // memo table, has to record it again for the error to be the same as without memoization.
+    epc_parser_t * word = epc_plus_l(list, "word", epc_alphanum_l(list, NULL));
+    epc_parser_t * head = epc_and_l(
+        list,
+        "head",
+        2,
+        epc_many_l(list, NULL, epc_and_l(list, NULL, 2, word, epc_char_l(list, NULL, '!'))),
+        epc_alphanum_l(list, NULL)
+    );
+    epc_parser_t * grammar = epc_and_l(
+        list,
+        "grammar",
+        3,
+        epc_or_l(list, NULL, 2, epc_and_l(list, NULL, 2, head, epc_char_l(list, NULL, '?')), epc_succeed_l(list, NULL)),
+        head,
+        epc_eoi_l(list, NULL)
+    );
+    epc_parse_options_t options = {.memoize = true};
+
+    result = parse(grammar, "b2cc 1aa", NULL);
+    CHECK_TRUE(result.is_error);
+
+    char * message = strdup(result.data.error->message);
+    char * expected = strdup(result.data.error->expected);
+    int const col = result.data.error->position.col;
+
+    epc_parse_session_destroy(&session);
+    result = parse(grammar, "b2cc 1aa", &options);
+
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL(message, result.data.error->message);
+    STRCMP_EQUAL(expected, result.data.error->expected);
+    LONGS_EQUAL(col, result.data.error->position.col);
+    LONGS_EQUAL(4, col);
+    free(message);
+    free(expected);
+}
+
+TEST(MemoizationTest, TinyBudgetEvictsButStillParses)
+{
+    size_t const input_len = 2000;
+    char * input = (char *)malloc(input_len + 1);
+    for (size_t i = 0; i < input_len; i++)
+    {
+        input[i] = (i % 2 == 0) ? 'a' : 'b';
+    }
+    input[input_len] = '\0';
+
+    epc_parser_t * p_ab = epc_and_l(list, "ab", 2, epc_char_l(list, NULL, 'a'), epc_char_l(list, NULL, 'b'));
+    epc_parser_t * p_ac = epc_and_l(list, "ac", 2, epc_char_l(list, NULL, 'a'), epc_char_l(list, NULL, 'c'));
+    epc_parser_t * p_many = epc_many_l(list, NULL, epc_or_l(list, NULL, 2, p_ac, p_ab));
+    epc_parse_options_t options = {.memoize = true, .memo_budget = 1};
+
+    result = parse(p_many, input, &options);
+    free(input);
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(input_len, result.data.success->len);
+    LONGS_EQUAL(input_len / 2, result.data.success->children_count);
+    STRCMP_EQUAL("ab", result.data.success->children[input_len / 2 - 1]->children[0]->name);
+}
+
+TEST(MemoizationTest, TinyBudgetDropsResultsCachedWithinFailedAlternatives)
+{
+    // Each item first tries "digits X", which fails after caching the digits; "digits ," then reuses them.
+    size_t const item_count = 500;
+    char * input = (char *)malloc(item_count * 4 + 1);
+    for (size_t i = 0; i < item_count; i++)
+    {
+        memcpy(&input[i * 4], "123,", 4);
+    }
+    input[item_count * 4] = '\0';
+
+    epc_parser_t * digits = epc_plus_l(list, "digits", epc_digit_l(list, NULL));
+    epc_parser_t * tagged = epc_and_l(list, "tagged", 2, digits, epc_char_l(list, NULL, 'X'));
+    epc_parser_t * item = epc_and_l(list, "item", 2, digits, epc_char_l(list, NULL, ','));
+    epc_parser_t * p_many = epc_many_l(list, NULL, epc_or_l(list, NULL, 2, tagged, item));
+    epc_parse_options_t options = {.memoize = true, .memo_budget = 64};
+
+    result = parse(p_many, input, &options);
+    free(input);
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(item_count * 4, result.data.success->len);
+    LONGS_EQUAL(item_count, result.data.success->children_count);
+
+    epc_cpt_node_t * last = result.data.success->children[item_count - 1]->children[0];
+    STRCMP_EQUAL("item", last->name);
+    STRCMP_EQUAL("digits", last->children[0]->name);
+    LONGS_EQUAL(3, last->children[0]->len);
+}
@@ -0,0 +1,236 @@
+#include "CppUTest/TestHarness.h"
+
+#include <atomic>
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define INPUT_COUNT 500
+
+typedef struct
+{
+    std::atomic<int> calls;
+    std::atomic<int> other_grammar_failures;
+    bool is_error[INPUT_COUNT];
+    size_t len[INPUT_COUNT];
+} ResultLog;
+
+static void
+log_result(size_t index, epc_parse_session_t * session, void * user_data)
+{
+    ResultLog * log = (ResultLog *)user_data;
+
+    log->calls++;
+    log->is_error[index] = session->result.is_error;
+    log->len[index] = session->result.is_error ? 0 : session->result.data.success->len;
+}
+
+// Builds, parses with and frees a grammar of its own for each result, as another part of a program might while a
+// batch runs.
+static void
+build_other_grammar(size_t index, epc_parse_session_t * session, void * user_data)
+{
+    epc_parser_list * list = epc_parser_list_create();
+    epc_parser_t * item = epc_parser_fwd_decl_l(list, "item");
+    epc_parser_t * items = epc_or_l(list, "items", 2, item, epc_char_l(list, NULL, 'z'));
+
+    epc_parser_duplicate(item, epc_plus_l(list, NULL, epc_one_of_l(list, NULL, "ab")));
+
+    epc_parse_session_t other = epc_parse_str(items, "abba", NULL);
+
+    if (other.result.is_error)
+    {
+        ((ResultLog *)user_data)->other_grammar_failures++;
+    }
+    epc_parse_session_destroy(&other);
+    epc_parser_list_free(list);
+    log_result(index, session, user_data);
+}
+
+TEST_GROUP(ParseBatchTest)
+{
+    epc_parser_list * list = NULL;
+    char * texts[INPUT_COUNT];
+    epc_parse_input_t inputs[INPUT_COUNT];
+    epc_parse_session_t sessions[INPUT_COUNT];
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+
+        // Inputs of very different lengths, every seventh of them invalid.
+        for (int i = 0; i < INPUT_COUNT; i++)
+        {
+            int const words = 1 + (i * 37) % 200;
+            texts[i] = (char *)malloc(words * 6 + 2);
+
+            char * end = texts[i];
+            for (int w = 0; w < words; w++)
+            {
+                end += sprintf(end, "w%d ", w % 1000);
+            }
+            if (i % 7 == 3)
+            {
+                strcpy(end, "!");
+            }
+            inputs[i] = (epc_parse_input_t){.type = EPC_PARSE_TYPE_STRING, .input_string = texts[i]};
+            sessions[i] = (epc_parse_session_t){0};
+        }
+    }
+
+    void teardown() override
+    {
+        for (int i = 0; i < INPUT_COUNT; i++)
+        {
+            epc_parse_session_destroy(&sessions[i]);
+            free(texts[i]);
+        }
+        epc_parser_list_free(list);
+    }
+
+    // words: (alpha alphanum* ' '*)+ eoi
+    epc_parser_t * words()
+    {
+        epc_parser_t * word = epc_and_l(
+            list, "word", 2, epc_alpha_l(list, NULL), epc_many_l(list, NULL, epc_alphanum_l(list, NULL))
+        );
+        epc_parser_t * spaces = epc_many_l(list, NULL, epc_char_l(list, NULL, ' '));
+
+        return epc_and_l(
+            list, "words", 2, epc_plus_l(list, NULL, epc_and_l(list, NULL, 2, word, spaces)), epc_eoi_l(list, NULL)
+        );
+    }
+
+    void check_matches_sequential_parse(epc_parser_t * parser, int index)
+    {
+        epc_parse_session_t expected = epc_parse_str(parser, texts[index], NULL);
+
+        CHECK_EQUAL(expected.result.is_error, sessions[index].result.is_error);
+        if (expected.result.is_error)
+        {
+            STRCMP_EQUAL(expected.result.data.error->message, sessions[index].result.data.error->message);
+            LONGS_EQUAL(expected.result.data.error->position.col, sessions[index].result.data.error->position.col);
+        }
+        else
+        {
+            char * expected_text = epc_cpt_to_string(expected.internal_parse_ctx, expected.result.data.success);
+            char * actual_text
+                = epc_cpt_to_string(sessions[index].internal_parse_ctx, sessions[index].result.data.success);
+
+            STRCMP_EQUAL(expected_text, actual_text);
+            free(expected_text);
+            free(actual_text);
+        }
+        epc_parse_session_destroy(&expected);
+    }
+};
+
+TEST(ParseBatchTest, ResultsMatchSequentialParses)
+{
+    epc_parser_t * p = words();
+    epc_parse_batch_options_t options = {.thread_count = 4};
+
+    epc_parse_batch(p, inputs, INPUT_COUNT, sessions, &options);
+
+    for (int i = 0; i < INPUT_COUNT; i++)
+    {
+        check_matches_sequential_parse(p, i);
+    }
+}
+
+TEST(ParseBatchTest, DefaultsUseEveryProcessor)
+{
+    epc_parser_t * p = words();
+
+    epc_parse_batch(p, inputs, INPUT_COUNT, sessions, NULL);
+
+    for (int i = 0; i < INPUT_COUNT; i++)
+    {
+        CHECK_EQUAL(i % 7 == 3, sessions[i].result.is_error);
+    }
+}
+
+TEST(ParseBatchTest, MoreThreadsThanInputs)
+{
+    epc_parser_t * p = words();
+    epc_parse_batch_options_t options = {.thread_count = 16};
+
+    epc_parse_batch(p, inputs, 3, sessions, &options);
+
+    for (int i = 0; i < 3; i++)
+    {
+        check_matches_sequential_parse(p, i);
+    }
+    POINTERS_EQUAL(NULL, sessions[3].internal_parse_ctx);
+}
+
+TEST(ParseBatchTest, CallbackSeesEveryResult)
+{
+    epc_parser_t * p = words();
+    ResultLog * log = new ResultLog();
+    epc_parse_batch_options_t options = {.thread_count = 4, .on_result = log_result, .on_result_data = log};
+
+    epc_parse_batch(p, inputs, INPUT_COUNT, NULL, &options);
+
+    LONGS_EQUAL(INPUT_COUNT, log->calls.load());
+    for (int i = 0; i < INPUT_COUNT; i++)
+    {
+        CHECK_EQUAL(i % 7 == 3, log->is_error[i]);
+        if (!log->is_error[i])
+        {
+            LONGS_EQUAL(strlen(texts[i]), log->len[i]);
+        }
+    }
+    delete log;
+}
+
+TEST(ParseBatchTest, OtherGrammarsCanBeBuiltWhileTheBatchRuns)
+{
+    epc_parser_t * p = words();
+    ResultLog * log = new ResultLog();
+    epc_parse_batch_options_t options = {.thread_count = 4, .on_result = build_other_grammar, .on_result_data = log};
+
+    epc_parse_batch(p, inputs, INPUT_COUNT, NULL, &options);
+
+    LONGS_EQUAL(INPUT_COUNT, log->calls.load());
+    LONGS_EQUAL(0, log->other_grammar_failures.load());
+    for (int i = 0; i < INPUT_COUNT; i++)
+    {
+        CHECK_EQUAL(i % 7 == 3, log->is_error[i]);
+        if (!log->is_error[i])
+        {
+            LONGS_EQUAL(strlen(texts[i]), log->len[i]);
+        }
+    }
+    delete log;
+}
+
+TEST(ParseBatchTest, ParseOptionsAreUsed)
+{
+    epc_parser_t * p = words();
+    epc_parse_options_t parse_options = {.memoize = true};
+    epc_parse_batch_options_t options = {.thread_count = 2, .parse_options = &parse_options};
+
+    epc_parse_batch(p, inputs, 20, sessions, &options);
+
+    for (int i = 0; i < 20; i++)
+    {
+        check_matches_sequential_parse(p, i);
+    }
+}
+
+TEST(ParseBatchTest, MissingTopParserIsReportedForEachInput)
+{
+    epc_parse_batch(NULL, inputs, 10, sessions, NULL);
+
+    for (int i = 0; i < 10; i++)
+    {
+        CHECK_TRUE(sessions[i].result.is_error);
+        STRCMP_EQUAL("Top parser not set for grammar", sessions[i].result.data.error->message);
+    }
+}
@@ -0,0 +1,324 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include <easy_pc/easy_pc.h>
+#include <easy_pc/easy_pc_ast.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+// AST nodes are strings, such as "sum[a op(+) call[f 1]]", so that trees are easily compared.
+enum ParseToAstActions
+{
+    ACTION_LEAF,
+    ACTION_OP,
+    ACTION_CALL,
+    ACTION_SUM,
+    ACTION_FAIL,
+    ACTION_LAST,
+    ACTION_COUNT
+};
+
+typedef struct
+{
+    int live_nodes;
+    int actions_run;
+} AstCounts;
+
+static void
+push_node(epc_ast_builder_ctx_t * ctx, AstCounts * counts, char * text)
+{
+    counts->actions_run++;
+    counts->live_nodes++;
+    epc_ast_push(ctx, text);
+}
+
+static void
+free_node(void * node, void * user_data)
+{
+    free(node);
+    ((AstCounts *)user_data)->live_nodes--;
+}
+
+// Makes "name[child child ...]", consuming the children.
+static char *
+join(char const * name, void ** children, int count, AstCounts * counts)
+{
+    size_t len = strlen(name) + 3;
+
+    for (int i = 0; i < count; i++)
+    {
+        len += strlen((char *)children[i]) + 1;
+    }
+
+    char * text = (char *)malloc(len);
+    char * end = text + sprintf(text, "%s[", name);
+
+    for (int i = 0; i < count; i++)
+    {
+        end += sprintf(end, i == 0 ? "%s" : " %s", (char *)children[i]);
+        free_node(children[i], counts);
+    }
+    strcpy(end, "]");
+
+    return text;
+}
+
+static void
+action_leaf(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    (void)children;
+    (void)count;
+    push_node(
+        ctx,
+        (AstCounts *)user_data,
+        strndup(epc_cpt_node_get_semantic_content(node), epc_cpt_node_get_semantic_len(node))
+    );
+}
+
+static void
+action_op(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    char text[8];
+
+    (void)children;
+    (void)count;
+    snprintf(text, sizeof(text), "op(%.*s)", (int)epc_cpt_node_get_len(node), epc_cpt_node_get_content(node));
+    push_node(ctx, (AstCounts *)user_data, strdup(text));
+}
+
+static void
+action_call(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    (void)node;
+    push_node(ctx, (AstCounts *)user_data, join("call", children, count, (AstCounts *)user_data));
+}
+
+static void
+action_sum(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    (void)node;
+    push_node(ctx, (AstCounts *)user_data, join("sum", children, count, (AstCounts *)user_data));
+}
+
+static void
+action_fail(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    for (int i = 0; i < count; i++)
+    {
+        free_node(children[i], user_data);
+    }
+    epc_ast_builder_set_error(ctx, "Rejected '%.*s'", (int)epc_cpt_node_get_len(node), epc_cpt_node_get_content(node));
+}
+
+// Keeps only the last child, so that deep trees don't build quadratically long strings.
+static void
+action_last(epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data)
+{
+    (void)node;
+    for (int i = 0; i < count - 1; i++)
+    {
+        free_node(children[i], user_data);
+    }
+    epc_ast_push(ctx, children[count - 1]);
+}
+
+static void
+init_registry(epc_ast_hook_registry_t * registry)
+{
+    epc_ast_hook_registry_set_free_node(registry, free_node);
+    epc_ast_hook_registry_set_action(registry, ACTION_LEAF, action_leaf);
+    epc_ast_hook_registry_set_action(registry, ACTION_OP, action_op);
+    epc_ast_hook_registry_set_action(registry, ACTION_CALL, action_call);
+    epc_ast_hook_registry_set_action(registry, ACTION_SUM, action_sum);
+    epc_ast_hook_registry_set_action(registry, ACTION_FAIL, action_fail);
+    epc_ast_hook_registry_set_action(registry, ACTION_LAST, action_last);
+}
+
+TEST_GROUP(ParseToAstTest)
+{
+    epc_parser_list * list = NULL;
+    AstCounts counts = {0};
+    epc_compile_result_t result = {0};
+    epc_parser_t * ident = NULL;
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+        counts = (AstCounts){0};
+        result = (epc_compile_result_t){0};
+    }
+
+    void teardown() override
+    {
+        epc_compile_result_cleanup(&result, free_node, &counts);
+        LONGS_EQUAL(0, counts.live_nodes);
+        epc_parser_list_free(list);
+    }
+
+    // sum: item (('+' | '-') item)* eoi
+    // item: ident '(' number ')' | ident | number
+    epc_parser_t * sum_grammar()
+    {
+        ident = epc_plus_l(list, "ident", epc_alpha_l(list, NULL));
+        epc_parser_t * number = epc_plus_l(list, "number", epc_digit_l(list, NULL));
+        epc_parser_t * call = epc_and_l(
+            list, "call", 4, ident, epc_char_l(list, NULL, '('), number, epc_char_l(list, NULL, ')')
+        );
+        epc_parser_t * item = epc_or_l(list, "item", 3, call, ident, number);
+        epc_parser_t * op = epc_one_of_l(list, "op", "+-");
+        epc_parser_t * sum = epc_chainl1_l(list, "sum", item, op);
+
+        epc_parser_set_ast_action(ident, ACTION_LEAF);
+        epc_parser_set_ast_action(number, ACTION_LEAF);
+        epc_parser_set_ast_action(call, ACTION_CALL);
+        epc_parser_set_ast_action(op, ACTION_OP);
+        epc_parser_set_ast_action(sum, ACTION_SUM);
+
+        return epc_and_l(list, "root", 2, sum, epc_eoi_l(list, NULL));
+    }
+
+    epc_compile_result_t parse_to_ast(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = input};
+
+        return epc_parse_to_ast(parser, parse_input, ACTION_COUNT, init_registry, NULL, &counts);
+    }
+
+    epc_compile_result_t parse_and_build_ast(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = input};
+
+        return epc_parse_and_build_ast(parser, parse_input, ACTION_COUNT, init_registry, NULL, &counts);
+    }
+};
+
+TEST(ParseToAstTest, BuildsTheSameAstAsTheParseTree)
+{
+    epc_parser_t * p = sum_grammar();
+    char const * input = "a+f(1)-23+g(45)";
+    epc_compile_result_t expected = parse_and_build_ast(p, input);
+
+    result = parse_to_ast(p, input);
+
+    CHECK_TRUE(expected.success);
+    CHECK_TRUE(result.success);
+    STRCMP_EQUAL("sum[sum[sum[a op(+) call[f 1]] op(-) 23] op(+) call[g 45]]", (char *)expected.ast);
+    STRCMP_EQUAL((char *)expected.ast, (char *)result.ast);
+    epc_compile_result_cleanup(&expected, free_node, &counts);
+}
+
+TEST(ParseToAstTest, NodesOfAbandonedAlternativesAreFreed)
+{
+    epc_parser_t * p = sum_grammar();
+
+    // "a" and "b" are built as the start of a call before they are built again as identifiers.
+    result = parse_to_ast(p, "a+b");
+
+    CHECK_TRUE(result.success);
+    STRCMP_EQUAL("sum[a op(+) b]", (char *)result.ast);
+    LONGS_EQUAL(1, counts.live_nodes);
+    LONGS_EQUAL(6, counts.actions_run);
+}
+
+TEST(ParseToAstTest, ErrorInAnAbandonedAlternativeIsForgotten)
+{
+    epc_parser_t * word = epc_plus_l(list, "word", epc_alpha_l(list, NULL));
+    epc_parser_t * rejected = epc_and_l(list, "rejected", 2, word, epc_char_l(list, NULL, '!'));
+    epc_parser_t * p = epc_or_l(list, "root", 2, epc_and_l(list, NULL, 2, rejected, epc_char_l(list, NULL, '?')), word);
+
+    epc_parser_set_ast_action(word, ACTION_LEAF);
+    epc_parser_set_ast_action(rejected, ACTION_FAIL);
+
+    result = parse_to_ast(p, "abc!");
+
+    CHECK_TRUE(result.success);
+    POINTERS_EQUAL(NULL, result.ast_error_message);
+    STRCMP_EQUAL("abc", (char *)result.ast);
+}
+
+TEST(ParseToAstTest, ErrorInTheMatchIsReported)
+{
+    epc_parser_t * word = epc_plus_l(list, "word", epc_alpha_l(list, NULL));
+    epc_parser_t * rejected = epc_and_l(list, "rejected", 2, word, epc_char_l(list, NULL, '!'));
+
+    epc_parser_set_ast_action(word, ACTION_LEAF);
+    epc_parser_set_ast_action(rejected, ACTION_FAIL);
+
+    result = parse_to_ast(rejected, "abc!");
+
+    CHECK_FALSE(result.success);
+    STRCMP_EQUAL("Rejected 'abc!'", result.ast_error_message);
+}
+
+TEST(ParseToAstTest, ParseErrorIsReported)
+{
+    epc_parser_t * p = sum_grammar();
+
+    result = parse_to_ast(p, "a+f(1");
+
+    CHECK_FALSE(result.success);
+    CHECK_TRUE(result.parse_error_message != NULL);
+    POINTERS_EQUAL(NULL, result.ast);
+}
+
+TEST(ParseToAstTest, TokenChildrenAreNotBuilt)
+{
+    epc_parser_t * p = sum_grammar();
+
+    epc_parser_set_token(ident, true);
+    epc_parser_set_ast_action(ident, ACTION_LEAF);
+    result = parse_to_ast(p, "ab+cd");
+
+    CHECK_TRUE(result.success);
+    STRCMP_EQUAL("sum[ab op(+) cd]", (char *)result.ast);
+}
+
+TEST(ParseToAstTest, NodesOfASkippedChildAreFreed)
+{
+    // The lookahead matches "ab" but leaves nothing in the tree.
+    epc_parser_t * word = epc_plus_l(list, "word", epc_alpha_l(list, NULL));
+    epc_parser_t * p = epc_and_l(list, "root", 2, epc_lookahead_l(list, NULL, word), word);
+
+    epc_parser_set_ast_action(word, ACTION_LEAF);
+    result = parse_to_ast(p, "ab");
+
+    CHECK_TRUE(result.success);
+    STRCMP_EQUAL("ab", (char *)result.ast);
+    LONGS_EQUAL(1, counts.live_nodes);
+}
+
+TEST(ParseToAstTest, DeepTreeIsBuilt)
+{
+    // A right associative chain nests one level per operator. The chain's nodes are built by epc_chainr1() rather than
+    // matched through parse(), and each has to be ruled out as already built in constant time for this to finish in
+    // milliseconds rather than minutes.
+    int const item_count = 200000;
+    char * input = (char *)malloc(item_count * 2);
+    for (int i = 0; i < item_count; i++)
+    {
+        input[i * 2] = 'a';
+        input[i * 2 + 1] = '+';
+    }
+    input[item_count * 2 - 1] = '\0';
+
+    epc_parser_t * leaf = epc_alpha_l(list, "leaf");
+    epc_parser_t * op = epc_char_l(list, "op", '+');
+    epc_parser_t * chain = epc_chainr1_l(list, "chain", leaf, op);
+
+    epc_parser_set_ast_action(leaf, ACTION_LEAF);
+    epc_parser_set_ast_action(op, ACTION_OP);
+    epc_parser_set_ast_action(chain, ACTION_LAST);
+
+    epc_compile_result_t expected = parse_and_build_ast(chain, input);
+    result = parse_to_ast(chain, input);
+
+    CHECK_TRUE(expected.success);
+    CHECK_TRUE(result.success);
+    STRCMP_EQUAL("a", (char *)expected.ast);
+    STRCMP_EQUAL("a", (char *)result.ast);
+    epc_compile_result_cleanup(&expected, free_node, &counts);
+    free(input);
+}
@@ -0,0 +1,205 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include <easy_pc/easy_pc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_GROUP(ProfileTest)
+{
+    epc_parser_list * list = NULL;
+    epc_parse_session_t session = {0};
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    // greeting: "ab" "cd" | "ab" "ce", where the first alternative backtracks over "ab" on "abce".
+    epc_parser_t * greeting_parser()
+    {
+        epc_parser_t * ab = epc_string_l(list, "ab", "ab");
+        epc_parser_t * abcd = epc_and_l(list, "abcd", 2, ab, epc_string_l(list, "cd", "cd"));
+        epc_parser_t * abce = epc_and_l(list, "abce", 2, ab, epc_string_l(list, "ce", "ce"));
+
+        return epc_or_l(list, "greeting", 2, abcd, abce);
+    }
+
+    void parse(epc_parser_t * parser, char const * text, bool profile = true)
+    {
+        epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = text};
+        epc_parse_options_t options = {.profile = profile};
+
+        session = epc_parse_with_options(parser, parse_input, NULL, &options);
+    }
+
+    // The counts of the parser named `name` in the session's profile.
+    epc_parser_profile_t counts_of(char const * name)
+    {
+        epc_parser_profile_t top[16];
+        size_t const count = epc_parse_session_profile_report(&session, EPC_PROFILE_BY_INVOCATIONS, 16, top, NULL);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (strcmp(top[i].name, name) == 0)
+            {
+                return top[i];
+            }
+        }
+        FAIL(name);
+
+        return epc_parser_profile_t{};
+    }
+};
+
+TEST(ProfileTest, CountsEachParser)
+{
+    parse(greeting_parser(), "abce");
+
+    CHECK_FALSE(session.result.is_error);
+
+    epc_parser_profile_t const greeting = counts_of("greeting");
+    LONGS_EQUAL(1, greeting.invocations);
+    LONGS_EQUAL(1, greeting.successes);
+    LONGS_EQUAL(4, greeting.bytes_consumed);
+
+    epc_parser_profile_t const ab = counts_of("ab");
+    LONGS_EQUAL(2, ab.invocations);
+    LONGS_EQUAL(2, ab.successes);
+    LONGS_EQUAL(0, ab.failures);
+    LONGS_EQUAL(4, ab.bytes_consumed);
+
+    epc_parser_profile_t const cd = counts_of("cd");
+    LONGS_EQUAL(1, cd.invocations);
+    LONGS_EQUAL(1, cd.failures);
+}
+
+TEST(ProfileTest, CountsTheInputAFailedParserBacktracksOver)
+{
+    parse(greeting_parser(), "abce");
+
+    epc_parser_profile_t const abcd = counts_of("abcd");
+    LONGS_EQUAL(1, abcd.failures);
+    LONGS_EQUAL(2, abcd.backtracked_bytes);
+
+    epc_parser_profile_t const abce = counts_of("abce");
+    LONGS_EQUAL(1, abce.successes);
+    LONGS_EQUAL(0, abce.backtracked_bytes);
+
+    epc_parser_profile_t top[1];
+    LONGS_EQUAL(1, epc_parse_session_profile_report(&session, EPC_PROFILE_BY_BACKTRACKED_BYTES, 1, top, NULL));
+    STRCMP_EQUAL("abcd", top[0].name);
+}
+
+TEST(ProfileTest, ReportIsInOrder)
+{
+    parse(greeting_parser(), "abce");
+
+    epc_parser_profile_t top[16];
+    size_t const count = epc_parse_session_profile_report(&session, EPC_PROFILE_BY_INCLUSIVE_TIME, 16, top, NULL);
+
+    LONGS_EQUAL(6, count);
+    for (size_t i = 1; i < count; i++)
+    {
+        CHECK_TRUE(top[i - 1].inclusive_ns >= top[i].inclusive_ns);
+    }
+
+    // The top parser's time includes everything else's.
+    STRCMP_EQUAL("greeting", top[0].name);
+    for (size_t i = 0; i < count; i++)
+    {
+        CHECK_TRUE(top[i].exclusive_ns <= top[i].inclusive_ns);
+    }
+}
+
+TEST(ProfileTest, RecursiveParserOnlyCountsItsOutermostTime)
+{
+    // nested: '(' nested ')' | 'x'
+    epc_parser_t * nested = epc_parser_fwd_decl_l(list, "nested");
+    epc_parser_t * parenthesised = epc_and_l(
+        list, "parenthesised", 3, epc_char_l(list, "open", '('), nested, epc_char_l(list, "close", ')')
+    );
+
+    epc_parser_duplicate(nested, epc_or_l(list, "nested", 2, parenthesised, epc_char_l(list, "x", 'x')));
+    parse(nested, "(((x)))");
+
+    CHECK_FALSE(session.result.is_error);
+
+    epc_parser_profile_t const counts = counts_of("nested");
+    LONGS_EQUAL(4, counts.invocations);
+    CHECK_TRUE(counts.inclusive_ns >= counts.exclusive_ns);
+
+    epc_parser_profile_t top[1];
+    epc_parse_session_profile_report(&session, EPC_PROFILE_BY_INCLUSIVE_TIME, 1, top, NULL);
+    STRCMP_EQUAL("nested", top[0].name);
+    CHECK_TRUE(top[0].inclusive_ns >= counts_of("parenthesised").inclusive_ns);
+}
+
+TEST(ProfileTest, ReportIsPrinted)
+{
+    parse(greeting_parser(), "abce");
+
+    FILE * fp = tmpfile();
+    CHECK_TRUE(fp != NULL);
+
+    LONGS_EQUAL(2, epc_parse_session_profile_report(&session, EPC_PROFILE_BY_EXCLUSIVE_TIME, 2, NULL, fp));
+
+    char text[1024] = {0};
+    rewind(fp);
+    size_t const len = fread(text, 1, sizeof(text) - 1, fp);
+    fclose(fp);
+
+    CHECK_TRUE(len > 0);
+    CHECK_TRUE(strstr(text, "backtracked") != NULL);
+
+    // A header and two parsers.
+    int lines = 0;
+    for (char const * c = text; *c != '\0'; c++)
+    {
+        lines += *c == '\n';
+    }
+    LONGS_EQUAL(3, lines);
+}
+
+TEST(ProfileTest, CompiledGrammarIsProfiledToo)
+{
+    epc_parser_t * greeting = greeting_parser();
+    epc_compiled_grammar_t * compiled = epc_grammar_compile(greeting);
+    CHECK_TRUE(compiled != NULL);
+
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = "abce"};
+    epc_parse_options_t options = {.profile = true};
+
+    session = epc_parse_compiled(compiled, parse_input, NULL, &options);
+
+    CHECK_FALSE(session.result.is_error);
+    LONGS_EQUAL(2, counts_of("ab").invocations);
+    epc_compiled_grammar_free(compiled);
+}
+
+TEST(ProfileTest, ResetSessionCountsTheNewInputOnly)
+{
+    parse(greeting_parser(), "abce");
+    CHECK_TRUE(epc_parse_session_reset(&session, "abcd"));
+
+    CHECK_FALSE(session.result.is_error);
+    LONGS_EQUAL(1, counts_of("ab").invocations);
+    LONGS_EQUAL(0, counts_of("abcd").failures);
+}
+
+TEST(ProfileTest, UnprofiledSessionHasNoReport)
+{
+    parse(greeting_parser(), "abce", false);
+
+    epc_parser_profile_t top[4];
+    LONGS_EQUAL(0, epc_parse_session_profile_report(&session, EPC_PROFILE_BY_EXCLUSIVE_TIME, 4, top, stdout));
+}
@@ -0,0 +1,275 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h> // For free
+#include <string.h>
+}
+
+static bool
+count_exit(epc_parse_result_t result, epc_parser_ctx_t * ctx, void * user_ctx)
+{
+    (void)result;
+    (void)ctx;
+    (*(int *)user_ctx)++;
+    return true;
+}
+
+TEST_GROUP(PushParseTest)
+{
+    epc_parser_list * list = NULL;
+    epc_parse_session_t session = {0};
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0}; // Reset session before each test
+        list = epc_parser_list_create();
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_parser_list_free(list);
+    }
+
+    // Numbers separated by commas, to the end of the input.
+    epc_parser_t * number_list()
+    {
+        epc_parser_t * numbers = epc_delimited_l(list, "numbers", epc_int_l(list, "number"), epc_char_l(list, NULL, ','));
+
+        return epc_and_l(list, "list", 2, numbers, epc_eoi_l(list, NULL));
+    }
+
+    // Feeds `input` a byte at a time, then finishes the parse.
+    void feed_bytes(char const * input)
+    {
+        for (char const * c = input; *c != '\0'; c++)
+        {
+            LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, c, 1));
+        }
+        LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_finish(&session));
+    }
+
+    void check_same_tree_as_string_parse(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_t expected_session = epc_parse_str(parser, input, NULL);
+
+        CHECK_FALSE(expected_session.result.is_error);
+        CHECK_FALSE(session.result.is_error);
+
+        char * expected = epc_cpt_to_string(expected_session.internal_parse_ctx, expected_session.result.data.success);
+        char * actual = epc_cpt_to_string(session.internal_parse_ctx, session.result.data.success);
+
+        STRCMP_EQUAL(expected, actual);
+        free(expected);
+        free(actual);
+        epc_parse_session_destroy(&expected_session);
+    }
+};
+
+TEST(PushParseTest, ParseWaitsForInputInPieces)
+{
+    epc_parser_t * p = epc_and_l(list, NULL, 2, epc_string_l(list, NULL, "hello world"), epc_eoi_l(list, NULL));
+
+    session = epc_parse_start(p, NULL);
+
+    CHECK_TRUE(session.internal_parse_ctx != NULL);
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, "hel", 3));
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, "lo wor", 6));
+    // All of the string is there, but whether the input ends after it isn't known yet.
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, "ld", 2));
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_finish(&session));
+
+    CHECK_FALSE(session.result.is_error);
+    STRNCMP_EQUAL("hello world", session.result.data.success->content, 11);
+    LONGS_EQUAL(11, session.result.data.success->len);
+}
+
+TEST(PushParseTest, ByteAtATimeBuildsSameTreeAsWholeInput)
+{
+    epc_parser_t * p = number_list();
+
+    session = epc_parse_start(p, NULL);
+    feed_bytes("12,-345,6789,0");
+
+    check_same_tree_as_string_parse(p, "12,-345,6789,0");
+}
+
+TEST(PushParseTest, ParseIsDoneWithoutWaitingForInputItDoesNotNeed)
+{
+    epc_parser_t * p = epc_string_l(list, NULL, "abc");
+
+    session = epc_parse_start(p, NULL);
+
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_feed(&session, "abcdef", 6));
+    CHECK_FALSE(session.result.is_error);
+    LONGS_EQUAL(3, session.result.data.success->len);
+    // Further input is ignored.
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_feed(&session, "ghi", 3));
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_finish(&session));
+    LONGS_EQUAL(3, session.result.data.success->len);
+}
+
+TEST(PushParseTest, MismatchReportsSameErrorAsWholeInput)
+{
+    epc_parser_t * p = number_list();
+    epc_parse_session_t expected_session = epc_parse_str(p, "1,2,x", NULL);
+
+    session = epc_parse_start(p, NULL);
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, "1,2", 3));
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_feed(&session, ",x", 2));
+
+    CHECK_TRUE(session.result.is_error);
+    STRCMP_EQUAL(expected_session.result.data.error->message, session.result.data.error->message);
+    STRCMP_EQUAL(expected_session.result.data.error->expected, session.result.data.error->expected);
+    STRCMP_EQUAL(expected_session.result.data.error->found, session.result.data.error->found);
+    LONGS_EQUAL(expected_session.result.data.error->position.col, session.result.data.error->position.col);
+    epc_parse_session_destroy(&expected_session);
+}
+
+TEST(PushParseTest, ErrorAtTheEndOfTheInputFedSoFarHasSamePositionAsWholeInput)
+{
+    // epc_fail() needs no input, so the parse fails where the input fed so far ends, before any more is fed.
+    char const * const input = "ab\ncd!";
+    size_t const input_len = strlen(input);
+    epc_parser_t * p = epc_and_l(list, NULL, 2, epc_string_l(list, NULL, input), epc_fail_l(list, NULL, "stop"));
+    epc_parse_session_t expected_session = epc_parse_str(p, input, NULL);
+
+    CHECK_TRUE(expected_session.result.is_error);
+    LONGS_EQUAL(1, expected_session.result.data.error->position.line);
+
+    for (size_t split = 1; split < input_len; split++)
+    {
+        session = epc_parse_start(p, NULL);
+        LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input, split));
+        LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_feed(&session, input + split, input_len - split));
+
+        CHECK_TRUE(session.result.is_error);
+        LONGS_EQUAL(expected_session.result.data.error->position.line, session.result.data.error->position.line);
+        LONGS_EQUAL(expected_session.result.data.error->position.col, session.result.data.error->position.col);
+        epc_parse_session_destroy(&session);
+    }
+    epc_parse_session_destroy(&expected_session);
+}
+
+TEST(PushParseTest, EmptyInputIsParsed)
+{
+    epc_parser_t * p = epc_eoi_l(list, NULL);
+
+    session = epc_parse_start(p, NULL);
+
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_finish(&session));
+    CHECK_FALSE(session.result.is_error);
+}
+
+TEST(PushParseTest, SessionCanBeDestroyedBeforeTheParseIsDone)
+{
+    epc_parser_t * p = number_list();
+
+    session = epc_parse_start(p, NULL);
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, "1,2,3", 5));
+
+    epc_parse_session_destroy(&session);
+    POINTERS_EQUAL(NULL, session.internal_parse_ctx);
+}
+
+TEST(PushParseTest, DestroyingAnUnfinishedSessionRunsNoCallbacks)
+{
+    int exit_calls = 0;
+    epc_wrap_callbacks_t callbacks = {NULL, count_exit};
+    epc_parser_t * number = epc_wrap_l(list, "number", epc_int_l(list, NULL), callbacks, &exit_calls);
+    epc_parser_t * numbers = epc_delimited_l(list, "numbers", number, epc_char_l(list, NULL, ','));
+    epc_parser_t * p = epc_and_l(list, "list", 2, numbers, epc_eoi_l(list, NULL));
+
+    session = epc_parse_start(p, NULL);
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, "1,2,3", 5));
+    LONGS_EQUAL(2, exit_calls);
+
+    epc_parse_session_destroy(&session);
+    POINTERS_EQUAL(NULL, session.internal_parse_ctx);
+    LONGS_EQUAL(2, exit_calls);
+}
+
+TEST(PushParseTest, ManySessionsAreFedInTurn)
+{
+    int const session_count = 100;
+    epc_parser_t * p = number_list();
+    epc_parse_session_t * sessions = (epc_parse_session_t *)calloc(session_count, sizeof(*sessions));
+    char const * input = "10,20,30";
+
+    for (int i = 0; i < session_count; i++)
+    {
+        sessions[i] = epc_parse_start(p, NULL);
+    }
+    for (char const * c = input; *c != '\0'; c++)
+    {
+        for (int i = 0; i < session_count; i++)
+        {
+            LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&sessions[i], c, 1));
+        }
+    }
+    for (int i = 0; i < session_count; i++)
+    {
+        LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_finish(&sessions[i]));
+        CHECK_FALSE(sessions[i].result.is_error);
+        LONGS_EQUAL(strlen(input), sessions[i].result.data.success->len);
+        epc_parse_session_destroy(&sessions[i]);
+    }
+    free(sessions);
+}
+
+TEST(PushParseTest, CompiledGrammarCanBeFed)
+{
+    epc_parser_t * p = number_list();
+    epc_compiled_grammar_t * compiled = epc_grammar_compile(p);
+    epc_parse_input_t input = {.type = EPC_PARSE_TYPE_PUSH};
+
+    CHECK_TRUE(compiled != NULL);
+    session = epc_parse_compiled(compiled, input, NULL, NULL);
+    feed_bytes("7,8,9");
+
+    check_same_tree_as_string_parse(p, "7,8,9");
+    epc_compiled_grammar_free(compiled);
+}
+
+TEST(PushParseTest, RunsSplitAcrossFeedsBuildSameTreeAsWholeInput)
+{
+    // Whitespace, comments and numbers each run over several feeds, and "*/" is split between two.
+    char const * input = "  -1234 // one\n\t 56 /* a ** b */ 7";
+    epc_parser_t * skip = epc_many_l(
+        list, NULL, epc_or_l(list, NULL, 2, epc_space_l(list, NULL), epc_c_comment_l(list, NULL))
+    );
+    epc_parser_t * number = epc_and_l(list, "number", 2, epc_lexeme_l(list, NULL, epc_int_l(list, NULL)), skip);
+    epc_parser_t * p = epc_and_l(list, NULL, 2, epc_many_l(list, NULL, number), epc_eoi_l(list, NULL));
+
+    session = epc_parse_start(p, NULL);
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input, 4));
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input + 4, 8));
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input + 12, 19));
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input + 31, strlen(input) - 31));
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_finish(&session));
+
+    check_same_tree_as_string_parse(p, input);
+}
+
+TEST(PushParseTest, CharacterRunsSplitAcrossFeedsBuildSameTreeAsWholeInput)
+{
+    char const * input = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJ0123456789012345678901234567890123456789";
+    epc_parser_t * p = epc_and_l(
+        list,
+        NULL,
+        3,
+        epc_plus_l(list, NULL, epc_alpha_l(list, NULL)),
+        epc_many_l(list, NULL, epc_digit_l(list, NULL)),
+        epc_eoi_l(list, NULL)
+    );
+
+    session = epc_parse_start(p, NULL);
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input, 20));
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input + 20, 36));
+    LONGS_EQUAL(EPC_PARSE_STATUS_NEED_INPUT, epc_parse_feed(&session, input + 56, strlen(input) - 56));
+    LONGS_EQUAL(EPC_PARSE_STATUS_DONE, epc_parse_finish(&session));
+
+    check_same_tree_as_string_parse(p, input);
+}
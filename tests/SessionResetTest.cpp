@@ -0,0 +1,188 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_GROUP(SessionResetTest)
+{
+    epc_parser_list * list = NULL;
+    epc_parse_session_t session = {0};
+    epc_compiled_grammar_t * compiled = NULL;
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0};
+        list = epc_parser_list_create();
+        compiled = NULL;
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_compiled_grammar_free(compiled);
+        epc_parser_list_free(list);
+    }
+
+    // words: (alpha+ [ \n]*)+ eoi
+    epc_parser_t * words()
+    {
+        epc_parser_t * word = epc_plus_l(list, "word", epc_alpha_l(list, NULL));
+        epc_parser_t * spaces = epc_many_l(list, NULL, epc_one_of_l(list, NULL, " \n"));
+
+        return epc_and_l(
+            list, "words", 2, epc_plus_l(list, NULL, epc_and_l(list, NULL, 2, word, spaces)), epc_eoi_l(list, NULL)
+        );
+    }
+
+    void check_same_tree(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_t expected = epc_parse_str(parser, input, NULL);
+        char * expected_text = epc_cpt_to_string(expected.internal_parse_ctx, expected.result.data.success);
+        char * actual_text = epc_cpt_to_string(session.internal_parse_ctx, session.result.data.success);
+
+        CHECK_FALSE(expected.result.is_error);
+        CHECK_FALSE(session.result.is_error);
+        STRCMP_EQUAL(expected_text, actual_text);
+        free(expected_text);
+        free(actual_text);
+        epc_parse_session_destroy(&expected);
+    }
+};
+
+TEST(SessionResetTest, ParsesEachInputWithTheSameGrammar)
+{
+    epc_parser_t * p = words();
+
+    session = epc_parse_str(p, "one two", NULL);
+    CHECK_FALSE(session.result.is_error);
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "three four five"));
+    check_same_tree(p, "three four five");
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "six 7"));
+    CHECK_TRUE(session.result.is_error);
+    LONGS_EQUAL(4, session.result.data.error->position.col);
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "eight"));
+    check_same_tree(p, "eight");
+}
+
+TEST(SessionResetTest, MemoryIsReused)
+{
+    epc_parser_t * p = words();
+
+    session = epc_parse_str(p, "alpha beta", NULL);
+    epc_cpt_node_t const * root = session.result.data.success;
+    char const * content = root->content;
+
+    // An input of the same shape is parsed into the same memory.
+    CHECK_TRUE(epc_parse_session_reset(&session, "gamma beta"));
+    CHECK_FALSE(session.result.is_error);
+    POINTERS_EQUAL(root, session.result.data.success);
+    POINTERS_EQUAL(content, session.result.data.success->content);
+}
+
+TEST(SessionResetTest, ErrorStringsAreReused)
+{
+    epc_parser_t * p = words();
+
+    session = epc_parse_str(p, "alpha beta!", NULL);
+    CHECK_TRUE(session.result.is_error);
+    char const * message = session.result.data.error->message;
+    char const * expected = session.result.data.error->expected;
+    char const * found = session.result.data.error->found;
+
+    // A failure of the same shape is reported in the same memory.
+    CHECK_TRUE(epc_parse_session_reset(&session, "gamma beta?"));
+    CHECK_TRUE(session.result.is_error);
+    POINTERS_EQUAL(message, session.result.data.error->message);
+    POINTERS_EQUAL(expected, session.result.data.error->expected);
+    POINTERS_EQUAL(found, session.result.data.error->found);
+    STRCMP_EQUAL("?", session.result.data.error->found);
+}
+
+TEST(SessionResetTest, LongerInputIsParsed)
+{
+    epc_parser_t * p = words();
+    size_t const len = 100000;
+    char * input = (char *)malloc(len + 1);
+
+    for (size_t i = 0; i < len; i++)
+    {
+        input[i] = i % 8 == 7 ? ' ' : 'a';
+    }
+    input[len] = '\0';
+
+    session = epc_parse_str(p, "short", NULL);
+    CHECK_TRUE(epc_parse_session_reset(&session, input));
+    CHECK_FALSE(session.result.is_error);
+    LONGS_EQUAL(len, session.result.data.success->len);
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "short again"));
+    check_same_tree(p, "short again");
+    free(input);
+}
+
+TEST(SessionResetTest, ErrorPositionIsForTheNewInput)
+{
+    epc_parser_t * p = words();
+
+    session = epc_parse_str(p, "a\nb\nc!", NULL);
+    CHECK_TRUE(session.result.is_error);
+    LONGS_EQUAL(2, session.result.data.error->position.line);
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "abc def!"));
+    CHECK_TRUE(session.result.is_error);
+    LONGS_EQUAL(0, session.result.data.error->position.line);
+    LONGS_EQUAL(7, session.result.data.error->position.col);
+}
+
+TEST(SessionResetTest, OptionsAreKept)
+{
+    epc_parser_t * p = words();
+    epc_parse_options_t options = {.memoize = true};
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = "memo ized"};
+
+    session = epc_parse_with_options(p, parse_input, NULL, &options);
+    CHECK_FALSE(session.result.is_error);
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "again and again"));
+    check_same_tree(p, "again and again");
+}
+
+TEST(SessionResetTest, CompiledGrammarIsKept)
+{
+    epc_parser_t * p = words();
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = "compiled"};
+
+    compiled = epc_grammar_compile(p);
+    CHECK_TRUE(compiled != NULL);
+    session = epc_parse_compiled(compiled, parse_input, NULL, NULL);
+    CHECK_FALSE(session.result.is_error);
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "still compiled"));
+    check_same_tree(p, "still compiled");
+}
+
+TEST(SessionResetTest, SessionWithoutAStringCantBeReset)
+{
+    CHECK_FALSE(epc_parse_session_reset(&session, "input"));
+    CHECK_TRUE(session.result.is_error);
+    STRCMP_EQUAL("Session can't be reset", session.result.data.error->message);
+}
+
+TEST(SessionResetTest, NullInputIsAnError)
+{
+    session = epc_parse_str(words(), "words", NULL);
+
+    CHECK_FALSE(epc_parse_session_reset(&session, NULL));
+    CHECK_TRUE(session.result.is_error);
+    STRCMP_EQUAL("Input string is NULL", session.result.data.error->message);
+
+    CHECK_TRUE(epc_parse_session_reset(&session, "words"));
+    CHECK_FALSE(session.result.is_error);
+}
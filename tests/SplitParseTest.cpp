@@ -0,0 +1,250 @@
+#include "CppUTest/TestHarness.h"
+
+#include <atomic>
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+// Long enough for four chunks of at least 64 KiB.
+#define LINE_COUNT 20000
+
+static std::atomic<int> records_parsed;
+static std::atomic<int> splits_asked;
+
+static bool
+count_record(epc_cpt_node_t * token, epc_parser_ctx_t * parse_ctx, void * user_ctx)
+{
+    (void)token;
+    (void)parse_ctx;
+    (void)user_ctx;
+    records_parsed++;
+    return true;
+}
+
+static bool
+split_at_line_start(char const * input, size_t input_len, size_t offset, void * user_data)
+{
+    splits_asked++;
+    return epc_split_at_line_start(input, input_len, offset, user_data);
+}
+
+// Says a record may start after '=', which is always wrong.
+static bool
+split_after_equals(char const * input, size_t input_len, size_t offset, void * user_data)
+{
+    (void)input_len;
+    (void)user_data;
+    splits_asked++;
+    return input[offset - 1] == '=';
+}
+
+TEST_GROUP(SplitParseTest)
+{
+    epc_parser_list * list = NULL;
+    char * input = NULL;
+    epc_parse_session_t sequential = {0};
+    epc_parse_session_t split = {0};
+
+    void setup() override
+    {
+        list = epc_parser_list_create();
+        records_parsed = 0;
+        splits_asked = 0;
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&sequential);
+        epc_parse_session_destroy(&split);
+        free(input);
+        epc_parser_list_free(list);
+    }
+
+    // Lines such as "k12=v84".
+    char * make_lines(char value_start = 'v')
+    {
+        char * text = (char *)malloc(LINE_COUNT * 32);
+        char * end = text;
+
+        for (int i = 0; i < LINE_COUNT; i++)
+        {
+            end += sprintf(end, "k%d=%c%d\n", i, value_start, i * 7);
+        }
+
+        return text;
+    }
+
+    // record: 'k' digits '=' value_start digits
+    epc_parser_t * record_parser(char value_start = 'v')
+    {
+        epc_parser_t * key = epc_and_l(
+            list, "key", 2, epc_char_l(list, NULL, 'k'), epc_plus_l(list, NULL, epc_digit_l(list, NULL))
+        );
+        epc_parser_t * value = epc_and_l(
+            list, "value", 2, epc_char_l(list, NULL, value_start), epc_plus_l(list, NULL, epc_digit_l(list, NULL))
+        );
+        epc_parser_t * record = epc_and_l(list, "record", 3, key, epc_char_l(list, NULL, '='), value);
+
+        return epc_satisfy_l(list, "counted", record, "record", count_record, NULL);
+    }
+
+    epc_parse_session_t parse(epc_parser_t * parser, char const * text, size_t thread_count)
+    {
+        epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = text};
+        epc_parse_options_t options = {.thread_count = thread_count};
+
+        return epc_parse_with_options(parser, parse_input, NULL, &options);
+    }
+
+    // Parses `text` sequentially, and then with four threads. Returns how many records the second parse parsed.
+    int parse_both_ways(epc_parser_t * parser, char const * text)
+    {
+        sequential = parse(parser, text, 1);
+        records_parsed = 0;
+        split = parse(parser, text, 4);
+
+        return records_parsed;
+    }
+
+    void check_same_tree()
+    {
+        CHECK_FALSE(sequential.result.is_error);
+        CHECK_FALSE(split.result.is_error);
+
+        char * expected = epc_cpt_to_string(sequential.internal_parse_ctx, sequential.result.data.success);
+        char * actual = epc_cpt_to_string(split.internal_parse_ctx, split.result.data.success);
+
+        STRCMP_EQUAL(expected, actual);
+        free(expected);
+        free(actual);
+    }
+};
+
+TEST(SplitParseTest, ManyRecordsAreParsedInChunks)
+{
+    epc_parser_t * line = epc_and_l(list, "line", 2, record_parser(), epc_char_l(list, NULL, '\n'));
+    epc_parser_t * lines = epc_many_l(list, "lines", line);
+    epc_parser_t * file = epc_and_l(list, "file", 2, lines, epc_eoi_l(list, NULL));
+
+    epc_parser_set_split(lines, split_at_line_start, NULL);
+    input = make_lines();
+
+    int const split_records = parse_both_ways(file, input);
+
+    // Each record was only parsed once, so no chunk had to be parsed again.
+    CHECK_TRUE(splits_asked > 0);
+    LONGS_EQUAL(LINE_COUNT, split_records);
+    LONGS_EQUAL(LINE_COUNT, split.result.data.success->children[0]->children_count);
+    check_same_tree();
+}
+
+TEST(SplitParseTest, DelimitedRecordsAreParsedInChunks)
+{
+    epc_parser_t * lines = epc_delimited_l(list, "lines", record_parser(), epc_char_l(list, "newline", '\n'));
+
+    epc_parser_set_split(lines, split_at_line_start, NULL);
+    input = make_lines();
+    input[strlen(input) - 1] = '\0'; // No delimiter after the last record.
+
+    int const split_records = parse_both_ways(lines, input);
+
+    CHECK_TRUE(splits_asked > 0);
+    LONGS_EQUAL(LINE_COUNT, split_records);
+    LONGS_EQUAL(LINE_COUNT, split.result.data.success->children_count);
+    check_same_tree();
+}
+
+TEST(SplitParseTest, WrongSplitFallsBackToSequentialParse)
+{
+    epc_parser_t * lines = epc_delimited_l(list, "lines", record_parser('k'), epc_char_l(list, "newline", '\n'));
+
+    // Values start with 'k' too, so splitting before them gets past the FIRST set of a record.
+    epc_parser_set_split(lines, split_after_equals, NULL);
+    input = make_lines('k');
+    input[strlen(input) - 1] = '\0';
+
+    int const split_records = parse_both_ways(lines, input);
+
+    // The chunks were parsed, and then the whole input again.
+    CHECK_TRUE(splits_asked > 0);
+    CHECK_TRUE(split_records > LINE_COUNT);
+    LONGS_EQUAL(LINE_COUNT, split.result.data.success->children_count);
+    check_same_tree();
+}
+
+TEST(SplitParseTest, RecordsThatStopInAChunkFallBack)
+{
+    epc_parser_t * line = epc_and_l(list, "line", 2, record_parser(), epc_char_l(list, NULL, '\n'));
+    epc_parser_t * lines = epc_many_l(list, "lines", line);
+
+    epc_parser_set_split(lines, split_at_line_start, NULL);
+    input = make_lines();
+
+    // The records stop at a bad line in the first quarter of the input, so the first chunk doesn't end where the
+    // second starts.
+    char * bad = strstr(input, "\nk3000=");
+    bad[1] = 'x';
+
+    parse_both_ways(lines, input);
+
+    LONGS_EQUAL(3000, split.result.data.success->children_count);
+    LONGS_EQUAL(bad + 1 - input, split.result.data.success->len);
+    check_same_tree();
+}
+
+TEST(SplitParseTest, ErrorIsTheSameAsInASequentialParse)
+{
+    epc_parser_t * line = epc_and_l(list, "line", 2, record_parser(), epc_char_l(list, NULL, '\n'));
+    epc_parser_t * lines = epc_many_l(list, "lines", line);
+    epc_parser_t * file = epc_and_l(list, "file", 2, lines, epc_eoi_l(list, NULL));
+
+    epc_parser_set_split(lines, epc_split_at_line_start, NULL);
+    input = make_lines();
+
+    // A bad line in the last quarter of the input.
+    char * bad = strstr(input, "\nk19000=");
+    bad[5] = 'x';
+
+    parse_both_ways(file, input);
+
+    CHECK_TRUE(sequential.result.is_error);
+    CHECK_TRUE(split.result.is_error);
+    STRCMP_EQUAL(sequential.result.data.error->message, split.result.data.error->message);
+    LONGS_EQUAL(19000, split.result.data.error->position.line);
+    LONGS_EQUAL(sequential.result.data.error->position.col, split.result.data.error->position.col);
+    STRCMP_EQUAL(sequential.result.data.error->expected, split.result.data.error->expected);
+}
+
+TEST(SplitParseTest, ShortInputIsParsedSequentially)
+{
+    epc_parser_t * line = epc_and_l(list, "line", 2, record_parser(), epc_char_l(list, NULL, '\n'));
+    epc_parser_t * lines = epc_many_l(list, "lines", line);
+
+    epc_parser_set_split(lines, split_at_line_start, NULL);
+    input = strdup("k1=v1\nk2=v2\n");
+
+    int const split_records = parse_both_ways(lines, input);
+
+    LONGS_EQUAL(0, splits_asked);
+    LONGS_EQUAL(2, split_records);
+    check_same_tree();
+}
+
+TEST(SplitParseTest, OneThreadIsParsedSequentially)
+{
+    epc_parser_t * line = epc_and_l(list, "line", 2, record_parser(), epc_char_l(list, NULL, '\n'));
+    epc_parser_t * lines = epc_many_l(list, "lines", line);
+
+    epc_parser_set_split(lines, split_at_line_start, NULL);
+    input = make_lines();
+
+    sequential = parse(lines, input, 1);
+
+    LONGS_EQUAL(0, splits_asked);
+    CHECK_FALSE(sequential.result.is_error);
+}
@@ -279,3 +279,158 @@ TEST(StreamingTest, StreamingCCommentTest)
     STRNCMP_EQUAL("/* first part second part*/", session.result.data.success->content, 27);
     LONGS_EQUAL(27, session.result.data.success->len);
 }
+
+TEST(StreamingTest, StreamingInputLargerThanFormerLimitTest)
+{
+    // Input used to be limited to 100 MB.
+    size_t const len = 101 * 1024 * 1024;
+    char * data = (char *)malloc(len + 1);
+
+    memset(data, ' ', len);
+    memcpy(data, "/*", 2);
+    memcpy(data + len - 2, "*/", 2);
+    data[len] = '\0';
+    int fd = start_producer(data);
+
+    epc_parser_t * p = epc_c_comment_l(list, NULL);
+    session = parse_fd(p, fd);
+    pthread_join(producer, NULL);
+    thread_started = false;
+    free(data);
+
+    check_is_success(session.result);
+    LONGS_EQUAL(len, session.result.data.success->len);
+}
+
+struct DiscardState
+{
+    size_t record_len;
+    size_t records;
+};
+
+static bool
+discard_record(epc_parse_result_t result, epc_parser_ctx_t * parse_ctx, void * parser_data)
+{
+    DiscardState * state = (DiscardState *)parser_data;
+
+    if (!result.is_error)
+    {
+        state->records++;
+        epc_parse_ctx_discard_input(parse_ctx, state->records * state->record_len);
+    }
+
+    return true;
+}
+
+// Records of several pages each, so that some of the input is released after each one.
+static size_t const discard_record_len = 4 * 4096;
+static size_t const discard_record_count = 16;
+
+// Lines of 'a' that are each discarded once parsed, followed by `tail`.
+static char *
+make_discarded_records(char const * tail)
+{
+    size_t const len = discard_record_len * discard_record_count;
+    char * data = (char *)malloc(len + strlen(tail) + 1);
+
+    for (size_t i = 0; i < discard_record_count; i++)
+    {
+        memset(data + i * discard_record_len, 'a', discard_record_len - 1);
+        data[(i + 1) * discard_record_len - 1] = '\n';
+    }
+    strcpy(data + len, tail);
+
+    return data;
+}
+
+// With `tokens`, each record collapses into one CPT node.
+static epc_parser_t *
+discarded_record_list(epc_parser_list * list, DiscardState * state, bool tokens)
+{
+    epc_wrap_callbacks_t callbacks = {NULL, discard_record};
+    epc_parser_t * record = epc_wrap_l(
+        list,
+        "record",
+        epc_and_l(list, NULL, 2, epc_plus_l(list, NULL, epc_char_l(list, NULL, 'a')), epc_char_l(list, NULL, '\n')),
+        callbacks,
+        state
+    );
+
+    epc_parser_set_token(record, tokens);
+    return epc_and_l(list, NULL, 2, epc_many_l(list, NULL, record), epc_eoi_l(list, NULL));
+}
+
+TEST(StreamingTest, StreamingDiscardInputTest)
+{
+    size_t const record_len = discard_record_len;
+    size_t const record_count = discard_record_count;
+    char * data = make_discarded_records("");
+    int fd = start_producer(data);
+
+    DiscardState state = {record_len, 0};
+    epc_parser_t * p = discarded_record_list(list, &state, false);
+    session = parse_fd(p, fd);
+    pthread_join(producer, NULL);
+    thread_started = false;
+    free(data);
+
+    check_is_success(session.result);
+    LONGS_EQUAL(record_count, state.records);
+    // Line numbers are still known for the input that was released.
+    epc_line_col_t position = epc_parse_ctx_get_line_col(session.internal_parse_ctx, record_len);
+    LONGS_EQUAL(1, position.line);
+    LONGS_EQUAL(1, position.col);
+    position = epc_parse_ctx_get_line_col(session.internal_parse_ctx, (record_count - 1) * record_len);
+    LONGS_EQUAL(record_count - 1, position.line);
+    LONGS_EQUAL(1, position.col);
+}
+
+TEST(StreamingTest, StreamingDiscardedTokenRecordsKeepOneNodeEachTest)
+{
+    // Discarding releases only the input; making the records tokens is what stops the CPT growing with their size.
+    char * data = make_discarded_records("");
+    int fd = start_producer(data);
+
+    DiscardState state = {discard_record_len, 0};
+    epc_parser_t * p = discarded_record_list(list, &state, true);
+    session = parse_fd(p, fd);
+    pthread_join(producer, NULL);
+    thread_started = false;
+    free(data);
+
+    check_is_success(session.result);
+    LONGS_EQUAL(discard_record_count, state.records);
+
+    epc_cpt_node_t * records = session.result.data.success->children[0];
+    LONGS_EQUAL(discard_record_count, records->children_count);
+    for (int i = 0; i < records->children_count; i++)
+    {
+        LONGS_EQUAL(0, records->children[i]->children_count);
+        LONGS_EQUAL(discard_record_len, records->children[i]->len);
+    }
+}
+
+TEST(StreamingTest, StreamingCompiledMismatchAfterDiscardedInputTest)
+{
+    // The error is reported from where the parse failed, without going back over the released input.
+    char * data = make_discarded_records("X");
+    int fd = start_producer(data);
+
+    DiscardState state = {discard_record_len, 0};
+    epc_parser_t * p = discarded_record_list(list, &state, false);
+    epc_compiled_grammar_t * compiled = epc_grammar_compile(p);
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_FD, .fd = fd};
+
+    CHECK_TRUE(compiled != NULL);
+    session = epc_parse_compiled(compiled, parse_input, NULL, NULL);
+    pthread_join(producer, NULL);
+    thread_started = false;
+    free(data);
+
+    CHECK_TRUE(session.result.is_error);
+    LONGS_EQUAL(discard_record_count, state.records);
+    LONGS_EQUAL(discard_record_count, session.result.data.error->position.line);
+    LONGS_EQUAL(1, session.result.data.error->position.col);
+    STRCMP_EQUAL("X", session.result.data.error->found);
+    epc_compiled_grammar_free(compiled);
+}
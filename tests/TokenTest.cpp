@@ -0,0 +1,242 @@
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "easy_pc_private.h"
+
+#include <stdlib.h> // For free
+#include <string.h>
+}
+
+TEST_GROUP(TokenTest)
+{
+    epc_parser_list * list = NULL;
+    epc_parse_session_t session = {0};
+    epc_compiled_grammar_t * compiled = NULL;
+
+    void setup() override
+    {
+        session = (epc_parse_session_t){0}; // Reset session before each test
+        list = epc_parser_list_create();
+        compiled = NULL;
+    }
+
+    void teardown() override
+    {
+        epc_parse_session_destroy(&session);
+        epc_compiled_grammar_free(compiled);
+        epc_parser_list_free(list);
+    }
+
+    epc_parse_result_t parse(epc_parser_t * parser, char const * input)
+    {
+        epc_parse_session_destroy(&session);
+        session = epc_parse_str(parser, input, NULL);
+        return session.result;
+    }
+
+    // identifier: (alpha | '_') (alphanum | '_')*
+    epc_parser_t * identifier()
+    {
+        epc_parser_t * underscore = epc_char_l(list, NULL, '_');
+
+        return epc_and_l(
+            list,
+            "identifier",
+            2,
+            epc_or_l(list, NULL, 2, epc_alpha_l(list, NULL), underscore),
+            epc_many_l(list, NULL, epc_or_l(list, NULL, 2, epc_alphanum_l(list, NULL), underscore))
+        );
+    }
+
+    // Identifiers and numbers separated by spaces, to the end of the input.
+    epc_parser_t * word_list(epc_parser_t * word, epc_parser_t * number)
+    {
+        epc_parser_t * item = epc_lexeme_l(list, "item", epc_or_l(list, "word_or_number", 2, word, number));
+        epc_parser_t * spaces = epc_many_l(list, NULL, epc_space_l(list, NULL));
+
+        return epc_and_l(list, "words", 3, spaces, epc_many_l(list, NULL, item), epc_eoi_l(list, NULL));
+    }
+
+    void check_leaf(epc_cpt_node_t * node, char const * name, char const * text)
+    {
+        STRCMP_EQUAL(name, node->name);
+        LONGS_EQUAL(strlen(text), node->len);
+        STRNCMP_EQUAL(text, node->content, strlen(text));
+        LONGS_EQUAL(0, node->children_count);
+        POINTERS_EQUAL(NULL, node->children);
+    }
+
+    // Checks that `actual` is `expected` with the subtree of each identifier and number replaced by a leaf covering the
+    // same input.
+    void check_collapsed(epc_cpt_node_t const * expected, epc_cpt_node_t const * actual)
+    {
+        STRCMP_EQUAL(expected->name, actual->name);
+        STRCMP_EQUAL(expected->tag, actual->tag);
+        LONGS_EQUAL(expected->len, actual->len);
+        STRNCMP_EQUAL(expected->content, actual->content, expected->len);
+        LONGS_EQUAL(expected->semantic_start_offset, actual->semantic_start_offset);
+        LONGS_EQUAL(expected->semantic_end_offset, actual->semantic_end_offset);
+        bool const is_token
+            = expected->name != NULL && (strcmp(expected->name, "identifier") == 0 || strcmp(expected->name, "number") == 0);
+
+        if (is_token)
+        {
+            LONGS_EQUAL(0, actual->children_count);
+            return;
+        }
+        LONGS_EQUAL(expected->children_count, actual->children_count);
+        for (int i = 0; i < expected->children_count; i++)
+        {
+            check_collapsed(expected->children[i], actual->children[i]);
+        }
+    }
+};
+
+TEST(TokenTest, TokenIsALeafCoveringItsMatch)
+{
+    epc_parser_t * p = identifier();
+
+    epc_parser_set_token(p, true);
+    epc_parse_result_t result = parse(p, "_snake_case2 rest");
+
+    CHECK_FALSE(result.is_error);
+    check_leaf(result.data.success, "identifier", "_snake_case2");
+    STRCMP_EQUAL(p->tag, result.data.success->tag);
+}
+
+TEST(TokenTest, TokensWithinATreeAreLeaves)
+{
+    epc_parser_t * word = identifier();
+    epc_parser_t * number = epc_plus_l(list, "number", epc_digit_l(list, NULL));
+    epc_parser_t * p = word_list(word, number);
+    char const * input = "  alpha 42 beta_2   7 ";
+    epc_parse_session_t expected_session = epc_parse_str(p, input, NULL);
+
+    epc_parser_set_token(word, true);
+    epc_parser_set_token(number, true);
+    epc_parse_result_t result = parse(p, input);
+
+    CHECK_FALSE(expected_session.result.is_error);
+    CHECK_FALSE(result.is_error);
+    check_collapsed(expected_session.result.data.success, result.data.success);
+
+    epc_cpt_node_t * items = result.data.success->children[1];
+    LONGS_EQUAL(4, items->children_count);
+    check_leaf(items->children[0]->children[0]->children[0], "identifier", "alpha");
+    check_leaf(items->children[1]->children[0]->children[0], "number", "42");
+    epc_parse_session_destroy(&expected_session);
+}
+
+TEST(TokenTest, SemanticContentIsKept)
+{
+    epc_parser_t * p = epc_lexeme_l(list, "lexeme", identifier());
+
+    epc_parser_set_token(p, true);
+    epc_parse_result_t result = parse(p, "  name  ");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(0, result.data.success->children_count);
+    LONGS_EQUAL(8, epc_cpt_node_get_len(result.data.success));
+    LONGS_EQUAL(4, epc_cpt_node_get_semantic_len(result.data.success));
+    STRNCMP_EQUAL("name", epc_cpt_node_get_semantic_content(result.data.success), 4);
+}
+
+TEST(TokenTest, ErrorsAreUnchanged)
+{
+    epc_parser_t * word = identifier();
+    epc_parser_t * p = word_list(word, epc_int_l(list, "number"));
+    epc_parse_session_t expected_session = epc_parse_str(p, "abc 12 $", NULL);
+
+    epc_parser_set_token(word, true);
+    epc_parse_result_t result = parse(p, "abc 12 $");
+
+    CHECK_TRUE(result.is_error);
+    STRCMP_EQUAL(expected_session.result.data.error->message, result.data.error->message);
+    STRCMP_EQUAL(expected_session.result.data.error->expected, result.data.error->expected);
+    STRCMP_EQUAL(expected_session.result.data.error->found, result.data.error->found);
+    LONGS_EQUAL(expected_session.result.data.error->position.col, result.data.error->position.col);
+    epc_parse_session_destroy(&expected_session);
+}
+
+TEST(TokenTest, MemoizedTokensAreShared)
+{
+    // Both alternatives start with the identifier, which is only parsed once.
+    epc_parser_t * word = identifier();
+    epc_parser_t * call = epc_and_l(list, "call", 2, word, epc_char_l(list, NULL, '('));
+    epc_parser_t * p = epc_or_l(list, "expression", 2, call, word);
+
+    epc_parser_set_token(word, true);
+    epc_parser_set_memoize(word, true);
+    epc_parse_result_t result = parse(p, "name");
+
+    CHECK_FALSE(result.is_error);
+    check_leaf(result.data.success->children[0], "identifier", "name");
+
+    epc_parse_options_t options = {.memoize = true};
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = "name("};
+    epc_parse_session_destroy(&session);
+    session = epc_parse_with_options(p, parse_input, NULL, &options);
+    CHECK_FALSE(session.result.is_error);
+    check_leaf(session.result.data.success->children[0]->children[0], "identifier", "name");
+}
+
+TEST(TokenTest, CompiledGrammarBuildsTheSameTree)
+{
+    epc_parser_t * word = identifier();
+    epc_parser_t * number = epc_plus_l(list, "number", epc_digit_l(list, NULL));
+    epc_parser_t * sign = epc_optional_l(list, "sign", epc_one_of_l(list, NULL, "+-"));
+    epc_parser_t * signed_number = epc_or_l(list, "signed", 2, epc_and_l(list, NULL, 2, sign, number), word);
+    epc_parser_t * p = word_list(word, signed_number);
+    char const * input = "x1 -12 y +3 4";
+
+    epc_parser_set_token(word, true);
+    epc_parser_set_token(number, true);
+    epc_parser_set_token(signed_number, true);
+    compiled = epc_grammar_compile(p);
+    CHECK_TRUE(compiled != NULL);
+
+    epc_parse_input_t parse_input = {.type = EPC_PARSE_TYPE_STRING, .input_string = input};
+    epc_parse_session_t vm = epc_parse_compiled(compiled, parse_input, NULL, NULL);
+    epc_parse_result_t result = parse(p, input);
+
+    CHECK_FALSE(result.is_error);
+    CHECK_FALSE(vm.result.is_error);
+
+    char * expected = epc_cpt_to_string(session.internal_parse_ctx, result.data.success);
+    char * actual = epc_cpt_to_string(vm.internal_parse_ctx, vm.result.data.success);
+
+    STRCMP_EQUAL(expected, actual);
+    LONGS_EQUAL(0, vm.result.data.success->children[1]->children[1]->children[0]->children[0]->children_count);
+    free(expected);
+    free(actual);
+    epc_parse_session_destroy(&vm);
+}
+
+TEST(TokenTest, AstActionSeesTheTokenText)
+{
+    epc_parser_t * p = identifier();
+
+    epc_parser_set_token(p, true);
+    epc_parser_set_ast_action(p, 0);
+    epc_parse_result_t result = parse(p, "abc");
+
+    CHECK_FALSE(result.is_error);
+    CHECK_TRUE(result.data.success->ast_config.assigned);
+    LONGS_EQUAL(0, result.data.success->ast_config.action);
+}
+
+TEST(TokenTest, TokenFlagIsCopiedByDuplicate)
+{
+    epc_parser_t * word = identifier();
+    epc_parser_t * item = epc_parser_fwd_decl_l(list, "item");
+
+    epc_parser_set_token(word, true);
+    epc_parser_duplicate(item, word);
+    epc_parse_result_t result = parse(item, "abc");
+
+    CHECK_FALSE(result.is_error);
+    LONGS_EQUAL(0, result.data.success->children_count);
+
+    epc_parser_set_token(item, false);
+    LONGS_EQUAL(2, parse(item, "abc").data.success->children_count);
+}
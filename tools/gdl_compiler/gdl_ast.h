@@ -41,6 +41,7 @@ typedef enum epc_ast_user_defined_action_gdl
     GDL_AST_ACTION_CREATE_FAIL_CALL,
     GDL_AST_ACTION_CREATE_SATISFY_CALL,
     GDL_AST_ACTION_CREATE_WRAP_CALL,
+    GDL_AST_ACTION_CREATE_SPLIT_CALL,
     GDL_AST_ACTION_MAX,
 } epc_ast_user_defined_action_gdl;
 
@@ -74,6 +75,7 @@ typedef enum
     GDL_AST_NODE_TYPE_COMBINATOR_SKIP,
     GDL_AST_NODE_TYPE_COMBINATOR_CHAINL1,
     GDL_AST_NODE_TYPE_COMBINATOR_CHAINR1,
+    GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS, // Added by the optimiser for an alternation of literals
     GDL_AST_NODE_TYPE_FAIL_CALL,
     GDL_AST_NODE_TYPE_SEQUENCE,
     GDL_AST_NODE_TYPE_ALTERNATIVE,
@@ -81,6 +83,7 @@ typedef enum
     GDL_AST_NODE_TYPE_ARGUMENT_LIST,
     GDL_AST_NODE_TYPE_SATISFY_CALL,
     GDL_AST_NODE_TYPE_WRAP_CALL,
+    GDL_AST_NODE_TYPE_SPLIT_CALL,
 } gdl_ast_node_type_t;
 
 // Forward declaration for gdl_ast_node_t
@@ -111,6 +114,7 @@ typedef struct
     char const * name;
     gdl_ast_node_t * definition;
     gdl_ast_node_t * semantic_action; // Optional
+    bool is_token;                    // Set by a 'token' prefix: the rule's matches are single CPT nodes.
 } gdl_ast_rule_definition_t;
 
 typedef struct
@@ -200,6 +204,11 @@ typedef struct
     gdl_ast_node_t * op_expr;
 } gdl_ast_combinator_chain_t; // For chainl1, chainr1
 
+typedef struct
+{
+    gdl_ast_list_t keywords; // GDL_AST_NODE_TYPE_STRING_LITERAL nodes, in the order they were written
+} gdl_ast_combinator_keywords_t;
+
 typedef struct
 {
     gdl_ast_list_t elements; // List of gdl_ast_node_t
@@ -235,10 +244,18 @@ typedef struct
     char const * parser_data_name;
 } gdl_ast_wrap_call_t;
 
+typedef struct
+{
+    gdl_ast_node_t * expr; // A repetition or delimited() call.
+    char const * split_fn_name;
+    char const * split_data_name;
+} gdl_ast_split_call_t;
+
 // Main GDL AST Node structure
 struct gdl_ast_node_t
 {
     gdl_ast_node_type_t type;
+    char const * name; // The rule's name, on the definition of a rule that the optimiser inlined. NULL otherwise.
     union
     {
         gdl_ast_program_t program;
@@ -261,12 +278,14 @@ struct gdl_ast_node_t
         gdl_ast_combinator_delimited_t delimited_call;
         gdl_ast_combinator_unary_t unary_combinator_call;
         gdl_ast_combinator_chain_t chain_combinator_call;
+        gdl_ast_combinator_keywords_t keywords_call;
         gdl_ast_sequence_t sequence;
         gdl_ast_alternative_t alternative;
         gdl_ast_optional_expression_t optional;
         gdl_ast_list_t argument_list;
         gdl_ast_satisfy_call_t satisfy_call;
         gdl_ast_wrap_call_t wrap_call;
+        gdl_ast_split_call_t split_call;
     } data;
 };
 
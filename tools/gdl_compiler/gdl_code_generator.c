@@ -1,5 +1,7 @@
 #include "gdl_code_generator.h"
 
+#include "gdl_direct_generator.h"
+
 #include <ctype.h> // For isalnum, isdigit, etc.
 #include <stdio.h>
 #include <stdlib.h>
@@ -68,6 +70,12 @@ to_pascal_case(char const * str)
     return pascal_str;
 }
 
+char *
+gdl_rule_variable_name(char const * rule_name)
+{
+    return to_pascal_case(rule_name);
+}
+
 // Function to convert a string to uppercase with underscores, handling existing underscores gracefully
 static char *
 to_upper_case(char const * str)
@@ -322,7 +330,12 @@ traverse_expression_for_references(
     case GDL_AST_NODE_TYPE_IDENTIFIER_REF:
     {
         gdl_rule_info_t * referenced_rule = gdl_rule_list_find(all_rules, expression_node->data.identifier_ref.name);
-        if (referenced_rule != NULL && referenced_rule != current_rule_info)
+        if (referenced_rule != NULL && referenced_rule == current_rule_info)
+        {
+            // A rule that refers to itself (e.g. Expr = Expr '-' Number | Number) is used before it is defined.
+            referenced_rule->needs_forward_declaration = true;
+        }
+        else if (referenced_rule != NULL)
         {
             // Check if the referenced rule appears later in the list than the current rule
             gdl_rule_info_t * temp_current = all_rules->head;
@@ -413,6 +426,7 @@ traverse_expression_for_references(
     case GDL_AST_NODE_TYPE_COMBINATOR_SKIP:
     case GDL_AST_NODE_TYPE_COMBINATOR_CHAINL1:
     case GDL_AST_NODE_TYPE_COMBINATOR_CHAINR1:
+    case GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS:
     case GDL_AST_NODE_TYPE_FAIL_CALL:
     case GDL_AST_NODE_TYPE_PROGRAM:         // Should not happen here
     case GDL_AST_NODE_TYPE_RULE_DEFINITION: // Should not happen here
@@ -422,6 +436,10 @@ traverse_expression_for_references(
     case GDL_AST_NODE_TYPE_WRAP_CALL:
         // These nodes do not contain further rule references in this context
         break;
+
+    case GDL_AST_NODE_TYPE_SPLIT_CALL:
+        traverse_expression_for_references(expression_node->data.split_call.expr, current_rule_info, all_rules);
+        break;
     }
 }
 
@@ -464,6 +482,14 @@ gdl_analyze_rule_dependencies(gdl_ast_node_t * ast_root, gdl_rule_list_t * rule_
 
 bool
 gdl_generate_c_code(gdl_ast_node_t * ast_root, char const * base_name, char const * output_dir)
+{
+    return gdl_generate_c_code_with_mode(ast_root, base_name, output_dir, GDL_EMIT_GRAPH);
+}
+
+bool
+gdl_generate_c_code_with_mode(
+    gdl_ast_node_t * ast_root, char const * base_name, char const * output_dir, gdl_emit_mode_t mode
+)
 {
     if (ast_root == NULL || ast_root->type != GDL_AST_NODE_TYPE_PROGRAM || base_name == NULL || output_dir == NULL)
     {
@@ -526,6 +552,26 @@ gdl_generate_c_code(gdl_ast_node_t * ast_root, char const * base_name, char cons
     fprintf(source_file, "#include <stdio.h>\n");  // For debugging, if needed
     fprintf(source_file, "\n");
 
+    gdl_direct_generator_t * direct_generator = NULL;
+
+    if (mode == GDL_EMIT_DIRECT)
+    {
+        fprintf(source_file, "#include <ctype.h>\n");
+        fprintf(source_file, "#include <easy_pc/easy_pc_direct.h>\n");
+        fprintf(source_file, "#include <stdbool.h>\n");
+        fprintf(source_file, "#include <string.h>\n");
+        fprintf(source_file, "\n");
+
+        direct_generator = gdl_direct_generator_create(ast_root);
+        if (direct_generator == NULL || !gdl_direct_generate_functions(direct_generator, source_file))
+        {
+            gdl_direct_generator_free(direct_generator);
+            fclose(source_file);
+            gdl_rule_list_free(&rule_dependencies);
+            return false;
+        }
+    }
+
     fprintf(source_file, "epc_parser_t * create_%s_parser(epc_parser_list * list)\n", base_name);
     fprintf(source_file, "{\n");
 
@@ -578,7 +624,15 @@ gdl_generate_c_code(gdl_ast_node_t * ast_root, char const * base_name, char cons
 
     // Return the Program rule parser
     char * pascal_program_name = to_pascal_case(ast_root->data.program.rules.tail->item->data.rule_def.name);
-    fprintf(source_file, "    return %s;\n", pascal_program_name);
+    if (direct_generator != NULL)
+    {
+        gdl_direct_generate_return(direct_generator, source_file, pascal_program_name);
+        gdl_direct_generator_free(direct_generator);
+    }
+    else
+    {
+        fprintf(source_file, "    return %s;\n", pascal_program_name);
+    }
     free(pascal_program_name);
 
     fprintf(source_file, "}\n");
@@ -642,6 +696,10 @@ generate_rule_definition_code(
             );
             free(upper_case_action);
         }
+        if (rule_node->data.rule_def.is_token)
+        {
+            fprintf(source_file, "%*sepc_parser_set_token(%s, true);\n", indent_level * 4, "", pascal_rule_name);
+        }
     }
     else
     {
@@ -674,6 +732,10 @@ generate_rule_definition_code(
             );
             free(upper_case_action);
         }
+        if (rule_node->data.rule_def.is_token)
+        {
+            fprintf(source_file, "%*sepc_parser_set_token(%s_def, true);\n", indent_level * 4, "", pascal_rule_name);
+        }
         // Be sure to assign the action _before_ duplicating the parser_list_duplicate so the forward
         // reference also gets the action assigned
         fprintf(
@@ -705,6 +767,10 @@ generate_expression_code(
     char const * null = "NULL";
     char const * q;
     char const * expr_name;
+    if (expression_name == NULL && expression_node != NULL)
+    {
+        expression_name = expression_node->name;
+    }
     if (expression_name == NULL)
     {
         q = empty;
@@ -1142,6 +1208,23 @@ generate_expression_code(
         break;
     }
 
+    case GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS:
+        fprintf(
+            source_file,
+            "epc_keywords_l(list, %s%s%s, %d",
+            q,
+            expr_name,
+            q,
+            expression_node->data.keywords_call.keywords.count
+        );
+        for (gdl_ast_list_node_t * keyword = expression_node->data.keywords_call.keywords.head; keyword != NULL;
+             keyword = keyword->next)
+        {
+            fprintf(source_file, ", \"%s\"", keyword->item->data.string_literal.value);
+        }
+        fprintf(source_file, ")");
+        break;
+
     case GDL_AST_NODE_TYPE_SATISFY_CALL:
     {
         fprintf(source_file, "epc_satisfy_l(list, %s%s%s, ", q, expr_name, q);
@@ -1179,6 +1262,25 @@ generate_expression_code(
         break;
     }
 
+    case GDL_AST_NODE_TYPE_SPLIT_CALL:
+    {
+        // The split parser is the repetition itself, so it gets the name.
+        fprintf(source_file, "epc_parser_set_split(");
+        if (!generate_expression_code(
+                source_file, expression_node->data.split_call.expr, indent_level + 1, rule_list, expression_name
+            ))
+        {
+            return false;
+        }
+        fprintf(
+            source_file,
+            ", %s, %s)",
+            expression_node->data.split_call.split_fn_name,
+            expression_node->data.split_call.split_data_name
+        );
+        break;
+    }
+
         // Handle other AST node types as needed
     default:
         fprintf(stderr, "Error: Unsupported AST node type for code generation: %d\n", expression_node->type);
@@ -14,9 +14,24 @@ typedef struct semantic_action_node
 } semantic_action_node_t;
 
 
+// What create_<base>_parser() returns
+typedef enum gdl_emit_mode_t
+{
+    GDL_EMIT_GRAPH,  // The graph of combinators built from the rules.
+    GDL_EMIT_DIRECT, // A direct parser that runs generated C functions over that graph (see gdl_direct_generator.h).
+} gdl_emit_mode_t;
+
 // Function to generate C code from the GDL AST
 bool gdl_generate_c_code(gdl_ast_node_t * ast_root, const char * base_name, const char * output_dir);
 
+// As gdl_generate_c_code(), with a choice of the kind of parser to generate
+bool gdl_generate_c_code_with_mode(
+    gdl_ast_node_t * ast_root, const char * base_name, const char * output_dir, gdl_emit_mode_t mode
+);
+
+// Returns the name of the C variable that holds the parser for a rule. The caller must free it.
+char * gdl_rule_variable_name(char const * rule_name);
+
 // Function to collect all unique semantic action names from the AST
 semantic_action_node_t * gdl_collect_semantic_actions(gdl_ast_node_t * ast_root);
 
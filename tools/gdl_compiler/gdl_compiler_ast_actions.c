@@ -206,6 +206,10 @@ gdl_ast_node_free(void * node_ptr, void * user_data)
         gdl_ast_list_free_recursive(&node->data.argument_list, user_data);
         break;
 
+    case GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS:
+        gdl_ast_list_free_recursive(&node->data.keywords_call.keywords, user_data);
+        break;
+
     case GDL_AST_NODE_TYPE_CHAR_LITERAL: // The 'char' is actually a string, because it may contain escape chars.
         free(node->data.char_literal.value);
         break;
@@ -223,6 +227,12 @@ gdl_ast_node_free(void * node_ptr, void * user_data)
         free((char *)node->data.wrap_call.parser_data_name);
         break;
 
+    case GDL_AST_NODE_TYPE_SPLIT_CALL:
+        gdl_ast_node_free(node->data.split_call.expr, user_data);
+        free((char *)node->data.split_call.split_fn_name);
+        free((char *)node->data.split_call.split_data_name);
+        break;
+
         /* The following node types have no dynamic data to free. */
     case GDL_AST_NODE_TYPE_NUMBER_LITERAL:      // No dynamic data to free
     case GDL_AST_NODE_TYPE_CHAR_RANGE:          // No dynamic data to free
@@ -232,6 +242,7 @@ gdl_ast_node_free(void * node_ptr, void * user_data)
         break;
     }
 
+    free((char *)node->name);
     free(node);
 }
 
@@ -807,6 +818,17 @@ handle_create_rule_definition(
 #endif
 
     (void)node;
+
+    // A 'token' prefix comes first, as a keyword.
+    gdl_ast_node_t * token_node = NULL;
+
+    if (count > 0 && ((gdl_ast_node_t *)children[0])->type == GDL_AST_NODE_TYPE_KEYWORD)
+    {
+        token_node = (gdl_ast_node_t *)children[0];
+        children++;
+        count--;
+    }
+
     if (count < 2 || count > 3)
     {
         epc_ast_builder_set_error(
@@ -814,6 +836,7 @@ handle_create_rule_definition(
             "Rule definition expects 2 or 3 children (identifier, definition, optional_semantic_action), got %d",
             count
         );
+        gdl_ast_node_free(token_node, user_data);
         for (int i = 0; i < count; ++i)
         {
             gdl_ast_node_free(children[i], user_data);
@@ -824,7 +847,9 @@ handle_create_rule_definition(
     gdl_ast_node_t * identifier_ref_node = (gdl_ast_node_t *)children[0];
     gdl_ast_node_t * definition_node = (gdl_ast_node_t *)children[1];
     gdl_ast_node_t * semantic_action_node = NULL;
+    bool const is_token = token_node != NULL;
 
+    gdl_ast_node_free(token_node, user_data);
     if (count == 3)
     {
         semantic_action_node = (gdl_ast_node_t *)children[2];
@@ -846,6 +871,7 @@ handle_create_rule_definition(
         identifier_ref_node->data.identifier_ref.name = NULL;                              // Prevent double free
         rule_def_node->data.rule_def.definition = definition_node;
         rule_def_node->data.rule_def.semantic_action = semantic_action_node;
+        rule_def_node->data.rule_def.is_token = is_token;
         epc_ast_push(ctx, rule_def_node);
     }
     gdl_ast_node_free(identifier_ref_node, user_data); // Free wrapper node (IdentifierRef node)
@@ -1739,6 +1765,60 @@ handle_create_wrap_call(
     epc_ast_push(ctx, wrap_node);
 }
 
+static void
+handle_create_split_call(
+    epc_ast_builder_ctx_t * ctx, epc_cpt_node_t * node, void ** children, int count, void * user_data
+)
+{
+    (void)node;
+    if (count != 3)
+    {
+        epc_ast_builder_set_error(
+            ctx, "Split call expects 3 children (arg_expr, split_fn_name, split_data_name), got %d", count
+        );
+        for (int i = 0; i < count; ++i)
+        {
+            gdl_ast_node_free(children[i], user_data);
+        }
+        return;
+    }
+
+    gdl_ast_node_t * expr_node = (gdl_ast_node_t *)children[0];
+    gdl_ast_node_t * split_fn_node = (gdl_ast_node_t *)children[1];
+    gdl_ast_node_t * split_data_node = (gdl_ast_node_t *)children[2];
+    if (split_fn_node->type != GDL_AST_NODE_TYPE_IDENTIFIER_REF
+        || split_data_node->type != GDL_AST_NODE_TYPE_IDENTIFIER_REF)
+    {
+        epc_ast_builder_set_error(ctx, "Split call expects split function and split data identifiers.");
+        for (int i = 0; i < count; ++i)
+        {
+            gdl_ast_node_free(children[i], user_data);
+        }
+        return;
+    }
+
+    gdl_ast_node_t * split_node = gdl_ast_node_alloc(ctx, GDL_AST_NODE_TYPE_SPLIT_CALL);
+    if (split_node == NULL)
+    {
+        epc_ast_builder_set_error(ctx, "Failed to allocate split call node.");
+        for (int i = 0; i < count; ++i)
+        {
+            gdl_ast_node_free(children[i], user_data);
+        }
+        return;
+    }
+
+    split_node->data.split_call.expr = expr_node;
+    split_node->data.split_call.split_fn_name = split_fn_node->data.identifier_ref.name;
+    split_fn_node->data.identifier_ref.name = NULL; // Transfer ownership
+    gdl_ast_node_free(split_fn_node, user_data);
+    split_node->data.split_call.split_data_name = split_data_node->data.identifier_ref.name;
+    split_data_node->data.identifier_ref.name = NULL; // Transfer ownership
+    gdl_ast_node_free(split_data_node, user_data);
+
+    epc_ast_push(ctx, split_node);
+}
+
 // --- Registry Initialization ---
 void
 gdl_ast_hook_registry_init(epc_ast_hook_registry_t * registry, void * user_data)
@@ -1793,4 +1873,5 @@ gdl_ast_hook_registry_init(epc_ast_hook_registry_t * registry, void * user_data)
     epc_ast_hook_registry_set_action(registry, GDL_AST_ACTION_CREATE_FAIL_CALL, handle_create_fail_call);
     epc_ast_hook_registry_set_action(registry, GDL_AST_ACTION_CREATE_SATISFY_CALL, handle_create_satisfy_call);
     epc_ast_hook_registry_set_action(registry, GDL_AST_ACTION_CREATE_WRAP_CALL, handle_create_wrap_call);
+    epc_ast_hook_registry_set_action(registry, GDL_AST_ACTION_CREATE_SPLIT_CALL, handle_create_split_call);
 }
\ No newline at end of file
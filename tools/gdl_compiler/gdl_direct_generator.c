@@ -0,0 +1,1262 @@
+#include "gdl_direct_generator.h"
+
+#include "first_set.h"
+#include "gdl_code_generator.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Alternatives are only dispatched on the next byte if there are no more than this many of them.
+#define MAX_DISPATCHED_ALTERNATIVES 64
+
+// A growable string, used to build functions while the helper functions they call are being generated.
+typedef struct text_t
+{
+    char * buf;
+    size_t len;
+    size_t capacity;
+} text_t;
+
+typedef enum first_set_state_t
+{
+    FIRST_SET_UNKNOWN,
+    FIRST_SET_COMPUTING,
+    FIRST_SET_KNOWN,
+} first_set_state_t;
+
+typedef struct direct_rule_t
+{
+    gdl_ast_node_t * rule_def;
+    char * variable; // The variable that holds the rule's graph parser.
+    int helper_count;
+    first_set_t first;
+    first_set_state_t first_state;
+    bool is_left_recursive; // Its matches are grown from a seed, which only its graph parser does.
+} direct_rule_t;
+
+struct gdl_direct_generator_t
+{
+    direct_rule_t * rules;
+    size_t rule_count;
+
+    char ** sites; // For each site, the C expression that finds its graph parser.
+    size_t site_count;
+    size_t site_capacity;
+
+    text_t prototypes;
+    text_t definitions;
+    bool failed;
+};
+
+// --- Text ---
+
+static void
+text_vprintf(text_t * text, bool * failed, char const * format, va_list args)
+{
+    va_list copy;
+
+    va_copy(copy, args);
+    int const needed = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if (needed < 0)
+    {
+        *failed = true;
+        return;
+    }
+    if (text->len + (size_t)needed + 1 > text->capacity)
+    {
+        size_t capacity = text->capacity == 0 ? 1024 : text->capacity;
+
+        while (text->len + (size_t)needed + 1 > capacity)
+        {
+            capacity *= 2;
+        }
+
+        char * buf = realloc(text->buf, capacity);
+
+        if (buf == NULL)
+        {
+            *failed = true;
+            return;
+        }
+        text->buf = buf;
+        text->capacity = capacity;
+    }
+    vsnprintf(text->buf + text->len, (size_t)needed + 1, format, args);
+    text->len += (size_t)needed;
+}
+
+static void
+text_printf(gdl_direct_generator_t * gen, text_t * text, char const * format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    text_vprintf(text, &gen->failed, format, args);
+    va_end(args);
+}
+
+static void
+text_append(gdl_direct_generator_t * gen, text_t * dst, text_t const * src)
+{
+    if (src->len > 0)
+    {
+        text_printf(gen, dst, "%s", src->buf);
+    }
+}
+
+static void
+text_free(text_t * text)
+{
+    free(text->buf);
+    *text = (text_t){0};
+}
+
+// Returns a newly allocated formatted string, or NULL if memory ran out.
+static char *
+format_string(char const * format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    int const needed = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (needed < 0)
+    {
+        return NULL;
+    }
+
+    char * str = malloc((size_t)needed + 1);
+
+    if (str != NULL)
+    {
+        va_start(args, format);
+        vsnprintf(str, (size_t)needed + 1, format, args);
+        va_end(args);
+    }
+
+    return str;
+}
+
+// --- Grammar helpers ---
+
+// Skips the nodes that don't create a parser of their own: terminals, and sequences and alternatives of one element.
+static gdl_ast_node_t *
+unwrap(gdl_ast_node_t * node)
+{
+    for (;;)
+    {
+        if (node->type == GDL_AST_NODE_TYPE_TERMINAL)
+        {
+            node = node->data.terminal.expression;
+        }
+        else if (node->type == GDL_AST_NODE_TYPE_SEQUENCE && node->data.sequence.elements.count == 1)
+        {
+            node = node->data.sequence.elements.head->item;
+        }
+        else if (node->type == GDL_AST_NODE_TYPE_ALTERNATIVE && node->data.alternative.alternatives.count == 1)
+        {
+            node = node->data.alternative.alternatives.head->item;
+        }
+        else
+        {
+            return node;
+        }
+    }
+}
+
+static direct_rule_t *
+find_rule(gdl_direct_generator_t * gen, char const * name)
+{
+    for (size_t i = 0; i < gen->rule_count; i++)
+    {
+        if (strcmp(gen->rules[i].rule_def->data.rule_def.name, name) == 0)
+        {
+            return &gen->rules[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Returns the child expression of the combinators that have exactly one.
+static gdl_ast_node_t *
+single_child(gdl_ast_node_t * node)
+{
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_REPETITION_EXPRESSION:
+        return node->data.repetition_expr.expression;
+    case GDL_AST_NODE_TYPE_OPTIONAL_EXPRESSION:
+        return node->data.optional.expr;
+    case GDL_AST_NODE_TYPE_COMBINATOR_COUNT:
+        return node->data.count_call.expression;
+    case GDL_AST_NODE_TYPE_COMBINATOR_LOOKAHEAD:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NOT:
+        return node->data.unary_combinator_call.expr;
+    default:
+        return NULL;
+    }
+}
+
+// Returns the byte that the C character literal body `s` (e.g. `a` or `\n`) starts with, or -1 if it isn't known.
+static int
+literal_first_byte(char const * s)
+{
+    if (s[0] != '\\')
+    {
+        return (unsigned char)s[0];
+    }
+
+    static char const escapes[] = "n\nt\tr\rv\vf\fa\ab\b\\\\''\"\"??";
+
+    for (size_t i = 0; escapes[i] != '\0'; i += 2)
+    {
+        if (s[1] == escapes[i])
+        {
+            return (unsigned char)escapes[i + 1];
+        }
+    }
+    if (s[1] == '0' && (s[2] == '\0' || !isdigit((unsigned char)s[2])))
+    {
+        return 0;
+    }
+
+    return -1;
+}
+
+// Adds the bytes accepted by a <ctype.h> classifier, as the library's FIRST sets do.
+static void
+first_set_add_class(first_set_t * first, int (*is_class)(int))
+{
+    for (int c = 0; c <= SCHAR_MAX; c++)
+    {
+        if (is_class(c))
+        {
+            first_set_add(first, (unsigned char)c);
+        }
+    }
+    first_set_add_range(first, SCHAR_MAX + 1, UCHAR_MAX);
+}
+
+static void expression_first_set(gdl_direct_generator_t * gen, gdl_ast_node_t * node, first_set_t * first);
+
+static void
+rule_first_set(gdl_direct_generator_t * gen, direct_rule_t * rule, first_set_t * first)
+{
+    if (rule->first_state == FIRST_SET_COMPUTING)
+    {
+        // Left recursion; nothing can be ruled out.
+        rule->is_left_recursive = true;
+        first_set_add_all(first);
+        first->nullable = true;
+        return;
+    }
+    if (rule->first_state == FIRST_SET_UNKNOWN)
+    {
+        rule->first_state = FIRST_SET_COMPUTING;
+        rule->first = (first_set_t){0};
+        expression_first_set(gen, rule->rule_def->data.rule_def.definition, &rule->first);
+        rule->first_state = FIRST_SET_KNOWN;
+    }
+    *first = rule->first;
+}
+
+// Computes the bytes an expression may start with. The set only has to include every byte the expression can match
+// first, so anything that is hard to work out is assumed to match anything.
+static void
+expression_first_set(gdl_direct_generator_t * gen, gdl_ast_node_t * node, first_set_t * first)
+{
+    node = unwrap(node);
+    *first = (first_set_t){0};
+
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_IDENTIFIER_REF:
+    {
+        direct_rule_t * rule = find_rule(gen, node->data.identifier_ref.name);
+
+        if (rule != NULL)
+        {
+            rule_first_set(gen, rule, first);
+            return;
+        }
+        break;
+    }
+
+    case GDL_AST_NODE_TYPE_CHAR_LITERAL:
+    {
+        int const c = literal_first_byte(node->data.char_literal.value);
+
+        if (c < 0)
+        {
+            break;
+        }
+        first_set_add(first, (unsigned char)c);
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_STRING_LITERAL:
+    {
+        char const * s = node->data.string_literal.value;
+        int const c = s[0] != '\0' ? literal_first_byte(s) : -1;
+
+        if (c < 0)
+        {
+            break;
+        }
+        first_set_add(first, (unsigned char)c);
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS:
+        for (gdl_ast_list_node_t * keyword = node->data.keywords_call.keywords.head; keyword != NULL;
+             keyword = keyword->next)
+        {
+            char const * s = keyword->item->data.string_literal.value;
+            int const c = s[0] != '\0' ? literal_first_byte(s) : -1;
+
+            if (c < 0)
+            {
+                first_set_add_all(first);
+                first->nullable = true;
+                return;
+            }
+            first_set_add(first, (unsigned char)c);
+        }
+        return;
+
+    case GDL_AST_NODE_TYPE_CHAR_RANGE:
+        for (int c = CHAR_MIN; c <= CHAR_MAX; c++)
+        {
+            if ((char)c >= node->data.char_range.start_char && (char)c <= node->data.char_range.end_char)
+            {
+                first_set_add(first, (unsigned char)c);
+            }
+        }
+        return;
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_ONEOF:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NONEOF:
+    {
+        char const * chars = node->data.none_or_one_of_call.args;
+
+        if (chars == NULL || strchr(chars, '\\') != NULL)
+        {
+            first_set_add_all(first);
+            return;
+        }
+        if (node->type == GDL_AST_NODE_TYPE_COMBINATOR_ONEOF)
+        {
+            // strchr() also finds the terminating NUL.
+            first_set_add(first, 0);
+            for (char const * c = chars; *c != '\0'; c++)
+            {
+                first_set_add(first, (unsigned char)*c);
+            }
+        }
+        else
+        {
+            first_set_add_all(first);
+            for (char const * c = chars; *c != '\0'; c++)
+            {
+                first->bytes[(unsigned char)*c >> 6] &= ~(UINT64_C(1) << ((unsigned char)*c & 63));
+            }
+        }
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_KEYWORD:
+    {
+        char const * keyword = node->data.keyword.name;
+
+        if (strcmp(keyword, "digit") == 0)
+        {
+            first_set_add_class(first, isdigit);
+        }
+        else if (strcmp(keyword, "alpha") == 0)
+        {
+            first_set_add_class(first, isalpha);
+        }
+        else if (strcmp(keyword, "alphanum") == 0)
+        {
+            first_set_add_class(first, isalnum);
+        }
+        else if (strcmp(keyword, "space") == 0)
+        {
+            first_set_add_class(first, isspace);
+        }
+        else if (strcmp(keyword, "hex_digit") == 0)
+        {
+            first_set_add_class(first, isxdigit);
+        }
+        else if (strcmp(keyword, "any") == 0)
+        {
+            first_set_add_all(first);
+        }
+        else if (strcmp(keyword, "eoi") == 0 || strcmp(keyword, "succeed") == 0)
+        {
+            first->nullable = true;
+        }
+        else
+        {
+            break;
+        }
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_FAIL_CALL:
+        return;
+
+    case GDL_AST_NODE_TYPE_SEQUENCE:
+        first->nullable = true;
+        for (gdl_ast_list_node_t * element = node->data.sequence.elements.head; element != NULL && first->nullable;
+             element = element->next)
+        {
+            first_set_t child;
+
+            expression_first_set(gen, element->item, &child);
+            first_set_union(first, &child);
+            first->nullable = child.nullable;
+        }
+        return;
+
+    case GDL_AST_NODE_TYPE_ALTERNATIVE:
+        for (gdl_ast_list_node_t * alternative = node->data.alternative.alternatives.head; alternative != NULL;
+             alternative = alternative->next)
+        {
+            first_set_t child;
+
+            expression_first_set(gen, alternative->item, &child);
+            first_set_union(first, &child);
+            first->nullable = first->nullable || child.nullable;
+        }
+        return;
+
+    case GDL_AST_NODE_TYPE_REPETITION_EXPRESSION:
+    case GDL_AST_NODE_TYPE_OPTIONAL_EXPRESSION:
+    case GDL_AST_NODE_TYPE_COMBINATOR_COUNT:
+    {
+        bool may_be_empty = true;
+
+        if (node->type == GDL_AST_NODE_TYPE_REPETITION_EXPRESSION)
+        {
+            may_be_empty = node->data.repetition_expr.repetition->data.repetition_op.operator_char != '+';
+        }
+        else if (node->type == GDL_AST_NODE_TYPE_COMBINATOR_COUNT)
+        {
+            may_be_empty = node->data.count_call.count_node->data.number_literal.value <= 0;
+        }
+        expression_first_set(gen, single_child(node), first);
+        first->nullable = first->nullable || may_be_empty;
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_LOOKAHEAD:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NOT:
+        first->nullable = true;
+        return;
+
+    default:
+        break;
+    }
+
+    first_set_add_all(first);
+    first->nullable = true;
+}
+
+// --- Code generation ---
+
+static size_t
+add_site(gdl_direct_generator_t * gen, char const * path)
+{
+    if (gen->site_count == gen->site_capacity)
+    {
+        size_t const capacity = gen->site_capacity == 0 ? 32 : gen->site_capacity * 2;
+        char ** sites = realloc(gen->sites, capacity * sizeof(*sites));
+
+        if (sites == NULL)
+        {
+            gen->failed = true;
+            return 0;
+        }
+        gen->sites = sites;
+        gen->site_capacity = capacity;
+    }
+
+    char * site = strdup(path);
+
+    if (site == NULL)
+    {
+        gen->failed = true;
+        return 0;
+    }
+    gen->sites[gen->site_count] = site;
+
+    return gen->site_count++;
+}
+
+static bool
+is_compound(gdl_ast_node_t * node)
+{
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_SEQUENCE:
+        return node->data.sequence.elements.count > 1;
+    case GDL_AST_NODE_TYPE_ALTERNATIVE:
+        return node->data.alternative.alternatives.count > 1;
+    case GDL_AST_NODE_TYPE_REPETITION_EXPRESSION:
+    case GDL_AST_NODE_TYPE_OPTIONAL_EXPRESSION:
+    case GDL_AST_NODE_TYPE_COMBINATOR_COUNT:
+    case GDL_AST_NODE_TYPE_COMBINATOR_LOOKAHEAD:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NOT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void emit_function(
+    gdl_direct_generator_t * gen, direct_rule_t * rule, char const * name, gdl_ast_node_t * node, char const * path
+);
+
+// Writes a C expression that matches a single byte with `test`, which is given the byte as `c`.
+static void
+emit_byte_match(gdl_direct_generator_t * gen, text_t * out, size_t site, char const * test)
+{
+    text_printf(
+        gen,
+        out,
+        "((epc_direct_has_input(d, *pos, 1) && %s) ? epc_direct_token(d, %zu, pos, 1) : epc_direct_fail(d, %zu, *pos))",
+        test,
+        site,
+        site
+    );
+}
+
+// Writes a C expression that matches nothing if `test` holds.
+static void
+emit_empty_match(gdl_direct_generator_t * gen, text_t * out, size_t site, char const * test)
+{
+    text_printf(gen, out, "(%s ? epc_direct_token(d, %zu, pos, 0) : epc_direct_fail(d, %zu, *pos))", test, site, site);
+}
+
+// Writes a C expression that matches `node` at `*pos` by the contract of easy_pc_direct.h. `path` finds the graph
+// parser for the node.
+static void
+emit_match(gdl_direct_generator_t * gen, text_t * out, direct_rule_t * rule, gdl_ast_node_t * node, char const * path)
+{
+    node = unwrap(node);
+
+    if (is_compound(node))
+    {
+        char * name = format_string("direct_%s_%d", rule->variable, ++rule->helper_count);
+
+        if (name == NULL)
+        {
+            gen->failed = true;
+            return;
+        }
+        emit_function(gen, rule, name, node, path);
+        text_printf(gen, out, "%s(d, pos)", name);
+        free(name);
+        return;
+    }
+
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_IDENTIFIER_REF:
+    {
+        char * variable = gdl_rule_variable_name(node->data.identifier_ref.name);
+
+        if (variable == NULL)
+        {
+            gen->failed = true;
+            return;
+        }
+        text_printf(gen, out, "direct_%s(d, pos)", variable);
+        free(variable);
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_CHAR_LITERAL:
+        text_printf(
+            gen, out, "epc_direct_char(d, %zu, pos, '%s')", add_site(gen, path), node->data.char_literal.value
+        );
+        return;
+
+    case GDL_AST_NODE_TYPE_STRING_LITERAL:
+        text_printf(
+            gen,
+            out,
+            "epc_direct_string(d, %zu, pos, \"%s\", sizeof(\"%s\") - 1)",
+            add_site(gen, path),
+            node->data.string_literal.value,
+            node->data.string_literal.value
+        );
+        return;
+
+    case GDL_AST_NODE_TYPE_CHAR_RANGE:
+    {
+        char test[64];
+
+        snprintf(
+            test,
+            sizeof(test),
+            "d->input[*pos] >= (char)%d && d->input[*pos] <= (char)%d",
+            node->data.char_range.start_char,
+            node->data.char_range.end_char
+        );
+        emit_byte_match(gen, out, add_site(gen, path), test);
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_ONEOF:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NONEOF:
+    {
+        char * test = format_string(
+            "strchr(\"%s\", d->input[*pos]) %s NULL",
+            node->data.none_or_one_of_call.args,
+            node->type == GDL_AST_NODE_TYPE_COMBINATOR_ONEOF ? "!=" : "=="
+        );
+
+        if (test == NULL)
+        {
+            gen->failed = true;
+            return;
+        }
+        emit_byte_match(gen, out, add_site(gen, path), test);
+        free(test);
+        return;
+    }
+
+    case GDL_AST_NODE_TYPE_KEYWORD:
+    {
+        static struct
+        {
+            char const * keyword;
+            char const * test;
+        } const classes[] = {
+            {"digit", "isdigit(d->input[*pos])"},
+            {"alpha", "isalpha(d->input[*pos])"},
+            {"alphanum", "isalnum(d->input[*pos])"},
+            {"space", "isspace(d->input[*pos])"},
+            {"hex_digit", "isxdigit(d->input[*pos])"},
+            {"any", "true"},
+        };
+        char const * keyword = node->data.keyword.name;
+
+        for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++)
+        {
+            if (strcmp(keyword, classes[i].keyword) == 0)
+            {
+                emit_byte_match(gen, out, add_site(gen, path), classes[i].test);
+                return;
+            }
+        }
+        if (strcmp(keyword, "eoi") == 0)
+        {
+            emit_empty_match(gen, out, add_site(gen, path), "!epc_direct_has_input(d, *pos, 1)");
+            return;
+        }
+        if (strcmp(keyword, "succeed") == 0)
+        {
+            emit_empty_match(gen, out, add_site(gen, path), "epc_direct_has_input(d, *pos, 1)");
+            return;
+        }
+        // Numbers and comments are left to their parse functions.
+        break;
+    }
+
+    case GDL_AST_NODE_TYPE_SEQUENCE:
+        // An empty sequence is generated as epc_succeed().
+        emit_empty_match(gen, out, add_site(gen, path), "epc_direct_has_input(d, *pos, 1)");
+        return;
+
+    case GDL_AST_NODE_TYPE_FAIL_CALL:
+        text_printf(gen, out, "epc_direct_fail(d, %zu, *pos)", add_site(gen, path));
+        return;
+
+    default:
+        break;
+    }
+
+    // Everything else runs the graph parser.
+    text_printf(gen, out, "epc_direct_callout(d, %zu, pos)", add_site(gen, path));
+}
+
+// Writes a call that matches the `index`th child of the graph parser at `path`.
+static void
+emit_child_match(
+    gdl_direct_generator_t * gen,
+    text_t * out,
+    direct_rule_t * rule,
+    gdl_ast_node_t * child,
+    char const * path,
+    int index
+)
+{
+    char * child_path = format_string("epc_direct_child(%s, %d)", path, index);
+
+    if (child_path == NULL)
+    {
+        gen->failed = true;
+        return;
+    }
+    emit_match(gen, out, rule, child, child_path);
+    free(child_path);
+}
+
+// Writes the end of input check of the combinator at `site`.
+static void
+emit_require_input(gdl_direct_generator_t * gen, text_t * out, size_t site)
+{
+    text_printf(
+        gen,
+        out,
+        "    if (!epc_direct_has_input(d, *pos, 1))\n    {\n        return epc_direct_fail(d, %zu, *pos);\n    }\n",
+        site
+    );
+}
+
+static void
+emit_open(gdl_direct_generator_t * gen, text_t * out)
+{
+    text_printf(
+        gen,
+        out,
+        "    size_t const start = *pos;\n"
+        "    size_t const mark = epc_direct_mark(d);\n"
+        "\n"
+        "    if (mark == EPC_DIRECT_NO_MARK)\n"
+        "    {\n"
+        "        return false;\n"
+        "    }\n"
+    );
+}
+
+static void
+emit_unwind(gdl_direct_generator_t * gen, text_t * out, char const * indent)
+{
+    text_printf(
+        gen,
+        out,
+        "%s    epc_direct_reset(d, mark);\n%s    *pos = start;\n%s    return false;\n",
+        indent,
+        indent,
+        indent
+    );
+}
+
+static void
+emit_sequence(
+    gdl_direct_generator_t * gen, text_t * out, direct_rule_t * rule, gdl_ast_node_t * node, char const * path
+)
+{
+    size_t const site = add_site(gen, path);
+    int index = 0;
+
+    emit_require_input(gen, out, site);
+    text_printf(gen, out, "\n");
+    emit_open(gen, out);
+    for (gdl_ast_list_node_t * element = node->data.sequence.elements.head; element != NULL;
+         element = element->next, index++)
+    {
+        text_printf(gen, out, index == 0 ? "    if (!" : "        || !");
+        emit_child_match(gen, out, rule, element->item, path, index);
+        text_printf(gen, out, element->next == NULL ? ")\n" : "\n");
+    }
+    text_printf(gen, out, "    {\n");
+    emit_unwind(gen, out, "    ");
+    text_printf(gen, out, "    }\n\n    return epc_direct_close(d, mark, %zu, start, pos);\n", site);
+}
+
+// Writes the alternatives in `mask` as an ordered choice, setting `matched`.
+static void
+emit_choice(
+    gdl_direct_generator_t * gen,
+    text_t * out,
+    text_t const * alternatives,
+    size_t count,
+    uint64_t mask,
+    char const * indent
+)
+{
+    bool first = true;
+
+    text_printf(gen, out, "%smatched = ", indent);
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((mask >> i) & 1)
+        {
+            text_printf(gen, out, "%s%s", first ? "" : " || ", alternatives[i].buf);
+            first = false;
+        }
+    }
+    text_printf(gen, out, "%s;\n", first ? "false" : "");
+}
+
+static void
+emit_case_label(gdl_direct_generator_t * gen, text_t * out, unsigned c)
+{
+    if (isalnum(c) || (ispunct(c) && c != '\'' && c != '\\'))
+    {
+        text_printf(gen, out, "    case '%c':\n", (char)c);
+    }
+    else
+    {
+        text_printf(gen, out, "    case %u:\n", c);
+    }
+}
+
+static void
+emit_alternative(
+    gdl_direct_generator_t * gen, text_t * out, direct_rule_t * rule, gdl_ast_node_t * node, char const * path
+)
+{
+    size_t const site = add_site(gen, path);
+    size_t const count = (size_t)node->data.alternative.alternatives.count;
+    text_t * alternatives = calloc(count, sizeof(*alternatives));
+    first_set_t * firsts = calloc(count, sizeof(*firsts));
+    uint64_t masks[UCHAR_MAX + 1] = {0};
+    size_t index = 0;
+
+    if (alternatives == NULL || firsts == NULL)
+    {
+        free(alternatives);
+        free(firsts);
+        gen->failed = true;
+        return;
+    }
+    for (gdl_ast_list_node_t * alternative = node->data.alternative.alternatives.head; alternative != NULL;
+         alternative = alternative->next, index++)
+    {
+        emit_child_match(gen, &alternatives[index], rule, alternative->item, path, (int)index);
+        expression_first_set(gen, alternative->item, &firsts[index]);
+    }
+
+    // For each byte, the alternatives that may match when it is next, as the epc_or dispatch table has.
+    bool dispatch = count <= MAX_DISPATCHED_ALTERNATIVES;
+
+    for (unsigned c = 0; c <= UCHAR_MAX && dispatch; c++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (first_set_may_start_with(&firsts[i], (unsigned char)c))
+            {
+                masks[c] |= UINT64_C(1) << i;
+            }
+        }
+    }
+    if (dispatch)
+    {
+        // There's nothing to gain if every byte leads to the same alternatives.
+        dispatch = false;
+        for (unsigned c = 1; c <= UCHAR_MAX; c++)
+        {
+            dispatch = dispatch || masks[c] != masks[0];
+        }
+    }
+
+    emit_require_input(gen, out, site);
+    text_printf(gen, out, "\n    size_t const saved = epc_direct_save_error(d);\n    bool matched;\n\n");
+    if (!dispatch)
+    {
+        emit_choice(gen, out, alternatives, count, count < 64 ? (UINT64_C(1) << count) - 1 : UINT64_MAX, "    ");
+    }
+    else
+    {
+        // The most common set of alternatives becomes the default.
+        uint64_t default_mask = masks[0];
+        size_t default_bytes = 0;
+
+        for (unsigned c = 0; c <= UCHAR_MAX; c++)
+        {
+            size_t bytes = 0;
+
+            for (unsigned other = 0; other <= UCHAR_MAX; other++)
+            {
+                bytes += masks[other] == masks[c];
+            }
+            if (bytes > default_bytes)
+            {
+                default_mask = masks[c];
+                default_bytes = bytes;
+            }
+        }
+
+        bool done[UCHAR_MAX + 1] = {false};
+
+        text_printf(gen, out, "    switch ((unsigned char)d->input[*pos])\n    {\n");
+        for (unsigned c = 0; c <= UCHAR_MAX; c++)
+        {
+            if (done[c] || masks[c] == default_mask)
+            {
+                continue;
+            }
+            for (unsigned other = c; other <= UCHAR_MAX; other++)
+            {
+                if (masks[other] == masks[c])
+                {
+                    emit_case_label(gen, out, other);
+                    done[other] = true;
+                }
+            }
+            emit_choice(gen, out, alternatives, count, masks[c], "        ");
+            text_printf(gen, out, "        break;\n");
+        }
+        text_printf(gen, out, "    default:\n");
+        emit_choice(gen, out, alternatives, count, default_mask, "        ");
+        text_printf(gen, out, "        break;\n    }\n");
+    }
+    text_printf(
+        gen,
+        out,
+        "    if (!matched)\n    {\n        return epc_direct_no_alternative(d, saved, %zu, *pos);\n    }\n"
+        "    epc_direct_restore_error(d, saved);\n\n    return epc_direct_wrap(d, %zu, pos);\n",
+        site,
+        site
+    );
+
+    for (size_t i = 0; i < count; i++)
+    {
+        text_free(&alternatives[i]);
+    }
+    free(alternatives);
+    free(firsts);
+}
+
+static void
+emit_repetition(
+    gdl_direct_generator_t * gen, text_t * out, direct_rule_t * rule, gdl_ast_node_t * node, char const * path
+)
+{
+    size_t const site = add_site(gen, path);
+    char const operator_char = node->data.repetition_expr.repetition->data.repetition_op.operator_char;
+    text_t child = {0};
+
+    emit_child_match(gen, &child, rule, node->data.repetition_expr.expression, path, 0);
+
+    if (operator_char == '?')
+    {
+        emit_require_input(gen, out, site);
+        text_printf(
+            gen,
+            out,
+            "\n    size_t const saved = epc_direct_save_error(d);\n\n"
+            "    if (%s)\n    {\n        epc_direct_restore_error(d, saved);\n"
+            "        return epc_direct_wrap(d, %zu, pos);\n    }\n"
+            "    epc_direct_keep_error(d, saved);\n\n"
+            "    return epc_direct_token(d, %zu, pos, 0);\n",
+            child.buf,
+            site,
+            site
+        );
+        text_free(&child);
+        return;
+    }
+
+    if (operator_char == '+')
+    {
+        emit_require_input(gen, out, site);
+        text_printf(gen, out, "\n");
+    }
+    emit_open(gen, out);
+    if (operator_char == '+')
+    {
+        text_printf(gen, out, "    if (!%s)\n    {\n", child.buf);
+        emit_unwind(gen, out, "    ");
+        text_printf(gen, out, "    }\n");
+    }
+    text_printf(
+        gen,
+        out,
+        "    for (;;)\n"
+        "    {\n"
+        "        size_t const before = *pos;\n"
+        "\n"
+        "        if (!%s)\n"
+        "        {\n"
+        "            break;\n"
+        "        }\n"
+        "        if (*pos == before)\n"
+        "        {\n"
+        "            // The repeated expression matched nothing, so it would repeat forever.\n"
+        "            epc_direct_no_progress(d, *pos);\n",
+        child.buf
+    );
+    emit_unwind(gen, out, "        ");
+    text_printf(gen, out, "        }\n    }\n\n    return epc_direct_close(d, mark, %zu, start, pos);\n", site);
+    text_free(&child);
+}
+
+static void
+emit_count(gdl_direct_generator_t * gen, text_t * out, direct_rule_t * rule, gdl_ast_node_t * node, char const * path)
+{
+    size_t const site = add_site(gen, path);
+    long long const count = node->data.count_call.count_node->data.number_literal.value;
+
+    emit_require_input(gen, out, site);
+    text_printf(gen, out, "\n");
+    if (count <= 0)
+    {
+        text_printf(gen, out, "    return epc_direct_token(d, %zu, pos, 0);\n", site);
+        return;
+    }
+    emit_open(gen, out);
+    text_printf(gen, out, "    for (long long i = 0; i < %lld; i++)\n    {\n        if (!", count);
+    emit_child_match(gen, out, rule, node->data.count_call.expression, path, 0);
+    text_printf(gen, out, ")\n        {\n            epc_direct_count_failed(d, *pos, (size_t)i);\n");
+    emit_unwind(gen, out, "        ");
+    text_printf(gen, out, "        }\n    }\n\n    return epc_direct_close(d, mark, %zu, start, pos);\n", site);
+}
+
+static void
+emit_predicate(
+    gdl_direct_generator_t * gen, text_t * out, direct_rule_t * rule, gdl_ast_node_t * node, char const * path
+)
+{
+    size_t const site = add_site(gen, path);
+    text_t child = {0};
+
+    emit_child_match(gen, &child, rule, node->data.unary_combinator_call.expr, path, 0);
+    emit_require_input(gen, out, site);
+    text_printf(gen, out, "\n");
+    emit_open(gen, out);
+    text_printf(gen, out, "\n    size_t const saved = epc_direct_save_error(d);\n\n    if (%s)\n    {\n", child.buf);
+    if (node->type == GDL_AST_NODE_TYPE_COMBINATOR_NOT)
+    {
+        text_printf(gen, out, "        epc_direct_unexpected_match(d, saved, %zu, start);\n", site);
+        emit_unwind(gen, out, "    ");
+        text_printf(
+            gen,
+            out,
+            "    }\n    epc_direct_reset(d, mark);\n    epc_direct_restore_error(d, saved);\n\n"
+            "    return epc_direct_token(d, %zu, pos, 0);\n",
+            site
+        );
+    }
+    else
+    {
+        text_printf(
+            gen,
+            out,
+            "        epc_direct_restore_error(d, saved);\n        epc_direct_reset(d, mark);\n        *pos = start;\n\n"
+            "        return epc_direct_token(d, %zu, pos, 0);\n    }\n"
+            "    epc_direct_reset(d, mark);\n\n    return epc_direct_lookahead_failed(d, saved);\n",
+            site
+        );
+    }
+    text_free(&child);
+}
+
+// Generates a function named `name` that matches `node`, whose graph parser is found by `path`.
+static void
+emit_function(
+    gdl_direct_generator_t * gen, direct_rule_t * rule, char const * name, gdl_ast_node_t * node, char const * path
+)
+{
+    text_t body = {0};
+
+    node = unwrap(node);
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_SEQUENCE:
+        if (node->data.sequence.elements.count > 1)
+        {
+            emit_sequence(gen, &body, rule, node, path);
+            break;
+        }
+        goto single;
+
+    case GDL_AST_NODE_TYPE_ALTERNATIVE:
+        if (node->data.alternative.alternatives.count > 1)
+        {
+            emit_alternative(gen, &body, rule, node, path);
+            break;
+        }
+        goto single;
+
+    case GDL_AST_NODE_TYPE_REPETITION_EXPRESSION:
+        emit_repetition(gen, &body, rule, node, path);
+        break;
+
+    case GDL_AST_NODE_TYPE_OPTIONAL_EXPRESSION:
+    {
+        // optional() behaves as the '?' operator.
+        gdl_ast_node_t operator_node = {.type = GDL_AST_NODE_TYPE_REPETITION_OPERATOR};
+        gdl_ast_node_t repetition = {.type = GDL_AST_NODE_TYPE_REPETITION_EXPRESSION};
+
+        operator_node.data.repetition_op.operator_char = '?';
+        repetition.data.repetition_expr.expression = node->data.optional.expr;
+        repetition.data.repetition_expr.repetition = &operator_node;
+        emit_repetition(gen, &body, rule, &repetition, path);
+        break;
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_COUNT:
+        emit_count(gen, &body, rule, node, path);
+        break;
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_LOOKAHEAD:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NOT:
+        emit_predicate(gen, &body, rule, node, path);
+        break;
+
+    default:
+    single:
+        text_printf(gen, &body, "    return ");
+        emit_match(gen, &body, rule, node, path);
+        text_printf(gen, &body, ";\n");
+        break;
+    }
+
+    text_printf(gen, &gen->prototypes, "static bool %s(epc_direct_t * d, size_t * pos);\n", name);
+    text_printf(gen, &gen->definitions, "\nstatic bool\n%s(epc_direct_t * d, size_t * pos)\n{\n", name);
+    text_append(gen, &gen->definitions, &body);
+    text_printf(gen, &gen->definitions, "}\n");
+    text_free(&body);
+}
+
+// Generates a function named `name` that runs the graph parser at `path`.
+static void
+emit_callout_function(gdl_direct_generator_t * gen, char const * name, char const * path)
+{
+    text_printf(gen, &gen->prototypes, "static bool %s(epc_direct_t * d, size_t * pos);\n", name);
+    text_printf(gen, &gen->definitions, "\nstatic bool\n%s(epc_direct_t * d, size_t * pos)\n{\n", name);
+    text_printf(gen, &gen->definitions, "    return epc_direct_callout(d, %zu, pos);\n}\n", add_site(gen, path));
+}
+
+gdl_direct_generator_t *
+gdl_direct_generator_create(gdl_ast_node_t * ast_root)
+{
+    if (ast_root == NULL || ast_root->type != GDL_AST_NODE_TYPE_PROGRAM)
+    {
+        return NULL;
+    }
+
+    gdl_direct_generator_t * gen = calloc(1, sizeof(*gen));
+
+    if (gen == NULL)
+    {
+        return NULL;
+    }
+    gen->rules = calloc((size_t)ast_root->data.program.rules.count, sizeof(*gen->rules));
+    if (gen->rules == NULL && ast_root->data.program.rules.count > 0)
+    {
+        free(gen);
+        return NULL;
+    }
+    for (gdl_ast_list_node_t * rule = ast_root->data.program.rules.head; rule != NULL; rule = rule->next)
+    {
+        if (rule->item->type != GDL_AST_NODE_TYPE_RULE_DEFINITION)
+        {
+            continue;
+        }
+
+        direct_rule_t * direct_rule = &gen->rules[gen->rule_count++];
+
+        direct_rule->rule_def = rule->item;
+        direct_rule->variable = gdl_rule_variable_name(rule->item->data.rule_def.name);
+        if (direct_rule->variable == NULL)
+        {
+            gdl_direct_generator_free(gen);
+            return NULL;
+        }
+    }
+
+    return gen;
+}
+
+void
+gdl_direct_generator_free(gdl_direct_generator_t * gen)
+{
+    if (gen == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0; i < gen->rule_count; i++)
+    {
+        free(gen->rules[i].variable);
+    }
+    free(gen->rules);
+    for (size_t i = 0; i < gen->site_count; i++)
+    {
+        free(gen->sites[i]);
+    }
+    free(gen->sites);
+    text_free(&gen->prototypes);
+    text_free(&gen->definitions);
+    free(gen);
+}
+
+bool
+gdl_direct_generate_functions(gdl_direct_generator_t * gen, FILE * source_file)
+{
+    // Which rules are left-recursive is only known once every FIRST set is.
+    for (size_t i = 0; i < gen->rule_count; i++)
+    {
+        first_set_t first;
+
+        rule_first_set(gen, &gen->rules[i], &first);
+    }
+    for (size_t i = 0; i < gen->rule_count; i++)
+    {
+        direct_rule_t * rule = &gen->rules[i];
+        char * name = format_string("direct_%s", rule->variable);
+
+        if (name == NULL)
+        {
+            return false;
+        }
+        text_printf(gen, &gen->definitions, "\n// Rule: %s", rule->rule_def->data.rule_def.name);
+        if (rule->is_left_recursive)
+        {
+            emit_callout_function(gen, name, rule->variable);
+        }
+        else
+        {
+            emit_function(gen, rule, name, rule->rule_def->data.rule_def.definition, rule->variable);
+        }
+        free(name);
+    }
+    if (gen->failed)
+    {
+        fprintf(stderr, "Error: Failed to generate the direct parser functions.\n");
+        return false;
+    }
+
+    fprintf(source_file, "// Direct matching functions. Each creates its nodes for the graph parser at a site.\n");
+    fprintf(source_file, "%s", gen->prototypes.buf != NULL ? gen->prototypes.buf : "");
+    fprintf(source_file, "%s\n", gen->definitions.buf != NULL ? gen->definitions.buf : "");
+
+    return true;
+}
+
+void
+gdl_direct_generate_return(gdl_direct_generator_t const * gen, FILE * source_file, char const * top_rule_variable)
+{
+    fprintf(source_file, "    // The graph parsers that the direct functions create nodes for, by site.\n");
+    fprintf(source_file, "    epc_parser_t * const sites[] = {\n");
+    for (size_t i = 0; i < gen->site_count; i++)
+    {
+        fprintf(source_file, "        %s,\n", gen->sites[i]);
+    }
+    if (gen->site_count == 0)
+    {
+        fprintf(source_file, "        NULL,\n");
+    }
+    fprintf(source_file, "    };\n\n");
+    fprintf(
+        source_file,
+        "    return epc_direct_l(list, \"%s\", direct_%s, %s, sites, %zu);\n",
+        top_rule_variable,
+        top_rule_variable,
+        top_rule_variable,
+        gen->site_count
+    );
+}
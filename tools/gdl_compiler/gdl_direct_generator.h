@@ -0,0 +1,25 @@
+#pragma once
+
+#include "gdl_ast.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Generates a direct parser (see easy_pc_direct.h): one C function per rule, with terminals matched inline,
+// sequences as straight-line code and alternatives as a switch on the next byte. The functions create their nodes
+// for the parsers of the graph that create_<base>_parser() builds, which they find by walking the graph from the
+// rule variables, and call out to the graph for constructs that have no direct form.
+typedef struct gdl_direct_generator_t gdl_direct_generator_t;
+
+gdl_direct_generator_t * gdl_direct_generator_create(gdl_ast_node_t * ast_root);
+
+void gdl_direct_generator_free(gdl_direct_generator_t * gen);
+
+// Writes the matching functions. Must be called before gdl_direct_generate_return().
+bool gdl_direct_generate_functions(gdl_direct_generator_t * gen, FILE * source_file);
+
+// Writes the statements that end create_<base>_parser(), which return a direct parser for the rule whose graph
+// parser is in the variable `top_rule_variable`.
+void gdl_direct_generate_return(
+    gdl_direct_generator_t const * gen, FILE * source_file, char const * top_rule_variable
+);
@@ -0,0 +1,488 @@
+#include "gdl_grammar_builder.h"
+
+#include "easy_pc_private.h"
+#include "gdl_literal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct gdl_grammar_rule_t
+{
+    char const * name;
+    epc_parser_t * parser; // Declared before any rule is built, so rules may refer to those after them.
+} gdl_grammar_rule_t;
+
+typedef struct gdl_grammar_builder_t
+{
+    epc_parser_list * list;
+    gdl_grammar_rule_t * rules;
+    size_t rule_count;
+} gdl_grammar_builder_t;
+
+static epc_parser_t * build_expression(gdl_grammar_builder_t * builder, gdl_ast_node_t * node, char const * name);
+
+static epc_parser_t *
+find_rule_parser(gdl_grammar_builder_t const * builder, char const * name)
+{
+    for (size_t i = 0; i < builder->rule_count; i++)
+    {
+        if (strcmp(builder->rules[i].name, name) == 0)
+        {
+            return builder->rules[i].parser;
+        }
+    }
+
+    return NULL;
+}
+
+static epc_parser_t *
+build_keyword(gdl_grammar_builder_t * builder, char const * keyword_name)
+{
+    static struct
+    {
+        char const * name;
+        epc_parser_t * (*create)(char const * name);
+    } const keywords[] = {
+        {"eoi", epc_eoi},
+        {"digit", epc_digit},
+        {"alpha", epc_alpha},
+        {"alphanum", epc_alphanum},
+        {"space", epc_space},
+        {"any", epc_any},
+        {"succeed", epc_succeed},
+        {"hex_digit", epc_hex_digit},
+        {"int", epc_int},
+        {"double", epc_double},
+        {"cpp_comment", epc_cpp_comment},
+        {"c_comment", epc_c_comment},
+        {"bash_comment", epc_bash_comment},
+    };
+
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++)
+    {
+        if (strcmp(keywords[i].name, keyword_name) == 0)
+        {
+            return epc_parser_list_add(builder->list, keywords[i].create(keyword_name));
+        }
+    }
+    fprintf(stderr, "Error: Unsupported GDL keyword '%s'.\n", keyword_name);
+
+    return NULL;
+}
+
+// Builds a parser from the literal text of a string, char, one_of or none_of.
+static epc_parser_t *
+build_literal(gdl_grammar_builder_t * builder, gdl_ast_node_t * node, char const * name)
+{
+    char const * text = node->type == GDL_AST_NODE_TYPE_CHAR_LITERAL ? node->data.char_literal.value
+                        : node->type == GDL_AST_NODE_TYPE_STRING_LITERAL
+                            ? node->data.string_literal.value
+                            : node->data.none_or_one_of_call.args;
+    char * decoded = text != NULL ? gdl_literal_decode(text, NULL) : NULL;
+    epc_parser_t * parser = NULL;
+
+    if (decoded == NULL)
+    {
+        return NULL;
+    }
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_CHAR_LITERAL:
+        parser = epc_char_l(builder->list, name, decoded[0]);
+        break;
+    case GDL_AST_NODE_TYPE_STRING_LITERAL:
+        parser = epc_string_l(builder->list, name, decoded);
+        break;
+    case GDL_AST_NODE_TYPE_COMBINATOR_ONEOF:
+        parser = epc_one_of_l(builder->list, name, decoded);
+        break;
+    default:
+        parser = epc_none_of_l(builder->list, name, decoded);
+        break;
+    }
+    free(decoded);
+
+    return parser;
+}
+
+// Builds an epc_keywords parser from the string literals of a keywords node.
+static epc_parser_t *
+build_keywords(gdl_grammar_builder_t * builder, gdl_ast_list_t const * literals, char const * name)
+{
+    char ** keywords = calloc((size_t)literals->count, sizeof(*keywords));
+    epc_parser_t * parser = NULL;
+    int count = 0;
+
+    if (keywords == NULL)
+    {
+        return NULL;
+    }
+    for (gdl_ast_list_node_t * item = literals->head; item != NULL; item = item->next, count++)
+    {
+        keywords[count] = gdl_literal_decode(item->item->data.string_literal.value, NULL);
+        if (keywords[count] == NULL)
+        {
+            break;
+        }
+    }
+    if (count == literals->count)
+    {
+        parser = epc_keywords_array_l(builder->list, name, count, (char const * const *)keywords);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        free(keywords[i]);
+    }
+    free(keywords);
+
+    return parser;
+}
+
+// Builds an epc_and or epc_or of the expressions in a list. The combinators only take their children as variadic
+// arguments, so the parser is created with the first two and then given the whole list.
+static epc_parser_t *
+build_combination(gdl_grammar_builder_t * builder, gdl_ast_list_t const * expressions, char const * name, bool is_and)
+{
+    epc_parser_t ** parsers = calloc((size_t)expressions->count, sizeof(*parsers));
+    size_t i = 0;
+
+    if (parsers == NULL)
+    {
+        return NULL;
+    }
+    for (gdl_ast_list_node_t * item = expressions->head; item != NULL; item = item->next, i++)
+    {
+        parsers[i] = build_expression(builder, item->item, NULL);
+        if (parsers[i] == NULL)
+        {
+            free(parsers);
+            return NULL;
+        }
+    }
+
+    epc_parser_t * parser = is_and ? epc_and_l(builder->list, name, 2, parsers[0], parsers[1])
+                                   : epc_or_l(builder->list, name, 2, parsers[0], parsers[1]);
+
+    if (parser == NULL || parser->data.parser_list == NULL)
+    {
+        free(parsers);
+        return NULL;
+    }
+    free(parser->data.parser_list->parsers);
+    parser->data.parser_list->parsers = parsers;
+    parser->data.parser_list->count = expressions->count;
+
+    return parser;
+}
+
+static epc_parser_t *
+build_expression(gdl_grammar_builder_t * builder, gdl_ast_node_t * node, char const * name)
+{
+    if (node == NULL)
+    {
+        return NULL;
+    }
+    if (name == NULL)
+    {
+        name = node->name;
+    }
+
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_STRING_LITERAL:
+    case GDL_AST_NODE_TYPE_CHAR_LITERAL:
+    case GDL_AST_NODE_TYPE_COMBINATOR_ONEOF:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NONEOF:
+        return build_literal(builder, node, name);
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS:
+        return build_keywords(builder, &node->data.keywords_call.keywords, name);
+
+    case GDL_AST_NODE_TYPE_CHAR_RANGE:
+        return epc_char_range_l(builder->list, name, node->data.char_range.start_char, node->data.char_range.end_char);
+
+    case GDL_AST_NODE_TYPE_IDENTIFIER_REF:
+    {
+        epc_parser_t * rule = find_rule_parser(builder, node->data.identifier_ref.name);
+
+        if (rule == NULL)
+        {
+            fprintf(stderr, "Error: Reference to undefined rule '%s'.\n", node->data.identifier_ref.name);
+        }
+        return rule;
+    }
+
+    case GDL_AST_NODE_TYPE_KEYWORD:
+        return build_keyword(builder, node->data.keyword.name);
+
+    case GDL_AST_NODE_TYPE_FAIL_CALL:
+        return epc_fail_l(builder->list, name, node->data.string_literal.value);
+
+    case GDL_AST_NODE_TYPE_TERMINAL:
+        return build_expression(builder, node->data.terminal.expression, name);
+
+    case GDL_AST_NODE_TYPE_SEQUENCE:
+        if (node->data.sequence.elements.count == 0)
+        {
+            return epc_succeed_l(builder->list, "empty_seq");
+        }
+        if (node->data.sequence.elements.count == 1)
+        {
+            return build_expression(builder, node->data.sequence.elements.head->item, name);
+        }
+        return build_combination(builder, &node->data.sequence.elements, name, true);
+
+    case GDL_AST_NODE_TYPE_ALTERNATIVE:
+        if (node->data.alternative.alternatives.count == 0)
+        {
+            return epc_fail_l(builder->list, "empty_alt", "empty alternative");
+        }
+        if (node->data.alternative.alternatives.count == 1)
+        {
+            return build_expression(builder, node->data.alternative.alternatives.head->item, name);
+        }
+        return build_combination(builder, &node->data.alternative.alternatives, name, false);
+
+    case GDL_AST_NODE_TYPE_REPETITION_EXPRESSION:
+    {
+        epc_parser_t * repeated = build_expression(builder, node->data.repetition_expr.expression, NULL);
+
+        if (repeated == NULL)
+        {
+            return NULL;
+        }
+        switch (node->data.repetition_expr.repetition->data.repetition_op.operator_char)
+        {
+        case '*':
+            return epc_many_l(builder->list, name, repeated);
+        case '+':
+            return epc_plus_l(builder->list, name, repeated);
+        case '?':
+            return epc_optional_l(builder->list, name, repeated);
+        default:
+            return NULL;
+        }
+    }
+
+    case GDL_AST_NODE_TYPE_OPTIONAL_EXPRESSION:
+    {
+        epc_parser_t * optional = build_expression(builder, node->data.optional.expr, NULL);
+
+        return optional != NULL ? epc_optional_l(builder->list, name, optional) : NULL;
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_COUNT:
+    {
+        epc_parser_t * counted = build_expression(builder, node->data.count_call.expression, NULL);
+
+        return counted != NULL ? epc_count_l(
+                                     builder->list,
+                                     name,
+                                     (int)node->data.count_call.count_node->data.number_literal.value,
+                                     counted
+                                 )
+                               : NULL;
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_BETWEEN:
+    {
+        epc_parser_t * open = build_expression(builder, node->data.between_call.open_expr, NULL);
+        epc_parser_t * content = build_expression(builder, node->data.between_call.content_expr, NULL);
+        epc_parser_t * close = build_expression(builder, node->data.between_call.close_expr, NULL);
+
+        return open != NULL && content != NULL && close != NULL
+                   ? epc_between_l(builder->list, name, open, content, close)
+                   : NULL;
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_NOT:
+    case GDL_AST_NODE_TYPE_COMBINATOR_LOOKAHEAD:
+    case GDL_AST_NODE_TYPE_COMBINATOR_SKIP:
+    case GDL_AST_NODE_TYPE_COMBINATOR_LEXEME:
+    {
+        epc_parser_t * child = build_expression(builder, node->data.unary_combinator_call.expr, NULL);
+
+        if (child == NULL)
+        {
+            return NULL;
+        }
+        switch (node->type)
+        {
+        case GDL_AST_NODE_TYPE_COMBINATOR_NOT:
+            return epc_not_l(builder->list, name, child);
+        case GDL_AST_NODE_TYPE_COMBINATOR_LOOKAHEAD:
+            return epc_lookahead_l(builder->list, name, child);
+        case GDL_AST_NODE_TYPE_COMBINATOR_SKIP:
+            return epc_skip_l(builder->list, name, child);
+        default:
+            return epc_lexeme_l(builder->list, name, child);
+        }
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_CHAINL1:
+    case GDL_AST_NODE_TYPE_COMBINATOR_CHAINR1:
+    {
+        epc_parser_t * item = build_expression(builder, node->data.chain_combinator_call.item_expr, NULL);
+        epc_parser_t * op = build_expression(builder, node->data.chain_combinator_call.op_expr, NULL);
+
+        if (item == NULL || op == NULL)
+        {
+            return NULL;
+        }
+        return node->type == GDL_AST_NODE_TYPE_COMBINATOR_CHAINL1 ? epc_chainl1_l(builder->list, name, item, op)
+                                                                  : epc_chainr1_l(builder->list, name, item, op);
+    }
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_DELIMITED:
+    {
+        epc_parser_t * item = build_expression(builder, node->data.delimited_call.item_expr, NULL);
+        epc_parser_t * delimiter = NULL;
+
+        if (node->data.delimited_call.delimiter_expr != NULL)
+        {
+            delimiter = build_expression(builder, node->data.delimited_call.delimiter_expr, NULL);
+            if (delimiter == NULL)
+            {
+                return NULL;
+            }
+        }
+        return item != NULL ? epc_delimited_l(builder->list, name, item, delimiter) : NULL;
+    }
+
+    case GDL_AST_NODE_TYPE_SATISFY_CALL:
+    {
+        epc_parser_t * token = build_expression(builder, node->data.satisfy_call.expr, NULL);
+
+        return token != NULL
+                   ? epc_satisfy_l(builder->list, name, token, node->data.satisfy_call.message, NULL, NULL)
+                   : NULL;
+    }
+
+    case GDL_AST_NODE_TYPE_WRAP_CALL:
+    {
+        epc_parser_t * wrapped = build_expression(builder, node->data.wrap_call.expr, NULL);
+
+        return wrapped != NULL ? epc_wrap_l(builder->list, name, wrapped, (epc_wrap_callbacks_t){0}, NULL) : NULL;
+    }
+
+    case GDL_AST_NODE_TYPE_SPLIT_CALL:
+        // Splitting only changes how the repetition is parsed, not what it matches.
+        return build_expression(builder, node->data.split_call.expr, name);
+
+    default:
+        fprintf(stderr, "Error: Unsupported AST node type for grammar analysis: %d\n", node->type);
+        return NULL;
+    }
+}
+
+// Returns the name of the rule that a rule is just another name for, or NULL.
+static char const *
+alias_target(gdl_ast_node_t const * definition)
+{
+    while (definition != NULL)
+    {
+        switch (definition->type)
+        {
+        case GDL_AST_NODE_TYPE_TERMINAL:
+            definition = definition->data.terminal.expression;
+            break;
+        case GDL_AST_NODE_TYPE_SEQUENCE:
+            if (definition->data.sequence.elements.count != 1)
+            {
+                return NULL;
+            }
+            definition = definition->data.sequence.elements.head->item;
+            break;
+        case GDL_AST_NODE_TYPE_ALTERNATIVE:
+            if (definition->data.alternative.alternatives.count != 1)
+            {
+                return NULL;
+            }
+            definition = definition->data.alternative.alternatives.head->item;
+            break;
+        case GDL_AST_NODE_TYPE_IDENTIFIER_REF:
+            return definition->data.identifier_ref.name;
+        default:
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+epc_parser_t *
+gdl_build_grammar(gdl_ast_node_t * ast_root, epc_parser_list * list)
+{
+    if (ast_root == NULL || ast_root->type != GDL_AST_NODE_TYPE_PROGRAM || list == NULL)
+    {
+        return NULL;
+    }
+
+    gdl_ast_list_t const * rules = &ast_root->data.program.rules;
+    gdl_grammar_builder_t builder = {.list = list, .rules = calloc((size_t)rules->count, sizeof(*builder.rules))};
+    bool * defined = calloc((size_t)rules->count, sizeof(*defined));
+    epc_parser_t * top = NULL;
+    bool ok = builder.rules != NULL && defined != NULL;
+
+    for (gdl_ast_list_node_t * item = rules->head; ok && item != NULL; item = item->next)
+    {
+        char const * rule_name = item->item->data.rule_def.name;
+
+        builder.rules[builder.rule_count].name = rule_name;
+        builder.rules[builder.rule_count].parser = epc_parser_fwd_decl_l(list, rule_name);
+        builder.rule_count++;
+    }
+
+    // Duplicating a rule that is only another name for a second rule copies the second rule's definition, so rules
+    // are defined after the rules they are aliases of, as in the generated code. Aliases that form a cycle are left
+    // undefined, which the analysis reports.
+    for (bool progress = true; ok && progress;)
+    {
+        gdl_ast_list_node_t * item = rules->head;
+
+        progress = false;
+        for (size_t i = 0; ok && i < builder.rule_count; i++, item = item->next)
+        {
+            gdl_ast_node_t * definition = item->item->data.rule_def.definition;
+            char const * target = alias_target(definition);
+
+            if (defined[i])
+            {
+                continue;
+            }
+            if (target != NULL)
+            {
+                size_t t = 0;
+
+                while (t < builder.rule_count && strcmp(builder.rules[t].name, target) != 0)
+                {
+                    t++;
+                }
+                if (t < builder.rule_count && !defined[t])
+                {
+                    continue;
+                }
+            }
+
+            epc_parser_t * parser = build_expression(&builder, definition, builder.rules[i].name);
+
+            if (parser == NULL)
+            {
+                ok = false;
+                break;
+            }
+            epc_parser_duplicate(builder.rules[i].parser, parser);
+            defined[i] = true;
+            progress = true;
+        }
+    }
+    if (ok && builder.rule_count > 0)
+    {
+        top = builder.rules[builder.rule_count - 1].parser;
+    }
+    free(defined);
+    free(builder.rules);
+
+    return top;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "gdl_ast.h"
+
+#include <easy_pc/easy_pc.h>
+
+// Builds the graph of combinators that the code generated for the GDL AST would build, adding its parsers to `list`,
+// so that the grammar can be analysed without compiling the generated code. User functions named by satisfy(), wrap()
+// and split() aren't available, so those parsers are built without them. Returns the parser for the last rule, or
+// NULL if a rule can't be built.
+epc_parser_t * gdl_build_grammar(gdl_ast_node_t * ast_root, epc_parser_list * list);
@@ -0,0 +1,121 @@
+#include "gdl_literal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char const escapes[] = "n\nt\tr\rv\vf\fa\ab\b\\\\''\"\"??";
+
+char *
+gdl_literal_decode(char const * text, size_t * len)
+{
+    char * decoded = malloc(strlen(text) + 1);
+    size_t n = 0;
+
+    if (decoded == NULL)
+    {
+        return NULL;
+    }
+    while (*text != '\0')
+    {
+        if (*text != '\\' || text[1] == '\0')
+        {
+            decoded[n++] = *text++;
+            continue;
+        }
+        text++;
+
+        char const * escape = NULL;
+
+        for (size_t i = 0; escapes[i] != '\0'; i += 2)
+        {
+            if (*text == escapes[i])
+            {
+                escape = &escapes[i + 1];
+                break;
+            }
+        }
+        if (escape != NULL)
+        {
+            decoded[n++] = *escape;
+            text++;
+        }
+        else if (*text == 'x')
+        {
+            char * end;
+
+            decoded[n++] = (char)strtoul(text + 1, &end, 16);
+            text = end;
+        }
+        else if (*text >= '0' && *text <= '7')
+        {
+            unsigned value = 0;
+
+            for (int digits = 0; digits < 3 && *text >= '0' && *text <= '7'; digits++)
+            {
+                value = value * 8 + (unsigned)(*text++ - '0');
+            }
+            decoded[n++] = (char)value;
+        }
+        else
+        {
+            decoded[n++] = *text++;
+        }
+    }
+    decoded[n] = '\0';
+    if (len != NULL)
+    {
+        *len = n;
+    }
+
+    return decoded;
+}
+
+char *
+gdl_literal_encode(char const * bytes, size_t len)
+{
+    // The longest form of a byte is a three digit octal escape.
+    char * encoded = malloc(len * 4 + 1);
+    size_t n = 0;
+
+    if (encoded == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < len; i++)
+    {
+        unsigned char const c = (unsigned char)bytes[i];
+        char const * escape = NULL;
+
+        for (size_t e = 0; escapes[e] != '\0'; e += 2)
+        {
+            if (c == (unsigned char)escapes[e + 1])
+            {
+                escape = &escapes[e];
+                break;
+            }
+        }
+        if (c == '\'' || (c == '?' && (i == 0 || bytes[i - 1] != '?')))
+        {
+            // Only needed between single quotes, or to avoid a trigraph.
+            encoded[n++] = (char)c;
+        }
+        else if (escape != NULL)
+        {
+            encoded[n++] = '\\';
+            encoded[n++] = *escape;
+        }
+        else if (c >= ' ' && c <= '~')
+        {
+            encoded[n++] = (char)c;
+        }
+        else
+        {
+            // Three digits, so that a digit that follows isn't taken as part of the escape.
+            n += (size_t)sprintf(encoded + n, "\\%03o", c);
+        }
+    }
+    encoded[n] = '\0';
+
+    return encoded;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stddef.h>
+
+// GDL literals keep the text between their quotes, with its C escape sequences, as that is pasted into the
+// generated code. These convert between that text and the bytes it stands for.
+
+// Returns the bytes that the escaped text `text` stands for, NUL-terminated, and sets `len`, if not NULL, to their
+// number, which strlen() doesn't give if they include a NUL. The caller must free it.
+char * gdl_literal_decode(char const * text, size_t * len);
+
+// Returns the escaped text for `len` bytes, for use between double quotes in C. The caller must free it.
+char * gdl_literal_encode(char const * bytes, size_t len);
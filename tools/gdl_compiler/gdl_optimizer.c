@@ -0,0 +1,873 @@
+#include "gdl_optimizer.h"
+
+#include "gdl_literal.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef void (*slot_visit_fn)(gdl_ast_node_t ** slot, void * data);
+
+typedef struct
+{
+    bool ok; // Cleared if memory ran out.
+} optimizer_t;
+
+typedef struct
+{
+    char const * name;
+    int uses;
+} rule_uses_t;
+
+typedef struct
+{
+    char const * name;
+    gdl_ast_node_t * definition; // Set to NULL once it has replaced the reference.
+} rule_inline_t;
+
+static gdl_ast_node_t *
+node_create(gdl_ast_node_type_t type)
+{
+    gdl_ast_node_t * node = calloc(1, sizeof(*node));
+
+    if (node != NULL)
+    {
+        node->type = type;
+    }
+    return node;
+}
+
+static bool
+list_append(gdl_ast_list_t * list, gdl_ast_node_t * item)
+{
+    gdl_ast_list_node_t * list_node = calloc(1, sizeof(*list_node));
+
+    if (list_node == NULL)
+    {
+        return false;
+    }
+    list_node->item = item;
+    if (list->tail == NULL)
+    {
+        list->head = list_node;
+    }
+    else
+    {
+        list->tail->next = list_node;
+    }
+    list->tail = list_node;
+    list->count++;
+
+    return true;
+}
+
+// Removes the `count` list nodes after `first` from the list, freeing them and their items.
+static void
+list_remove_after(gdl_ast_list_t * list, gdl_ast_list_node_t * first, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        gdl_ast_list_node_t * removed = first->next;
+
+        first->next = removed->next;
+        if (list->tail == removed)
+        {
+            list->tail = first;
+        }
+        list->count--;
+        gdl_ast_node_free(removed->item, NULL);
+        free(removed);
+    }
+}
+
+// Calls `visit` for the slot that holds each expression below and including `*slot`, children first, so `visit` may
+// replace the expression in the slot.
+static void
+visit_slots(gdl_ast_node_t ** slot, slot_visit_fn visit, void * data)
+{
+    gdl_ast_node_t * node = *slot;
+
+    if (node == NULL)
+    {
+        return;
+    }
+
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_TERMINAL:
+        visit_slots(&node->data.terminal.expression, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_REPETITION_EXPRESSION:
+        visit_slots(&node->data.repetition_expr.expression, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_OPTIONAL_EXPRESSION:
+        visit_slots(&node->data.optional.expr, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_COMBINATOR_COUNT:
+        visit_slots(&node->data.count_call.expression, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_COMBINATOR_BETWEEN:
+        visit_slots(&node->data.between_call.open_expr, visit, data);
+        visit_slots(&node->data.between_call.content_expr, visit, data);
+        visit_slots(&node->data.between_call.close_expr, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_COMBINATOR_DELIMITED:
+        visit_slots(&node->data.delimited_call.item_expr, visit, data);
+        visit_slots(&node->data.delimited_call.delimiter_expr, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_COMBINATOR_LOOKAHEAD:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NOT:
+    case GDL_AST_NODE_TYPE_COMBINATOR_LEXEME:
+    case GDL_AST_NODE_TYPE_COMBINATOR_SKIP:
+        visit_slots(&node->data.unary_combinator_call.expr, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_COMBINATOR_CHAINL1:
+    case GDL_AST_NODE_TYPE_COMBINATOR_CHAINR1:
+        visit_slots(&node->data.chain_combinator_call.item_expr, visit, data);
+        visit_slots(&node->data.chain_combinator_call.op_expr, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_SEQUENCE:
+        for (gdl_ast_list_node_t * item = node->data.sequence.elements.head; item != NULL; item = item->next)
+        {
+            visit_slots(&item->item, visit, data);
+        }
+        break;
+    case GDL_AST_NODE_TYPE_ALTERNATIVE:
+        for (gdl_ast_list_node_t * item = node->data.alternative.alternatives.head; item != NULL; item = item->next)
+        {
+            visit_slots(&item->item, visit, data);
+        }
+        break;
+    case GDL_AST_NODE_TYPE_SATISFY_CALL:
+        visit_slots(&node->data.satisfy_call.expr, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_WRAP_CALL:
+        visit_slots(&node->data.wrap_call.expr, visit, data);
+        break;
+    case GDL_AST_NODE_TYPE_SPLIT_CALL:
+        visit_slots(&node->data.split_call.expr, visit, data);
+        break;
+    default:
+        break;
+    }
+    visit(slot, data);
+}
+
+// Looks through the nodes that don't change what an expression matches. An inlined rule's definition is kept whole,
+// and is never merged or fused with its neighbours, so that its parser keeps the rule's name.
+static gdl_ast_node_t *
+unwrap(gdl_ast_node_t * node)
+{
+    for (;;)
+    {
+        if (node->name != NULL)
+        {
+            return node;
+        }
+        else if (node->type == GDL_AST_NODE_TYPE_TERMINAL)
+        {
+            node = node->data.terminal.expression;
+        }
+        else if (node->type == GDL_AST_NODE_TYPE_SEQUENCE && node->data.sequence.elements.count == 1)
+        {
+            node = node->data.sequence.elements.head->item;
+        }
+        else if (node->type == GDL_AST_NODE_TYPE_ALTERNATIVE && node->data.alternative.alternatives.count == 1)
+        {
+            node = node->data.alternative.alternatives.head->item;
+        }
+        else
+        {
+            return node;
+        }
+    }
+}
+
+// Returns the bytes a char or string literal matches, or NULL if `node` isn't one. Literals with a NUL are left
+// alone, as epc_string() would stop at it.
+static char *
+literal_bytes(gdl_ast_node_t * node, size_t * len)
+{
+    node = unwrap(node);
+    if (node->name != NULL)
+    {
+        return NULL;
+    }
+
+    char const * text = node->type == GDL_AST_NODE_TYPE_CHAR_LITERAL     ? node->data.char_literal.value
+                        : node->type == GDL_AST_NODE_TYPE_STRING_LITERAL ? node->data.string_literal.value
+                                                                         : NULL;
+    char * bytes = text != NULL ? gdl_literal_decode(text, len) : NULL;
+
+    if (bytes != NULL && strlen(bytes) != *len)
+    {
+        free(bytes);
+        bytes = NULL;
+    }
+    return bytes;
+}
+
+static gdl_ast_node_t *
+string_literal_create(char const * bytes, size_t len)
+{
+    gdl_ast_node_t * node = node_create(GDL_AST_NODE_TYPE_STRING_LITERAL);
+
+    if (node != NULL)
+    {
+        node->data.string_literal.value = gdl_literal_encode(bytes, len);
+        if (node->data.string_literal.value == NULL)
+        {
+            free(node);
+            node = NULL;
+        }
+    }
+    return node;
+}
+
+// Adds the bytes that an expression matching exactly one byte accepts to `set`. Returns false if it isn't one.
+static bool
+byte_set_add(gdl_ast_node_t * node, bool set[UCHAR_MAX + 1])
+{
+    node = unwrap(node);
+    if (node->name != NULL)
+    {
+        return false;
+    }
+
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_CHAR_LITERAL:
+    case GDL_AST_NODE_TYPE_STRING_LITERAL:
+    {
+        size_t len;
+        char * bytes = literal_bytes(node, &len);
+        bool const is_byte = bytes != NULL && len == 1;
+
+        if (is_byte)
+        {
+            set[(unsigned char)bytes[0]] = true;
+        }
+        free(bytes);
+        return is_byte;
+    }
+
+    case GDL_AST_NODE_TYPE_CHAR_RANGE:
+        for (int c = CHAR_MIN; c <= CHAR_MAX; c++)
+        {
+            if (c != 0 && (char)c >= node->data.char_range.start_char && (char)c <= node->data.char_range.end_char)
+            {
+                set[(unsigned char)c] = true;
+            }
+        }
+        return true;
+
+    case GDL_AST_NODE_TYPE_COMBINATOR_ONEOF:
+    {
+        size_t len;
+        char * bytes = gdl_literal_decode(node->data.none_or_one_of_call.args, &len);
+
+        if (bytes == NULL || strlen(bytes) != len)
+        {
+            free(bytes);
+            return false;
+        }
+        for (size_t i = 0; i < len; i++)
+        {
+            set[(unsigned char)bytes[i]] = true;
+        }
+        free(bytes);
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+// Returns true if an expression only matches terminals, so inlining it can't change what the rules it is inlined
+// into refer to.
+static bool
+is_terminal_only(gdl_ast_node_t * node)
+{
+    switch (node->type)
+    {
+    case GDL_AST_NODE_TYPE_STRING_LITERAL:
+    case GDL_AST_NODE_TYPE_CHAR_LITERAL:
+    case GDL_AST_NODE_TYPE_CHAR_RANGE:
+    case GDL_AST_NODE_TYPE_COMBINATOR_ONEOF:
+    case GDL_AST_NODE_TYPE_COMBINATOR_NONEOF:
+    case GDL_AST_NODE_TYPE_KEYWORD:
+        return true;
+
+    case GDL_AST_NODE_TYPE_TERMINAL:
+        return is_terminal_only(node->data.terminal.expression);
+
+    case GDL_AST_NODE_TYPE_SEQUENCE:
+        for (gdl_ast_list_node_t * item = node->data.sequence.elements.head; item != NULL; item = item->next)
+        {
+            if (!is_terminal_only(item->item))
+            {
+                return false;
+            }
+        }
+        return true;
+
+    case GDL_AST_NODE_TYPE_ALTERNATIVE:
+        for (gdl_ast_list_node_t * item = node->data.alternative.alternatives.head; item != NULL; item = item->next)
+        {
+            if (!is_terminal_only(item->item))
+            {
+                return false;
+            }
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// --- Inlining ---
+
+static void
+count_rule_uses(gdl_ast_node_t ** slot, void * data)
+{
+    rule_uses_t * uses = data;
+
+    if ((*slot)->type == GDL_AST_NODE_TYPE_IDENTIFIER_REF && strcmp((*slot)->data.identifier_ref.name, uses->name) == 0)
+    {
+        uses->uses++;
+    }
+}
+
+static void
+inline_rule_use(gdl_ast_node_t ** slot, void * data)
+{
+    rule_inline_t * rule = data;
+
+    if (rule->definition != NULL && (*slot)->type == GDL_AST_NODE_TYPE_IDENTIFIER_REF
+        && strcmp((*slot)->data.identifier_ref.name, rule->name) == 0)
+    {
+        gdl_ast_node_free(*slot, NULL);
+        *slot = rule->definition;
+        rule->definition = NULL;
+    }
+}
+
+static int
+rule_use_count(gdl_ast_list_t const * rules, char const * name)
+{
+    rule_uses_t uses = {.name = name};
+
+    for (gdl_ast_list_node_t * item = rules->head; item != NULL; item = item->next)
+    {
+        visit_slots(&item->item->data.rule_def.definition, count_rule_uses, &uses);
+    }
+    return uses.uses;
+}
+
+// Inlines a rule that is used once, if that can't change the AST nodes that semantic actions get. The last rule is
+// the grammar's entry point so is always kept.
+static bool
+inline_single_use_rule(gdl_ast_list_t * rules)
+{
+    gdl_ast_list_node_t * previous = NULL;
+
+    for (gdl_ast_list_node_t * item = rules->head; item != NULL && item != rules->tail;
+         previous = item, item = item->next)
+    {
+        gdl_ast_rule_definition_t * rule = &item->item->data.rule_def;
+
+        bool has_action
+            = rule->semantic_action != NULL && rule->semantic_action->data.semantic_action.action_name != NULL;
+
+        if (has_action || rule->is_token || rule->definition == NULL
+            || !is_terminal_only(rule->definition) || rule_use_count(rules, rule->name) != 1)
+        {
+            continue;
+        }
+
+        if (rule->definition->name == NULL)
+        {
+            rule->definition->name = strdup(rule->name);
+            if (rule->definition->name == NULL)
+            {
+                continue;
+            }
+        }
+
+        rule_inline_t inlined = {.name = rule->name, .definition = rule->definition};
+
+        for (gdl_ast_list_node_t * user = rules->head; user != NULL && inlined.definition != NULL; user = user->next)
+        {
+            visit_slots(&user->item->data.rule_def.definition, inline_rule_use, &inlined);
+        }
+        rule->definition = NULL;
+        gdl_ast_node_free(inlined.definition, NULL);
+
+        if (previous == NULL)
+        {
+            rules->head = item->next;
+        }
+        else
+        {
+            previous->next = item->next;
+        }
+        rules->count--;
+        gdl_ast_node_free(item->item, NULL);
+        free(item);
+
+        return true;
+    }
+
+    return false;
+}
+
+// --- Expression rewriting ---
+
+// Replaces each run of adjacent literals in a sequence with a single string.
+static void
+merge_sequence_literals(optimizer_t * opt, gdl_ast_node_t * sequence)
+{
+    gdl_ast_list_t * elements = &sequence->data.sequence.elements;
+
+    for (gdl_ast_list_node_t * first = elements->head; first != NULL; first = first->next)
+    {
+        size_t len;
+        char * merged = literal_bytes(first->item, &len);
+        int run = 0;
+
+        if (merged == NULL)
+        {
+            continue;
+        }
+        for (gdl_ast_list_node_t * next = first->next; next != NULL; next = next->next, run++)
+        {
+            size_t next_len;
+            char * next_bytes = literal_bytes(next->item, &next_len);
+            char * grown = next_bytes != NULL ? realloc(merged, len + next_len + 1) : NULL;
+
+            if (grown == NULL)
+            {
+                opt->ok = opt->ok && next_bytes == NULL;
+                free(next_bytes);
+                break;
+            }
+            merged = grown;
+            memcpy(merged + len, next_bytes, next_len + 1);
+            len += next_len;
+            free(next_bytes);
+        }
+        if (run > 0)
+        {
+            gdl_ast_node_t * string = string_literal_create(merged, len);
+
+            if (string == NULL)
+            {
+                opt->ok = false;
+            }
+            else
+            {
+                gdl_ast_node_free(first->item, NULL);
+                first->item = string;
+                list_remove_after(elements, first, run);
+            }
+        }
+        free(merged);
+    }
+}
+
+// Returns the bytes of the literal that an alternative begins with, or NULL if it doesn't begin with one.
+static char *
+leading_literal(gdl_ast_node_t * alternative, size_t * len)
+{
+    gdl_ast_node_t * node = unwrap(alternative);
+
+    if (node->name == NULL && node->type == GDL_AST_NODE_TYPE_SEQUENCE && node->data.sequence.elements.count > 1)
+    {
+        node = node->data.sequence.elements.head->item;
+    }
+    return literal_bytes(node, len);
+}
+
+// Frees an alternative that begins with a literal, returning a sequence of what follows the first `prefix_len` bytes
+// of that literal. Returns NULL, leaving the alternative as it was, if memory runs out.
+static gdl_ast_node_t *
+alternative_remainder(gdl_ast_node_t * alternative, size_t prefix_len)
+{
+    gdl_ast_node_t * node = unwrap(alternative);
+    gdl_ast_node_t * remainder = node_create(GDL_AST_NODE_TYPE_SEQUENCE);
+    gdl_ast_list_t * elements = remainder != NULL ? &remainder->data.sequence.elements : NULL;
+    size_t len;
+    char * bytes = leading_literal(alternative, &len);
+    bool ok = remainder != NULL && bytes != NULL;
+
+    if (ok && len > prefix_len)
+    {
+        gdl_ast_node_t * rest = string_literal_create(bytes + prefix_len, len - prefix_len);
+
+        ok = rest != NULL && list_append(elements, rest);
+        if (!ok)
+        {
+            gdl_ast_node_free(rest, NULL);
+        }
+    }
+    free(bytes);
+
+    // The elements after the literal are shared until all of them have been added, then taken from the alternative.
+    gdl_ast_list_node_t * shared_from = ok ? elements->tail : NULL;
+
+    if (ok && node->type == GDL_AST_NODE_TYPE_SEQUENCE)
+    {
+        for (gdl_ast_list_node_t * item = node->data.sequence.elements.head->next; ok && item != NULL;
+             item = item->next)
+        {
+            ok = list_append(elements, item->item);
+        }
+        for (gdl_ast_list_node_t * item = node->data.sequence.elements.head->next; item != NULL; item = item->next)
+        {
+            if (ok)
+            {
+                item->item = NULL;
+            }
+        }
+    }
+    if (!ok)
+    {
+        if (remainder != NULL)
+        {
+            for (gdl_ast_list_node_t * item = shared_from != NULL ? shared_from->next : elements->head; item != NULL;
+                 item = item->next)
+            {
+                item->item = NULL;
+            }
+        }
+        gdl_ast_node_free(remainder, NULL);
+        return NULL;
+    }
+    gdl_ast_node_free(alternative, NULL);
+
+    return remainder;
+}
+
+static void optimize_alternative(optimizer_t * opt, gdl_ast_node_t * alternative);
+
+// Factors the literal text shared by the start of `count` adjacent alternatives out of them: "abc" X | "abd" Y
+// becomes "ab" ('c' X | 'd' Y). Choosing between alternatives that begin with the same text matches it the same way
+// each time, so this doesn't change what is matched.
+static void
+factor_alternatives(optimizer_t * opt, gdl_ast_list_t * alternatives, gdl_ast_list_node_t * first, int count)
+{
+    size_t prefix_len;
+    char * prefix = leading_literal(first->item, &prefix_len);
+    gdl_ast_node_t * factored = node_create(GDL_AST_NODE_TYPE_SEQUENCE);
+    gdl_ast_node_t * choice = node_create(GDL_AST_NODE_TYPE_ALTERNATIVE);
+    gdl_ast_node_t * common = NULL;
+    gdl_ast_list_node_t * item = first->next;
+
+    for (int i = 1; prefix != NULL && i < count; i++, item = item->next)
+    {
+        size_t len;
+        char * bytes = leading_literal(item->item, &len);
+        size_t shared = 0;
+
+        while (bytes != NULL && shared < prefix_len && shared < len && bytes[shared] == prefix[shared])
+        {
+            shared++;
+        }
+        prefix_len = shared;
+        free(bytes);
+    }
+    if (prefix != NULL)
+    {
+        common = string_literal_create(prefix, prefix_len);
+    }
+    if (prefix == NULL || factored == NULL || choice == NULL || common == NULL
+        || !list_append(&factored->data.sequence.elements, common))
+    {
+        opt->ok = false;
+        free(prefix);
+        gdl_ast_node_free(common, NULL);
+        gdl_ast_node_free(factored, NULL);
+        gdl_ast_node_free(choice, NULL);
+        return;
+    }
+    free(prefix);
+    if (!list_append(&factored->data.sequence.elements, choice))
+    {
+        opt->ok = false;
+        gdl_ast_node_free(factored, NULL);
+        gdl_ast_node_free(choice, NULL);
+        return;
+    }
+
+    item = first;
+    for (int i = 0; i < count; i++)
+    {
+        gdl_ast_list_node_t * next = item->next;
+        gdl_ast_node_t * remainder = alternative_remainder(item->item, prefix_len);
+
+        if (remainder == NULL || !list_append(&choice->data.alternative.alternatives, remainder))
+        {
+            // The alternatives before this one have already been moved, so the factored sequence has to be kept.
+            opt->ok = false;
+            gdl_ast_node_free(remainder, NULL);
+            count = i;
+            break;
+        }
+        item->item = NULL;
+        item = next;
+    }
+    if (count == 0)
+    {
+        gdl_ast_node_free(factored, NULL);
+        return;
+    }
+
+    // The first list node takes the factored sequence, and the others, now empty, are removed.
+    first->item = factored;
+    list_remove_after(alternatives, first, count - 1);
+    optimize_alternative(opt, choice);
+}
+
+// Factors runs of adjacent alternatives that begin with the same literal text. A run only takes alternatives whose
+// literal is longer than the text they all share, so that each remainder has to match at least one more byte. A
+// remainder that could match nothing would be tried by an epc_or at the end of the input, which fails there, where the
+// alternative as written would have matched.
+static void
+factor_common_prefixes(optimizer_t * opt, gdl_ast_node_t * alternative)
+{
+    gdl_ast_list_t * alternatives = &alternative->data.alternative.alternatives;
+
+    for (gdl_ast_list_node_t * first = alternatives->head; first != NULL; first = first->next)
+    {
+        size_t len;
+        char * bytes = leading_literal(first->item, &len);
+        size_t shortest = len;
+        int run = 1;
+
+        if (bytes == NULL || len == 0)
+        {
+            free(bytes);
+            continue;
+        }
+        for (gdl_ast_list_node_t * next = first->next; next != NULL; next = next->next, run++)
+        {
+            size_t next_len;
+            char * next_bytes = leading_literal(next->item, &next_len);
+            size_t shared = 0;
+
+            while (next_bytes != NULL && shared < len && shared < next_len && next_bytes[shared] == bytes[shared])
+            {
+                shared++;
+            }
+            free(next_bytes);
+            if (shared == 0 || shared >= shortest || shared >= next_len)
+            {
+                break;
+            }
+            len = shared;
+            if (next_len < shortest)
+            {
+                shortest = next_len;
+            }
+        }
+        free(bytes);
+        if (run > 1)
+        {
+            factor_alternatives(opt, alternatives, first, run);
+        }
+    }
+}
+
+// Returns true if one of the `count` literals in `run` is a proper prefix of `bytes`.
+static bool
+run_has_prefix_of(char * const * run, size_t const * run_lens, int count, char const * bytes, size_t len)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (run_lens[i] < len && memcmp(run[i], bytes, run_lens[i]) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Replaces each run of adjacent alternatives that are literals with one epc_keywords(), which reads the input once
+// rather than once for each literal. It matches the longest of its literals where an epc_or() matches the first, so a
+// run stops before a literal that an earlier one is a prefix of: "in" | "int" never matches "int", but "int" | "in"
+// can become a keywords node. Runs of single bytes are left to become a oneof().
+static void
+fuse_keyword_alternatives(optimizer_t * opt, gdl_ast_node_t * alternative)
+{
+    gdl_ast_list_t * alternatives = &alternative->data.alternative.alternatives;
+    char ** run = calloc((size_t)alternatives->count, sizeof(*run));
+    size_t * run_lens = calloc((size_t)alternatives->count, sizeof(*run_lens));
+
+    if (run == NULL || run_lens == NULL)
+    {
+        opt->ok = false;
+        free(run);
+        free(run_lens);
+        return;
+    }
+    for (gdl_ast_list_node_t * first = alternatives->head; first != NULL; first = first->next)
+    {
+        int count = 0;
+        bool has_string = false;
+
+        for (gdl_ast_list_node_t * next = first; next != NULL && count < UINT16_MAX; next = next->next)
+        {
+            size_t len;
+            char * bytes = literal_bytes(next->item, &len);
+
+            if (bytes == NULL || len == 0 || run_has_prefix_of(run, run_lens, count, bytes, len))
+            {
+                free(bytes);
+                break;
+            }
+            run[count] = bytes;
+            run_lens[count++] = len;
+            has_string = has_string || len > 1;
+        }
+
+        bool const is_keywords = count > 1 && has_string;
+        gdl_ast_node_t * keywords = is_keywords ? node_create(GDL_AST_NODE_TYPE_COMBINATOR_KEYWORDS) : NULL;
+        bool ok = keywords != NULL;
+
+        for (int i = 0; ok && i < count; i++)
+        {
+            gdl_ast_node_t * string = string_literal_create(run[i], run_lens[i]);
+
+            ok = string != NULL && list_append(&keywords->data.keywords_call.keywords, string);
+            if (!ok)
+            {
+                gdl_ast_node_free(string, NULL);
+            }
+        }
+        if (ok)
+        {
+            gdl_ast_node_free(first->item, NULL);
+            first->item = keywords;
+            list_remove_after(alternatives, first, count - 1);
+        }
+        else if (is_keywords)
+        {
+            opt->ok = false;
+            gdl_ast_node_free(keywords, NULL);
+        }
+        for (int i = 0; i < count; i++)
+        {
+            free(run[i]);
+        }
+    }
+    free(run);
+    free(run_lens);
+}
+
+// Replaces each run of adjacent alternatives that match a single byte with one oneof(). Whichever of them matches,
+// it matches the same byte, so their order within the run doesn't matter.
+static void
+fuse_byte_alternatives(optimizer_t * opt, gdl_ast_node_t * alternative)
+{
+    gdl_ast_list_t * alternatives = &alternative->data.alternative.alternatives;
+
+    for (gdl_ast_list_node_t * first = alternatives->head; first != NULL; first = first->next)
+    {
+        bool set[UCHAR_MAX + 1] = {false};
+        int run = 1;
+
+        if (!byte_set_add(first->item, set))
+        {
+            continue;
+        }
+        for (gdl_ast_list_node_t * next = first->next; next != NULL && byte_set_add(next->item, set); next = next->next)
+        {
+            run++;
+        }
+        if (run == 1)
+        {
+            continue;
+        }
+
+        char chars[UCHAR_MAX + 1];
+        size_t len = 0;
+
+        for (int c = 1; c <= UCHAR_MAX; c++)
+        {
+            if (set[c])
+            {
+                chars[len++] = (char)c;
+            }
+        }
+        if (len == 0)
+        {
+            continue;
+        }
+
+        gdl_ast_node_t * one_of = node_create(GDL_AST_NODE_TYPE_COMBINATOR_ONEOF);
+
+        if (one_of != NULL)
+        {
+            one_of->data.none_or_one_of_call.args = gdl_literal_encode(chars, len);
+        }
+        if (one_of == NULL || one_of->data.none_or_one_of_call.args == NULL)
+        {
+            opt->ok = false;
+            free(one_of);
+            continue;
+        }
+        gdl_ast_node_free(first->item, NULL);
+        first->item = one_of;
+        list_remove_after(alternatives, first, run - 1);
+    }
+}
+
+static void
+optimize_alternative(optimizer_t * opt, gdl_ast_node_t * alternative)
+{
+    // Keywords come first, as factoring would split up the literals they take.
+    fuse_keyword_alternatives(opt, alternative);
+    factor_common_prefixes(opt, alternative);
+    fuse_byte_alternatives(opt, alternative);
+}
+
+static void
+optimize_slot(gdl_ast_node_t ** slot, void * data)
+{
+    optimizer_t * opt = data;
+
+    if ((*slot)->type == GDL_AST_NODE_TYPE_SEQUENCE)
+    {
+        merge_sequence_literals(opt, *slot);
+    }
+    else if ((*slot)->type == GDL_AST_NODE_TYPE_ALTERNATIVE)
+    {
+        optimize_alternative(opt, *slot);
+    }
+}
+
+bool
+gdl_optimize_ast(gdl_ast_node_t * ast_root)
+{
+    if (ast_root == NULL || ast_root->type != GDL_AST_NODE_TYPE_PROGRAM)
+    {
+        return false;
+    }
+
+    gdl_ast_list_t * rules = &ast_root->data.program.rules;
+    optimizer_t opt = {.ok = true};
+
+    // Inlining first lets the literals of inlined rules be merged with those around them.
+    while (inline_single_use_rule(rules))
+    {
+    }
+    for (gdl_ast_list_node_t * item = rules->head; item != NULL; item = item->next)
+    {
+        visit_slots(&item->item->data.rule_def.definition, optimize_slot, &opt);
+    }
+
+    return opt.ok;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "gdl_ast.h"
+
+#include <stdbool.h>
+
+// Rewrites the GDL AST so that the code generated for it builds fewer parsers and makes fewer calls, without
+// changing what any rule with a semantic action matches:
+// - rules without a semantic action that are used once and only match terminals are inlined where they are used;
+// - alternatives that begin with the same literal text have it factored out: "abc" X | "abd" Y becomes
+//   "ab" ('c' X | 'd' Y);
+// - adjacent alternatives that each match one character ('a' | 'b' | [0-9]) become one oneof();
+// - adjacent literals in a sequence ('a' 'b' "cd") become one string.
+// Returns false if memory ran out, in which case the AST is still valid but may be partly optimised.
+bool gdl_optimize_ast(gdl_ast_node_t * ast_root);
@@ -156,6 +156,8 @@ create_gdl_parser(epc_parser_list * l)
     epc_parser_t * p_satisfy = epc_lexeme_l(l, "satisfy", p_satisfy_raw);
     epc_parser_t * p_wrap_raw = epc_string_l(l, "wrap", "wrap");
     epc_parser_t * p_wrap = epc_lexeme_l(l, "wrap", p_wrap_raw);
+    epc_parser_t * p_split_raw = epc_string_l(l, "split", "split");
+    epc_parser_t * p_split = epc_lexeme_l(l, "split", p_split_raw);
 
     epc_parser_t * terminal_no_arg_parser = epc_or_l(
         l,
@@ -188,7 +190,7 @@ create_gdl_parser(epc_parser_list * l)
     epc_parser_t * combinator_parser = epc_or_l(
         l,
         "CombinatorKeyword",
-        17,
+        18,
         p_string_raw,
         p_char_range_raw,
         p_none_of_raw,
@@ -205,7 +207,8 @@ create_gdl_parser(epc_parser_list * l)
         p_chainr1_raw,
         p_skip_raw,
         p_satisfy_raw,
-        p_wrap_raw
+        p_wrap_raw,
+        p_split_raw
     );
     epc_parser_set_ast_action(combinator_parser, GDL_AST_ACTION_CREATE_KEYWORD);
 
@@ -350,10 +353,15 @@ create_gdl_parser(epc_parser_list * l)
     epc_parser_t * wrap_call = epc_and_l(l, "WrapCall", 4, p_wrap, gdl_lparen, wrap_args, gdl_rparen);
     epc_parser_set_ast_action(wrap_call, GDL_AST_ACTION_CREATE_WRAP_CALL);
 
+    epc_parser_t * split_args
+        = epc_and_l(l, "SplitArgs", 5, gdl_expression_arg, gdl_comma, gdl_identifier, gdl_comma, gdl_identifier);
+    epc_parser_t * split_call = epc_and_l(l, "SplitCall", 4, p_split, gdl_lparen, split_args, gdl_rparen);
+    epc_parser_set_ast_action(split_call, GDL_AST_ACTION_CREATE_SPLIT_CALL);
+
     epc_parser_t * gdl_combinator_call = epc_or_l(
         l,
         "CombinatorCall",
-        14,
+        15,
         none_of_call,
         count_call,
         between_call,
@@ -367,7 +375,8 @@ create_gdl_parser(epc_parser_list * l)
         chainr1_call,
         skip_call,
         satisfy_call,
-        wrap_call
+        wrap_call,
+        split_call
     );
 
     // PrimaryExpression: terminal | char_range | combinator_call | '(' definition_expression ')'
@@ -411,16 +420,27 @@ create_gdl_parser(epc_parser_list * l)
     epc_parser_duplicate(gdl_definition_expression, temp_definition_expression);
     epc_parser_duplicate(gdl_expression_arg, gdl_definition_expression);
 
-    // RuleDefinition: identifier '=' definition_expression semantic_action? ';'
+    // RuleDefinition: 'token'? identifier '=' definition_expression semantic_action? ';'
     epc_parser_t * raw_gdl_equals_char = epc_char_l(l, "RawEqualsChar", '=');
     epc_parser_t * gdl_equals_char = epc_lexeme_l(l, "EqualsChar", raw_gdl_equals_char);
     epc_parser_t * raw_gdl_semicolon_char = epc_char_l(l, "RawSemicolonChar", ';');
     epc_parser_t * gdl_semicolon_char = epc_lexeme_l(l, "SemicolonChar", raw_gdl_semicolon_char);
 
+    // TokenPrefix: 'token' before the rule's name, unless it is the rule's name
+    epc_parser_t * gdl_not_identifier_cont_char = epc_not_l(l, "NotIdentifierContChar", gdl_identifier_cont_char);
+    epc_parser_t * raw_gdl_token
+        = epc_and_l(l, "Token_Raw", 2, epc_string_l(l, "token", "token"), gdl_not_identifier_cont_char);
+    epc_parser_set_ast_action(raw_gdl_token, GDL_AST_ACTION_CREATE_KEYWORD);
+    epc_parser_t * gdl_token_keyword = epc_lexeme_l(l, "TokenKeyword", raw_gdl_token);
+    epc_parser_t * gdl_token_prefix
+        = epc_and_l(l, "TokenPrefix", 2, gdl_token_keyword, epc_not_l(l, "NotEqualsChar", gdl_equals_char));
+    epc_parser_t * gdl_optional_token_prefix = epc_optional_l(l, "OptionalTokenPrefix", gdl_token_prefix);
+
     epc_parser_t * gdl_rule_definition = epc_and_l(
         l,
         "RuleDefinition",
-        5,
+        6,
+        gdl_optional_token_prefix,
         gdl_identifier,
         gdl_equals_char,
         gdl_definition_expression,
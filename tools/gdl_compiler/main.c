@@ -1,6 +1,8 @@
 #include "gdl_bootstrap_generator.h"
 #include "gdl_code_generator.h"
 #include "gdl_compiler_ast_actions.h"
+#include "gdl_grammar_builder.h"
+#include "gdl_optimizer.h"
 #include "gdl_parser.h"
 
 #include <easy_pc/easy_pc.h>
@@ -8,12 +10,50 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Prints the FIRST and FOLLOW sets of each rule and the problems found in the grammar. Returns false if any of the
+// problems would stop the generated parser from working.
+static bool
+analyze_grammar(gdl_ast_node_t * ast_root)
+{
+    epc_parser_list * list = epc_parser_list_create();
+    epc_parser_t * top = list != NULL ? gdl_build_grammar(ast_root, list) : NULL;
+    epc_grammar_analysis_t * analysis = top != NULL ? epc_grammar_analyze(top) : NULL;
+    bool ok = analysis != NULL;
+
+    if (analysis != NULL)
+    {
+        epc_grammar_issue_t const * issues;
+        size_t issue_count = epc_grammar_analysis_get_issues(analysis, &issues);
+
+        epc_grammar_analysis_print(analysis, stdout);
+        for (size_t i = 0; i < issue_count; i++)
+        {
+            if (issues[i].kind == EPC_GRAMMAR_UNBOUNDED_RECURSION || issues[i].kind == EPC_GRAMMAR_NULLABLE_REPETITION
+                || issues[i].kind == EPC_GRAMMAR_UNDEFINED_PARSER)
+            {
+                ok = false;
+            }
+        }
+        epc_grammar_analysis_free(analysis);
+    }
+    else
+    {
+        fprintf(stderr, "Error: Failed to analyse the grammar.\n");
+    }
+    epc_parser_list_free(list);
+
+    return ok;
+}
+
 int
 main(int argc, char ** argv)
 {
     int exit_code = EXIT_SUCCESS;
     char const * gdl_filepath = NULL;
     char const * output_dir = "."; // Default output directory
+    gdl_emit_mode_t emit_mode = GDL_EMIT_GRAPH;
+    bool analyze = false;
+    bool optimize = true;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i)
@@ -41,6 +81,32 @@ main(int argc, char ** argv)
                 }
             }
         }
+        else if (strncmp(argv[i], "--emit=", strlen("--emit=")) == 0)
+        {
+            char const * value = argv[i] + strlen("--emit=");
+
+            if (strcmp(value, "graph") == 0)
+            {
+                emit_mode = GDL_EMIT_GRAPH;
+            }
+            else if (strcmp(value, "direct") == 0)
+            {
+                emit_mode = GDL_EMIT_DIRECT;
+            }
+            else
+            {
+                fprintf(stderr, "Error: --emit must be 'graph' or 'direct'.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--analyze") == 0)
+        {
+            analyze = true;
+        }
+        else if (strcmp(argv[i], "--no-optimize") == 0)
+        {
+            optimize = false;
+        }
         else if (strcmp(argv[i], "--bootstrap-ast") == 0)
         {
             // This flag is handled after parsing, ignore it here.
@@ -51,14 +117,22 @@ main(int argc, char ** argv)
         }
         else
         {
-            fprintf(stderr, "Usage: %s <gdl_file> [--output-dir <directory>]\n", argv[0]);
+            fprintf(
+                stderr,
+                "Usage: %s <gdl_file> [--output-dir <directory>] [--emit=graph|direct] [--analyze] [--no-optimize]\n",
+                argv[0]
+            );
             return EXIT_FAILURE;
         }
     }
 
     if (gdl_filepath == NULL)
     {
-        fprintf(stderr, "Usage: %s <gdl_file> [--output-dir <directory>]\n", argv[0]);
+        fprintf(
+            stderr,
+            "Usage: %s <gdl_file> [--output-dir <directory>] [--emit=graph|direct] [--analyze] [--no-optimize]\n",
+            argv[0]
+        );
         return EXIT_FAILURE;
     }
 
@@ -127,6 +201,19 @@ main(int argc, char ** argv)
             {
                 printf("GDL AST built successfully!\n");
 
+                // The analysis is printed before the code is generated, so that problems it finds are reported even
+                // if generation fails.
+                if (analyze && !analyze_grammar((gdl_ast_node_t *)ast_build_result.ast_root))
+                {
+                    exit_code = EXIT_FAILURE;
+                }
+                // The analysis is of the grammar as written, so the optimiser runs after it.
+                if (optimize && !gdl_optimize_ast((gdl_ast_node_t *)ast_build_result.ast_root))
+                {
+                    fprintf(stderr, "Error: Failed to optimise the grammar.\n");
+                    exit_code = EXIT_FAILURE;
+                }
+
                 // Call the C code generator
                 char * gdl_filename = strrchr(gdl_filepath, '/');
                 if (gdl_filename)
@@ -147,7 +234,9 @@ main(int argc, char ** argv)
                     *dot = '\0';
                 }
 
-                if (!gdl_generate_c_code((gdl_ast_node_t *)ast_build_result.ast_root, base_name, output_dir))
+                if (!gdl_generate_c_code_with_mode(
+                        (gdl_ast_node_t *)ast_build_result.ast_root, base_name, output_dir, emit_mode
+                    ))
                 {
                     fprintf(stderr, "C code generation failed.\n");
                     exit_code = EXIT_FAILURE;